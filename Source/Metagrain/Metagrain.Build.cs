@@ -8,6 +8,13 @@ public class Metagrain : ModuleRules
     {
         PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
 
+        // Route the grain core's profiling scopes to the Metagrain Insights channel
+        PrivateDefinitions.Add("METAGRAIN_WITH_UNREAL_TRACE=1");
+
+        // Allocation and lock checking around operator Execute, switched on at runtime with -MetagrainRealtimeCheck
+        bool bRealtimeChecks = Target.Configuration != UnrealTargetConfiguration.Shipping && Target.Configuration != UnrealTargetConfiguration.Test;
+        PrivateDefinitions.Add("METAGRAIN_REALTIME_CHECKS=" + (bRealtimeChecks ? "1" : "0"));
+
         PublicDependencyModuleNames.AddRange(
             new string[]
             {
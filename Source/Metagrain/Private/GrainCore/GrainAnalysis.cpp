@@ -0,0 +1,295 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Metagrain
+{
+    static_assert(sizeof(FGrainAnalysisHeader) == 64, "FGrainAnalysisHeader is part of the blob format");
+
+    namespace GrainAnalysisPrivate
+    {
+        uint16_t EncodeLevelDb(float InLevelDb)
+        {
+            const float Normalized = (InLevelDb - FGrainAnalysis::MinLevelDb) / -FGrainAnalysis::MinLevelDb;
+            return static_cast<uint16_t>(std::clamp(Normalized, 0.0f, 1.0f) * 65535.0f + 0.5f);
+        }
+
+        // Keeps every array 4-byte aligned inside the blob
+        uint32_t AlignOffset(size_t InOffset)
+        {
+            return static_cast<uint32_t>((InOffset + 3) & ~static_cast<size_t>(3));
+        }
+    }
+
+    uint64_t HashGrainContent(const void* InData, size_t InNumBytes, uint64_t InHash)
+    {
+        const uint8_t* Bytes = static_cast<const uint8_t*>(InData);
+        for (size_t Index = 0; Index < InNumBytes; ++Index)
+        {
+            InHash = (InHash ^ Bytes[Index]) * 0x100000001b3ull;
+        }
+        return InHash;
+    }
+
+    // --- FGrainAnalysis ---
+
+    std::shared_ptr<const FGrainAnalysis> FGrainAnalysis::Create(std::shared_ptr<const void> InOwner, const uint8_t* InData, size_t InSize, std::string& OutError)
+    {
+        if (InData == nullptr || InSize < sizeof(FGrainAnalysisHeader) || (reinterpret_cast<uintptr_t>(InData) & 7) != 0)
+        {
+            OutError = "analysis blob is truncated or misaligned";
+            return nullptr;
+        }
+
+        const FGrainAnalysisHeader* Header = reinterpret_cast<const FGrainAnalysisHeader*>(InData);
+        if (std::memcmp(Header->Magic, FGrainAnalysisHeader().Magic, sizeof(Header->Magic)) != 0)
+        {
+            OutError = "not a Metagrain analysis blob";
+            return nullptr;
+        }
+        if (Header->Version != FGrainAnalysisHeader::CurrentVersion || Header->HeaderBytes != sizeof(FGrainAnalysisHeader))
+        {
+            OutError = "analysis version " + std::to_string(Header->Version) + " is not supported, re-save the wave to rebuild it";
+            return nullptr;
+        }
+
+        const auto FitsArray = [InSize](uint32_t InOffset, size_t InCount, size_t InElementBytes)
+        {
+            return (InOffset & 3) == 0 && InOffset <= InSize && InCount <= (InSize - InOffset) / InElementBytes;
+        };
+        if (Header->HopFrames <= 0 || !FitsArray(Header->LevelOffset, Header->NumHops, sizeof(uint16_t))
+            || !FitsArray(Header->ZeroCrossingOffset, Header->NumHops, sizeof(uint16_t)) || !FitsArray(Header->PitchOffset, Header->NumHops, sizeof(uint16_t))
+            || !FitsArray(Header->OnsetOffset, Header->NumOnsets, sizeof(uint32_t)))
+        {
+            OutError = "analysis arrays exceed the blob";
+            return nullptr;
+        }
+
+        std::shared_ptr<FGrainAnalysis> Analysis = std::make_shared<FGrainAnalysis>();
+        Analysis->Owner = std::move(InOwner);
+        Analysis->Header = Header;
+        Analysis->Size = InSize;
+        Analysis->Level = reinterpret_cast<const uint16_t*>(InData + Header->LevelOffset);
+        Analysis->ZeroCrossings = reinterpret_cast<const uint16_t*>(InData + Header->ZeroCrossingOffset);
+        Analysis->Pitch = reinterpret_cast<const uint16_t*>(InData + Header->PitchOffset);
+        Analysis->Onsets = reinterpret_cast<const uint32_t*>(InData + Header->OnsetOffset);
+        return Analysis;
+    }
+
+    bool FGrainAnalysis::Matches(const FGrainSourceInfo& InInfo) const
+    {
+        return Header->NumChannels == InInfo.NumChannels && Header->NumFrames == InInfo.NumFrames && Header->SampleRate == InInfo.SampleRate;
+    }
+
+    uint32_t FGrainAnalysis::GetHopIndex(int64_t InFrame) const
+    {
+        if (Header->NumHops == 0)
+        {
+            return 0;
+        }
+        const int64_t Hop = std::max<int64_t>(0, InFrame) / Header->HopFrames;
+        return static_cast<uint32_t>(std::min<int64_t>(Hop, Header->NumHops - 1));
+    }
+
+    float FGrainAnalysis::GetLevelDb(uint32_t InHop) const
+    {
+        return MinLevelDb + static_cast<float>(Level[InHop]) * (-MinLevelDb / 65535.0f);
+    }
+
+    int64_t FGrainAnalysis::GetZeroCrossingFrame(uint32_t InHop) const
+    {
+        const uint16_t Offset = ZeroCrossings[InHop];
+        return (Offset == NoZeroCrossing) ? -1 : static_cast<int64_t>(InHop) * Header->HopFrames + Offset;
+    }
+
+    // --- FGrainAnalysisBuilder ---
+
+    void FGrainAnalysisBuilder::Begin(const FGrainSourceInfo& InInfo, uint64_t InContentHash, int32_t InHopFrames)
+    {
+        Info = InInfo;
+        ContentHash = InContentHash;
+        HopFrames = std::clamp(InHopFrames, 16, 65534);
+
+        Hop.clear();
+        Hop.reserve(HopFrames);
+        PreviousSample = 0.0f;
+        DecimationSum = 0.0f;
+        DecimationCount = 0;
+
+        const float DecimatedRate = std::max(1.0f, Info.SampleRate) / PitchDecimation;
+        MinPitchLag = std::max(2, static_cast<int32_t>(DecimatedRate / PitchMaxHz));
+        MaxPitchLag = std::max(MinPitchLag + 1, static_cast<int32_t>(std::ceil(DecimatedRate / PitchMinHz)));
+        Decimated.clear();
+        Decimated.reserve(PitchWindow + MaxPitchLag + HopFrames / PitchDecimation + 1);
+
+        const size_t ExpectedHops = (Info.NumFrames > 0) ? static_cast<size_t>(Info.NumFrames / HopFrames + 1) : 0;
+        Level.clear();
+        Level.reserve(ExpectedHops);
+        ZeroCrossings.clear();
+        ZeroCrossings.reserve(ExpectedHops);
+        Pitch.clear();
+        Pitch.reserve(ExpectedHops);
+        Onsets.clear();
+        std::fill(std::begin(RecentLevelDb), std::end(RecentLevelDb), FGrainAnalysis::MinLevelDb);
+        OnsetMinSpacingHops = std::max(1, static_cast<int32_t>(OnsetMinSpacingSeconds * Info.SampleRate / HopFrames));
+        HopsSinceOnset = OnsetMinSpacingHops;
+    }
+
+    void FGrainAnalysisBuilder::Append(const float* InInterleaved, int32_t InNumFrames)
+    {
+        const int32_t NumChannels = std::max(1, Info.NumChannels);
+        const float ChannelScale = 1.0f / NumChannels;
+        for (int32_t Frame = 0; Frame < InNumFrames; ++Frame)
+        {
+            float Sum = 0.0f;
+            for (int32_t Channel = 0; Channel < NumChannels; ++Channel)
+            {
+                Sum += InInterleaved[Frame * NumChannels + Channel];
+            }
+            const float Sample = Sum * ChannelScale;
+            Hop.push_back(Sample);
+
+            DecimationSum += Sample;
+            if (++DecimationCount == PitchDecimation)
+            {
+                Decimated.push_back(DecimationSum * (1.0f / PitchDecimation));
+                DecimationSum = 0.0f;
+                DecimationCount = 0;
+            }
+
+            if (static_cast<int32_t>(Hop.size()) == HopFrames)
+            {
+                AnalyzeHop();
+            }
+        }
+    }
+
+    void FGrainAnalysisBuilder::AnalyzeHop()
+    {
+        using namespace GrainAnalysisPrivate;
+
+        double SumSquares = 0.0;
+        uint16_t FirstCrossing = FGrainAnalysis::NoZeroCrossing;
+        float Previous = PreviousSample;
+        for (size_t Index = 0; Index < Hop.size(); ++Index)
+        {
+            const float Sample = Hop[Index];
+            SumSquares += static_cast<double>(Sample) * Sample;
+            if (FirstCrossing == FGrainAnalysis::NoZeroCrossing && Previous < 0.0f && Sample >= 0.0f)
+            {
+                FirstCrossing = static_cast<uint16_t>(Index);
+            }
+            Previous = Sample;
+        }
+        PreviousSample = Previous;
+
+        const double Rms = std::sqrt(SumSquares / static_cast<double>(std::max<size_t>(1, Hop.size())));
+        const float LevelDb = (Rms > 1.0e-5) ? std::max(FGrainAnalysis::MinLevelDb, static_cast<float>(20.0 * std::log10(Rms))) : FGrainAnalysis::MinLevelDb;
+
+        float RecentAverageDb = 0.0f;
+        for (float RecentDb : RecentLevelDb)
+        {
+            RecentAverageDb += RecentDb * (1.0f / OnsetHistoryHops);
+        }
+        const uint32_t HopIndex = static_cast<uint32_t>(Level.size());
+        if (HopsSinceOnset >= OnsetMinSpacingHops && LevelDb > OnsetFloorDb && LevelDb - RecentAverageDb >= OnsetRiseDb)
+        {
+            Onsets.push_back(HopIndex);
+            HopsSinceOnset = 0;
+        }
+        else
+        {
+            ++HopsSinceOnset;
+        }
+        std::copy(std::begin(RecentLevelDb) + 1, std::end(RecentLevelDb), std::begin(RecentLevelDb));
+        RecentLevelDb[OnsetHistoryHops - 1] = LevelDb;
+
+        // Only the most recent window and lag range matter for the pitch estimate
+        const size_t PitchHistory = static_cast<size_t>(PitchWindow + MaxPitchLag);
+        if (Decimated.size() > PitchHistory)
+        {
+            Decimated.erase(Decimated.begin(), Decimated.end() - PitchHistory);
+        }
+
+        Level.push_back(EncodeLevelDb(LevelDb));
+        ZeroCrossings.push_back(FirstCrossing);
+        Pitch.push_back(LevelDb > OnsetFloorDb ? EstimatePitchPeriod() : 0);
+        Hop.clear();
+    }
+
+    uint16_t FGrainAnalysisBuilder::EstimatePitchPeriod() const
+    {
+        if (Decimated.size() < static_cast<size_t>(PitchWindow + MaxPitchLag))
+        {
+            return 0;
+        }
+
+        // Cumulative mean normalized difference; the first dip below the threshold is the period
+        const float* Window = Decimated.data() + (Decimated.size() - PitchWindow - MaxPitchLag);
+        float RunningSum = 0.0f;
+        int32_t BestLag = 0;
+        float BestValue = PitchThreshold;
+        for (int32_t Lag = 1; Lag <= MaxPitchLag; ++Lag)
+        {
+            float Difference = 0.0f;
+            for (int32_t Index = 0; Index < PitchWindow; ++Index)
+            {
+                const float Delta = Window[Index] - Window[Index + Lag];
+                Difference += Delta * Delta;
+            }
+            RunningSum += Difference;
+            const float Normalized = (RunningSum > 0.0f) ? Difference * Lag / RunningSum : 1.0f;
+            if (Lag < MinPitchLag)
+            {
+                continue;
+            }
+            if (Normalized < BestValue)
+            {
+                BestValue = Normalized;
+                BestLag = Lag;
+            }
+            else if (BestLag != 0)
+            {
+                break;
+            }
+        }
+        return static_cast<uint16_t>(std::min(65535, BestLag * PitchDecimation));
+    }
+
+    std::vector<uint8_t> FGrainAnalysisBuilder::Finish()
+    {
+        using namespace GrainAnalysisPrivate;
+
+        if (!Hop.empty())
+        {
+            AnalyzeHop();
+        }
+
+        FGrainAnalysisHeader Header;
+        Header.NumChannels = Info.NumChannels;
+        Header.NumFrames = Info.NumFrames;
+        Header.ContentHash = ContentHash;
+        Header.SampleRate = Info.SampleRate;
+        Header.HopFrames = HopFrames;
+        Header.NumHops = static_cast<uint32_t>(Level.size());
+        Header.NumOnsets = static_cast<uint32_t>(Onsets.size());
+
+        const size_t HopArrayBytes = Level.size() * sizeof(uint16_t);
+        Header.LevelOffset = AlignOffset(sizeof(FGrainAnalysisHeader));
+        Header.ZeroCrossingOffset = AlignOffset(Header.LevelOffset + HopArrayBytes);
+        Header.PitchOffset = AlignOffset(Header.ZeroCrossingOffset + HopArrayBytes);
+        Header.OnsetOffset = AlignOffset(Header.PitchOffset + HopArrayBytes);
+
+        std::vector<uint8_t> Blob(Header.OnsetOffset + Onsets.size() * sizeof(uint32_t), 0);
+        std::memcpy(Blob.data(), &Header, sizeof(Header));
+        std::memcpy(Blob.data() + Header.LevelOffset, Level.data(), HopArrayBytes);
+        std::memcpy(Blob.data() + Header.ZeroCrossingOffset, ZeroCrossings.data(), HopArrayBytes);
+        std::memcpy(Blob.data() + Header.PitchOffset, Pitch.data(), HopArrayBytes);
+        std::memcpy(Blob.data() + Header.OnsetOffset, Onsets.data(), Onsets.size() * sizeof(uint32_t));
+        return Blob;
+    }
+}
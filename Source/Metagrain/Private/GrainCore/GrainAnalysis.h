@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Offline source analysis for grain placement: a per-hop level envelope, the first rising zero crossing in
+// each hop, a per-hop pitch period and a list of onset hops. Analysis is computed once (by the editor when a
+// wave is saved or cooked, or by MetagrainAnalyze) and stored as one versioned blob. At runtime the blob is
+// used in place: FGrainAnalysis only checks the header and points into it, nothing is parsed or copied.
+//
+// Blob layout, little endian: FGrainAnalysisHeader, then the level, zero crossing and pitch arrays (NumHops
+// uint16 each) and the onset array (NumOnsets uint32 hop indices), each starting at its offset in the header.
+
+#include "GrainCore.h"
+
+#include <string>
+
+namespace Metagrain
+{
+    struct FGrainAnalysisHeader
+    {
+        static constexpr uint32_t CurrentVersion = 1;
+
+        char Magic[4] = { 'M', 'G', 'A', 'N' };
+        uint32_t Version = CurrentVersion;
+        uint32_t HeaderBytes = sizeof(FGrainAnalysisHeader);
+        int32_t NumChannels = 0;
+        int64_t NumFrames = 0;
+        uint64_t ContentHash = 0;          // Hash of the analyzed audio as supplied by the caller, see HashGrainContent
+        float SampleRate = 0.0f;
+        int32_t HopFrames = 0;
+        uint32_t NumHops = 0;
+        uint32_t NumOnsets = 0;
+        uint32_t LevelOffset = 0;
+        uint32_t ZeroCrossingOffset = 0;
+        uint32_t PitchOffset = 0;
+        uint32_t OnsetOffset = 0;
+    };
+
+    // FNV-1a over raw bytes. Chain calls by passing the previous result as InHash.
+    uint64_t HashGrainContent(const void* InData, size_t InNumBytes, uint64_t InHash = 0xcbf29ce484222325ull);
+
+    // Read-only view of an analysis blob.
+    class FGrainAnalysis
+    {
+    public:
+        static constexpr uint16_t NoZeroCrossing = 0xFFFF;
+        static constexpr float MinLevelDb = -96.0f;
+
+        // Checks the header and array bounds of InData and points into it. InOwner keeps InData alive for as
+        // long as the analysis is referenced. Returns null and sets OutError if the blob is invalid.
+        static std::shared_ptr<const FGrainAnalysis> Create(std::shared_ptr<const void> InOwner, const uint8_t* InData, size_t InSize, std::string& OutError);
+
+        const FGrainAnalysisHeader& GetHeader() const { return *Header; }
+        int32_t GetHopFrames() const { return Header->HopFrames; }
+        uint32_t GetNumHops() const { return Header->NumHops; }
+        uint32_t GetNumOnsets() const { return Header->NumOnsets; }
+
+        // The whole blob, for storing it elsewhere (source cache files).
+        const uint8_t* GetData() const { return reinterpret_cast<const uint8_t*>(Header); }
+        size_t GetSize() const { return Size; }
+
+        // True if the analysis was made from audio with this layout.
+        bool Matches(const FGrainSourceInfo& InInfo) const;
+
+        // Hop containing InFrame, clamped to the analyzed range.
+        uint32_t GetHopIndex(int64_t InFrame) const;
+
+        // RMS level of the downmixed hop in dB, MinLevelDb for silence.
+        float GetLevelDb(uint32_t InHop) const;
+
+        // Frame of the first rising zero crossing in the hop, or -1 if it has none.
+        int64_t GetZeroCrossingFrame(uint32_t InHop) const;
+
+        // Pitch period in source frames for the window ending at this hop, 0 where no stable period was found.
+        // Resolution is FGrainAnalysisBuilder::PitchDecimation frames.
+        int32_t GetPitchPeriodFrames(uint32_t InHop) const { return Pitch[InHop]; }
+
+        // First frame of the onset hop.
+        int64_t GetOnsetFrame(uint32_t InOnset) const { return static_cast<int64_t>(Onsets[InOnset]) * Header->HopFrames; }
+
+    private:
+        std::shared_ptr<const void> Owner;
+        const FGrainAnalysisHeader* Header = nullptr;
+        size_t Size = 0;
+        const uint16_t* Level = nullptr;
+        const uint16_t* ZeroCrossings = nullptr;
+        const uint16_t* Pitch = nullptr;
+        const uint32_t* Onsets = nullptr;
+    };
+
+    // Builds an analysis blob from audio fed in chunks of any size, so long recordings never need to be
+    // decoded into memory at once.
+    class FGrainAnalysisBuilder
+    {
+    public:
+        static constexpr int32_t DefaultHopFrames = 512;
+
+        // Pitch detection runs on a decimated downmix, so periods are multiples of this many frames
+        static constexpr int32_t PitchDecimation = 4;
+
+        void Begin(const FGrainSourceInfo& InInfo, uint64_t InContentHash, int32_t InHopFrames = DefaultHopFrames);
+
+        // Appends InNumFrames interleaved frames with the channel count passed to Begin.
+        void Append(const float* InInterleaved, int32_t InNumFrames);
+
+        // Analyzes the remaining partial hop and returns the finished blob.
+        std::vector<uint8_t> Finish();
+
+    private:
+        void AnalyzeHop();
+        uint16_t EstimatePitchPeriod() const;
+
+        // Onset detection: level rise against the average of the previous hops, with a refractory period
+        static constexpr int32_t OnsetHistoryHops = 3;
+        static constexpr float OnsetRiseDb = 6.0f;
+        static constexpr float OnsetFloorDb = -50.0f;
+        static constexpr float OnsetMinSpacingSeconds = 0.05f;
+
+        // YIN style difference function over the decimated downmix
+        static constexpr int32_t PitchWindow = 128;
+        static constexpr float PitchMinHz = 80.0f;
+        static constexpr float PitchMaxHz = 1000.0f;
+        static constexpr float PitchThreshold = 0.15f;
+
+        FGrainSourceInfo Info;
+        uint64_t ContentHash = 0;
+        int32_t HopFrames = DefaultHopFrames;
+
+        std::vector<float> Hop;                 // Downmixed frames of the current hop
+        float PreviousSample = 0.0f;            // Last downmixed frame of the previous hop, for crossings at hop starts
+        std::vector<float> Decimated;           // Decimated downmix history, PitchWindow + max lag
+        float DecimationSum = 0.0f;
+        int32_t DecimationCount = 0;
+        int32_t MinPitchLag = 0;
+        int32_t MaxPitchLag = 0;
+
+        std::vector<uint16_t> Level;
+        std::vector<uint16_t> ZeroCrossings;
+        std::vector<uint16_t> Pitch;
+        std::vector<uint32_t> Onsets;
+        float RecentLevelDb[OnsetHistoryHops] = {};
+        int32_t HopsSinceOnset = 0;
+        int32_t OnsetMinSpacingHops = 1;
+    };
+}
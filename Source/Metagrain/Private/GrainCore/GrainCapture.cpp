@@ -0,0 +1,139 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainCapture.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Metagrain
+{
+    namespace GrainCapturePrivate
+    {
+        // Engines move starts within a few ms of the end of the source back a little (SourceEndMarginSeconds), which
+        // lengthens the delay of grains starting there.
+        constexpr float StartClampMarginSeconds = 0.01f;
+
+        int64_t WrapFrame(int64_t InFrame, int64_t InCapacity)
+        {
+            const int64_t Wrapped = InFrame % InCapacity;
+            return (Wrapped < 0) ? Wrapped + InCapacity : Wrapped;
+        }
+
+        // Voices read the ring in place, this reader serves anything else that reads the source. It wraps around the
+        // ring as grains do.
+        class FGrainCaptureReader : public IGrainSourceReader
+        {
+        public:
+            FGrainCaptureReader(std::shared_ptr<const std::vector<float>> InSamples, const FGrainSourceInfo& InInfo, int64_t InStartFrame)
+                : Samples(std::move(InSamples))
+                , Info(InInfo)
+                , Frame(InStartFrame)
+            {
+            }
+
+            virtual int32_t PopFrames(float* OutInterleaved, int32_t InNumFrames) override
+            {
+                int32_t FramesWritten = 0;
+                while (FramesWritten < InNumFrames)
+                {
+                    const int32_t FramesToCopy = static_cast<int32_t>(std::min<int64_t>(InNumFrames - FramesWritten, Info.NumFrames - Frame));
+                    std::copy_n(Samples->data() + Frame, FramesToCopy, OutInterleaved + FramesWritten);
+                    FramesWritten += FramesToCopy;
+                    Frame = (Frame + FramesToCopy) % Info.NumFrames;
+                }
+                return FramesWritten;
+            }
+
+            virtual bool Seek(float InStartTimeSeconds, bool /*bInLooping*/) override
+            {
+                Frame = Info.GetStartFrame(InStartTimeSeconds, true);
+                return true;
+            }
+
+        private:
+            std::shared_ptr<const std::vector<float>> Samples;
+            FGrainSourceInfo Info;
+            int64_t Frame = 0;
+        };
+    }
+
+    FGrainCaptureSource::FGrainCaptureSource(int32_t InCapacityFrames, float InSampleRate)
+        : CapacityFrames(std::max(1, InCapacityFrames))
+    {
+        Samples = std::make_shared<std::vector<float>>(static_cast<size_t>(CapacityFrames), 0.0f);
+        Info.NumChannels = 1;
+        Info.SampleRate = InSampleRate;
+        Info.NumFrames = CapacityFrames;
+    }
+
+    void FGrainCaptureSource::Write(const float* InSamples, int32_t InNumFrames)
+    {
+        if (!InSamples || InNumFrames <= 0)
+        {
+            return;
+        }
+
+        // Only the newest CapacityFrames frames of a long write survive it
+        const int64_t WriteFrame = FramesWritten.load(std::memory_order_relaxed);
+        const int32_t FramesSkipped = std::max(0, InNumFrames - CapacityFrames);
+        int64_t Frame = GrainCapturePrivate::WrapFrame(WriteFrame + FramesSkipped, CapacityFrames);
+        int32_t FramesCopied = FramesSkipped;
+        while (FramesCopied < InNumFrames)
+        {
+            const int32_t FramesToCopy = static_cast<int32_t>(std::min<int64_t>(InNumFrames - FramesCopied, CapacityFrames - Frame));
+            std::copy_n(InSamples + FramesCopied, FramesToCopy, Samples->data() + Frame);
+            FramesCopied += FramesToCopy;
+            Frame = (Frame + FramesToCopy) % CapacityFrames;
+        }
+        FramesWritten.store(WriteFrame + InNumFrames, std::memory_order_release);
+    }
+
+    void FGrainCaptureSource::Clear()
+    {
+        std::fill(Samples->begin(), Samples->end(), 0.0f);
+        FramesWritten.store(0, std::memory_order_release);
+    }
+
+    float FGrainCaptureSource::GetStartSeconds(int64_t InWriteFrame, float InDelaySeconds) const
+    {
+        const int64_t DelayFrames = static_cast<int64_t>(std::llround(std::max(0.0f, InDelaySeconds) * Info.SampleRate));
+        const int64_t StartFrame = GrainCapturePrivate::WrapFrame(InWriteFrame - DelayFrames, CapacityFrames);
+        // Half a frame in, so the start time does not round down to the frame before
+        return static_cast<float>((static_cast<double>(StartFrame) + 0.5) / Info.SampleRate);
+    }
+
+    float FGrainCaptureSource::GetDelaySeconds(int64_t InWriteFrame, float InStartSeconds) const
+    {
+        const int64_t StartFrame = Info.GetStartFrame(InStartSeconds, true);
+        return static_cast<float>(GrainCapturePrivate::WrapFrame(InWriteFrame - StartFrame, CapacityFrames)) / Info.SampleRate;
+    }
+
+    void FGrainCaptureSource::GetDelayLimits(float InMaxGrainSeconds, float InMinFrameRatio, float InMaxFrameRatio, int32_t InBlockFrames, float& OutMinSeconds, float& OutMaxSeconds) const
+    {
+        using namespace GrainCapturePrivate;
+
+        const float MaxGrainSeconds = std::max(0.0f, InMaxGrainSeconds);
+        const float FrameSeconds = 1.0f / Info.SampleRate;
+
+        // A grain gains (ratio - 1) frames on the head per frame it plays, plus the frame it interpolates towards
+        const float MinSeconds = MaxGrainSeconds * std::max(0.0f, InMaxFrameRatio - 1.0f) + 2.0f * FrameSeconds;
+
+        // The head runs up to a block ahead of the grains and a grain may start a block after the head was read, so
+        // two blocks of the ring are never safe; a slow grain loses (1 - ratio) frames to the head per frame
+        const float RingSeconds = static_cast<float>(CapacityFrames - 2 * std::max(0, InBlockFrames) - 2) * FrameSeconds;
+        const float MaxSeconds = RingSeconds - MaxGrainSeconds * std::max(0.0f, 1.0f - InMinFrameRatio) - StartClampMarginSeconds;
+
+        OutMaxSeconds = std::max(0.0f, MaxSeconds);
+        OutMinSeconds = std::min(MinSeconds, OutMaxSeconds);
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainCaptureSource::CreateReader(float InStartTimeSeconds, bool /*bInLooping*/, int32_t /*InMaxDecodeSizeInFrames*/)
+    {
+        return std::make_unique<GrainCapturePrivate::FGrainCaptureReader>(Samples, Info, Info.GetStartFrame(InStartTimeSeconds, true));
+    }
+
+    FGrainResidentAudio FGrainCaptureSource::GetResidentAudio() const
+    {
+        return { Samples, Samples->data(), false, CapacityFrames };
+    }
+}
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Grain source over live audio. Incoming blocks are written into a fixed-size mono ring that grains read in place,
+// wrapping around it (see FGrainResidentAudio::LoopFrames), so live grains need no recording, decoder or reader.
+// The ring is a single-producer buffer: one thread writes, and the write head is published with release semantics
+// after the samples, so voices reading behind it never take a lock. Grains address the ring by delay: the source
+// converts "this far behind the write head" into the start time an engine takes, and back.
+
+#include "GrainCore.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Metagrain
+{
+    class FGrainCaptureSource : public IGrainSource
+    {
+    public:
+        // Allocates the ring, InCapacityFrames frames of silence. InSampleRate must be the rate of the audio written.
+        FGrainCaptureSource(int32_t InCapacityFrames, float InSampleRate);
+
+        // Appends InNumFrames frames of mono audio at the write head, overwriting the oldest audio in the ring.
+        void Write(const float* InSamples, int32_t InNumFrames);
+
+        // Fills the ring with silence and moves the write head back to the start.
+        void Clear();
+
+        // Frames written since construction or the last Clear.
+        int64_t GetWriteFrame() const { return FramesWritten.load(std::memory_order_acquire); }
+
+        int32_t GetCapacityFrames() const { return CapacityFrames; }
+
+        // Start time of the audio captured InDelaySeconds before the write head stood at InWriteFrame.
+        float GetStartSeconds(int64_t InWriteFrame, float InDelaySeconds) const;
+
+        // How far behind the write head at InWriteFrame a grain starting at InStartSeconds reads, in seconds.
+        float GetDelaySeconds(int64_t InWriteFrame, float InStartSeconds) const;
+
+        // Range of delays from which a grain reads only audio that has been written and not yet overwritten, for
+        // grains up to InMaxGrainSeconds long played at frame ratios within [InMinFrameRatio, InMaxFrameRatio] by an
+        // engine rendering InBlockFrames at a time from the head at the start of the block. Grains faster than real
+        // time must start far enough back not to catch the head, slower ones close enough not to be overtaken by
+        // it. OutMinSeconds is raised no further than OutMaxSeconds when the ring is too short for both.
+        void GetDelayLimits(float InMaxGrainSeconds, float InMinFrameRatio, float InMaxFrameRatio, int32_t InBlockFrames, float& OutMinSeconds, float& OutMaxSeconds) const;
+
+        virtual const FGrainSourceInfo& GetInfo() const override { return Info; }
+        virtual std::unique_ptr<IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override;
+        virtual uint64_t GetAllocatedBytes() const override { return Samples->capacity() * sizeof(float); }
+        virtual FGrainResidentAudio GetResidentAudio() const override;
+
+    private:
+        std::shared_ptr<std::vector<float>> Samples;
+        int32_t CapacityFrames = 0;
+        std::atomic<int64_t> FramesWritten { 0 };
+        FGrainSourceInfo Info;
+    };
+}
@@ -0,0 +1,1833 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainCore.h"
+#include "GrainAnalysis.h"
+#include "GrainRecord.h"
+#include "GrainTrace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Metagrain
+{
+    namespace GrainCorePrivate
+    {
+        constexpr float Pi = 3.1415926535897932f;
+        constexpr float SmallNumber = 1.e-8f;
+        constexpr float FloatMax = std::numeric_limits<float>::max();
+
+        inline int32_t CeilToInt(float InValue) { return static_cast<int32_t>(std::ceil(InValue)); }
+        inline int32_t FloorToInt(float InValue) { return static_cast<int32_t>(std::floor(InValue)); }
+
+        template<typename T>
+        inline T Clamp(T InValue, T InMin, T InMax) { return std::min(std::max(InValue, InMin), InMax); }
+
+        inline float SemitonesToFrameRatio(float InSemitones) { return std::pow(2.0f, InSemitones / 12.0f); }
+
+        inline uint64_t ReadClock(FGrainClock InClock) { return InClock ? InClock() : 0; }
+
+        // Grows a voice buffer in power of two steps, so a voice reallocates a handful of times while grain
+        // sizes settle instead of on every slightly longer grain.
+        inline void GrowToFit(std::vector<float>& InOutBuffer, size_t InRequiredSize)
+        {
+            if (InOutBuffer.size() >= InRequiredSize)
+            {
+                return;
+            }
+            size_t NewSize = std::max<size_t>(InOutBuffer.size(), 1);
+            while (NewSize < InRequiredSize)
+            {
+                NewSize *= 2;
+            }
+            InOutBuffer.resize(NewSize);
+        }
+
+        // Wraps a time into [0, InDuration).
+        inline float WrapTime(float InSeconds, float InDuration)
+        {
+            float Wrapped = std::fmod(InSeconds, InDuration);
+            if (Wrapped < 0.0f)
+            {
+                Wrapped += InDuration;
+            }
+            return Wrapped;
+        }
+
+        // Hints the source range a grain reads: from its start for forward grains, the segment they reverse for
+        // reversed ones. Capped by the source, see IGrainSource::Prefetch.
+        inline void PrefetchGrain(IGrainSource& InSource, const FGrainDesc& InDesc, float InSampleRate)
+        {
+            const double SourceFrames = InDesc.bReversed ? static_cast<double>(InDesc.ReverseSourceFrames) : static_cast<double>(InDesc.DurationFrames) * InDesc.FrameRatio;
+            InSource.Prefetch(InDesc.StartTimeSeconds, InDesc.StartTimeSeconds + static_cast<float>(SourceFrames / InSampleRate));
+        }
+
+        // Fades out the playing grains from InFrame of the next block, for Stop and restarts
+        inline void ReleaseVoices(FGrainVoicePool& InOutVoicePool, int32_t InFrame, float InReleaseFrames, FGrainRecorder* InRecorder)
+        {
+            const int32_t ReleaseFrames = std::max(1, CeilToInt(InReleaseFrames));
+            InOutVoicePool.Release(InFrame, ReleaseFrames);
+            if (InRecorder)
+            {
+                InRecorder->RecordRelease(InFrame, ReleaseFrames);
+            }
+        }
+
+        class FGrainMemorySourceReader : public IGrainSourceReader
+        {
+        public:
+            FGrainMemorySourceReader(std::shared_ptr<const std::vector<float>> InSamples, const FGrainSourceInfo& InInfo, int64_t InStartFrame, bool bInLooping)
+                : Samples(std::move(InSamples))
+                , Info(InInfo)
+                , FramePosition(InStartFrame)
+                , bLooping(bInLooping)
+            {
+            }
+
+            virtual int32_t PopFrames(float* OutInterleaved, int32_t InNumFrames) override
+            {
+                int32_t FramesWritten = 0;
+                while (FramesWritten < InNumFrames)
+                {
+                    if (FramePosition >= Info.NumFrames)
+                    {
+                        if (!bLooping)
+                        {
+                            break;
+                        }
+                        FramePosition = 0;
+                    }
+
+                    const int64_t FramesLeftInSource = Info.NumFrames - FramePosition;
+                    const int32_t FramesToCopy = static_cast<int32_t>(std::min<int64_t>(InNumFrames - FramesWritten, FramesLeftInSource));
+                    std::memcpy(OutInterleaved + static_cast<int64_t>(FramesWritten) * Info.NumChannels,
+                        Samples->data() + FramePosition * Info.NumChannels,
+                        sizeof(float) * static_cast<size_t>(FramesToCopy) * Info.NumChannels);
+                    FramesWritten += FramesToCopy;
+                    FramePosition += FramesToCopy;
+                }
+                return FramesWritten;
+            }
+
+            virtual bool Seek(float InStartTimeSeconds, bool bInLooping) override
+            {
+                FramePosition = Info.GetStartFrame(InStartTimeSeconds, bInLooping);
+                bLooping = bInLooping;
+                return true;
+            }
+
+        private:
+            std::shared_ptr<const std::vector<float>> Samples;
+            FGrainSourceInfo Info;
+            int64_t FramePosition = 0;
+            bool bLooping = false;
+        };
+    }
+
+    // --- 16-bit Sources ---
+
+    void ConvertPcm16ToFloat(const int16_t* InSamples, float* OutSamples, size_t InNumSamples)
+    {
+        // Fixed-size inner runs vectorize at -O2, a plain loop converts one sample at a time
+        constexpr size_t RunSize = 8;
+        size_t Index = 0;
+        for (; Index + RunSize <= InNumSamples; Index += RunSize)
+        {
+            for (size_t Offset = 0; Offset < RunSize; ++Offset)
+            {
+                OutSamples[Index + Offset] = static_cast<float>(InSamples[Index + Offset]) * (1.0f / 32768.0f);
+            }
+        }
+        for (; Index < InNumSamples; ++Index)
+        {
+            OutSamples[Index] = static_cast<float>(InSamples[Index]) * (1.0f / 32768.0f);
+        }
+    }
+
+    // --- FGrainMemorySource ---
+
+    FGrainMemorySource::FGrainMemorySource(std::vector<float>&& InInterleavedSamples, int32_t InNumChannels, float InSampleRate)
+        : Samples(std::make_shared<const std::vector<float>>(std::move(InInterleavedSamples)))
+    {
+        Info.NumChannels = std::max(0, InNumChannels);
+        Info.SampleRate = InSampleRate;
+        Info.NumFrames = (Info.NumChannels > 0) ? static_cast<int64_t>(Samples->size()) / Info.NumChannels : 0;
+    }
+
+    void FGrainMemorySource::SetAnalysis(std::shared_ptr<const FGrainAnalysis> InAnalysis)
+    {
+        Analysis = (InAnalysis && InAnalysis->Matches(Info)) ? std::move(InAnalysis) : nullptr;
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainMemorySource::CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t /*InMaxDecodeSizeInFrames*/)
+    {
+        if (!Info.IsValid())
+        {
+            return nullptr;
+        }
+
+        return std::make_unique<GrainCorePrivate::FGrainMemorySourceReader>(Samples, Info, Info.GetStartFrame(InStartTimeSeconds, bInLooping), bInLooping);
+    }
+
+    // --- Envelopes ---
+
+    void ApplyAttackDecayEnvelope(float* InOutSamples, int32_t InNumFrames, int32_t InFrameInGrain, int32_t InTotalFrames, const FGrainEnvelope& InEnvelope)
+    {
+        using namespace GrainCorePrivate;
+
+        const int32_t AttackSamples = CeilToInt(InTotalFrames * InEnvelope.AttackPercent);
+        const int32_t DecaySamples = CeilToInt(InTotalFrames * InEnvelope.DecayPercent);
+        const int32_t DecayStartFrame = InTotalFrames - DecaySamples;
+
+        for (int32_t FrameIndex = 0; FrameIndex < InNumFrames; ++FrameIndex)
+        {
+            const int32_t CurrentFrameInGrain = InFrameInGrain + FrameIndex;
+            float EnvelopeScale = 1.0f;
+
+            if (CurrentFrameInGrain < AttackSamples)
+            {
+                EnvelopeScale = std::pow((AttackSamples > 0) ? static_cast<float>(CurrentFrameInGrain) / AttackSamples : 1.0f, InEnvelope.AttackCurve);
+            }
+            else if (CurrentFrameInGrain >= DecayStartFrame)
+            {
+                EnvelopeScale = std::pow((DecaySamples > 0) ? static_cast<float>(InTotalFrames - CurrentFrameInGrain) / DecaySamples : 0.0f, InEnvelope.DecayCurve);
+            }
+            InOutSamples[FrameIndex] *= Clamp(EnvelopeScale, 0.0f, 1.0f);
+        }
+    }
+
+    void ApplyWindowEnvelope(float* InOutSamples, int32_t InNumFrames, int32_t InFrameInGrain, int32_t InTotalFrames,
+        float InSmoothingAmount, float InPhaseOffset, const FGrainEnvelope& InEnvelope)
+    {
+        using namespace GrainCorePrivate;
+
+        if (InTotalFrames <= 0)
+        {
+            return;
+        }
+
+        const int32_t AttackSamples = CeilToInt(InTotalFrames * InEnvelope.AttackPercent);
+        const int32_t DecaySamples = CeilToInt(InTotalFrames * InEnvelope.DecayPercent);
+        const int32_t DecayStartFrame = InTotalFrames - DecaySamples;
+        const float TotalFrames = static_cast<float>(InTotalFrames);
+        const float SmoothingExponent = 1.0f - (InSmoothingAmount * 0.3f);
+
+        for (int32_t FrameIndex = 0; FrameIndex < InNumFrames; ++FrameIndex)
+        {
+            const int32_t CurrentFrameInGrain = InFrameInGrain + FrameIndex;
+            float EnvelopeScale = 1.0f;
+
+            switch (InEnvelope.WindowShape)
+            {
+            case EGrainWindowShape::Linear:
+                if (CurrentFrameInGrain < AttackSamples)
+                {
+                    EnvelopeScale = (AttackSamples > 0) ? static_cast<float>(CurrentFrameInGrain) / AttackSamples : 1.0f;
+                }
+                else if (CurrentFrameInGrain >= DecayStartFrame)
+                {
+                    EnvelopeScale = (DecaySamples > 0) ? static_cast<float>(InTotalFrames - CurrentFrameInGrain) / DecaySamples : 0.0f;
+                }
+                break;
+
+            case EGrainWindowShape::Parabolic:
+                if (CurrentFrameInGrain < AttackSamples)
+                {
+                    const float T = (AttackSamples > 0) ? static_cast<float>(CurrentFrameInGrain) / AttackSamples : 1.0f;
+                    EnvelopeScale = T * T;
+                }
+                else if (CurrentFrameInGrain >= DecayStartFrame)
+                {
+                    const float T = (DecaySamples > 0) ? static_cast<float>(InTotalFrames - CurrentFrameInGrain) / DecaySamples : 0.0f;
+                    EnvelopeScale = T * T;
+                }
+                break;
+
+            case EGrainWindowShape::Gaussian:
+                {
+                    // Center is shifted slightly later and width grows with smoothing for gentler attack/decay
+                    const float Center = TotalFrames * (0.5f + InSmoothingAmount * 0.1f);
+                    const float Width = TotalFrames * (0.25f + InSmoothingAmount * 0.1f);
+                    const float Distance = (static_cast<float>(CurrentFrameInGrain) - Center) / Width;
+                    EnvelopeScale = std::exp(-0.5f * Distance * Distance);
+                }
+                break;
+
+            case EGrainWindowShape::Cosine:
+                {
+                    const float Phase = Pi * CurrentFrameInGrain / TotalFrames;
+                    EnvelopeScale = 0.5f * (1.0f - std::cos(2.0f * Phase));
+                }
+                break;
+
+            case EGrainWindowShape::Hann:
+                {
+                    // Phase offset for better inter-grain crossfades
+                    const float Phase = Pi * (CurrentFrameInGrain / TotalFrames) + InPhaseOffset * Pi * 0.25f;
+                    switch (InEnvelope.XfadeCurve)
+                    {
+                    case 0: // Linear
+                        EnvelopeScale = 0.5f * (1.0f - std::cos(2.0f * Phase));
+                        break;
+
+                    case 1: // Equal Power
+                        {
+                            const float SinValue = std::sin(Phase);
+                            EnvelopeScale = SinValue * SinValue;
+                        }
+                        break;
+
+                    case 2: // Smooth
+                        EnvelopeScale = std::pow(0.5f * (1.0f - std::cos(2.0f * Phase)), 0.7f + (0.6f * InSmoothingAmount));
+                        break;
+                    }
+                }
+                break;
+
+            case EGrainWindowShape::Blackman:
+                {
+                    const float X = CurrentFrameInGrain / TotalFrames;
+                    EnvelopeScale = 0.42f - 0.5f * std::cos(2.0f * Pi * X) + 0.08f * std::cos(4.0f * Pi * X);
+                }
+                break;
+
+            case EGrainWindowShape::Triangular:
+                {
+                    const float X = CurrentFrameInGrain / TotalFrames;
+                    EnvelopeScale = 1.0f - std::abs(2.0f * X - 1.0f);
+                }
+                break;
+
+            case EGrainWindowShape::Rectangular:
+                EnvelopeScale = 1.0f;
+                break;
+            }
+
+            // Reduce the steepness of the envelope for smoother transitions
+            if (InSmoothingAmount > 0.0f && EnvelopeScale > 0.0f && EnvelopeScale < 1.0f)
+            {
+                EnvelopeScale = std::pow(EnvelopeScale, SmoothingExponent);
+            }
+
+            InOutSamples[FrameIndex] *= Clamp(EnvelopeScale, 0.0f, 1.0f);
+        }
+    }
+
+    void ApplyReleaseFade(float* InOutSamples, int32_t InNumFrames, int32_t InFrameInRelease, int32_t InReleaseFrames)
+    {
+        const float Step = 1.0f / static_cast<float>(std::max(1, InReleaseFrames));
+        for (int32_t FrameIndex = std::max(0, -InFrameInRelease); FrameIndex < InNumFrames; ++FrameIndex)
+        {
+            const float Gain = 1.0f - static_cast<float>(InFrameInRelease + FrameIndex + 1) * Step;
+            InOutSamples[FrameIndex] *= std::max(0.0f, Gain);
+        }
+    }
+
+    void GetPanGains(float InPan, float& OutLeftGain, float& OutRightGain)
+    {
+        const float PanAngle = (InPan + 1.0f) * 0.5f * GrainCorePrivate::Pi * 0.5f;
+        OutLeftGain = std::cos(PanAngle);
+        OutRightGain = std::sin(PanAngle);
+    }
+
+    void ApplyOutputFilter(float* InOutLeft, float* InOutRight, int32_t InNumFrames, float InCoeff, float (&InOutState)[2])
+    {
+        float* Channels[2] = { InOutLeft, InOutRight };
+        for (int32_t ChannelIndex = 0; ChannelIndex < 2; ++ChannelIndex)
+        {
+            float* Channel = Channels[ChannelIndex];
+            float Previous = InOutState[ChannelIndex];
+            for (int32_t FrameIndex = 0; FrameIndex < InNumFrames; ++FrameIndex)
+            {
+                Previous = Channel[FrameIndex] * InCoeff + Previous * (1.0f - InCoeff);
+                Channel[FrameIndex] = Previous;
+            }
+            InOutState[ChannelIndex] = Previous;
+        }
+    }
+
+    // --- FGrainVoicePool ---
+
+    void FGrainVoicePool::Init(int32_t InMaxVoices, int32_t InBlockSize)
+    {
+        BlockSize = std::max(1, InBlockSize);
+        Voices.clear();
+        Voices.resize(std::max(0, InMaxVoices));
+        for (FGrainVoice& Voice : Voices)
+        {
+            Voice.SourceFrames.resize(SourceChunkFrames + BlockSize * 2 + 2);
+        }
+        MonoScratch.assign(BlockSize, 0.0f);
+        InterleavedScratch.assign(SourceChunkFrames * 2, 0.0f);
+        FreeReaders.clear();
+        FreeReaders.reserve(Voices.size());
+        NumReadersCreated = 0;
+        NumReadersReused = 0;
+        NumSourceSamplesRead = 0;
+        NumReaderSamplesRead = 0;
+    }
+
+    void FGrainVoicePool::ReleaseReaders()
+    {
+        FreeReaders.clear();
+        ++ReaderGeneration;
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainVoicePool::AcquireReader(IGrainSource& InSource, const FGrainDesc& InDesc)
+    {
+        const float StartTimeSeconds = std::max(0.0f, InDesc.StartTimeSeconds);
+        const bool bLooping = InDesc.bLoopSource && !InDesc.bReversed;
+        while (!FreeReaders.empty())
+        {
+            std::unique_ptr<IGrainSourceReader> Reader = std::move(FreeReaders.back());
+            FreeReaders.pop_back();
+            if (Reader->Seek(StartTimeSeconds, bLooping))
+            {
+                ++NumReadersReused;
+                return Reader;
+            }
+        }
+
+        METAGRAIN_TRACE_SCOPE(CreateReader);
+        std::unique_ptr<IGrainSourceReader> Reader = InSource.CreateReader(StartTimeSeconds, bLooping, InDesc.MaxDecodeSizeInFrames);
+        NumReadersCreated += Reader ? 1 : 0;
+        return Reader;
+    }
+
+    void FGrainVoicePool::RecycleReader(std::unique_ptr<IGrainSourceReader>&& InReader, uint32_t InGeneration)
+    {
+        if (InReader && InGeneration == ReaderGeneration && FreeReaders.size() < FreeReaders.capacity())
+        {
+            FreeReaders.push_back(std::move(InReader));
+        }
+        InReader.reset();
+    }
+
+    int32_t FGrainVoicePool::FindFreeVoice() const
+    {
+        int32_t ReleasingVoiceIndex = -1;
+        for (int32_t VoiceIndex = 0; VoiceIndex < static_cast<int32_t>(Voices.size()); ++VoiceIndex)
+        {
+            const FGrainVoice& Voice = Voices[VoiceIndex];
+            if (!Voice.bIsActive)
+            {
+                return VoiceIndex;
+            }
+            if (Voice.bIsReleasing && (ReleasingVoiceIndex < 0 || Voice.SamplesRemaining < Voices[ReleasingVoiceIndex].SamplesRemaining))
+            {
+                ReleasingVoiceIndex = VoiceIndex;
+            }
+        }
+        return ReleasingVoiceIndex;
+    }
+
+    int32_t FGrainVoicePool::GetNumActiveVoices() const
+    {
+        int32_t NumActive = 0;
+        for (const FGrainVoice& Voice : Voices)
+        {
+            NumActive += Voice.bIsActive ? 1 : 0;
+        }
+        return NumActive;
+    }
+
+    int32_t FGrainVoicePool::GetNumReleasingVoices() const
+    {
+        int32_t NumReleasing = 0;
+        for (const FGrainVoice& Voice : Voices)
+        {
+            NumReleasing += (Voice.bIsActive && Voice.bIsReleasing) ? 1 : 0;
+        }
+        return NumReleasing;
+    }
+
+    void FGrainVoicePool::Release(int32_t InFrame, int32_t InReleaseFrames)
+    {
+        InFrame = std::max(0, InFrame);
+        InReleaseFrames = std::max(1, InReleaseFrames);
+        for (FGrainVoice& Voice : Voices)
+        {
+            if (!Voice.bIsActive || Voice.bIsReleasing)
+            {
+                continue;
+            }
+
+            // The grain's own timeline starts after its delay
+            const int32_t FramesUntilRelease = InFrame - Voice.DelayFrames;
+            if (FramesUntilRelease <= 0 && Voice.SamplesPlayed == 0)
+            {
+                ReleaseVoice(Voice);
+                continue;
+            }
+            if (Voice.SamplesRemaining <= FramesUntilRelease + InReleaseFrames)
+            {
+                continue;
+            }
+
+            Voice.bIsReleasing = true;
+            Voice.ReleaseStartSample = Voice.SamplesPlayed + std::max(0, FramesUntilRelease);
+            Voice.ReleaseSamples = InReleaseFrames;
+            Voice.SamplesRemaining = std::max(0, FramesUntilRelease) + InReleaseFrames;
+        }
+    }
+
+    uint64_t FGrainVoicePool::GetAllocatedBytes() const
+    {
+        uint64_t NumBytes = (InterleavedScratch.capacity() + MonoScratch.capacity()) * sizeof(float);
+        for (const FGrainVoice& Voice : Voices)
+        {
+            NumBytes += sizeof(FGrainVoice) + Voice.SourceFrames.capacity() * sizeof(float);
+        }
+        return NumBytes;
+    }
+
+    int32_t FGrainVoicePool::StartGrain(IGrainSource& InSource, const FGrainDesc& InDesc)
+    {
+        METAGRAIN_TRACE_SCOPE(StartGrain);
+
+        const FGrainSourceInfo& Info = InSource.GetInfo();
+        if (!Info.IsValid() || InDesc.DurationFrames <= 0 || InDesc.FrameRatio <= 0.0f)
+        {
+            return -1;
+        }
+
+        if (InDesc.bReversed && InDesc.ReverseSourceFrames <= 0)
+        {
+            return -1;
+        }
+
+        // May be a releasing voice, which is cut short for the new grain only once its reader or resident audio is
+        // set up, so a grain that cannot start leaves the release tail playing
+        const int32_t VoiceIndex = FindFreeVoice();
+        if (VoiceIndex < 0)
+        {
+            return -1;
+        }
+
+        FGrainResidentAudio Resident = InSource.GetResidentAudio();
+        if (Resident.IsValid() && Resident.LoopFrames > 0)
+        {
+            return StartLoopedGrain(VoiceIndex, Info, std::move(Resident), InDesc);
+        }
+
+        // A grain starting partway through reads from where it would be by now. Reversed grains play their
+        // segment from the end, so they leave out its last frames instead.
+        FGrainDesc Desc = InDesc;
+        const int32_t SkipFrames = std::max(0, std::min(InDesc.SkipFrames, InDesc.DurationFrames));
+        if (SkipFrames >= InDesc.DurationFrames)
+        {
+            return -1;
+        }
+        const double SkipSourceFrames = static_cast<double>(SkipFrames) * InDesc.FrameRatio;
+        const int64_t WholeSkipSourceFrames = static_cast<int64_t>(SkipSourceFrames);
+        if (WholeSkipSourceFrames > 0)
+        {
+            if (InDesc.bReversed)
+            {
+                Desc.ReverseSourceFrames = static_cast<int32_t>(std::max<int64_t>(0, InDesc.ReverseSourceFrames - WholeSkipSourceFrames));
+                if (Desc.ReverseSourceFrames <= 0)
+                {
+                    return -1;
+                }
+            }
+            else
+            {
+                const double StartFrame = std::floor(std::max(0.0f, InDesc.StartTimeSeconds) * static_cast<double>(Info.SampleRate));
+                Desc.StartTimeSeconds = static_cast<float>((StartFrame + WholeSkipSourceFrames + 0.5) / Info.SampleRate);
+            }
+        }
+
+        GrainCorePrivate::PrefetchGrain(InSource, Desc, Info.SampleRate);
+
+        // Audio held in memory is read in place, which leaves grain start without reader or decoder work
+        std::unique_ptr<IGrainSourceReader> Reader;
+        if (!Resident.IsValid())
+        {
+            Reader = AcquireReader(InSource, Desc);
+            if (!Reader)
+            {
+                return -1;
+            }
+        }
+
+        FGrainVoice& Voice = Voices[VoiceIndex];
+        if (Voice.bIsActive)
+        {
+            ReleaseVoice(Voice);
+        }
+        Voice.Resident = std::move(Resident);
+        if (Voice.Resident.IsValid())
+        {
+            // Reversed grains never loop, as in AcquireReader
+            const bool bLooping = Desc.bLoopSource && !Desc.bReversed;
+            Voice.ResidentFrame = Info.GetStartFrame(Desc.StartTimeSeconds, bLooping);
+            Voice.ResidentNumFrames = Info.NumFrames;
+            Voice.bResidentLooping = bLooping;
+        }
+
+        Voice.NumChannels = Info.NumChannels;
+        Voice.FrameRatio = InDesc.FrameRatio;
+        Voice.ReadPosition = SkipSourceFrames - static_cast<double>(WholeSkipSourceFrames);
+        // On whole frames at a whole frame ratio interpolation always returns the frame itself, so the grain is copied
+        const float WholeFrameRatio = std::floor(Voice.FrameRatio);
+        Voice.SourceStep = (Voice.ReadPosition == 0.0 && Voice.FrameRatio == WholeFrameRatio && WholeFrameRatio >= 1.0f && WholeFrameRatio <= MaxSourceStep)
+            ? static_cast<int32_t>(WholeFrameRatio) : 0;
+        Voice.SourceNumFrames = 0;
+        Voice.bSourceExhausted = false;
+        Voice.bIsReversed = InDesc.bReversed;
+
+        const size_t RequiredInterleaved = static_cast<size_t>(SourceChunkFrames) * Voice.NumChannels;
+        if (InterleavedScratch.size() < RequiredInterleaved)
+        {
+            InterleavedScratch.resize(RequiredInterleaved);
+        }
+
+        int32_t GrainSamples = InDesc.DurationFrames;
+        if (InDesc.bReversed)
+        {
+            // Read the whole segment up front, then play it backwards
+            METAGRAIN_TRACE_SCOPE(ReadReverseSegment);
+            GrainCorePrivate::GrowToFit(Voice.SourceFrames, static_cast<size_t>(Desc.ReverseSourceFrames));
+
+            while (Voice.SourceNumFrames < Desc.ReverseSourceFrames)
+            {
+                const int32_t FramesToRead = std::min(SourceChunkFrames, Desc.ReverseSourceFrames - Voice.SourceNumFrames);
+                if (Voice.Resident.IsValid())
+                {
+                    if (ReadResident(Voice, FramesToRead) <= 0)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+
+                const int32_t FramesRead = Reader->PopFrames(InterleavedScratch.data(), FramesToRead);
+                if (FramesRead <= 0)
+                {
+                    break;
+                }
+                NumSourceSamplesRead += static_cast<uint64_t>(FramesRead) * Voice.NumChannels;
+                NumReaderSamplesRead += static_cast<uint64_t>(FramesRead) * Voice.NumChannels;
+                AppendDownmixed(Voice, InterleavedScratch.data(), FramesRead);
+            }
+
+            if (Reader)
+            {
+                RecycleReader(std::move(Reader), ReaderGeneration);
+            }
+            if (Voice.SourceNumFrames <= 0)
+            {
+                ReleaseVoice(Voice);
+                return -1;
+            }
+
+            std::reverse(Voice.SourceFrames.begin(), Voice.SourceFrames.begin() + Voice.SourceNumFrames);
+            Voice.bSourceExhausted = true;
+
+            // A frame ratio of 2 (octave up) turns N source frames into N / 2 output frames
+            const int64_t SegmentFrames = Voice.SourceNumFrames + WholeSkipSourceFrames;
+            const int32_t MaxOutputSamplesFromSegment = std::max(1, GrainCorePrivate::CeilToInt(static_cast<float>(SegmentFrames) / InDesc.FrameRatio));
+            GrainSamples = std::max(1, std::min(InDesc.DurationFrames, MaxOutputSamplesFromSegment));
+        }
+        else
+        {
+            Voice.Reader = std::move(Reader);
+            Voice.ReaderGeneration = ReaderGeneration;
+
+            const size_t RequiredCapacity = static_cast<size_t>(SourceChunkFrames) + static_cast<size_t>(std::ceil(BlockSize * static_cast<double>(InDesc.FrameRatio))) + 2;
+            GrainCorePrivate::GrowToFit(Voice.SourceFrames, RequiredCapacity);
+        }
+
+        if (SkipFrames >= GrainSamples)
+        {
+            ReleaseVoice(Voice);
+            return -1;
+        }
+
+        Voice.bIsActive = true;
+        Voice.SamplesRemaining = GrainSamples - SkipFrames;
+        Voice.SamplesPlayed = SkipFrames;
+        Voice.TotalGrainSamples = GrainSamples;
+        Voice.PanPosition = InDesc.Pan;
+        Voice.VolumeScale = InDesc.Volume;
+        Voice.SmoothingAmount = InDesc.SmoothingAmount;
+        Voice.PhaseOffset = InDesc.PhaseOffset;
+        Voice.DelayFrames = std::max(0, InDesc.DelayFrames);
+        Voice.bIsReleasing = false;
+        return VoiceIndex;
+    }
+
+    int32_t FGrainVoicePool::StartLoopedGrain(int32_t InVoiceIndex, const FGrainSourceInfo& InInfo, FGrainResidentAudio&& InResident, const FGrainDesc& InDesc)
+    {
+        if (InInfo.NumChannels != 1 || InResident.bPcm16 || InInfo.NumFrames % InResident.LoopFrames != 0)
+        {
+            return -1;
+        }
+
+        // The grain plays the loop its start frame is in, from that frame's phase. Reversed grains run the phase
+        // backwards from the end of their segment, and a grain starting partway through is that far along.
+        const int64_t LoopFrames = InResident.LoopFrames;
+        int64_t StartFrame = InInfo.GetStartFrame(InDesc.StartTimeSeconds, true);
+        if (InDesc.bReversed)
+        {
+            StartFrame = std::min(InInfo.NumFrames - 1, StartFrame + std::max(1, InDesc.ReverseSourceFrames) - 1);
+        }
+        StartFrame = std::min(StartFrame, InInfo.NumFrames - 1);
+
+        const int32_t SkipFrames = std::max(0, std::min(InDesc.SkipFrames, InDesc.DurationFrames));
+        if (SkipFrames >= InDesc.DurationFrames)
+        {
+            return -1;
+        }
+        const double SkipSourceFrames = static_cast<double>(SkipFrames) * InDesc.FrameRatio;
+        const double Loop = static_cast<double>(LoopFrames);
+        double Phase = static_cast<double>(StartFrame % LoopFrames) + (InDesc.bReversed ? -SkipSourceFrames : SkipSourceFrames);
+        Phase -= std::floor(Phase / Loop) * Loop;
+
+        FGrainVoice& Voice = Voices[InVoiceIndex];
+        if (Voice.bIsActive)
+        {
+            ReleaseVoice(Voice);
+        }
+        Voice.Resident = std::move(InResident);
+        Voice.ResidentLoopStart = StartFrame - StartFrame % LoopFrames;
+        Voice.NumChannels = 1;
+        Voice.FrameRatio = InDesc.FrameRatio;
+        Voice.ReadPosition = Phase;
+        Voice.SourceStep = 0;
+        Voice.SourceNumFrames = 0;
+        Voice.bSourceExhausted = true;
+        Voice.bIsReversed = InDesc.bReversed;
+        Voice.bIsActive = true;
+        Voice.SamplesRemaining = InDesc.DurationFrames - SkipFrames;
+        Voice.SamplesPlayed = SkipFrames;
+        Voice.TotalGrainSamples = InDesc.DurationFrames;
+        Voice.PanPosition = InDesc.Pan;
+        Voice.VolumeScale = InDesc.Volume;
+        Voice.SmoothingAmount = InDesc.SmoothingAmount;
+        Voice.PhaseOffset = InDesc.PhaseOffset;
+        Voice.DelayFrames = std::max(0, InDesc.DelayFrames);
+        Voice.bIsReleasing = false;
+        return InVoiceIndex;
+    }
+
+    int32_t FGrainVoicePool::GenerateLoopedVoice(FGrainVoice& InVoice, float* OutMono, int32_t InNumFrames)
+    {
+        METAGRAIN_TRACE_SCOPE(Resample);
+
+        const float* Loop = static_cast<const float*>(InVoice.Resident.Samples) + InVoice.ResidentLoopStart;
+        const int64_t LoopFrames = InVoice.Resident.LoopFrames;
+        const double LoopLength = static_cast<double>(LoopFrames);
+        const double Step = InVoice.bIsReversed ? -static_cast<double>(InVoice.FrameRatio) : static_cast<double>(InVoice.FrameRatio);
+        double Phase = InVoice.ReadPosition;
+        for (int32_t FrameIndex = 0; FrameIndex < InNumFrames; ++FrameIndex)
+        {
+            // Rounding can leave the phase a hair short of wrapping, which must not index past the loop
+            const int64_t Index = std::min(static_cast<int64_t>(Phase), LoopFrames - 1);
+            const int64_t NextIndex = (Index + 1 < LoopFrames) ? Index + 1 : 0;
+            const float Alpha = static_cast<float>(Phase - static_cast<double>(Index));
+            OutMono[FrameIndex] = Loop[Index] + Alpha * (Loop[NextIndex] - Loop[Index]);
+
+            Phase += Step;
+            if (Phase >= LoopLength || Phase < 0.0)
+            {
+                Phase -= std::floor(Phase / LoopLength) * LoopLength;
+            }
+        }
+
+        InVoice.ReadPosition = Phase;
+        return InNumFrames;
+    }
+
+    void FGrainVoicePool::AppendDownmixed(FGrainVoice& InVoice, const float* InInterleaved, int32_t InNumFrames)
+    {
+        float* Destination = InVoice.SourceFrames.data() + InVoice.SourceNumFrames;
+        if (InVoice.NumChannels == 1)
+        {
+            std::memcpy(Destination, InInterleaved, sizeof(float) * InNumFrames);
+        }
+        else
+        {
+            // Only the first two channels contribute, matching the original operators
+            const int32_t NumChannels = InVoice.NumChannels;
+            for (int32_t FrameIndex = 0; FrameIndex < InNumFrames; ++FrameIndex)
+            {
+                const float* Frame = InInterleaved + FrameIndex * NumChannels;
+                Destination[FrameIndex] = (Frame[0] + Frame[1]) * 0.5f;
+            }
+        }
+        InVoice.SourceNumFrames += InNumFrames;
+    }
+
+    int32_t FGrainVoicePool::ReadResident(FGrainVoice& InVoice, int32_t InMaxFrames)
+    {
+        if (InVoice.ResidentFrame >= InVoice.ResidentNumFrames)
+        {
+            if (!InVoice.bResidentLooping)
+            {
+                return 0;
+            }
+            InVoice.ResidentFrame = 0;
+        }
+
+        const int32_t FramesRead = static_cast<int32_t>(std::min<int64_t>(InMaxFrames, InVoice.ResidentNumFrames - InVoice.ResidentFrame));
+        if (FramesRead <= 0)
+        {
+            return 0;
+        }
+
+        const int64_t SampleOffset = InVoice.ResidentFrame * InVoice.NumChannels;
+        if (InVoice.Resident.bPcm16)
+        {
+            ConvertPcm16ToFloat(static_cast<const int16_t*>(InVoice.Resident.Samples) + SampleOffset, InterleavedScratch.data(), static_cast<size_t>(FramesRead) * InVoice.NumChannels);
+            AppendDownmixed(InVoice, InterleavedScratch.data(), FramesRead);
+        }
+        else
+        {
+            AppendDownmixed(InVoice, static_cast<const float*>(InVoice.Resident.Samples) + SampleOffset, FramesRead);
+        }
+        InVoice.ResidentFrame += FramesRead;
+        NumSourceSamplesRead += static_cast<uint64_t>(FramesRead) * InVoice.NumChannels;
+        return FramesRead;
+    }
+
+    template <bool bInResample>
+    int32_t FGrainVoicePool::GenerateVoice(FGrainVoice& InVoice, float* OutMono, int32_t InNumFrames)
+    {
+        double Position = InVoice.ReadPosition;
+        const double Ratio = InVoice.FrameRatio;
+
+        if (!InVoice.bSourceExhausted)
+        {
+            METAGRAIN_TRACE_SCOPE(SourceRead);
+
+            // Index of the last source frame the interpolator will touch for this block
+            int64_t LastFrameNeeded = static_cast<int64_t>(Position + (InNumFrames - 1) * Ratio) + 1;
+            while (InVoice.SourceNumFrames <= LastFrameNeeded && !InVoice.bSourceExhausted)
+            {
+                // Drop frames the read position has moved past
+                const int32_t FramesConsumed = std::min(static_cast<int32_t>(Position), InVoice.SourceNumFrames);
+                if (FramesConsumed > 0)
+                {
+                    std::memmove(InVoice.SourceFrames.data(), InVoice.SourceFrames.data() + FramesConsumed, sizeof(float) * (InVoice.SourceNumFrames - FramesConsumed));
+                    InVoice.SourceNumFrames -= FramesConsumed;
+                    Position -= FramesConsumed;
+                    LastFrameNeeded -= FramesConsumed;
+                }
+
+                GrainCorePrivate::GrowToFit(InVoice.SourceFrames, static_cast<size_t>(InVoice.SourceNumFrames + SourceChunkFrames));
+
+                int32_t FramesRead = 0;
+                if (InVoice.Resident.IsValid())
+                {
+                    // Only what this block needs, so a grain of a few ms does not copy a whole chunk
+                    const int64_t FramesNeeded = LastFrameNeeded + 1 - InVoice.SourceNumFrames;
+                    FramesRead = ReadResident(InVoice, static_cast<int32_t>(std::min<int64_t>(SourceChunkFrames, FramesNeeded)));
+                }
+                else
+                {
+                    FramesRead = InVoice.Reader ? InVoice.Reader->PopFrames(InterleavedScratch.data(), SourceChunkFrames) : 0;
+                    if (FramesRead > 0)
+                    {
+                        NumSourceSamplesRead += static_cast<uint64_t>(FramesRead) * InVoice.NumChannels;
+                        NumReaderSamplesRead += static_cast<uint64_t>(FramesRead) * InVoice.NumChannels;
+                        AppendDownmixed(InVoice, InterleavedScratch.data(), FramesRead);
+                    }
+                }
+                if (FramesRead <= 0)
+                {
+                    InVoice.bSourceExhausted = true;
+                    break;
+                }
+            }
+        }
+
+        const float* Source = InVoice.SourceFrames.data();
+        int32_t FramesProduced = 0;
+        if constexpr (bInResample)
+        {
+            METAGRAIN_TRACE_SCOPE(Resample);
+            for (; FramesProduced < InNumFrames; ++FramesProduced)
+            {
+                const int64_t Index = static_cast<int64_t>(Position);
+                if (Index + 1 >= InVoice.SourceNumFrames)
+                {
+                    break;
+                }
+                const float Alpha = static_cast<float>(Position - static_cast<double>(Index));
+                OutMono[FramesProduced] = Source[Index] + Alpha * (Source[Index + 1] - Source[Index]);
+                Position += Ratio;
+            }
+        }
+        else
+        {
+            // At a whole frame ratio the read position stays on whole frames, where interpolation returns the frame
+            // itself. The last frame is held back as the interpolator would, so both paths stop at the same frame.
+            METAGRAIN_TRACE_SCOPE(CopySource);
+            const int64_t Index = static_cast<int64_t>(Position);
+            const int64_t Step = std::max(1, InVoice.SourceStep);
+            const int64_t FramesAvailable = InVoice.SourceNumFrames - 1 - Index > 0 ? (InVoice.SourceNumFrames - 2 - Index) / Step + 1 : 0;
+            FramesProduced = static_cast<int32_t>(std::min<int64_t>(InNumFrames, FramesAvailable));
+            if (Step == 1)
+            {
+                std::memcpy(OutMono, Source + Index, sizeof(float) * FramesProduced);
+            }
+            else
+            {
+                for (int32_t FrameIndex = 0; FrameIndex < FramesProduced; ++FrameIndex)
+                {
+                    OutMono[FrameIndex] = Source[Index + FrameIndex * Step];
+                }
+            }
+            Position += static_cast<double>(FramesProduced * Step);
+        }
+
+        InVoice.ReadPosition = Position;
+        return FramesProduced;
+    }
+
+    template <bool bInResample>
+    void FGrainVoicePool::Render(float* OutLeft, float* OutRight, int32_t InNumFrames, const FGrainEnvelope& InEnvelope)
+    {
+        METAGRAIN_TRACE_SCOPE(RenderVoices);
+
+        InNumFrames = std::min(InNumFrames, BlockSize);
+        float* MonoBuffer = MonoScratch.data();
+
+        for (FGrainVoice& Voice : Voices)
+        {
+            if (!Voice.bIsActive)
+            {
+                continue;
+            }
+
+            // Grains placed at a trigger frame stay silent until it
+            const int32_t DelayFrames = std::min(Voice.DelayFrames, InNumFrames);
+            Voice.DelayFrames -= DelayFrames;
+            const int32_t FramesToProcess = std::min(InNumFrames - DelayFrames, Voice.SamplesRemaining);
+            if (FramesToProcess <= 0)
+            {
+                if (DelayFrames == 0)
+                {
+                    ReleaseVoice(Voice);
+                }
+                continue;
+            }
+
+            int32_t FramesGenerated = 0;
+            if (Voice.Resident.LoopFrames > 0)
+            {
+                FramesGenerated = GenerateLoopedVoice(Voice, MonoBuffer, FramesToProcess);
+            }
+            else
+            {
+                FramesGenerated = (bInResample && Voice.SourceStep == 0)
+                    ? GenerateVoice<true>(Voice, MonoBuffer, FramesToProcess)
+                    : GenerateVoice<false>(Voice, MonoBuffer, FramesToProcess);
+            }
+            if (FramesGenerated < FramesToProcess)
+            {
+                std::fill(MonoBuffer + FramesGenerated, MonoBuffer + FramesToProcess, 0.0f);
+            }
+
+            if (FramesGenerated > 0)
+            {
+                METAGRAIN_TRACE_SCOPE(Envelope);
+                if (InEnvelope.Type == EGrainEnvelopeType::AttackDecay)
+                {
+                    ApplyAttackDecayEnvelope(MonoBuffer, FramesGenerated, Voice.SamplesPlayed, Voice.TotalGrainSamples, InEnvelope);
+                }
+                else
+                {
+                    ApplyWindowEnvelope(MonoBuffer, FramesGenerated, Voice.SamplesPlayed, Voice.TotalGrainSamples, Voice.SmoothingAmount, Voice.PhaseOffset, InEnvelope);
+                }
+            }
+
+            if (FramesGenerated > 0 && Voice.bIsReleasing)
+            {
+                ApplyReleaseFade(MonoBuffer, FramesGenerated, Voice.SamplesPlayed - Voice.ReleaseStartSample, Voice.ReleaseSamples);
+            }
+
+            if (FramesGenerated > 0)
+            {
+                METAGRAIN_TRACE_SCOPE(PanMix);
+                float LeftGain = 0.0f;
+                float RightGain = 0.0f;
+                GetPanGains(Voice.PanPosition, LeftGain, RightGain);
+                LeftGain *= Voice.VolumeScale;
+                RightGain *= Voice.VolumeScale;
+
+                float* Left = OutLeft + DelayFrames;
+                float* Right = OutRight + DelayFrames;
+                for (int32_t FrameIndex = 0; FrameIndex < FramesGenerated; ++FrameIndex)
+                {
+                    Left[FrameIndex] += MonoBuffer[FrameIndex] * LeftGain;
+                    Right[FrameIndex] += MonoBuffer[FrameIndex] * RightGain;
+                }
+            }
+
+            Voice.SamplesPlayed += FramesToProcess;
+            Voice.SamplesRemaining -= FramesToProcess;
+            if (Voice.SamplesRemaining <= 0)
+            {
+                ReleaseVoice(Voice);
+            }
+        }
+    }
+
+    template void FGrainVoicePool::Render<true>(float* OutLeft, float* OutRight, int32_t InNumFrames, const FGrainEnvelope& InEnvelope);
+    template void FGrainVoicePool::Render<false>(float* OutLeft, float* OutRight, int32_t InNumFrames, const FGrainEnvelope& InEnvelope);
+
+    void FGrainVoicePool::ReleaseVoice(FGrainVoice& InVoice)
+    {
+        InVoice.bIsActive = false;
+        InVoice.bIsReleasing = false;
+        InVoice.DelayFrames = 0;
+        RecycleReader(std::move(InVoice.Reader), InVoice.ReaderGeneration);
+        InVoice.SourceNumFrames = 0;
+        InVoice.ReadPosition = 0.0;
+        InVoice.SourceStep = 0;
+        InVoice.Resident = FGrainResidentAudio();
+    }
+
+    void FGrainVoicePool::Reset()
+    {
+        for (FGrainVoice& Voice : Voices)
+        {
+            ReleaseVoice(Voice);
+            Voice.bIsReversed = false;
+            Voice.bSourceExhausted = false;
+            Voice.NumChannels = 0;
+            Voice.SamplesRemaining = 0;
+            Voice.SamplesPlayed = 0;
+            Voice.TotalGrainSamples = 0;
+            Voice.PanPosition = 0.0f;
+            Voice.VolumeScale = 1.0f;
+            Voice.SmoothingAmount = 0.0f;
+            Voice.PhaseOffset = 0.0f;
+        }
+    }
+
+    // --- TGranularSynthEngine ---
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::Init(float InSampleRate, int32_t InBlockSize)
+    {
+        SampleRate = InSampleRate;
+        BlockSize = (InBlockSize > 0) ? InBlockSize : 256;
+        VoicePool.Init(MaxGrainVoices, BlockSize);
+        SpawnEvents.clear();
+        SpawnEvents.reserve(MaxGrainVoices * 2);
+        DeferredWarmStartGrains.clear();
+        DeferredWarmStartGrains.reserve(MaxGrainVoices);
+        SamplesUntilNextGrain = 0.0f;
+        NumGrainsStarted = 0;
+        NumGrainsDropped = 0;
+    }
+
+    template <typename FeaturesType>
+    bool TGranularSynthEngine<FeaturesType>::SetSource(std::shared_ptr<IGrainSource> InSource)
+    {
+        if (!InSource || !InSource->GetInfo().IsValid())
+        {
+            ClearSource();
+            return false;
+        }
+
+        if (Source != InSource)
+        {
+            VoicePool.ReleaseReaders();
+        }
+        Source = std::move(InSource);
+        SourceDurationSeconds = Source->GetInfo().GetDurationSeconds();
+        if (Recorder)
+        {
+            Recorder->RecordSource(Source->GetInfo());
+        }
+        return true;
+    }
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::ClearSource()
+    {
+        VoicePool.Reset();
+        VoicePool.ReleaseReaders();
+        if (Recorder)
+        {
+            Recorder->RecordReset(false);
+        }
+        Source.reset();
+        SourceDurationSeconds = 0.0f;
+    }
+
+    template <typename FeaturesType>
+    bool TGranularSynthEngine<FeaturesType>::HasValidSource() const
+    {
+        return Source && SourceDurationSeconds >= MinGrainDurationSeconds;
+    }
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::Reset()
+    {
+        ClearSource();
+        SpawnEvents.clear();
+        DeferredWarmStartGrains.clear();
+        SamplesUntilNextGrain = 0.0f;
+        StartFrame = 0;
+        StopFrame = -1;
+        bStopped = false;
+    }
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::Stop(int32_t InFrame)
+    {
+        if (!bStopped)
+        {
+            DeferredWarmStartGrains.clear();
+            bStopped = true;
+            StopFrame = GrainCorePrivate::Clamp(InFrame, 0, BlockSize - 1);
+        }
+    }
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::SetRecorder(FGrainRecorder* InRecorder)
+    {
+        Recorder = InRecorder;
+        if (Recorder && Source)
+        {
+            Recorder->RecordSource(Source->GetInfo());
+        }
+    }
+
+    template <typename FeaturesType>
+    FGrainEngineStats TGranularSynthEngine<FeaturesType>::GetStats() const
+    {
+        FGrainEngineStats Stats;
+        Stats.GrainsStarted = NumGrainsStarted;
+        Stats.GrainsDropped = NumGrainsDropped;
+        Stats.ReadersCreated = VoicePool.GetNumReadersCreated();
+        Stats.ReadersReused = VoicePool.GetNumReadersReused();
+        Stats.SourceSamplesRead = VoicePool.GetNumSourceSamplesRead();
+        Stats.ReaderSamplesRead = VoicePool.GetNumReaderSamplesRead();
+        Stats.ActiveVoices = VoicePool.GetNumActiveVoices();
+        Stats.MaxVoices = VoicePool.GetMaxVoices();
+        Stats.VoiceBufferBytes = VoicePool.GetAllocatedBytes();
+        if (Source)
+        {
+            Source->GetCacheStats(Stats.CacheLookups, Stats.CacheHits);
+            Stats.SourceBytes = Source->GetAllocatedBytes();
+        }
+        return Stats;
+    }
+
+    template <typename FeaturesType>
+    typename TGranularSynthEngine<FeaturesType>::FResolvedParams TGranularSynthEngine<FeaturesType>::ResolveParams(const FGranularSynthParams& InParams) const
+    {
+        using namespace GrainCorePrivate;
+
+        FResolvedParams Resolved;
+        Resolved.BaseGrainDurationSeconds = std::max(MinGrainDurationSeconds, InParams.GrainDurationMs / 1000.0f);
+        Resolved.MaxDurationRandSeconds = std::max(0.0f, InParams.DurationRandMs / 1000.0f);
+
+        const float EffectiveActiveVoices = std::max(MinActiveVoicesParam, InParams.ActiveVoices);
+        Resolved.BaseSamplesPerGrainInterval = (EffectiveActiveVoices > 0.0f && Resolved.BaseGrainDurationSeconds > 0.0f && SampleRate > 0.0f)
+            ? (Resolved.BaseGrainDurationSeconds / EffectiveActiveVoices) * SampleRate : FloatMax;
+        Resolved.TimeJitterPercent = Clamp(InParams.TimeJitterPercent, 0.0f, 100.0f);
+
+        Resolved.BaseStartPointSeconds = InParams.StartPointSeconds;
+        Resolved.MaxStartPointRandSeconds = std::max(0.0f, InParams.StartPointRandMs) / 1000.0f;
+        Resolved.ReverseChance = FeaturesType::bReverse ? Clamp(InParams.ReverseChancePercent, 0.0f, 100.0f) : 0.0f;
+        Resolved.BasePitchShiftSemitones = FeaturesType::bPitch ? Clamp(InParams.PitchShiftSemitones, -MaxAbsPitchShiftSemitones, MaxAbsPitchShiftSemitones) : 0.0f;
+        Resolved.PitchRandSemitones = FeaturesType::bPitch ? std::max(0.0f, InParams.PitchRandSemitones) : 0.0f;
+        Resolved.FrameRatioScale = FeaturesType::bPitch ? std::max(SmallNumber, InParams.FrameRatioScale) : 1.0f;
+        Resolved.BasePan = Clamp(InParams.Pan, -1.0f, 1.0f);
+        Resolved.PanRandAmount = Clamp(InParams.PanRand, 0.0f, 1.0f);
+        Resolved.VolumeRandPercent = Clamp(InParams.VolumeRandPercent, 0.0f, 100.0f);
+
+        const float AttackPercent = Clamp(InParams.AttackPercent, 0.0f, 1.0f);
+        const float DecayPercent = Clamp(InParams.DecayPercent, 0.0f, 1.0f);
+        Resolved.Envelope.Type = EGrainEnvelopeType::AttackDecay;
+        Resolved.Envelope.AttackPercent = AttackPercent;
+        Resolved.Envelope.DecayPercent = std::min(DecayPercent, 1.0f - AttackPercent);
+        Resolved.Envelope.AttackCurve = std::max(SmallNumber, InParams.AttackCurve);
+        Resolved.Envelope.DecayCurve = std::max(SmallNumber, InParams.DecayCurve);
+        return Resolved;
+    }
+
+    template <typename FeaturesType>
+    bool TGranularSynthEngine<FeaturesType>::SpawnGrain(const FResolvedParams& InParams, int32_t InDelayFrames, FGrainSpawnEvent& OutEvent, FGrainDesc& OutDesc)
+    {
+        if (!DrawGrain(InParams, OutEvent, OutDesc))
+        {
+            return false;
+        }
+        OutDesc.DelayFrames = InDelayFrames;
+        return VoicePool.StartGrain(*Source, OutDesc) >= 0;
+    }
+
+    template <typename FeaturesType>
+    bool TGranularSynthEngine<FeaturesType>::DrawGrain(const FResolvedParams& InParams, FGrainSpawnEvent& OutEvent, FGrainDesc& OutDesc)
+    {
+        using namespace GrainCorePrivate;
+
+        const float RandomStartOffsetSeconds = Random.FRandRange(0.0f, InParams.MaxStartPointRandSeconds);
+        const float ConceptualStartPointSecs = InParams.BaseStartPointSeconds + RandomStartOffsetSeconds;
+
+        const float DurationOffset = Random.FRandRange(0.0f, InParams.MaxDurationRandSeconds);
+        const float FinalOutputGrainDurationSeconds = std::max(MinGrainDurationSeconds, InParams.BaseGrainDurationSeconds + DurationOffset);
+        const int32_t OutputGrainDurationSamples = std::max(1, CeilToInt(FinalOutputGrainDurationSeconds * SampleRate));
+
+        // Features a variant leaves out don't draw either, so their grains cost no random numbers
+        float FinalTargetPitchShift = 0.0f;
+        float FrameRatio = 1.0f;
+        if constexpr (FeaturesType::bPitch)
+        {
+            const float PitchOffset = Random.FRandRange(-InParams.PitchRandSemitones, InParams.PitchRandSemitones);
+            FinalTargetPitchShift = Clamp(InParams.BasePitchShiftSemitones + PitchOffset, -MaxAbsPitchShiftSemitones, MaxAbsPitchShiftSemitones);
+            FrameRatio = std::max(SmallNumber, SemitonesToFrameRatio(FinalTargetPitchShift) * InParams.FrameRatioScale);
+        }
+
+        bool bReverse = false;
+        if constexpr (FeaturesType::bReverse)
+        {
+            bReverse = Random.FRandRange(0.0f, 100.0f) < InParams.ReverseChance;
+        }
+
+        float ReaderStartTimeForSegment = 0.0f;
+        int32_t NumSourceFramesToReadForSegment = 0;
+
+        if (bReverse)
+        {
+            // The grain ends at the conceptual start point and reads backwards from there
+            const float SourceMaterialNeededSeconds = FinalOutputGrainDurationSeconds * FrameRatio;
+            if (SourceMaterialNeededSeconds < Epsilon)
+            {
+                return false;
+            }
+
+            const float ConceptualSegmentEndInSource = WrapTime(ConceptualStartPointSecs, SourceDurationSeconds);
+            const float ConceptualSegmentStartInSource = ConceptualSegmentEndInSource - SourceMaterialNeededSeconds;
+            const float ActualSegmentStart = std::max(0.0f, ConceptualSegmentStartInSource);
+            float ActualSegmentEnd = std::min(SourceDurationSeconds, ConceptualSegmentEndInSource);
+            if (ActualSegmentStart == 0.0f && SourceMaterialNeededSeconds > 0.0f)
+            {
+                ActualSegmentEnd = std::min(SourceDurationSeconds, SourceMaterialNeededSeconds);
+            }
+            if (ActualSegmentStart >= ActualSegmentEnd - Epsilon)
+            {
+                return false;
+            }
+
+            NumSourceFramesToReadForSegment = CeilToInt((ActualSegmentEnd - ActualSegmentStart) * SampleRate);
+            if (NumSourceFramesToReadForSegment <= 0)
+            {
+                return false;
+            }
+            ReaderStartTimeForSegment = ActualSegmentStart;
+        }
+        else
+        {
+            ReaderStartTimeForSegment = WrapTime(ConceptualStartPointSecs, SourceDurationSeconds);
+            ReaderStartTimeForSegment = std::min(ReaderStartTimeForSegment, SourceDurationSeconds - SourceEndMarginSeconds);
+            ReaderStartTimeForSegment = std::max(0.0f, ReaderStartTimeForSegment);
+        }
+
+        const float PanOffset = Random.FRandRange(-InParams.PanRandAmount, InParams.PanRandAmount);
+        const float FinalGrainPanPosition = Clamp(InParams.BasePan + PanOffset, -1.0f, 1.0f);
+        const float MinVolumeScale = 1.0f - (InParams.VolumeRandPercent / 100.0f);
+        const float FinalGrainVolumeScale = Random.FRandRange(MinVolumeScale, 1.0f);
+
+        FGrainDesc& Desc = OutDesc;
+        Desc = FGrainDesc();
+        Desc.StartTimeSeconds = ReaderStartTimeForSegment;
+        Desc.DurationFrames = OutputGrainDurationSamples;
+        Desc.FrameRatio = FrameRatio;
+        Desc.Pan = FinalGrainPanPosition;
+        Desc.Volume = FinalGrainVolumeScale;
+        Desc.bReversed = bReverse;
+        Desc.ReverseSourceFrames = NumSourceFramesToReadForSegment;
+        Desc.bLoopSource = true;
+        Desc.MaxDecodeSizeInFrames = DeinterleaveBlockSizeFrames;
+
+        OutEvent.StartTimeSeconds = ReaderStartTimeForSegment;
+        OutEvent.DurationSeconds = FinalOutputGrainDurationSeconds;
+        OutEvent.bReversed = bReverse;
+        OutEvent.Volume = FinalGrainVolumeScale;
+        OutEvent.PitchSemitones = FinalTargetPitchShift;
+        OutEvent.Pan = FinalGrainPanPosition;
+        return true;
+    }
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::Start(const FGranularSynthParams& InParams, int32_t InFrame)
+    {
+        using namespace GrainCorePrivate;
+
+        StartFrame = Clamp(InFrame, 0, BlockSize - 1);
+        StopFrame = -1;
+        bStopped = false;
+        DeferredWarmStartGrains.clear();
+        ReleaseVoices(VoicePool, StartFrame, SampleRate * ReleaseSeconds, Recorder);
+
+        if (!InParams.bWarmStart || !HasValidSource() || SampleRate <= 0.0f)
+        {
+            // Standard behavior: trigger first grain at the Play frame in Process()
+            SamplesUntilNextGrain = static_cast<float>(StartFrame);
+            return;
+        }
+
+        const FResolvedParams Resolved = ResolveParams(InParams);
+
+        int32_t NumVoicesToWarmStart = FloorToInt(InParams.ActiveVoices);
+        if (InParams.ActiveVoices < 1.0f && InParams.ActiveVoices > 0.0f) // If fractional but > 0, warm start at least 1
+        {
+            NumVoicesToWarmStart = 1;
+        }
+        NumVoicesToWarmStart = Clamp(NumVoicesToWarmStart, 0, MaxGrainVoices);
+
+        // Every grain is drawn now so the random sequence doesn't depend on the block size, but only the first
+        // WarmStartGrainsPerBlock start here. The rest start over the next blocks partway through their envelopes,
+        // sounding as if they had all started at the Play frame without setting them all up in one block.
+        for (int32_t WarmUpIndex = 0; WarmUpIndex < NumVoicesToWarmStart; ++WarmUpIndex)
+        {
+            FGrainSpawnEvent Event;
+            FGrainDesc Desc;
+            if (!DrawGrain(Resolved, Event, Desc))
+            {
+                ++NumGrainsDropped;
+                continue;
+            }
+
+            if (WarmUpIndex >= WarmStartGrainsPerBlock)
+            {
+                PrefetchGrain(*Source, Desc, Source->GetInfo().SampleRate);
+                DeferredWarmStartGrains.push_back({ Event, Desc });
+                continue;
+            }
+
+            Desc.DelayFrames = StartFrame;
+            if (VoicePool.StartGrain(*Source, Desc) < 0)
+            {
+                ++NumGrainsDropped;
+                continue;
+            }
+
+            ++NumGrainsStarted;
+            Event.FrameInBlock = StartFrame;
+            SpawnEvents.push_back(Event);
+            if (Recorder)
+            {
+                Recorder->RecordGrain(StartFrame, Desc);
+            }
+        }
+        WarmStartElapsedFrames = -StartFrame;
+
+        // After warm start, schedule the next grain based on the interval.
+        SamplesUntilNextGrain = StartFrame + Resolved.BaseSamplesPerGrainInterval;
+    }
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::StartDeferredWarmStartGrains()
+    {
+        // Oldest first so grains keep their warm start order; the list is short enough to shift
+        const int32_t NumToStart = std::min(WarmStartGrainsPerBlock, static_cast<int32_t>(DeferredWarmStartGrains.size()));
+        for (int32_t Index = 0; Index < NumToStart; ++Index)
+        {
+            FDeferredGrain& Deferred = DeferredWarmStartGrains[Index];
+            Deferred.Desc.SkipFrames = WarmStartElapsedFrames;
+            if (VoicePool.StartGrain(*Source, Deferred.Desc) < 0)
+            {
+                // Also the case for grains that would already be over by now
+                ++NumGrainsDropped;
+                continue;
+            }
+
+            ++NumGrainsStarted;
+            Deferred.Event.FrameInBlock = 0;
+            SpawnEvents.push_back(Deferred.Event);
+            if (Recorder)
+            {
+                Recorder->RecordGrain(0, Deferred.Desc);
+            }
+        }
+        DeferredWarmStartGrains.erase(DeferredWarmStartGrains.begin(), DeferredWarmStartGrains.begin() + NumToStart);
+    }
+
+    template <typename FeaturesType>
+    void TGranularSynthEngine<FeaturesType>::Process(const FGranularSynthParams& InParams, float* OutLeft, float* OutRight)
+    {
+        using namespace GrainCorePrivate;
+
+        LastBlockTimings = FGrainBlockTimings();
+        std::fill(OutLeft, OutLeft + BlockSize, 0.0f);
+        std::fill(OutRight, OutRight + BlockSize, 0.0f);
+
+        if (!HasValidSource())
+        {
+            if (Recorder)
+            {
+                Recorder->EndBlock();
+            }
+            return;
+        }
+
+        METAGRAIN_TRACE_SCOPE(SynthProcess);
+        const uint64_t PlanStart = ReadClock(Clock);
+
+        const FResolvedParams Resolved = ResolveParams(InParams);
+        const float Interval = Resolved.BaseSamplesPerGrainInterval;
+
+        int32_t GrainsToTriggerThisBlock = 0;
+        const float ElapsedSamples = static_cast<float>(BlockSize);
+        const bool bSpawning = !bStopped || StopFrame >= 0;
+        if (bSpawning && Interval > 0.0f && Interval < FloatMax)
+        {
+            METAGRAIN_TRACE_SCOPE(PlanGrains);
+            while (SamplesUntilNextGrain <= ElapsedSamples && (StopFrame < 0 || SamplesUntilNextGrain < StopFrame))
+            {
+                GrainsToTriggerThisBlock++;
+                const float JitteredInterval = std::max(MinSamplesPerGrainInterval, Interval + Random.FRandRange(-1.0f, 1.0f) * Interval * (Resolved.TimeJitterPercent / 100.0f));
+                SamplesUntilNextGrain += JitteredInterval;
+            }
+            SamplesUntilNextGrain -= ElapsedSamples;
+        }
+
+        const uint64_t StartGrainsStart = ReadClock(Clock);
+        if (!DeferredWarmStartGrains.empty() && WarmStartElapsedFrames > 0)
+        {
+            StartDeferredWarmStartGrains();
+        }
+
+        for (int32_t GrainIndex = 0; GrainIndex < GrainsToTriggerThisBlock; ++GrainIndex)
+        {
+            FGrainSpawnEvent Event;
+            FGrainDesc Desc;
+            if (!SpawnGrain(Resolved, StartFrame, Event, Desc))
+            {
+                ++NumGrainsDropped;
+                continue;
+            }
+
+            ++NumGrainsStarted;
+            const float StepSamples = (Interval > Epsilon) ? Interval : static_cast<float>(std::max(1, CeilToInt(Event.DurationSeconds * SampleRate)));
+            const float ApproxTimeOfThisGrainSpawn = ElapsedSamples - (SamplesUntilNextGrain + (GrainsToTriggerThisBlock - 1 - GrainIndex) * StepSamples);
+            Event.FrameInBlock = Clamp(static_cast<int32_t>(ApproxTimeOfThisGrainSpawn), StartFrame, BlockSize - 1);
+            SpawnEvents.push_back(Event);
+            if (Recorder)
+            {
+                Recorder->RecordGrain(Event.FrameInBlock, Desc);
+            }
+        }
+
+        if (StopFrame >= 0)
+        {
+            ReleaseVoices(VoicePool, StopFrame, SampleRate * ReleaseSeconds, Recorder);
+            StopFrame = -1;
+        }
+        StartFrame = 0;
+        WarmStartElapsedFrames += BlockSize;
+
+        const uint64_t RenderStart = ReadClock(Clock);
+        VoicePool.Render<FeaturesType::bPitch>(OutLeft, OutRight, BlockSize, Resolved.Envelope);
+
+        if (Clock)
+        {
+            LastBlockTimings.Plan = StartGrainsStart - PlanStart;
+            LastBlockTimings.StartGrains = RenderStart - StartGrainsStart;
+            LastBlockTimings.Render = Clock() - RenderStart;
+        }
+
+        if (Recorder)
+        {
+            Recorder->RecordEnvelope(Resolved.Envelope);
+            Recorder->EndBlock();
+        }
+    }
+
+    template class TGranularSynthEngine<FGrainSynthFullFeatures>;
+    template class TGranularSynthEngine<FGrainSynthForwardFeatures>;
+    template class TGranularSynthEngine<FGrainSynthLiteFeatures>;
+
+    // --- FGranularSmoothEngine ---
+
+    void FGranularSmoothEngine::Init(float InSampleRate, int32_t InBlockSize)
+    {
+        SampleRate = InSampleRate;
+        BlockSize = (InBlockSize > 0) ? InBlockSize : 256;
+        VoicePool.Init(MaxGrainVoices, BlockSize);
+        SpawnEvents.clear();
+        SpawnEvents.reserve(MaxGrainVoices * 2);
+        SamplesUntilNextGrain = 0.0f;
+        NumGrainsStarted = 0;
+        NumGrainsDropped = 0;
+    }
+
+    bool FGranularSmoothEngine::SetSource(std::shared_ptr<IGrainSource> InSource)
+    {
+        if (!InSource || !InSource->GetInfo().IsValid())
+        {
+            ClearSource();
+            return false;
+        }
+
+        if (Source != InSource)
+        {
+            VoicePool.ReleaseReaders();
+        }
+        Source = std::move(InSource);
+        SourceDurationSeconds = Source->GetInfo().GetDurationSeconds();
+        if (Recorder)
+        {
+            Recorder->RecordSource(Source->GetInfo());
+        }
+        return true;
+    }
+
+    void FGranularSmoothEngine::ClearSource()
+    {
+        VoicePool.Reset();
+        VoicePool.ReleaseReaders();
+        if (Recorder)
+        {
+            Recorder->RecordReset(false);
+        }
+        Source.reset();
+        SourceDurationSeconds = 0.0f;
+    }
+
+    bool FGranularSmoothEngine::HasValidSource() const
+    {
+        return Source && SourceDurationSeconds > 0.0f;
+    }
+
+    void FGranularSmoothEngine::Start(int32_t InFrame)
+    {
+        StartFrame = GrainCorePrivate::Clamp(InFrame, 0, BlockSize - 1);
+        StopFrame = -1;
+        bStopped = false;
+        GrainCorePrivate::ReleaseVoices(VoicePool, StartFrame, SampleRate * ReleaseSeconds, Recorder);
+        SamplesUntilNextGrain = static_cast<float>(StartFrame);
+    }
+
+    void FGranularSmoothEngine::Stop(int32_t InFrame)
+    {
+        if (!bStopped)
+        {
+            bStopped = true;
+            StopFrame = GrainCorePrivate::Clamp(InFrame, 0, BlockSize - 1);
+        }
+    }
+
+    void FGranularSmoothEngine::SetRecorder(FGrainRecorder* InRecorder)
+    {
+        Recorder = InRecorder;
+        if (Recorder && Source)
+        {
+            Recorder->RecordSource(Source->GetInfo());
+        }
+    }
+
+    void FGranularSmoothEngine::Reset()
+    {
+        ClearSource();
+        SpawnEvents.clear();
+        SamplesUntilNextGrain = 0.0f;
+        StartFrame = 0;
+        StopFrame = -1;
+        bStopped = false;
+        CurrentPlaybackPositionSeconds = 0.0f;
+        PrevFilterValue[0] = 0.0f;
+        PrevFilterValue[1] = 0.0f;
+        if (Recorder)
+        {
+            Recorder->RecordReset(true);
+        }
+    }
+
+    FGrainEngineStats FGranularSmoothEngine::GetStats() const
+    {
+        FGrainEngineStats Stats;
+        Stats.GrainsStarted = NumGrainsStarted;
+        Stats.GrainsDropped = NumGrainsDropped;
+        Stats.ReadersCreated = VoicePool.GetNumReadersCreated();
+        Stats.ReadersReused = VoicePool.GetNumReadersReused();
+        Stats.SourceSamplesRead = VoicePool.GetNumSourceSamplesRead();
+        Stats.ReaderSamplesRead = VoicePool.GetNumReaderSamplesRead();
+        Stats.ActiveVoices = VoicePool.GetNumActiveVoices();
+        Stats.MaxVoices = VoicePool.GetMaxVoices();
+        Stats.VoiceBufferBytes = VoicePool.GetAllocatedBytes();
+        if (Source)
+        {
+            Source->GetCacheStats(Stats.CacheLookups, Stats.CacheHits);
+            Stats.SourceBytes = Source->GetAllocatedBytes();
+        }
+        return Stats;
+    }
+
+    bool FGranularSmoothEngine::StartGrain(FGrainDesc& InOutDesc)
+    {
+        if (InOutDesc.DurationFrames <= 0 || VoicePool.FindFreeVoice() < 0)
+        {
+            return false;
+        }
+
+        // Make sure we don't go beyond the end of the file
+        FGrainDesc& Desc = InOutDesc;
+        Desc.StartTimeSeconds = std::max(0.0f, Desc.StartTimeSeconds);
+        const float DurationInSeconds = Desc.DurationFrames / SampleRate;
+        if (Desc.StartTimeSeconds + DurationInSeconds > SourceDurationSeconds)
+        {
+            Desc.StartTimeSeconds = std::max(0.0f, SourceDurationSeconds - DurationInSeconds);
+            if (Desc.StartTimeSeconds <= 0.0f || DurationInSeconds < MinGrainDurationSeconds)
+            {
+                return false;
+            }
+        }
+
+        // Decode in large quantized chunks; short grains are usually read in one go
+        constexpr int32_t DecodeSizeQuantization = 128;
+        const int32_t DesiredDecodeSize = std::max(Desc.DurationFrames, BlockSize * 2);
+        Desc.MaxDecodeSizeInFrames = ((DesiredDecodeSize + DecodeSizeQuantization - 1) / DecodeSizeQuantization) * DecodeSizeQuantization;
+        Desc.bLoopSource = false;
+
+        // Phase alignment for smoother overlapping, only when smoothing is requested
+        Desc.PhaseOffset = (Desc.SmoothingAmount > 0.0f) ? Random.FRand() * 0.05f * Desc.SmoothingAmount : 0.0f;
+
+        return VoicePool.StartGrain(*Source, Desc) >= 0;
+    }
+
+    void FGranularSmoothEngine::Process(const FGranularSmoothParams& InParams, float* OutLeft, float* OutRight)
+    {
+        using namespace GrainCorePrivate;
+
+        LastBlockTimings = FGrainBlockTimings();
+        std::fill(OutLeft, OutLeft + BlockSize, 0.0f);
+        std::fill(OutRight, OutRight + BlockSize, 0.0f);
+
+        if (!HasValidSource())
+        {
+            if (Recorder)
+            {
+                Recorder->EndBlock();
+            }
+            return;
+        }
+
+        METAGRAIN_TRACE_SCOPE(SmoothProcess);
+        const uint64_t PlanStart = ReadClock(Clock);
+
+        const float BaseGrainDurationSeconds = std::max(MinGrainDurationSeconds, InParams.GrainDurationMs / 1000.0f);
+        const float MaxDurationRandSeconds = std::max(0.0f, InParams.DurationRandMs / 1000.0f);
+        const float GrainsPerSec = std::max(0.1f, InParams.GrainsPerSecond);
+        const float SamplesPerGrainInterval = SampleRate / GrainsPerSec;
+
+        const float PlaybackSpeed = Clamp(InParams.PlaybackSpeedPercent, 0.0f, 800.0f) / 100.0f;
+        const bool bFreezed = std::abs(PlaybackSpeed) <= 0.001f;
+
+        const int32_t DesiredGrainDensity = Clamp(InParams.GrainDensity, 1, MaxGrainVoices);
+        const float TimeJitterMs = std::max(0.0f, InParams.TimeJitterMs);
+        const float VolumeRandPercent = Clamp(InParams.VolumeRandPercent, 0.0f, 100.0f);
+        const float Smoothing = Clamp(InParams.SmoothingPercent, 0.0f, 100.0f) / 100.0f;
+        const float GrainOverlap = Clamp(InParams.GrainOverlap, 1.0f, 5.0f);
+        const float PlayRangeSeconds = std::max(1.0f, InParams.PlayRangeMs) / 1000.0f;
+
+        // When freeze state changes, retrigger grains immediately without resetting voices
+        const bool bFreezeStateChanged = bFreezed != bPreviousFreezeState;
+        bPreviousFreezeState = bFreezed;
+        if (bFreezeStateChanged)
+        {
+            SamplesUntilNextGrain = 0.0f;
+        }
+
+        float PositionInSeconds = 0.0f;
+        if (bFreezed)
+        {
+            // When speed is 0, the Position input drives the playhead
+            const float PlayPosition = Clamp(InParams.PlayPositionPercent, 0.0f, 100.0f) / 100.0f;
+            const float MaxValidPosition = std::max(0.0f, SourceDurationSeconds - (BaseGrainDurationSeconds + MaxDurationRandSeconds));
+            const float SafePlayPosition = std::min(PlayPosition, MaxValidPosition / SourceDurationSeconds);
+            const float NewPositionInSeconds = SafePlayPosition * SourceDurationSeconds;
+
+            if (std::abs(NewPositionInSeconds - CurrentPlaybackPositionSeconds) > 0.01f)
+            {
+                SamplesUntilNextGrain = 0.0f;
+            }
+
+            PositionInSeconds = NewPositionInSeconds;
+            CurrentPlaybackPositionSeconds = NewPositionInSeconds;
+        }
+        else
+        {
+            // If we just transitioned from freeze to normal, don't advance position yet
+            if (!bFreezeStateChanged)
+            {
+                CurrentPlaybackPositionSeconds += (static_cast<float>(BlockSize) / SampleRate) * PlaybackSpeed;
+            }
+
+            if (CurrentPlaybackPositionSeconds >= SourceDurationSeconds)
+            {
+                CurrentPlaybackPositionSeconds = std::fmod(CurrentPlaybackPositionSeconds, SourceDurationSeconds);
+            }
+            PositionInSeconds = CurrentPlaybackPositionSeconds;
+        }
+
+        const float AttackPercent = Clamp(InParams.AttackPercent, 0.0f, 1.0f);
+        const float DecayPercent = Clamp(InParams.DecayPercent, 0.0f, 1.0f);
+        const float ClampedDecayPercent = std::min(DecayPercent, 1.0f - AttackPercent);
+        const float BasePitchShiftSemitones = Clamp(InParams.PitchShiftSemitones, -MaxAbsPitchShiftSemitones, MaxAbsPitchShiftSemitones);
+        const float PitchRandSemitones = std::max(0.0f, InParams.PitchRandSemitones);
+        const float BasePan = Clamp(InParams.Pan, -1.0f, 1.0f);
+        const float PanRandAmount = Clamp(InParams.PanRand, 0.0f, 1.0f);
+
+        // Larger overlap = gentler envelope = smoother transition
+        const float OverlapCompensation = std::min(1.0f, 1.0f / GrainOverlap);
+        FGrainEnvelope Envelope;
+        Envelope.Type = EGrainEnvelopeType::Window;
+        Envelope.AttackPercent = Clamp(AttackPercent * OverlapCompensation, 0.05f, 0.95f);
+        Envelope.DecayPercent = Clamp(ClampedDecayPercent * OverlapCompensation, 0.05f, 0.95f);
+        Envelope.WindowShape = static_cast<EGrainWindowShape>(Clamp(InParams.WindowShape, 0, 7));
+        Envelope.XfadeCurve = Clamp(InParams.XfadeCurve, 0, 2);
+
+        // --- Trigger New Grains ---
+        int32_t GrainsToTriggerThisBlock = 0;
+        const float ElapsedSamples = static_cast<float>(BlockSize);
+        const float TimeJitterSamples = (TimeJitterMs / 1000.0f) * SampleRate;
+
+        const bool bSpawning = !bStopped || StopFrame >= 0;
+        if (!bSpawning)
+        {
+            // Stopped, only the release tails play
+        }
+        else if (bFreezeStateChanged)
+        {
+            // Force at least 2 grains this block for a smoother transition. They start at StartFrame, so only when
+            // that comes before a Stop in this block.
+            GrainsToTriggerThisBlock = (StopFrame < 0 || StartFrame < StopFrame) ? 2 : 0;
+        }
+        else
+        {
+            METAGRAIN_TRACE_SCOPE(PlanGrains);
+            int32_t ActiveVoiceCount = VoicePool.GetNumActiveVoices() - VoicePool.GetNumReleasingVoices();
+            const float TriggerProbability = std::min(1.0f, static_cast<float>(DesiredGrainDensity) / static_cast<float>(MaxGrainVoices));
+
+            while (SamplesUntilNextGrain <= ElapsedSamples && (StopFrame < 0 || SamplesUntilNextGrain < StopFrame))
+            {
+                if (TimeJitterSamples > 0.0f)
+                {
+                    SamplesUntilNextGrain += Random.FRandRange(-TimeJitterSamples, TimeJitterSamples);
+                }
+
+                // Only trigger a grain if we have room and probability check passes
+                if (ActiveVoiceCount < DesiredGrainDensity && Random.FRand() <= TriggerProbability)
+                {
+                    GrainsToTriggerThisBlock++;
+                    ActiveVoiceCount++;
+                }
+                SamplesUntilNextGrain += SamplesPerGrainInterval;
+            }
+            SamplesUntilNextGrain -= ElapsedSamples;
+        }
+
+        const uint64_t StartGrainsStart = ReadClock(Clock);
+        for (int32_t GrainIndex = 0; GrainIndex < GrainsToTriggerThisBlock; ++GrainIndex)
+        {
+            const float LastValidStartSeconds = SourceDurationSeconds - SourceEndMarginSeconds;
+            float GrainStartTimeSeconds = 0.0f;
+            if (bFreezed)
+            {
+                // In freeze mode, use a window centered on the position
+                const float HalfWindowSizeSeconds = std::min(PlayRangeSeconds * 0.5f, SourceDurationSeconds * 0.5f);
+                GrainStartTimeSeconds = Random.FRandRange(
+                    std::max(0.0f, PositionInSeconds - HalfWindowSizeSeconds),
+                    std::min(LastValidStartSeconds, PositionInSeconds + HalfWindowSizeSeconds));
+            }
+            else
+            {
+                // In normal playback mode, pick ahead of the playhead within the play range
+                const float SafeEndPositionSeconds = std::min(CurrentPlaybackPositionSeconds + PlayRangeSeconds, LastValidStartSeconds);
+                GrainStartTimeSeconds = Random.FRandRange(CurrentPlaybackPositionSeconds, SafeEndPositionSeconds);
+            }
+            GrainStartTimeSeconds = Clamp(GrainStartTimeSeconds, 0.0f, LastValidStartSeconds);
+
+            const float DurationOffset = Random.FRandRange(0.0f, MaxDurationRandSeconds);
+            const float GrainDurationSeconds = std::max(MinGrainDurationSeconds, BaseGrainDurationSeconds + DurationOffset);
+            const float PitchOffset = Random.FRandRange(-PitchRandSemitones, PitchRandSemitones);
+            const float TargetPitchShift = Clamp(BasePitchShiftSemitones + PitchOffset, -MaxAbsPitchShiftSemitones, MaxAbsPitchShiftSemitones);
+
+            // At 100% volume randomization grains can play at any volume from silent to full
+            float VolumeScale = 1.0f;
+            if (VolumeRandPercent > 0.0f)
+            {
+                VolumeScale = 1.0f - (Random.FRand() * (VolumeRandPercent / 100.0f));
+            }
+
+            const float PanOffset = Random.FRandRange(-PanRandAmount, PanRandAmount);
+
+            FGrainDesc Desc;
+            Desc.StartTimeSeconds = GrainStartTimeSeconds;
+            Desc.DurationFrames = CeilToInt(GrainDurationSeconds * SampleRate);
+            Desc.FrameRatio = std::abs(SemitonesToFrameRatio(TargetPitchShift));
+            Desc.Pan = Clamp(BasePan + PanOffset, -1.0f, 1.0f);
+            Desc.Volume = VolumeScale;
+            Desc.SmoothingAmount = Smoothing;
+            Desc.DelayFrames = StartFrame;
+
+            // Spawn events report the requested start, the voice gets the one fitted to the source
+            FGrainDesc StartedDesc = Desc;
+            if (!StartGrain(StartedDesc))
+            {
+                ++NumGrainsDropped;
+                continue;
+            }
+
+            ++NumGrainsStarted;
+            FGrainSpawnEvent Event;
+            Event.FrameInBlock = Clamp(BlockSize - static_cast<int32_t>(SamplesUntilNextGrain), StartFrame, BlockSize - 1);
+            Event.StartTimeSeconds = Desc.StartTimeSeconds;
+            Event.DurationSeconds = GrainDurationSeconds;
+            Event.Volume = VolumeScale;
+            Event.PitchSemitones = TargetPitchShift;
+            Event.Pan = Desc.Pan;
+            SpawnEvents.push_back(Event);
+            if (Recorder)
+            {
+                Recorder->RecordGrain(Event.FrameInBlock, StartedDesc);
+            }
+        }
+
+        if (StopFrame >= 0)
+        {
+            ReleaseVoices(VoicePool, StopFrame, SampleRate * ReleaseSeconds, Recorder);
+            StopFrame = -1;
+        }
+        StartFrame = 0;
+
+        const uint64_t RenderStart = ReadClock(Clock);
+        VoicePool.Render(OutLeft, OutRight, BlockSize, Envelope);
+        const uint64_t PostFilterStart = ReadClock(Clock);
+
+        // Final 1-pole low pass to reduce any remaining transients
+        const float FilterCoeff = (Smoothing > 0.5f) ? std::max(0.1f, 1.0f - (Smoothing * 0.5f)) : 0.0f;
+        if (FilterCoeff > 0.0f)
+        {
+            METAGRAIN_TRACE_SCOPE(PostFilter);
+            ApplyOutputFilter(OutLeft, OutRight, BlockSize, FilterCoeff, PrevFilterValue);
+        }
+
+        if (Clock)
+        {
+            LastBlockTimings.Plan = StartGrainsStart - PlanStart;
+            LastBlockTimings.StartGrains = RenderStart - StartGrainsStart;
+            LastBlockTimings.Render = PostFilterStart - RenderStart;
+            LastBlockTimings.PostFilter = Clock() - PostFilterStart;
+        }
+
+        if (Recorder)
+        {
+            Recorder->RecordEnvelope(Envelope);
+            Recorder->RecordPostFilter(FilterCoeff);
+            Recorder->EndBlock();
+        }
+    }
+}
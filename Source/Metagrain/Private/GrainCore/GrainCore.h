@@ -0,0 +1,636 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Engine-independent grain DSP core shared by the Metagrain operators.
+// Nothing in here may include Unreal headers: the same sources are compiled into the
+// plugin module and into the standalone CMake targets used for profiling on Linux.
+// The one exception is GrainTrace.h, which only maps profiling scopes onto Unreal Insights
+// when the plugin module asks for it.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Metagrain
+{
+    class FGrainRecorder;
+    class FGrainAnalysis;
+
+    // --- Random Numbers ---
+    // Small xorshift generator so every engine owns its own (seedable) random stream
+    // instead of sharing the global FMath one.
+    class FGrainRandom
+    {
+    public:
+        explicit FGrainRandom(uint32_t InSeed = 0x9E3779B9u) { Seed(InSeed); }
+
+        void Seed(uint32_t InSeed) { State = (InSeed != 0) ? InSeed : 0x9E3779B9u; }
+
+        uint32_t NextUInt()
+        {
+            State ^= State << 13;
+            State ^= State >> 17;
+            State ^= State << 5;
+            return State;
+        }
+
+        // Uniform in [0, 1).
+        float FRand() { return static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f); }
+
+        float FRandRange(float InMin, float InMax) { return InMin + (InMax - InMin) * FRand(); }
+
+    private:
+        uint32_t State = 0x9E3779B9u;
+    };
+
+    // --- Grain Sources ---
+    struct FGrainSourceInfo
+    {
+        int32_t NumChannels = 0;
+        float SampleRate = 0.0f;
+        int64_t NumFrames = 0;
+
+        float GetDurationSeconds() const { return (SampleRate > 0.0f) ? static_cast<float>(NumFrames) / SampleRate : 0.0f; }
+        bool IsValid() const { return NumChannels > 0 && NumFrames > 0 && SampleRate > 0.0f; }
+
+        // First frame a reader starting at InSeconds reads: wrapped when looping, the end of the source otherwise.
+        int64_t GetStartFrame(float InSeconds, bool bInLooping) const
+        {
+            const int64_t Frame = static_cast<int64_t>((InSeconds > 0.0f ? InSeconds : 0.0f) * SampleRate);
+            return (Frame < NumFrames) ? Frame : (bInLooping ? Frame % NumFrames : NumFrames);
+        }
+    };
+
+    // Audio a source holds in memory as one block of interleaved PCM, GetInfo().NumFrames frames long. Voices read it
+    // in place instead of through a reader, so starting a grain on it costs a few stores.
+    struct FGrainResidentAudio
+    {
+        std::shared_ptr<const void> Owner;  // Keeps the memory alive while grains read it
+        const void* Samples = nullptr;      // float, or int16_t when bPcm16
+        bool bPcm16 = false;
+        int64_t LoopFrames = 0;             // Audio made of loops this long (mono float only): grains repeat the one they start in
+
+        bool IsValid() const { return Samples != nullptr; }
+    };
+
+    // Sequential interleaved reader over a grain source.
+    class IGrainSourceReader
+    {
+    public:
+        virtual ~IGrainSourceReader() = default;
+
+        // Writes up to InNumFrames interleaved frames to OutInterleaved. Returns the number of frames written,
+        // 0 once the source is exhausted or has failed.
+        virtual int32_t PopFrames(float* OutInterleaved, int32_t InNumFrames) = 0;
+
+        // Moves the reader to a new start, as if it had been created there, keeping its decoder and buffers so a
+        // finished grain's reader can serve the next one. Returns false if it cannot; the caller creates a new one.
+        virtual bool Seek(float /*InStartTimeSeconds*/, bool /*bInLooping*/) { return false; }
+    };
+
+    // Anything grains can be read from (decoded wave, in-memory PCM, ...).
+    class IGrainSource
+    {
+    public:
+        virtual ~IGrainSource() = default;
+
+        virtual const FGrainSourceInfo& GetInfo() const = 0;
+
+        // InMaxDecodeSizeInFrames is a hint for decoders, sources without a decoder may ignore it.
+        virtual std::unique_ptr<IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) = 0;
+
+        // Running totals for sources that cache readers or decoded audio. Sources without a cache report nothing.
+        virtual void GetCacheStats(uint64_t& OutLookups, uint64_t& OutHits) const { OutLookups = 0; OutHits = 0; }
+
+        // The source's audio if it is held in memory as a whole. Sources that decode or assemble their audio return
+        // an invalid one and are read through readers.
+        virtual FGrainResidentAudio GetResidentAudio() const { return {}; }
+
+        // Bytes of audio or decoder state this source keeps resident, for diagnostics.
+        virtual uint64_t GetAllocatedBytes() const { return 0; }
+
+        // Offline analysis of this source's audio, if any was found for it (see GrainAnalysis.h).
+        virtual const FGrainAnalysis* GetAnalysis() const { return nullptr; }
+
+        // Hint that a grain just drawn will read between these times. InEndSeconds may pass the end of the source, the
+        // excess wraps to the start as looping grains read it. Called on the render thread, so it must stay cheap. Sources reading a mapped file ask
+        // the OS to page the range in without waiting for it; sources that hold or decode their audio ignore it.
+        virtual void Prefetch(float /*InStartSeconds*/, float /*InEndSeconds*/) {}
+    };
+
+    // Converts 16-bit PCM to float (x / 32768), for sources that store 16-bit audio.
+    void ConvertPcm16ToFloat(const int16_t* InSamples, float* OutSamples, size_t InNumSamples);
+
+    // Interleaved PCM held in memory. Used by the standalone tools and as the reference source.
+    class FGrainMemorySource : public IGrainSource
+    {
+    public:
+        FGrainMemorySource(std::vector<float>&& InInterleavedSamples, int32_t InNumChannels, float InSampleRate);
+
+        virtual const FGrainSourceInfo& GetInfo() const override { return Info; }
+        virtual std::unique_ptr<IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override;
+        virtual uint64_t GetAllocatedBytes() const override { return Samples->capacity() * sizeof(float); }
+        virtual FGrainResidentAudio GetResidentAudio() const override { return { Samples, Samples->data(), false }; }
+
+        virtual const FGrainAnalysis* GetAnalysis() const override { return Analysis.get(); }
+
+        const std::vector<float>& GetSamples() const { return *Samples; }
+
+        // Ignored unless the analysis was made from audio with this source's layout.
+        void SetAnalysis(std::shared_ptr<const FGrainAnalysis> InAnalysis);
+
+    private:
+        std::shared_ptr<const std::vector<float>> Samples;
+        std::shared_ptr<const FGrainAnalysis> Analysis;
+        FGrainSourceInfo Info;
+    };
+
+    // --- Envelopes ---
+    enum class EGrainWindowShape : uint8_t
+    {
+        Linear = 0,
+        Parabolic = 1,
+        Gaussian = 2,
+        Cosine = 3,
+        Hann = 4,
+        Blackman = 5,
+        Triangular = 6,
+        Rectangular = 7
+    };
+
+    enum class EGrainEnvelopeType : uint8_t
+    {
+        AttackDecay,  // Granular Synth: attack/decay ramps shaped by curve exponents
+        Window        // Granular Wave Player Smooth: window function selected by shape
+    };
+
+    // Block-rate envelope settings, applied to every active voice.
+    struct FGrainEnvelope
+    {
+        EGrainEnvelopeType Type = EGrainEnvelopeType::AttackDecay;
+        float AttackPercent = 0.1f;  // 0-1 of the grain duration
+        float DecayPercent = 0.1f;   // 0-1 of the grain duration, already limited to 1 - AttackPercent
+        float AttackCurve = 1.0f;
+        float DecayCurve = 1.0f;
+        EGrainWindowShape WindowShape = EGrainWindowShape::Linear;
+        int32_t XfadeCurve = 1;      // 0 = Linear, 1 = Equal Power, 2 = Smooth (Hann window only)
+    };
+
+    // Multiplies InOutSamples by the attack/decay envelope for frames [InFrameInGrain, InFrameInGrain + InNumFrames).
+    void ApplyAttackDecayEnvelope(float* InOutSamples, int32_t InNumFrames, int32_t InFrameInGrain, int32_t InTotalFrames, const FGrainEnvelope& InEnvelope);
+
+    // Multiplies InOutSamples by the window function for frames [InFrameInGrain, InFrameInGrain + InNumFrames).
+    void ApplyWindowEnvelope(float* InOutSamples, int32_t InNumFrames, int32_t InFrameInGrain, int32_t InTotalFrames,
+        float InSmoothingAmount, float InPhaseOffset, const FGrainEnvelope& InEnvelope);
+
+    // Multiplies InOutSamples by a linear fade to silence over InReleaseFrames. InFrameInRelease is the first
+    // sample's position in the fade; samples before it (negative positions) are left as they are.
+    void ApplyReleaseFade(float* InOutSamples, int32_t InNumFrames, int32_t InFrameInRelease, int32_t InReleaseFrames);
+
+    // Equal power pan law used by both nodes (-1 = left, 1 = right).
+    void GetPanGains(float InPan, float& OutLeftGain, float& OutRightGain);
+
+    // One-pole low pass over both output channels (Granular Wave Player Smooth post-filter).
+    void ApplyOutputFilter(float* InOutLeft, float* InOutRight, int32_t InNumFrames, float InCoeff, float (&InOutState)[2]);
+
+    // --- Voices ---
+    // Everything needed to start one grain, produced by the grain planners.
+    struct FGrainDesc
+    {
+        float StartTimeSeconds = 0.0f;
+        int32_t DurationFrames = 0;
+        float FrameRatio = 1.0f;
+        float Pan = 0.0f;
+        float Volume = 1.0f;
+        bool bReversed = false;
+        int32_t ReverseSourceFrames = 0;   // Source frames read (then reversed) for reversed grains
+        bool bLoopSource = true;
+        int32_t MaxDecodeSizeInFrames = 256;
+        float SmoothingAmount = 0.0f;
+        float PhaseOffset = 0.0f;
+        int32_t DelayFrames = 0;           // Silent frames of the next rendered block before the grain starts
+        int32_t SkipFrames = 0;            // Output frames of the grain already elapsed when it starts
+    };
+
+    struct FGrainVoice
+    {
+        std::unique_ptr<IGrainSourceReader> Reader;
+        uint32_t ReaderGeneration = 0;      // FGrainVoicePool::ReaderGeneration the reader was acquired in
+        std::vector<float> SourceFrames;    // Mono (downmixed) source frames awaiting interpolation
+        int32_t SourceNumFrames = 0;
+        double ReadPosition = 0.0;          // Fractional read index into SourceFrames
+        float FrameRatio = 1.0f;
+        int32_t SourceStep = 0;             // Whole source frames per output frame when interpolation is skipped, else 0
+        FGrainResidentAudio Resident;       // Read in place instead of through Reader when valid
+        int64_t ResidentFrame = 0;          // Next frame of Resident to read
+        int64_t ResidentNumFrames = 0;
+        bool bResidentLooping = false;
+        int64_t ResidentLoopStart = 0;      // First frame of the loop a grain on looped resident audio plays, see FGrainResidentAudio
+        bool bSourceExhausted = false;
+        bool bIsActive = false;
+        bool bIsReversed = false;
+        int32_t NumChannels = 0;
+        int32_t SamplesRemaining = 0;
+        int32_t SamplesPlayed = 0;
+        int32_t TotalGrainSamples = 0;
+        float PanPosition = 0.0f;
+        float VolumeScale = 1.0f;
+        float SmoothingAmount = 0.0f;
+        float PhaseOffset = 0.0f;
+        int32_t DelayFrames = 0;
+        bool bIsReleasing = false;
+        int32_t ReleaseStartSample = 0;     // Grain sample the release fade starts at
+        int32_t ReleaseSamples = 0;
+    };
+
+    // Fixed-size pool of grain voices. Reads from the source, resamples with linear interpolation,
+    // downmixes to mono, applies the envelope and pans into a stereo output.
+    class FGrainVoicePool
+    {
+    public:
+        static constexpr int32_t SourceChunkFrames = 256;
+        static constexpr int32_t MaxSourceStep = 4;     // Largest whole frame ratio read without interpolation
+
+        void Init(int32_t InMaxVoices, int32_t InBlockSize);
+
+        // Starts a grain on a free voice, or on the releasing voice closest to its end when none is free.
+        // Returns the voice index, or -1 if no voice was started.
+        int32_t StartGrain(IGrainSource& InSource, const FGrainDesc& InDesc);
+
+        // Renders and mixes every active voice into OutLeft/OutRight (InNumFrames <= block size). Grains that start on a
+        // whole source frame with a whole frame ratio up to MaxSourceStep are copied instead of interpolated. Without
+        // bInResample every grain must play at the source pitch (frame ratio 1), the interpolator is then left out.
+        template <bool bInResample = true>
+        void Render(float* OutLeft, float* OutRight, int32_t InNumFrames, const FGrainEnvelope& InEnvelope);
+
+        // Fades every active voice out linearly over InReleaseFrames, starting at InFrame of the next rendered
+        // block. Grains that end before the fade would play out as they are.
+        void Release(int32_t InFrame, int32_t InReleaseFrames);
+
+        // Stops every voice at once. Release() is the click-free way to end playback.
+        void Reset();
+
+        int32_t FindFreeVoice() const;
+        int32_t GetNumActiveVoices() const;
+        int32_t GetNumReleasingVoices() const;
+        int32_t GetMaxVoices() const { return static_cast<int32_t>(Voices.size()); }
+        const FGrainVoice& GetVoice(int32_t InIndex) const { return Voices[InIndex]; }
+
+        // Running totals since Init(), see FGrainEngineStats.
+        uint64_t GetNumReadersCreated() const { return NumReadersCreated; }
+        uint64_t GetNumReadersReused() const { return NumReadersReused; }
+        uint64_t GetNumSourceSamplesRead() const { return NumSourceSamplesRead; }
+        uint64_t GetNumReaderSamplesRead() const { return NumReaderSamplesRead; }
+
+        // Voice source buffers and scratch space, not counting the readers themselves.
+        uint64_t GetAllocatedBytes() const;
+
+        // Destroys the readers kept for reuse. Call when the source changes: pooled readers read the old one, and
+        // readers of grains still playing on it are destroyed when those grains finish instead of being kept.
+        void ReleaseReaders();
+
+    private:
+        void ReleaseVoice(FGrainVoice& InVoice);
+
+        // A pooled reader moved to InDesc's start, or a new one from InSource.
+        std::unique_ptr<IGrainSourceReader> AcquireReader(IGrainSource& InSource, const FGrainDesc& InDesc);
+
+        // Keeps a finished grain's reader for the next grain, capacity allowing and if it reads the current source.
+        void RecycleReader(std::unique_ptr<IGrainSourceReader>&& InReader, uint32_t InGeneration);
+
+        // Appends InNumFrames interleaved frames as mono to the voice source buffer.
+        void AppendDownmixed(FGrainVoice& InVoice, const float* InInterleaved, int32_t InNumFrames);
+
+        // Appends up to InMaxFrames (<= SourceChunkFrames) of the voice's resident audio, wrapping when looping.
+        // Returns frames read, 0 at the end of the source.
+        int32_t ReadResident(FGrainVoice& InVoice, int32_t InMaxFrames);
+
+        // Starts a grain on resident audio made of loops. The voice reads the loop in place with a phase accumulator,
+        // without a source buffer. Returns InVoiceIndex, or -1 if the grain cannot start.
+        int32_t StartLoopedGrain(int32_t InVoiceIndex, const FGrainSourceInfo& InInfo, FGrainResidentAudio&& InResident, const FGrainDesc& InDesc);
+
+        // Produces InNumFrames frames of a grain started by StartLoopedGrain. Returns frames produced.
+        int32_t GenerateLoopedVoice(FGrainVoice& InVoice, float* OutMono, int32_t InNumFrames);
+
+        // Produces up to InNumFrames resampled mono frames, every SourceStep-th source frame without bInResample.
+        // Returns frames produced.
+        template <bool bInResample>
+        int32_t GenerateVoice(FGrainVoice& InVoice, float* OutMono, int32_t InNumFrames);
+
+        std::vector<FGrainVoice> Voices;
+        std::vector<std::unique_ptr<IGrainSourceReader>> FreeReaders;  // Capacity reserved for one per voice
+        uint32_t ReaderGeneration = 0;  // Bumped by ReleaseReaders()
+        std::vector<float> InterleavedScratch;
+        std::vector<float> MonoScratch;
+        int32_t BlockSize = 0;
+        uint64_t NumReadersCreated = 0;
+        uint64_t NumReadersReused = 0;
+        uint64_t NumSourceSamplesRead = 0;
+        uint64_t NumReaderSamplesRead = 0;
+    };
+
+    // --- Engine Statistics ---
+    // Running totals since the engine was initialized. Callers that want rates keep the previous
+    // snapshot and diff against it; nothing here is reset by Start/Stop/Reset.
+    struct FGrainEngineStats
+    {
+        uint64_t GrainsStarted = 0;
+        uint64_t GrainsDropped = 0;         // Grains the scheduler asked for but could not start
+        uint64_t ReadersCreated = 0;
+        uint64_t ReadersReused = 0;         // Grains started on a finished grain's reader instead of a new one
+        uint64_t SourceSamplesRead = 0;     // Interleaved samples grains read, resident or through source readers
+        uint64_t ReaderSamplesRead = 0;     // The part read through source readers, i.e. decoded
+        uint64_t CacheLookups = 0;          // From IGrainSource::GetCacheStats, restart with each new source
+        uint64_t CacheHits = 0;
+        uint64_t VoiceBufferBytes = 0;      // Current, not a running total
+        uint64_t SourceBytes = 0;           // Current, not a running total
+        int32_t ActiveVoices = 0;
+        int32_t MaxVoices = 0;
+    };
+
+    // --- Spawn Reporting ---
+    struct FGrainSpawnEvent
+    {
+        int32_t FrameInBlock = 0;
+        float StartTimeSeconds = 0.0f;
+        float DurationSeconds = 0.0f;
+        bool bReversed = false;
+        float Volume = 1.0f;
+        float PitchSemitones = 0.0f;
+        float Pan = 0.0f;
+    };
+
+    // --- Block Phase Timing ---
+    // Optional per-block timing of the engine phases, in ticks of whatever clock the caller installs.
+    // Without a clock the engines skip it entirely.
+    using FGrainClock = uint64_t (*)();
+
+    struct FGrainBlockTimings
+    {
+        uint64_t Plan = 0;          // Parameter resolve and grain scheduling
+        uint64_t StartGrains = 0;   // Reader creation and reverse segment reads
+        uint64_t Render = 0;        // Source reads, resampling, envelope and pan/mix of every voice
+        uint64_t PostFilter = 0;    // Smooth node output filter
+    };
+
+    // --- Granular Synth Engine ---
+    struct FGranularSynthParams
+    {
+        float GrainDurationMs = 100.0f;
+        float DurationRandMs = 0.0f;
+        float ActiveVoices = 1.0f;
+        float TimeJitterPercent = 0.0f;
+        float StartPointSeconds = 0.0f;
+        float StartPointRandMs = 0.0f;
+        float ReverseChancePercent = 0.0f;
+        float AttackPercent = 0.1f;
+        float DecayPercent = 0.1f;
+        float AttackCurve = 1.0f;
+        float DecayCurve = 1.0f;
+        float PitchShiftSemitones = 0.0f;
+        float PitchRandSemitones = 0.0f;
+        float Pan = 0.0f;
+        float PanRand = 0.0f;
+        float VolumeRandPercent = 0.0f;
+        float FrameRatioScale = 1.0f;  // Applied to every grain's frame ratio on top of the pitch shift, for sources such as wave tables whose pitch is set in Hz
+        bool bWarmStart = false;
+    };
+
+    // Compile-time feature sets of the synth engine. The lite node variants leave out what their graphs never use,
+    // which removes that code and its random draws instead of branching on inputs left at zero.
+    struct FGrainSynthFullFeatures
+    {
+        static constexpr bool bReverse = true;  // Reverse Chance
+        static constexpr bool bPitch = true;    // Pitch Shift and Pitch Rand, grains are resampled
+    };
+
+    struct FGrainSynthForwardFeatures
+    {
+        static constexpr bool bReverse = false;
+        static constexpr bool bPitch = true;
+    };
+
+    // Forward grains at the source pitch, which are copied from the source without resampling.
+    struct FGrainSynthLiteFeatures
+    {
+        static constexpr bool bReverse = false;
+        static constexpr bool bPitch = false;
+    };
+
+    // Grain scheduling and rendering of the "Granular Synth" node and its lite variants. Instantiated in
+    // GrainCore.cpp for the feature sets above.
+    template <typename FeaturesType>
+    class TGranularSynthEngine
+    {
+    public:
+        static constexpr int32_t MaxGrainVoices = 32;
+        static constexpr float MinGrainDurationSeconds = 0.001f;
+        static constexpr float SourceEndMarginSeconds = 0.005f;  // Grains start at least this far before the end of the source
+        static constexpr float MaxAbsPitchShiftSemitones = 60.0f;
+        static constexpr int32_t DeinterleaveBlockSizeFrames = 256;
+        static constexpr float MinActiveVoicesParam = 0.01f; // Minimum value for ActiveVoices to calculate interval
+        static constexpr float MinSamplesPerGrainInterval = 1.0f;
+        static constexpr float Epsilon = 1e-6f;
+        static constexpr float ReleaseSeconds = 0.02f;  // Fade of grains still playing at Stop or a restart
+        static constexpr int32_t WarmStartGrainsPerBlock = 8;  // Warm start grains set up per block, the rest wait
+
+        void Init(float InSampleRate, int32_t InBlockSize);
+
+        // Returns false (and clears the source) if the source is unusable for granulation.
+        bool SetSource(std::shared_ptr<IGrainSource> InSource);
+        void ClearSource();
+        bool HasValidSource() const;
+
+        // Releases the grains of a previous Start at InFrame of the next block and schedules the first grain
+        // there, spawning the warm start burst if requested. Warm start grains beyond WarmStartGrainsPerBlock
+        // start over the following blocks as if they had started at InFrame.
+        void Start(const FGranularSynthParams& InParams, int32_t InFrame);
+
+        // Spawns no grains from InFrame of the next block on and releases the playing ones there. Keep calling
+        // Process() while IsReleasing() for their tails, and for the grains due before a Stop not yet reached.
+        void Stop(int32_t InFrame = 0);
+        bool IsReleasing() const { return bStopped && (StopFrame >= 0 || VoicePool.GetNumActiveVoices() > 0); }
+        void Reset();
+
+        // Renders one block into OutLeft/OutRight (overwritten).
+        void Process(const FGranularSynthParams& InParams, float* OutLeft, float* OutRight);
+
+        // Grains spawned since the last ClearSpawnEvents().
+        const std::vector<FGrainSpawnEvent>& GetSpawnEvents() const { return SpawnEvents; }
+        void ClearSpawnEvents() { SpawnEvents.clear(); }
+
+        FGrainRandom& GetRandom() { return Random; }
+        const FGrainVoicePool& GetVoicePool() const { return VoicePool; }
+        const std::shared_ptr<IGrainSource>& GetSource() const { return Source; }
+        int32_t GetBlockSize() const { return BlockSize; }
+        float GetSampleRate() const { return SampleRate; }
+
+        FGrainEngineStats GetStats() const;
+
+        void SetClock(FGrainClock InClock) { Clock = InClock; }
+        // Phase timing of the last Process() call, all zero without a clock.
+        const FGrainBlockTimings& GetLastBlockTimings() const { return LastBlockTimings; }
+
+        // Logs every grain and voice reset to InRecorder (nullptr stops). The recorder must already be begun;
+        // the current source is recorded right away.
+        void SetRecorder(FGrainRecorder* InRecorder);
+
+    private:
+        struct FResolvedParams
+        {
+            float BaseGrainDurationSeconds = 0.0f;
+            float MaxDurationRandSeconds = 0.0f;
+            float BaseSamplesPerGrainInterval = 0.0f;
+            float TimeJitterPercent = 0.0f;
+            float BaseStartPointSeconds = 0.0f;
+            float MaxStartPointRandSeconds = 0.0f;
+            float ReverseChance = 0.0f;
+            float BasePitchShiftSemitones = 0.0f;
+            float PitchRandSemitones = 0.0f;
+            float FrameRatioScale = 1.0f;
+            float BasePan = 0.0f;
+            float PanRandAmount = 0.0f;
+            float VolumeRandPercent = 0.0f;
+            FGrainEnvelope Envelope;
+        };
+
+        FResolvedParams ResolveParams(const FGranularSynthParams& InParams) const;
+
+        struct FDeferredGrain
+        {
+            FGrainSpawnEvent Event;
+            FGrainDesc Desc;
+        };
+
+        // Draws a grain from the parameter distributions and starts it. Returns false if no grain was started.
+        bool SpawnGrain(const FResolvedParams& InParams, int32_t InDelayFrames, FGrainSpawnEvent& OutEvent, FGrainDesc& OutDesc);
+
+        // Only draws the grain. Returns false if the draw gives no playable grain.
+        bool DrawGrain(const FResolvedParams& InParams, FGrainSpawnEvent& OutEvent, FGrainDesc& OutDesc);
+
+        // Starts the next WarmStartGrainsPerBlock deferred warm start grains at the start of this block.
+        void StartDeferredWarmStartGrains();
+
+        FGrainVoicePool VoicePool;
+        FGrainRandom Random;
+        std::shared_ptr<IGrainSource> Source;
+        std::vector<FGrainSpawnEvent> SpawnEvents;
+        std::vector<FDeferredGrain> DeferredWarmStartGrains;   // Reserved to MaxGrainVoices
+        float SourceDurationSeconds = 0.0f;
+        float SampleRate = 48000.0f;
+        int32_t BlockSize = 256;
+        float SamplesUntilNextGrain = 0.0f;
+        int32_t WarmStartElapsedFrames = 0;   // Frames from the last Play frame to the start of the next block
+        int32_t StartFrame = 0;     // Frame of the next block playback starts at, grains wait for it
+        int32_t StopFrame = -1;     // Frame of the next block spawning stops at, -1 if no Stop is pending
+        bool bStopped = false;
+        uint64_t NumGrainsStarted = 0;
+        uint64_t NumGrainsDropped = 0;
+        FGrainClock Clock = nullptr;
+        FGrainBlockTimings LastBlockTimings;
+        FGrainRecorder* Recorder = nullptr;
+    };
+
+    using FGranularSynthEngine = TGranularSynthEngine<FGrainSynthFullFeatures>;
+    using FGranularSynthForwardEngine = TGranularSynthEngine<FGrainSynthForwardFeatures>;
+    using FGranularSynthLiteEngine = TGranularSynthEngine<FGrainSynthLiteFeatures>;
+
+    // --- Granular Wave Player Smooth Engine ---
+    struct FGranularSmoothParams
+    {
+        float GrainDurationMs = 100.0f;
+        float GrainsPerSecond = 10.0f;
+        float PlaybackSpeedPercent = 100.0f;
+        float PlayPositionPercent = 0.0f;
+        float PlayRangeMs = 1000.0f;
+        float DurationRandMs = 0.0f;
+        float AttackPercent = 0.1f;
+        float DecayPercent = 0.1f;
+        float PitchShiftSemitones = 0.0f;
+        float PitchRandSemitones = 0.0f;
+        float Pan = 0.0f;
+        float PanRand = 0.0f;
+        float TimeJitterMs = 0.0f;
+        float VolumeRandPercent = 0.0f;
+        float SmoothingPercent = 30.0f;
+        float GrainOverlap = 3.0f;
+        int32_t GrainDensity = 8;
+        int32_t WindowShape = 0;
+        int32_t XfadeCurve = 1;
+    };
+
+    // Grain scheduling, playhead and rendering of the "Granular Wave Player Smooth" node.
+    class FGranularSmoothEngine
+    {
+    public:
+        static constexpr int32_t MaxGrainVoices = 32;
+        static constexpr float MinGrainDurationSeconds = 0.001f;
+        static constexpr float SourceEndMarginSeconds = 0.005f;  // Grains start at least this far before the end of the source
+        static constexpr float MaxAbsPitchShiftSemitones = 60.0f;
+        static constexpr int32_t DeinterleaveBlockSizeFrames = 256;
+        static constexpr float ReleaseSeconds = 0.02f;       // Fade of grains still playing at Stop or a restart
+
+        void Init(float InSampleRate, int32_t InBlockSize);
+
+        bool SetSource(std::shared_ptr<IGrainSource> InSource);
+        void ClearSource();
+        bool HasValidSource() const;
+
+        // Releases the grains of a previous Start at InFrame of the next block and starts spawning there.
+        void Start(int32_t InFrame = 0);
+
+        // Spawns no grains from InFrame of the next block on and releases the playing ones there. Keep calling
+        // Process() while IsReleasing() for their tails, and for the grains due before a Stop not yet reached.
+        void Stop(int32_t InFrame = 0);
+        bool IsReleasing() const { return bStopped && (StopFrame >= 0 || VoicePool.GetNumActiveVoices() > 0); }
+        void Reset();
+
+        void Process(const FGranularSmoothParams& InParams, float* OutLeft, float* OutRight);
+
+        const std::vector<FGrainSpawnEvent>& GetSpawnEvents() const { return SpawnEvents; }
+        void ClearSpawnEvents() { SpawnEvents.clear(); }
+
+        float GetPlaybackPositionSeconds() const { return CurrentPlaybackPositionSeconds; }
+
+        FGrainRandom& GetRandom() { return Random; }
+        const FGrainVoicePool& GetVoicePool() const { return VoicePool; }
+        const std::shared_ptr<IGrainSource>& GetSource() const { return Source; }
+        int32_t GetBlockSize() const { return BlockSize; }
+        float GetSampleRate() const { return SampleRate; }
+
+        FGrainEngineStats GetStats() const;
+
+        void SetClock(FGrainClock InClock) { Clock = InClock; }
+        // Phase timing of the last Process() call, all zero without a clock.
+        const FGrainBlockTimings& GetLastBlockTimings() const { return LastBlockTimings; }
+
+        // Logs every grain and voice reset to InRecorder (nullptr stops). The recorder must already be begun;
+        // the current source is recorded right away.
+        void SetRecorder(FGrainRecorder* InRecorder);
+
+    private:
+        // Fits InOutDesc to the source and starts it; InOutDesc holds what the voice pool was given.
+        bool StartGrain(FGrainDesc& InOutDesc);
+
+        FGrainVoicePool VoicePool;
+        FGrainRandom Random;
+        std::shared_ptr<IGrainSource> Source;
+        std::vector<FGrainSpawnEvent> SpawnEvents;
+        float SourceDurationSeconds = 0.0f;
+        float SampleRate = 48000.0f;
+        int32_t BlockSize = 256;
+        float SamplesUntilNextGrain = 0.0f;
+        int32_t StartFrame = 0;     // Frame of the next block playback starts at, grains wait for it
+        int32_t StopFrame = -1;     // Frame of the next block spawning stops at, -1 if no Stop is pending
+        bool bStopped = false;
+        uint64_t NumGrainsStarted = 0;
+        uint64_t NumGrainsDropped = 0;
+        FGrainClock Clock = nullptr;
+        FGrainBlockTimings LastBlockTimings;
+        FGrainRecorder* Recorder = nullptr;
+        bool bPreviousFreezeState = false;
+        float CurrentPlaybackPositionSeconds = 0.0f;
+        float PrevFilterValue[2] = { 0.0f, 0.0f };
+    };
+}
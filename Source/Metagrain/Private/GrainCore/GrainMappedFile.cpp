@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainMappedFile.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Metagrain
+{
+    namespace GrainMappedFilePrivate
+    {
+        // Hints are issued for whole pages, 4 KB covers every platform the plugin ships on
+        constexpr size_t PageBytes = 4096;
+    }
+
+    void FGrainMappedFile::Prefetch(size_t InOffset, size_t InNumBytes) const
+    {
+        using namespace GrainMappedFilePrivate;
+
+        if (Data == nullptr || InOffset >= Size || InNumBytes == 0)
+        {
+            return;
+        }
+        const size_t Begin = InOffset & ~(PageBytes - 1);
+        const size_t End = (InNumBytes > Size - InOffset) ? Size : InOffset + InNumBytes;
+
+#if defined(_WIN32)
+        WIN32_MEMORY_RANGE_ENTRY Range;
+        Range.VirtualAddress = const_cast<uint8_t*>(Data + Begin);
+        Range.NumberOfBytes = End - Begin;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+#else
+        ::madvise(const_cast<uint8_t*>(Data + Begin), End - Begin, MADV_WILLNEED);
+#endif
+    }
+
+#if defined(_WIN32)
+
+    bool FGrainMappedFile::Open(const std::string& InPath, std::string& OutError)
+    {
+        Close();
+
+        HANDLE File = CreateFileA(InPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (File == INVALID_HANDLE_VALUE)
+        {
+            OutError = "cannot open '" + InPath + "'";
+            return false;
+        }
+
+        LARGE_INTEGER FileSize;
+        if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart <= 0)
+        {
+            CloseHandle(File);
+            OutError = "'" + InPath + "' is empty";
+            return false;
+        }
+
+        HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* View = Mapping ? MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (View == nullptr)
+        {
+            if (Mapping)
+            {
+                CloseHandle(Mapping);
+            }
+            CloseHandle(File);
+            OutError = "cannot map '" + InPath + "'";
+            return false;
+        }
+
+        FileHandle = File;
+        MappingHandle = Mapping;
+        Data = static_cast<const uint8_t*>(View);
+        Size = static_cast<size_t>(FileSize.QuadPart);
+        return true;
+    }
+
+    void FGrainMappedFile::Close()
+    {
+        if (Data)
+        {
+            UnmapViewOfFile(Data);
+            CloseHandle(MappingHandle);
+            CloseHandle(FileHandle);
+        }
+        Data = nullptr;
+        Size = 0;
+        FileHandle = nullptr;
+        MappingHandle = nullptr;
+    }
+
+#else
+
+    bool FGrainMappedFile::Open(const std::string& InPath, std::string& OutError)
+    {
+        Close();
+
+        const int File = ::open(InPath.c_str(), O_RDONLY);
+        if (File < 0)
+        {
+            OutError = "cannot open '" + InPath + "'";
+            return false;
+        }
+
+        struct stat FileStat;
+        if (::fstat(File, &FileStat) != 0 || FileStat.st_size <= 0)
+        {
+            ::close(File);
+            OutError = "'" + InPath + "' is empty";
+            return false;
+        }
+
+        // The mapping keeps its own reference to the file, the descriptor is not needed after this
+        void* View = ::mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_SHARED, File, 0);
+        ::close(File);
+        if (View == MAP_FAILED)
+        {
+            OutError = "cannot map '" + InPath + "'";
+            return false;
+        }
+
+        Data = static_cast<const uint8_t*>(View);
+        Size = static_cast<size_t>(FileStat.st_size);
+        return true;
+    }
+
+    void FGrainMappedFile::Close()
+    {
+        if (Data)
+        {
+            ::munmap(const_cast<uint8_t*>(Data), Size);
+        }
+        Data = nullptr;
+        Size = 0;
+    }
+
+#endif
+}
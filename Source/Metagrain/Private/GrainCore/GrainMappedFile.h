@@ -0,0 +1,42 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Read-only memory mapping of a whole file, for grain sources that read audio in place instead of decoding it.
+// Uses mmap on POSIX and file mappings on Windows; the OS page cache decides what stays resident.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Metagrain
+{
+    class FGrainMappedFile
+    {
+    public:
+        FGrainMappedFile() = default;
+        ~FGrainMappedFile() { Close(); }
+
+        FGrainMappedFile(const FGrainMappedFile&) = delete;
+        FGrainMappedFile& operator=(const FGrainMappedFile&) = delete;
+
+        bool Open(const std::string& InPath, std::string& OutError);
+        void Close();
+
+        bool IsOpen() const { return Data != nullptr; }
+        const uint8_t* GetData() const { return Data; }
+        size_t GetSize() const { return Size; }
+
+        // Asks the OS to start reading the pages of [InOffset, InOffset + InNumBytes) into the page cache and
+        // returns without waiting for them. Out-of-range parts are ignored.
+        void Prefetch(size_t InOffset, size_t InNumBytes) const;
+
+    private:
+        const uint8_t* Data = nullptr;
+        size_t Size = 0;
+#if defined(_WIN32)
+        void* FileHandle = nullptr;
+        void* MappingHandle = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainRealtime.h"
+
+namespace Metagrain
+{
+    namespace GrainRealtimePrivate
+    {
+        // Constant initialized so touching it from inside malloc never allocates
+        struct FThreadState
+        {
+            int32_t Depth = 0;
+            uint32_t NumAllocations = 0;
+            uint32_t NumLocks = 0;
+        };
+
+        thread_local FThreadState ThreadState;
+    }
+
+    FRealtimeScope::FRealtimeScope()
+    {
+        GrainRealtimePrivate::FThreadState& State = GrainRealtimePrivate::ThreadState;
+        ++State.Depth;
+        AllocationsAtStart = State.NumAllocations;
+        LocksAtStart = State.NumLocks;
+    }
+
+    FRealtimeScope::~FRealtimeScope()
+    {
+        --GrainRealtimePrivate::ThreadState.Depth;
+    }
+
+    uint32_t FRealtimeScope::GetNumAllocations() const
+    {
+        return GrainRealtimePrivate::ThreadState.NumAllocations - AllocationsAtStart;
+    }
+
+    uint32_t FRealtimeScope::GetNumLocks() const
+    {
+        return GrainRealtimePrivate::ThreadState.NumLocks - LocksAtStart;
+    }
+
+    bool FRealtimeScope::IsActive()
+    {
+        return GrainRealtimePrivate::ThreadState.Depth > 0;
+    }
+
+    void FRealtimeScope::NoteAllocation()
+    {
+        GrainRealtimePrivate::FThreadState& State = GrainRealtimePrivate::ThreadState;
+        if (State.Depth > 0)
+        {
+            ++State.NumAllocations;
+        }
+    }
+
+    void FRealtimeScope::NoteLock()
+    {
+        GrainRealtimePrivate::FThreadState& State = GrainRealtimePrivate::ThreadState;
+        if (State.Depth > 0)
+        {
+            ++State.NumLocks;
+        }
+    }
+}
@@ -0,0 +1,38 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Real-time section marking for debug tooling. A render block is wrapped in an FRealtimeScope; allocator or
+// lock hooks (the plugin's real-time checker, the MetagrainRtCheck tool) ask IsActive() and report what they
+// see with NoteAllocation() / NoteLock(). Nothing in the core installs a hook, so in normal builds this is
+// two thread-local increments per block.
+
+#include <cstdint>
+
+namespace Metagrain
+{
+    class FRealtimeScope
+    {
+    public:
+        FRealtimeScope();
+        ~FRealtimeScope();
+
+        FRealtimeScope(const FRealtimeScope&) = delete;
+        FRealtimeScope& operator=(const FRealtimeScope&) = delete;
+
+        // Violations reported on this thread since the scope was opened.
+        uint32_t GetNumAllocations() const;
+        uint32_t GetNumLocks() const;
+
+        // True while the calling thread is inside a real-time section. Safe to call from inside an allocator.
+        static bool IsActive();
+
+        // Called by hooks. Counted only while a scope is active on the calling thread.
+        static void NoteAllocation();
+        static void NoteLock();
+
+    private:
+        uint32_t AllocationsAtStart = 0;
+        uint32_t LocksAtStart = 0;
+    };
+}
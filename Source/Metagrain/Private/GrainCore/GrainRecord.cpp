@@ -0,0 +1,445 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainRecord.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Metagrain
+{
+    namespace GrainRecordPrivate
+    {
+        constexpr char Magic[4] = { 'M', 'G', 'R', 'C' };
+
+        bool EnvelopesEqual(const FGrainEnvelope& A, const FGrainEnvelope& B)
+        {
+            return A.Type == B.Type && A.AttackPercent == B.AttackPercent && A.DecayPercent == B.DecayPercent
+                && A.AttackCurve == B.AttackCurve && A.DecayCurve == B.DecayCurve && A.WindowShape == B.WindowShape
+                && A.XfadeCurve == B.XfadeCurve;
+        }
+
+        // Bounds checked sequential reads, mirroring FGrainRecorder::Write
+        class FByteReader
+        {
+        public:
+            FByteReader(const uint8_t* InData, size_t InSize)
+                : Data(InData)
+                , Size(InSize)
+            {
+            }
+
+            template<typename T>
+            bool Read(T& OutValue)
+            {
+                if (Size - Offset < sizeof(T))
+                {
+                    return false;
+                }
+                std::memcpy(&OutValue, Data + Offset, sizeof(T));
+                Offset += sizeof(T);
+                return true;
+            }
+
+            bool IsAtEnd() const { return Offset == Size; }
+
+        private:
+            const uint8_t* Data;
+            size_t Size;
+            size_t Offset = 0;
+        };
+    }
+
+    // --- FGrainRecorder ---
+
+    template<typename T>
+    void FGrainRecorder::Write(T InValue)
+    {
+        const size_t Offset = Bytes.size();
+        Bytes.resize(Offset + sizeof(T));
+        std::memcpy(Bytes.data() + Offset, &InValue, sizeof(T));
+    }
+
+    void FGrainRecorder::BeginRecord(EGrainRecordType InType)
+    {
+        Write(static_cast<uint8_t>(InType));
+        Write(BlockIndex);
+    }
+
+    void FGrainRecorder::Begin(EGrainRecordNode InNode, float InSampleRate, int32_t InBlockSize, int32_t InMaxVoices, size_t InMaxBytes)
+    {
+        Bytes.clear();
+        Bytes.reserve(InitialReserveBytes);
+        BlockIndex = 0;
+        NumGrains = 0;
+        bHasEnvelope = false;
+        LastPostFilterCoeff = 0.0f;
+        MaxBytes = InMaxBytes;
+        bTruncated = false;
+        bFinished = false;
+
+        for (char Character : GrainRecordPrivate::Magic)
+        {
+            Write(static_cast<uint8_t>(Character));
+        }
+        Write(FGrainRecordHeader::CurrentVersion);
+        Write(static_cast<uint8_t>(InNode));
+        Write(InSampleRate);
+        Write(InBlockSize);
+        Write(InMaxVoices);
+    }
+
+    void FGrainRecorder::RecordSource(const FGrainSourceInfo& InInfo)
+    {
+        if (bTruncated)
+        {
+            return;
+        }
+        BeginRecord(EGrainRecordType::Source);
+        Write(InInfo.NumChannels);
+        Write(InInfo.SampleRate);
+        Write(InInfo.NumFrames);
+    }
+
+    void FGrainRecorder::RecordReset(bool bInResetFilter)
+    {
+        if (bTruncated)
+        {
+            return;
+        }
+        BeginRecord(EGrainRecordType::Reset);
+        Write(static_cast<uint8_t>(bInResetFilter ? 1 : 0));
+        if (bInResetFilter)
+        {
+            LastPostFilterCoeff = 0.0f;
+        }
+    }
+
+    void FGrainRecorder::RecordRelease(int32_t InFrame, int32_t InReleaseFrames)
+    {
+        if (bTruncated)
+        {
+            return;
+        }
+        BeginRecord(EGrainRecordType::Release);
+        Write(static_cast<uint16_t>(std::max(0, InFrame)));
+        Write(InReleaseFrames);
+    }
+
+    void FGrainRecorder::RecordEnvelope(const FGrainEnvelope& InEnvelope)
+    {
+        if (bTruncated || (bHasEnvelope && GrainRecordPrivate::EnvelopesEqual(LastEnvelope, InEnvelope)))
+        {
+            return;
+        }
+        LastEnvelope = InEnvelope;
+        bHasEnvelope = true;
+
+        BeginRecord(EGrainRecordType::Envelope);
+        Write(static_cast<uint8_t>(InEnvelope.Type));
+        Write(InEnvelope.AttackPercent);
+        Write(InEnvelope.DecayPercent);
+        Write(InEnvelope.AttackCurve);
+        Write(InEnvelope.DecayCurve);
+        Write(static_cast<uint8_t>(InEnvelope.WindowShape));
+        Write(InEnvelope.XfadeCurve);
+    }
+
+    void FGrainRecorder::RecordPostFilter(float InCoeff)
+    {
+        if (bTruncated || InCoeff == LastPostFilterCoeff)
+        {
+            return;
+        }
+        LastPostFilterCoeff = InCoeff;
+
+        BeginRecord(EGrainRecordType::PostFilter);
+        Write(InCoeff);
+    }
+
+    void FGrainRecorder::RecordGrain(int32_t InFrameInBlock, const FGrainDesc& InDesc)
+    {
+        if (bTruncated)
+        {
+            return;
+        }
+        ++NumGrains;
+        BeginRecord(EGrainRecordType::Grain);
+        Write(static_cast<uint16_t>(std::max(0, InFrameInBlock)));
+        Write(static_cast<uint8_t>((InDesc.bReversed ? 1 : 0) | (InDesc.bLoopSource ? 2 : 0)));
+        Write(InDesc.StartTimeSeconds);
+        Write(InDesc.DurationFrames);
+        Write(InDesc.FrameRatio);
+        Write(InDesc.Pan);
+        Write(InDesc.Volume);
+        Write(InDesc.ReverseSourceFrames);
+        Write(InDesc.MaxDecodeSizeInFrames);
+        Write(InDesc.SmoothingAmount);
+        Write(InDesc.PhaseOffset);
+        Write(static_cast<uint16_t>(std::max(0, InDesc.DelayFrames)));
+        Write(std::max(0, InDesc.SkipFrames));
+    }
+
+    void FGrainRecorder::EndBlock()
+    {
+        if (bTruncated)
+        {
+            return;
+        }
+        ++BlockIndex;
+        bTruncated = MaxBytes > 0 && Bytes.size() >= MaxBytes;
+    }
+
+    const std::vector<uint8_t>& FGrainRecorder::Finish()
+    {
+        if (!bFinished)
+        {
+            BeginRecord(EGrainRecordType::End);
+            bFinished = true;
+        }
+        return Bytes;
+    }
+
+    // --- FGrainRecording ---
+
+    bool FGrainRecording::Parse(const uint8_t* InData, size_t InSize, std::string& OutError)
+    {
+        using GrainRecordPrivate::FByteReader;
+
+        Events.clear();
+        NumBlocks = 0;
+        NumGrains = 0;
+
+        FByteReader Reader(InData, InSize);
+        uint8_t MagicBytes[4] = {};
+        for (uint8_t& Byte : MagicBytes)
+        {
+            if (!Reader.Read(Byte))
+            {
+                OutError = "not a grain recording (too short)";
+                return false;
+            }
+        }
+        if (std::memcmp(MagicBytes, GrainRecordPrivate::Magic, sizeof(MagicBytes)) != 0)
+        {
+            OutError = "not a grain recording (bad magic)";
+            return false;
+        }
+
+        uint8_t Node = 0;
+        if (!Reader.Read(Header.Version) || !Reader.Read(Node) || !Reader.Read(Header.SampleRate)
+            || !Reader.Read(Header.BlockSize) || !Reader.Read(Header.MaxVoices))
+        {
+            OutError = "truncated header";
+            return false;
+        }
+        if (Header.Version < 1 || Header.Version > FGrainRecordHeader::CurrentVersion)
+        {
+            OutError = "unsupported recording version " + std::to_string(Header.Version);
+            return false;
+        }
+        if (Node > static_cast<uint8_t>(EGrainRecordNode::Smooth) || Header.SampleRate <= 0.0f || Header.BlockSize <= 0 || Header.MaxVoices <= 0)
+        {
+            OutError = "invalid header";
+            return false;
+        }
+        Header.Node = static_cast<EGrainRecordNode>(Node);
+
+        bool bEnded = false;
+        while (!bEnded)
+        {
+            uint8_t Type = 0;
+            FGrainRecordEvent Event;
+            if (!Reader.Read(Type) || !Reader.Read(Event.BlockIndex))
+            {
+                OutError = "truncated recording (no End record)";
+                return false;
+            }
+            if (!Events.empty() && Event.BlockIndex < Events.back().BlockIndex)
+            {
+                OutError = "block indices go backwards";
+                return false;
+            }
+            Event.Type = static_cast<EGrainRecordType>(Type);
+
+            bool bRead = true;
+            switch (Event.Type)
+            {
+            case EGrainRecordType::Source:
+                bRead = Reader.Read(Event.SourceInfo.NumChannels) && Reader.Read(Event.SourceInfo.SampleRate) && Reader.Read(Event.SourceInfo.NumFrames);
+                break;
+            case EGrainRecordType::Reset:
+            {
+                uint8_t bResetFilter = 0;
+                bRead = Reader.Read(bResetFilter);
+                Event.bResetFilter = bResetFilter != 0;
+                break;
+            }
+            case EGrainRecordType::Envelope:
+            {
+                uint8_t EnvelopeType = 0;
+                uint8_t WindowShape = 0;
+                bRead = Reader.Read(EnvelopeType) && Reader.Read(Event.Envelope.AttackPercent) && Reader.Read(Event.Envelope.DecayPercent)
+                    && Reader.Read(Event.Envelope.AttackCurve) && Reader.Read(Event.Envelope.DecayCurve) && Reader.Read(WindowShape)
+                    && Reader.Read(Event.Envelope.XfadeCurve);
+                Event.Envelope.Type = static_cast<EGrainEnvelopeType>(EnvelopeType);
+                Event.Envelope.WindowShape = static_cast<EGrainWindowShape>(WindowShape);
+                break;
+            }
+            case EGrainRecordType::PostFilter:
+                bRead = Reader.Read(Event.PostFilterCoeff);
+                break;
+            case EGrainRecordType::Grain:
+            {
+                uint16_t Frame = 0;
+                uint8_t Flags = 0;
+                FGrainDesc& Desc = Event.Desc;
+                bRead = Reader.Read(Frame) && Reader.Read(Flags) && Reader.Read(Desc.StartTimeSeconds) && Reader.Read(Desc.DurationFrames)
+                    && Reader.Read(Desc.FrameRatio) && Reader.Read(Desc.Pan) && Reader.Read(Desc.Volume) && Reader.Read(Desc.ReverseSourceFrames)
+                    && Reader.Read(Desc.MaxDecodeSizeInFrames) && Reader.Read(Desc.SmoothingAmount) && Reader.Read(Desc.PhaseOffset);
+                uint16_t DelayFrames = 0;
+                if (bRead && Header.Version >= 2)
+                {
+                    bRead = Reader.Read(DelayFrames);
+                }
+                if (bRead && Header.Version >= 3)
+                {
+                    bRead = Reader.Read(Desc.SkipFrames);
+                }
+                Event.FrameInBlock = Frame;
+                Desc.DelayFrames = DelayFrames;
+                Desc.bReversed = (Flags & 1) != 0;
+                Desc.bLoopSource = (Flags & 2) != 0;
+                ++NumGrains;
+                break;
+            }
+            case EGrainRecordType::Release:
+            {
+                uint16_t Frame = 0;
+                bRead = Reader.Read(Frame) && Reader.Read(Event.ReleaseFrames);
+                Event.FrameInBlock = Frame;
+                break;
+            }
+            case EGrainRecordType::End:
+                NumBlocks = Event.BlockIndex;
+                bEnded = true;
+                break;
+            default:
+                OutError = "unknown record type " + std::to_string(Type);
+                return false;
+            }
+
+            if (!bRead)
+            {
+                OutError = "truncated record";
+                return false;
+            }
+            if (!bEnded)
+            {
+                Events.push_back(Event);
+            }
+        }
+        return true;
+    }
+
+    // --- FGrainReplayer ---
+
+    bool FGrainReplayer::Init(const FGrainRecording& InRecording, std::shared_ptr<IGrainSource> InSource, std::string& OutError)
+    {
+        if (!InSource || !InSource->GetInfo().IsValid())
+        {
+            OutError = "replay source is empty";
+            return false;
+        }
+
+        const FGrainSourceInfo& Info = InSource->GetInfo();
+        for (const FGrainRecordEvent& Event : InRecording.Events)
+        {
+            if (Event.Type != EGrainRecordType::Source)
+            {
+                continue;
+            }
+            if (Event.SourceInfo.NumChannels != Info.NumChannels || Event.SourceInfo.SampleRate != Info.SampleRate || Event.SourceInfo.NumFrames != Info.NumFrames)
+            {
+                OutError = "replay source does not match the recorded one (recorded " + std::to_string(Event.SourceInfo.NumChannels) + " ch, "
+                    + std::to_string(Event.SourceInfo.SampleRate) + " Hz, " + std::to_string(Event.SourceInfo.NumFrames) + " frames)";
+                return false;
+            }
+        }
+
+        Recording = &InRecording;
+        Source = std::move(InSource);
+        BlockSize = InRecording.Header.BlockSize;
+        VoicePool.Init(InRecording.Header.MaxVoices, BlockSize);
+        Rewind();
+        return true;
+    }
+
+    void FGrainReplayer::Rewind()
+    {
+        VoicePool.Reset();
+        Envelope = FGrainEnvelope();
+        PostFilterCoeff = 0.0f;
+        PrevFilterValue[0] = 0.0f;
+        PrevFilterValue[1] = 0.0f;
+        BlockIndex = 0;
+        NextEvent = 0;
+    }
+
+    bool FGrainReplayer::Process(float* OutLeft, float* OutRight)
+    {
+        if (Recording == nullptr || BlockIndex >= Recording->NumBlocks)
+        {
+            return false;
+        }
+
+        std::fill(OutLeft, OutLeft + BlockSize, 0.0f);
+        std::fill(OutRight, OutRight + BlockSize, 0.0f);
+
+        const std::vector<FGrainRecordEvent>& Events = Recording->Events;
+        for (; NextEvent < Events.size() && Events[NextEvent].BlockIndex == BlockIndex; ++NextEvent)
+        {
+            const FGrainRecordEvent& Event = Events[NextEvent];
+            switch (Event.Type)
+            {
+            case EGrainRecordType::Reset:
+                VoicePool.Reset();
+                if (Event.bResetFilter)
+                {
+                    PrevFilterValue[0] = 0.0f;
+                    PrevFilterValue[1] = 0.0f;
+                }
+                break;
+            case EGrainRecordType::Release:
+                VoicePool.Release(Event.FrameInBlock, Event.ReleaseFrames);
+                break;
+            case EGrainRecordType::Envelope:
+                Envelope = Event.Envelope;
+                break;
+            case EGrainRecordType::PostFilter:
+                PostFilterCoeff = Event.PostFilterCoeff;
+                break;
+            case EGrainRecordType::Grain:
+                if (VoicePool.StartGrain(*Source, Event.Desc) >= 0)
+                {
+                    ++NumGrainsStarted;
+                }
+                else
+                {
+                    ++NumGrainsDropped;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        VoicePool.Render(OutLeft, OutRight, BlockSize, Envelope);
+        if (PostFilterCoeff > 0.0f)
+        {
+            ApplyOutputFilter(OutLeft, OutRight, BlockSize, PostFilterCoeff, PrevFilterValue);
+        }
+
+        ++BlockIndex;
+        return true;
+    }
+}
@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Grain event recording and replay. A recorder attached to an engine logs everything the engine asks of its
+// voice pool, block by block: every started grain as its final FGrainDesc, voice resets and releases, and the
+// envelope and post-filter settings whenever they change. A replayer feeds that stream back into a voice pool, so
+// the exact grain load of a captured session can be rendered again without the scheduler or the random stream.
+//
+// File layout, little endian: FGrainRecordHeader, then records. A record is one EGrainRecordType byte, the
+// uint32 block index it belongs to and a fixed size payload for its type. Only blocks the engine processed are
+// counted, so time spent stopped is not part of a recording (release tails after a Stop are).
+
+#include "GrainCore.h"
+
+#include <string>
+
+namespace Metagrain
+{
+    enum class EGrainRecordNode : uint8_t
+    {
+        Synth = 0,
+        Smooth = 1
+    };
+
+    enum class EGrainRecordType : uint8_t
+    {
+        Source = 1,      // A new source was set (channels, rate and length, for checking the replay source)
+        Reset = 2,       // All voices were released; optionally the post-filter state too
+        Envelope = 3,    // Envelope used by this and later blocks
+        PostFilter = 4,  // One-pole output filter coefficient for this and later blocks, 0 = off
+        Grain = 5,       // A grain started on a voice
+        End = 6,         // Total number of blocks recorded
+        Release = 7      // Playing voices fade out from a frame of the block (Stop or restart)
+    };
+
+    struct FGrainRecordHeader
+    {
+        static constexpr uint32_t CurrentVersion = 3;   // 2 added grain delays and Release records, 3 grain skips
+
+        EGrainRecordNode Node = EGrainRecordNode::Synth;
+        uint32_t Version = CurrentVersion;
+        float SampleRate = 0.0f;
+        int32_t BlockSize = 0;
+        int32_t MaxVoices = 0;
+    };
+
+    struct FGrainRecordEvent
+    {
+        EGrainRecordType Type = EGrainRecordType::Grain;
+        uint32_t BlockIndex = 0;
+        int32_t FrameInBlock = 0;        // Grain: where the scheduler placed it (grains render from their DelayFrames). Release: where the fade starts
+        int32_t ReleaseFrames = 0;       // Release
+        FGrainDesc Desc;                 // Grain
+        FGrainEnvelope Envelope;         // Envelope
+        float PostFilterCoeff = 0.0f;    // PostFilter
+        bool bResetFilter = false;       // Reset
+        FGrainSourceInfo SourceInfo;     // Source
+    };
+
+    // Appends records to an in-memory buffer. Recording allocates as the buffer grows, so it is a diagnostic
+    // mode, not something to leave on in shipping content.
+    class FGrainRecorder
+    {
+    public:
+        static constexpr size_t InitialReserveBytes = 64 * 1024;
+
+        // Clears anything recorded so far and writes the header. With InMaxBytes > 0 recording stops at the first
+        // block boundary past that size, so the recording covers whole blocks only.
+        void Begin(EGrainRecordNode InNode, float InSampleRate, int32_t InBlockSize, int32_t InMaxVoices, size_t InMaxBytes = 0);
+
+        // Engine hooks
+        void RecordSource(const FGrainSourceInfo& InInfo);
+        void RecordReset(bool bInResetFilter);
+        void RecordRelease(int32_t InFrame, int32_t InReleaseFrames);
+        void RecordEnvelope(const FGrainEnvelope& InEnvelope);     // Skipped when unchanged
+        void RecordPostFilter(float InCoeff);                      // Skipped when unchanged
+        void RecordGrain(int32_t InFrameInBlock, const FGrainDesc& InDesc);
+        void EndBlock();
+
+        // Appends the End record. Returns the complete recording.
+        const std::vector<uint8_t>& Finish();
+
+        uint32_t GetNumBlocks() const { return BlockIndex; }
+        uint64_t GetNumGrains() const { return NumGrains; }
+        bool IsEmpty() const { return NumGrains == 0; }
+        bool IsTruncated() const { return bTruncated; }
+
+    private:
+        void BeginRecord(EGrainRecordType InType);
+
+        template<typename T>
+        void Write(T InValue);
+
+        std::vector<uint8_t> Bytes;
+        uint32_t BlockIndex = 0;
+        uint64_t NumGrains = 0;
+        FGrainEnvelope LastEnvelope;
+        bool bHasEnvelope = false;
+        float LastPostFilterCoeff = 0.0f;
+        size_t MaxBytes = 0;
+        bool bTruncated = false;
+        bool bFinished = false;
+    };
+
+    // A parsed recording.
+    struct FGrainRecording
+    {
+        FGrainRecordHeader Header;
+        std::vector<FGrainRecordEvent> Events;  // In recording order, block indices never decrease
+        uint32_t NumBlocks = 0;
+        uint64_t NumGrains = 0;
+
+        bool Parse(const uint8_t* InData, size_t InSize, std::string& OutError);
+    };
+
+    // Renders a recording block by block on its own voice pool.
+    class FGrainReplayer
+    {
+    public:
+        // InRecording must outlive the replayer. Fails if InSource does not match the recorded source layout.
+        bool Init(const FGrainRecording& InRecording, std::shared_ptr<IGrainSource> InSource, std::string& OutError);
+
+        // Renders the next recorded block into OutLeft/OutRight (overwritten). Returns false once every block was rendered.
+        bool Process(float* OutLeft, float* OutRight);
+
+        // Starts again from the first block.
+        void Rewind();
+
+        uint32_t GetBlockIndex() const { return BlockIndex; }
+        int32_t GetBlockSize() const { return BlockSize; }
+        const FGrainVoicePool& GetVoicePool() const { return VoicePool; }
+        uint64_t GetNumGrainsStarted() const { return NumGrainsStarted; }
+        uint64_t GetNumGrainsDropped() const { return NumGrainsDropped; }  // Non-zero means the source differs from the recorded one
+
+    private:
+        const FGrainRecording* Recording = nullptr;
+        std::shared_ptr<IGrainSource> Source;
+        FGrainVoicePool VoicePool;
+        FGrainEnvelope Envelope;
+        float PostFilterCoeff = 0.0f;
+        float PrevFilterValue[2] = { 0.0f, 0.0f };
+        int32_t BlockSize = 0;
+        uint32_t BlockIndex = 0;
+        size_t NextEvent = 0;
+        uint64_t NumGrainsStarted = 0;
+        uint64_t NumGrainsDropped = 0;
+    };
+}
@@ -0,0 +1,252 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainSeekPoints.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Metagrain
+{
+    namespace GrainSeekPointsPrivate
+    {
+        // Finished readers kept for Refill; more are freed when handed back
+        constexpr int64_t MaxSpares = 64;
+
+        // Decoding forward to a grain's start goes through this much scratch at a time
+        constexpr int32_t SkipBufferSamples = 1024;
+
+        // Decoded by Refill just before each point, so the codec has loaded and decoded the packets around it
+        // before a grain takes it rather than on the first read
+        constexpr int64_t PrimeFrames = 256;
+
+        // Half a frame in, so the start time does not round down to the frame before
+        float GetFrameSeconds(int64_t InFrame, float InSampleRate)
+        {
+            return static_cast<float>((static_cast<double>(InFrame) + 0.5) / InSampleRate);
+        }
+
+        class FGrainSeekPointReader : public IGrainSourceReader
+        {
+        public:
+            FGrainSeekPointReader(std::shared_ptr<FGrainSeekPointSource> InOwner, int32_t InDecodeSizeInFrames)
+                : Owner(std::move(InOwner))
+                , DecodeSizeInFrames(InDecodeSizeInFrames)
+            {
+            }
+
+            virtual ~FGrainSeekPointReader() override
+            {
+                if (Reader)
+                {
+                    Owner->ReturnReader(std::move(Reader));
+                }
+            }
+
+            // Moves to InFrame from the point before it if one is parked, otherwise by seeking a reader as grains
+            // without the index do.
+            bool Start(int64_t InFrame, bool bInLooping)
+            {
+                bLooping = bInLooping;
+                int64_t PointFrame = 0;
+                if (std::unique_ptr<IGrainSourceReader> Parked = Owner->TakePoint(InFrame, PointFrame))
+                {
+                    if (Reader)
+                    {
+                        Owner->ReturnReader(std::move(Reader));
+                    }
+                    Reader = std::move(Parked);
+                    FramesToSkip = InFrame - PointFrame;
+                    return true;
+                }
+
+                FramesToSkip = 0;
+                const float StartSeconds = GetFrameSeconds(InFrame, Owner->GetInfo().SampleRate);
+                if (Reader && Reader->Seek(StartSeconds, false))
+                {
+                    return true;
+                }
+                Reader = Owner->GetSource()->CreateReader(StartSeconds, false, DecodeSizeInFrames);
+                return Reader != nullptr;
+            }
+
+            virtual int32_t PopFrames(float* OutInterleaved, int32_t InNumFrames) override
+            {
+                const int32_t NumChannels = Owner->GetInfo().NumChannels;
+                while (FramesToSkip > 0 && Reader)
+                {
+                    const int32_t FramesToRead = static_cast<int32_t>(std::min<int64_t>(FramesToSkip, SkipBufferSamples / NumChannels));
+                    const int32_t FramesRead = Reader->PopFrames(SkipBuffer, FramesToRead);
+                    FramesToSkip = (FramesRead > 0) ? FramesToSkip - FramesRead : 0;
+                }
+
+                int32_t FramesWritten = 0;
+                bool bWrapped = false;
+                while (FramesWritten < InNumFrames && Reader)
+                {
+                    const int32_t FramesRead = Reader->PopFrames(OutInterleaved + static_cast<int64_t>(FramesWritten) * NumChannels, InNumFrames - FramesWritten);
+                    if (FramesRead > 0)
+                    {
+                        FramesWritten += FramesRead;
+                        bWrapped = false;
+                        continue;
+                    }
+                    if (!bLooping || bWrapped)
+                    {
+                        break;
+                    }
+
+                    // End of the source, carry on from its start as a looping reader would
+                    bWrapped = true;
+                    Start(0, true);
+                }
+                return FramesWritten;
+            }
+
+            virtual bool Seek(float InStartTimeSeconds, bool bInLooping) override
+            {
+                return Start(Owner->GetInfo().GetStartFrame(InStartTimeSeconds, bInLooping), bInLooping);
+            }
+
+        private:
+            std::shared_ptr<FGrainSeekPointSource> Owner;
+            std::unique_ptr<IGrainSourceReader> Reader;  // Of the owner's underlying source, never looping
+            int64_t FramesToSkip = 0;
+            int32_t DecodeSizeInFrames = 0;
+            bool bLooping = false;
+            float SkipBuffer[SkipBufferSamples];
+        };
+    }
+
+    FGrainSeekPointSource::FGrainSeekPointSource(std::shared_ptr<IGrainSource> InSource, int32_t InIntervalFrames, int32_t InDecodeSizeInFrames)
+        : Source(std::move(InSource))
+        , IntervalFrames(std::max(1, InIntervalFrames))
+        , DecodeSizeInFrames(InDecodeSizeInFrames)
+    {
+        const int64_t NumFrames = std::max<int64_t>(1, Source->GetInfo().NumFrames);
+        NumPoints = (NumFrames + IntervalFrames - 1) / IntervalFrames;
+        NumSpares = static_cast<int32_t>(std::min(NumPoints, GrainSeekPointsPrivate::MaxSpares));
+
+        Points.reset(new std::atomic<IGrainSourceReader*>[static_cast<size_t>(NumPoints)]);
+        for (int64_t Point = 0; Point < NumPoints; ++Point)
+        {
+            Points[Point].store(nullptr, std::memory_order_relaxed);
+        }
+        Spares.reset(new std::atomic<IGrainSourceReader*>[static_cast<size_t>(NumSpares)]);
+        for (int32_t Spare = 0; Spare < NumSpares; ++Spare)
+        {
+            Spares[Spare].store(nullptr, std::memory_order_relaxed);
+        }
+        NumEmptyPoints.store(NumPoints, std::memory_order_release);
+    }
+
+    FGrainSeekPointSource::~FGrainSeekPointSource()
+    {
+        for (int64_t Point = 0; Point < NumPoints; ++Point)
+        {
+            delete Points[Point].exchange(nullptr);
+        }
+        for (int32_t Spare = 0; Spare < NumSpares; ++Spare)
+        {
+            delete Spares[Spare].exchange(nullptr);
+        }
+    }
+
+    int32_t FGrainSeekPointSource::GetIntervalFrames(const FGrainSourceInfo& InInfo, int64_t InMaxPoints, int32_t InMinIntervalFrames)
+    {
+        const int64_t MaxPoints = std::max<int64_t>(1, InMaxPoints);
+        const int64_t IntervalFrames = (InInfo.NumFrames + MaxPoints - 1) / MaxPoints;
+        return static_cast<int32_t>(std::clamp<int64_t>(IntervalFrames, std::max(1, InMinIntervalFrames), std::numeric_limits<int32_t>::max()));
+    }
+
+    int32_t FGrainSeekPointSource::Refill()
+    {
+        using namespace GrainSeekPointsPrivate;
+
+        const FGrainSourceInfo& Info = GetInfo();
+        std::vector<float> PrimeBuffer(static_cast<size_t>(PrimeFrames * Info.NumChannels));
+        int32_t NumFilled = 0;
+        for (int64_t Point = 0; Point < NumPoints; ++Point)
+        {
+            if (Points[Point].load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            const int64_t PointFrame = Point * IntervalFrames;
+            const int64_t StartFrame = std::max<int64_t>(0, PointFrame - PrimeFrames);
+            const float StartSeconds = GetFrameSeconds(StartFrame, Info.SampleRate);
+            std::unique_ptr<IGrainSourceReader> Reader = TakeSpare();
+            if (!Reader || !Reader->Seek(StartSeconds, false))
+            {
+                Reader = Source->CreateReader(StartSeconds, false, DecodeSizeInFrames);
+            }
+            const int32_t FramesToPrime = static_cast<int32_t>(PointFrame - StartFrame);
+            if (!Reader || (FramesToPrime > 0 && Reader->PopFrames(PrimeBuffer.data(), FramesToPrime) != FramesToPrime))
+            {
+                continue;
+            }
+
+            // Only Refill fills points, so the empty one is still empty
+            Points[Point].store(Reader.release(), std::memory_order_release);
+            NumEmptyPoints.fetch_sub(1, std::memory_order_acq_rel);
+            ++NumFilled;
+        }
+
+        // Frees the readers no point needed here rather than on the render thread
+        for (int32_t Spare = 0; Spare < NumSpares; ++Spare)
+        {
+            TakeSpare();
+        }
+        return NumFilled;
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainSeekPointSource::CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t /*InMaxDecodeSizeInFrames*/)
+    {
+        std::unique_ptr<GrainSeekPointsPrivate::FGrainSeekPointReader> Reader = std::make_unique<GrainSeekPointsPrivate::FGrainSeekPointReader>(shared_from_this(), DecodeSizeInFrames);
+        if (!Reader->Start(GetInfo().GetStartFrame(InStartTimeSeconds, bInLooping), bInLooping))
+        {
+            return nullptr;
+        }
+        return Reader;
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainSeekPointSource::TakePoint(int64_t InFrame, int64_t& OutPointFrame)
+    {
+        const int64_t Point = std::clamp<int64_t>(InFrame / IntervalFrames, 0, NumPoints - 1);
+        IGrainSourceReader* Reader = Points[Point].exchange(nullptr, std::memory_order_acq_rel);
+        if (!Reader)
+        {
+            return nullptr;
+        }
+        NumEmptyPoints.fetch_add(1, std::memory_order_acq_rel);
+        OutPointFrame = Point * IntervalFrames;
+        return std::unique_ptr<IGrainSourceReader>(Reader);
+    }
+
+    void FGrainSeekPointSource::ReturnReader(std::unique_ptr<IGrainSourceReader>&& InReader)
+    {
+        IGrainSourceReader* Reader = InReader.release();
+        for (int32_t Spare = 0; Spare < NumSpares && Reader; ++Spare)
+        {
+            IGrainSourceReader* Expected = nullptr;
+            if (Spares[Spare].compare_exchange_strong(Expected, Reader, std::memory_order_acq_rel))
+            {
+                return;
+            }
+        }
+        delete Reader;  // Every spare slot is taken
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainSeekPointSource::TakeSpare()
+    {
+        for (int32_t Spare = 0; Spare < NumSpares; ++Spare)
+        {
+            if (IGrainSourceReader* Reader = Spares[Spare].exchange(nullptr, std::memory_order_acq_rel))
+            {
+                return std::unique_ptr<IGrainSourceReader>(Reader);
+            }
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Seek index for sources that decode. Starting a decoder at an arbitrary time costs whatever the codec needs to get
+// there (the packet containing it plus preroll, or everything before it for streams that cannot seek), and grains
+// pay it on the render thread each time they start. A seek point source keeps decoders parked at fixed intervals
+// through the source instead. A grain takes the one at or before its start and decodes forward from it, at most one
+// interval, and a worker thread parks a decoder there again (Refill) from the readers finished grains hand back.
+//
+// The points hold decoder state, not decoded audio, so the audio played is exactly what the source's own readers
+// produce, and memory is bounded by the number of points rather than the length of the source. Grains that find
+// their point taken seek a decoder of their own, as they would without the index. Parked readers never loop; readers
+// of looping grains continue from the point at the start of the source when they reach its end.
+
+#include "GrainCore.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Metagrain
+{
+    class FGrainSeekPointSource : public IGrainSource, public std::enable_shared_from_this<FGrainSeekPointSource>
+    {
+    public:
+        // Points every InIntervalFrames frames of InSource, each a reader created with InDecodeSizeInFrames. Nothing
+        // is decoded until the first Refill.
+        FGrainSeekPointSource(std::shared_ptr<IGrainSource> InSource, int32_t InIntervalFrames, int32_t InDecodeSizeInFrames);
+        virtual ~FGrainSeekPointSource() override;
+
+        // Interval giving a source of InInfo at most InMaxPoints points, never shorter than InMinIntervalFrames.
+        static int32_t GetIntervalFrames(const FGrainSourceInfo& InInfo, int64_t InMaxPoints, int32_t InMinIntervalFrames);
+
+        // Parks a reader at every empty point, having decoded the frames just before it, seeking the readers finished
+        // grains handed back before creating new ones, and frees any left over. Seeks decoders, so call it from a worker thread, one call at a time, never
+        // from the render thread. Returns the number of points filled.
+        int32_t Refill();
+
+        // True while a point is empty, i.e. after a grain took one and before the next Refill.
+        bool NeedsRefill() const { return NumEmptyPoints.load(std::memory_order_acquire) > 0; }
+
+        int32_t GetIntervalFrames() const { return IntervalFrames; }
+        int64_t GetNumPoints() const { return NumPoints; }
+        const std::shared_ptr<IGrainSource>& GetSource() const { return Source; }
+
+        virtual const FGrainSourceInfo& GetInfo() const override { return Source->GetInfo(); }
+        virtual std::unique_ptr<IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override;
+        virtual uint64_t GetAllocatedBytes() const override { return Source->GetAllocatedBytes(); }
+        virtual const FGrainAnalysis* GetAnalysis() const override { return Source->GetAnalysis(); }
+        virtual void Prefetch(float InStartSeconds, float InEndSeconds) override { Source->Prefetch(InStartSeconds, InEndSeconds); }
+
+        // Render thread side, for the readers this source creates. TakePoint returns the reader parked at the point
+        // at or before InFrame and that point's frame, or null if a grain took it since the last Refill.
+        std::unique_ptr<IGrainSourceReader> TakePoint(int64_t InFrame, int64_t& OutPointFrame);
+
+        // A reader of this source's underlying source a grain is done with, kept for Refill to park again.
+        void ReturnReader(std::unique_ptr<IGrainSourceReader>&& InReader);
+
+    private:
+        std::unique_ptr<IGrainSourceReader> TakeSpare();
+
+        std::shared_ptr<IGrainSource> Source;
+        int32_t IntervalFrames = 1;
+        int32_t DecodeSizeInFrames = 0;
+        int64_t NumPoints = 0;
+        int32_t NumSpares = 0;
+        std::unique_ptr<std::atomic<IGrainSourceReader*>[]> Points;   // Owned, null once taken
+        std::unique_ptr<std::atomic<IGrainSourceReader*>[]> Spares;   // Owned, handed back by grains
+        std::atomic<int64_t> NumEmptyPoints { 0 };
+    };
+}
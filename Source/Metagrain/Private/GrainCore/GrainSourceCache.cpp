@@ -0,0 +1,350 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainSourceCache.h"
+#include "GrainAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Metagrain
+{
+    static_assert(sizeof(FGrainSourceCacheHeader) == 72, "FGrainSourceCacheHeader is part of the cache file format");
+
+    namespace GrainSourceCachePrivate
+    {
+        size_t GetBytesPerSample(EGrainSampleFormat InFormat)
+        {
+            return (InFormat == EGrainSampleFormat::Int16) ? sizeof(int16_t) : sizeof(float);
+        }
+
+        bool WriteZeros(std::FILE* InFile, uint64_t InNumBytes)
+        {
+            static const uint8_t Zeros[256] = {};
+            while (InNumBytes > 0)
+            {
+                const size_t Chunk = static_cast<size_t>(std::min<uint64_t>(InNumBytes, sizeof(Zeros)));
+                if (std::fwrite(Zeros, 1, Chunk, InFile) != Chunk)
+                {
+                    return false;
+                }
+                InNumBytes -= Chunk;
+            }
+            return true;
+        }
+
+        class FGrainMappedSourceReader : public IGrainSourceReader
+        {
+        public:
+            FGrainMappedSourceReader(std::shared_ptr<const FGrainMappedFile> InFile, const uint8_t* InSamples, EGrainSampleFormat InFormat,
+                const FGrainSourceInfo& InInfo, int64_t InStartFrame, bool bInLooping)
+                : File(std::move(InFile))
+                , Samples(InSamples)
+                , Format(InFormat)
+                , Info(InInfo)
+                , FramePosition(InStartFrame)
+                , bLooping(bInLooping)
+            {
+            }
+
+            virtual int32_t PopFrames(float* OutInterleaved, int32_t InNumFrames) override
+            {
+                int32_t FramesWritten = 0;
+                while (FramesWritten < InNumFrames)
+                {
+                    if (FramePosition >= Info.NumFrames)
+                    {
+                        if (!bLooping)
+                        {
+                            break;
+                        }
+                        FramePosition = 0;
+                    }
+
+                    const int32_t FramesToCopy = static_cast<int32_t>(std::min<int64_t>(InNumFrames - FramesWritten, Info.NumFrames - FramePosition));
+                    const size_t NumSamples = static_cast<size_t>(FramesToCopy) * Info.NumChannels;
+                    float* Output = OutInterleaved + static_cast<int64_t>(FramesWritten) * Info.NumChannels;
+                    if (Format == EGrainSampleFormat::Int16)
+                    {
+                        ConvertPcm16ToFloat(reinterpret_cast<const int16_t*>(Samples) + FramePosition * Info.NumChannels, Output, NumSamples);
+                    }
+                    else
+                    {
+                        std::memcpy(Output, reinterpret_cast<const float*>(Samples) + FramePosition * Info.NumChannels, NumSamples * sizeof(float));
+                    }
+                    FramesWritten += FramesToCopy;
+                    FramePosition += FramesToCopy;
+                }
+                return FramesWritten;
+            }
+
+            virtual bool Seek(float InStartTimeSeconds, bool bInLooping) override
+            {
+                FramePosition = Info.GetStartFrame(InStartTimeSeconds, bInLooping);
+                bLooping = bInLooping;
+                return true;
+            }
+
+        private:
+            std::shared_ptr<const FGrainMappedFile> File;
+            const uint8_t* Samples = nullptr;
+            EGrainSampleFormat Format = EGrainSampleFormat::Float32;
+            FGrainSourceInfo Info;
+            int64_t FramePosition = 0;
+            bool bLooping = false;
+        };
+    }
+
+    // --- FGrainSourceCacheWriter ---
+
+    FGrainSourceCacheWriter::~FGrainSourceCacheWriter()
+    {
+        Abort();
+    }
+
+    bool FGrainSourceCacheWriter::Begin(const std::string& InPath, int32_t InNumChannels, float InSampleRate, uint64_t InContentHash, EGrainSampleFormat InFormat, std::string& OutError)
+    {
+        Abort();
+
+        Path = InPath;
+        TempPath = InPath + ".tmp";
+        File = std::fopen(TempPath.c_str(), "wb");
+        if (File == nullptr)
+        {
+            OutError = "cannot write '" + TempPath + "'";
+            return false;
+        }
+
+        Header = FGrainSourceCacheHeader();
+        Header.SampleFormat = InFormat;
+        Header.ContentHash = InContentHash;
+        Header.NumChannels = InNumChannels;
+        Header.SampleRate = InSampleRate;
+        Header.DataOffset = FGrainSourceCacheHeader::DataAlignment;
+
+        // The real header is written by Finish(), once the frame count is known
+        if (!GrainSourceCachePrivate::WriteZeros(File, Header.DataOffset))
+        {
+            OutError = "cannot write '" + TempPath + "'";
+            Abort();
+            return false;
+        }
+        return true;
+    }
+
+    bool FGrainSourceCacheWriter::Append(const float* InInterleaved, int32_t InNumFrames, std::string& OutError)
+    {
+        if (File == nullptr || InNumFrames <= 0)
+        {
+            return File != nullptr;
+        }
+
+        const size_t NumSamples = static_cast<size_t>(InNumFrames) * Header.NumChannels;
+        size_t Written = 0;
+        if (Header.SampleFormat == EGrainSampleFormat::Int16)
+        {
+            ConvertScratch.resize(NumSamples);
+            for (size_t Index = 0; Index < NumSamples; ++Index)
+            {
+                const float Scaled = std::round(InInterleaved[Index] * 32768.0f);
+                ConvertScratch[Index] = static_cast<int16_t>(std::clamp(Scaled, -32768.0f, 32767.0f));
+            }
+            Written = std::fwrite(ConvertScratch.data(), sizeof(int16_t), NumSamples, File);
+        }
+        else
+        {
+            Written = std::fwrite(InInterleaved, sizeof(float), NumSamples, File);
+        }
+
+        if (Written != NumSamples)
+        {
+            OutError = "cannot write '" + TempPath + "', disk full?";
+            Abort();
+            return false;
+        }
+        Header.NumFrames += InNumFrames;
+        Header.DataBytes += NumSamples * GrainSourceCachePrivate::GetBytesPerSample(Header.SampleFormat);
+        return true;
+    }
+
+    bool FGrainSourceCacheWriter::Finish(const uint8_t* InAnalysis, size_t InAnalysisBytes, std::string& OutError)
+    {
+        if (File == nullptr)
+        {
+            OutError = "cache file was not started";
+            return false;
+        }
+
+        const uint64_t DataEnd = Header.DataOffset + Header.DataBytes;
+        Header.AnalysisOffset = (DataEnd + 7) & ~static_cast<uint64_t>(7);
+        Header.AnalysisBytes = InAnalysisBytes;
+
+        bool bWritten = GrainSourceCachePrivate::WriteZeros(File, Header.AnalysisOffset - DataEnd)
+            && (InAnalysisBytes == 0 || std::fwrite(InAnalysis, 1, InAnalysisBytes, File) == InAnalysisBytes)
+            && std::fseek(File, 0, SEEK_SET) == 0
+            && std::fwrite(&Header, sizeof(Header), 1, File) == 1;
+        bWritten = (std::fclose(File) == 0) && bWritten;
+        File = nullptr;
+
+        if (!bWritten)
+        {
+            OutError = "cannot write '" + TempPath + "', disk full?";
+            std::remove(TempPath.c_str());
+            return false;
+        }
+
+        // Replace any stale file for the same content hash
+        std::remove(Path.c_str());
+        if (std::rename(TempPath.c_str(), Path.c_str()) != 0)
+        {
+            OutError = "cannot write '" + Path + "'";
+            std::remove(TempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void FGrainSourceCacheWriter::Abort()
+    {
+        if (File)
+        {
+            std::fclose(File);
+            File = nullptr;
+            std::remove(TempPath.c_str());
+        }
+    }
+
+    // --- FGrainMappedSource ---
+
+    std::shared_ptr<FGrainMappedSource> FGrainMappedSource::Open(const std::string& InPath, uint64_t InExpectedContentHash, std::string& OutError)
+    {
+        using namespace GrainSourceCachePrivate;
+
+        std::shared_ptr<FGrainMappedFile> File = std::make_shared<FGrainMappedFile>();
+        if (!File->Open(InPath, OutError))
+        {
+            return nullptr;
+        }
+
+        FGrainSourceCacheHeader Header;
+        if (File->GetSize() < sizeof(Header))
+        {
+            OutError = "'" + InPath + "' is truncated";
+            return nullptr;
+        }
+        std::memcpy(&Header, File->GetData(), sizeof(Header));
+
+        if (std::memcmp(Header.Magic, FGrainSourceCacheHeader().Magic, sizeof(Header.Magic)) != 0 || Header.HeaderBytes != sizeof(Header)
+            || Header.Version != FGrainSourceCacheHeader::CurrentVersion)
+        {
+            OutError = "'" + InPath + "' is not a current Metagrain source cache file";
+            return nullptr;
+        }
+        if (InExpectedContentHash != 0 && Header.ContentHash != InExpectedContentHash)
+        {
+            OutError = "'" + InPath + "' was made from different audio";
+            return nullptr;
+        }
+
+        const size_t BytesPerSample = GetBytesPerSample(Header.SampleFormat);
+        const bool bValidLayout = Header.NumChannels > 0 && Header.NumFrames > 0 && Header.SampleRate > 0.0f
+            && (Header.SampleFormat == EGrainSampleFormat::Float32 || Header.SampleFormat == EGrainSampleFormat::Int16)
+            && Header.DataBytes == static_cast<uint64_t>(Header.NumFrames) * Header.NumChannels * BytesPerSample
+            && Header.DataOffset % FGrainSourceCacheHeader::DataAlignment == 0
+            && Header.DataOffset + Header.DataBytes <= File->GetSize()
+            && Header.AnalysisOffset + Header.AnalysisBytes <= File->GetSize();
+        if (!bValidLayout)
+        {
+            OutError = "'" + InPath + "' is corrupt";
+            return nullptr;
+        }
+
+        std::shared_ptr<FGrainMappedSource> Source = std::make_shared<FGrainMappedSource>();
+        Source->Samples = File->GetData() + Header.DataOffset;
+        Source->DataOffset = Header.DataOffset;
+        Source->SampleFormat = Header.SampleFormat;
+        Source->ContentHash = Header.ContentHash;
+        Source->Info.NumChannels = Header.NumChannels;
+        Source->Info.SampleRate = Header.SampleRate;
+        Source->Info.NumFrames = Header.NumFrames;
+
+        const uint64_t NumGranules = (File->GetSize() + PrefetchGranuleBytes - 1) / PrefetchGranuleBytes;
+        Source->PrefetchStamps.reset(new std::atomic<uint64_t>[static_cast<size_t>(NumGranules)]);
+        for (uint64_t Granule = 0; Granule < NumGranules; ++Granule)
+        {
+            Source->PrefetchStamps[Granule].store(0, std::memory_order_relaxed);
+        }
+
+        if (Header.AnalysisBytes > 0)
+        {
+            // A bad analysis only costs the analysis, the audio is still usable
+            std::string AnalysisError;
+            std::shared_ptr<const FGrainAnalysis> Analysis = FGrainAnalysis::Create(File, File->GetData() + Header.AnalysisOffset, static_cast<size_t>(Header.AnalysisBytes), AnalysisError);
+            if (Analysis && Analysis->Matches(Source->Info))
+            {
+                Source->Analysis = std::move(Analysis);
+            }
+        }
+
+        Source->File = std::move(File);
+        return Source;
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainMappedSource::CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t /*InMaxDecodeSizeInFrames*/)
+    {
+        return std::make_unique<GrainSourceCachePrivate::FGrainMappedSourceReader>(File, Samples, SampleFormat, Info, Info.GetStartFrame(InStartTimeSeconds, bInLooping), bInLooping);
+    }
+
+    void FGrainMappedSource::Prefetch(float InStartSeconds, float InEndSeconds)
+    {
+        const int64_t FirstFrame = std::max<int64_t>(0, static_cast<int64_t>(InStartSeconds * Info.SampleRate));
+        const uint64_t FrameBytes = static_cast<uint64_t>(Info.NumChannels) * GrainSourceCachePrivate::GetBytesPerSample(SampleFormat);
+        const int64_t MaxFrames = std::min<int64_t>(Info.NumFrames, std::max<uint64_t>(1, MaxPrefetchBytes / FrameBytes));
+        const int64_t EndFrame = std::min<int64_t>(FirstFrame + MaxFrames, static_cast<int64_t>(std::ceil(InEndSeconds * Info.SampleRate)));
+        if (EndFrame <= FirstFrame || FirstFrame >= Info.NumFrames)
+        {
+            return;
+        }
+
+        PrefetchFrames(FirstFrame, std::min<int64_t>(EndFrame, Info.NumFrames));
+        if (EndFrame > Info.NumFrames)
+        {
+            PrefetchFrames(0, EndFrame - Info.NumFrames);  // The part looping grains read after wrapping
+        }
+    }
+
+    void FGrainMappedSource::PrefetchFrames(int64_t InFirstFrame, int64_t InEndFrame)
+    {
+        const uint64_t FrameBytes = static_cast<uint64_t>(Info.NumChannels) * GrainSourceCachePrivate::GetBytesPerSample(SampleFormat);
+        const uint64_t FirstGranule = (DataOffset + InFirstFrame * FrameBytes) / PrefetchGranuleBytes;
+        const uint64_t LastGranule = (DataOffset + InEndFrame * FrameBytes - 1) / PrefetchGranuleBytes;
+        const uint64_t DataEnd = DataOffset + static_cast<uint64_t>(Info.NumFrames) * FrameBytes;
+        const uint64_t Hint = NumPrefetchHints.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        // One request per run of granules that need it. Operators racing on a granule at worst both ask for it.
+        uint64_t RunStart = LastGranule + 1;
+        for (uint64_t Granule = FirstGranule; Granule <= LastGranule + 1; ++Granule)
+        {
+            bool bNeeded = false;
+            if (Granule <= LastGranule)
+            {
+                const uint64_t LastHint = PrefetchStamps[Granule].load(std::memory_order_relaxed);
+                bNeeded = LastHint == 0 || Hint - LastHint > PrefetchRefreshHints;
+                if (bNeeded)
+                {
+                    PrefetchStamps[Granule].store(Hint, std::memory_order_relaxed);
+                    RunStart = std::min(RunStart, Granule);
+                }
+            }
+            if (!bNeeded && RunStart <= LastGranule)
+            {
+                const uint64_t Begin = std::max(RunStart * PrefetchGranuleBytes, DataOffset);
+                const uint64_t End = std::min(Granule * PrefetchGranuleBytes, DataEnd);
+                File->Prefetch(static_cast<size_t>(Begin), static_cast<size_t>(End - Begin));
+                NumPrefetchCalls.fetch_add(1, std::memory_order_relaxed);
+                NumPrefetchBytes.fetch_add(End - Begin, std::memory_order_relaxed);
+                RunStart = LastGranule + 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// On-disk cache of a fully decoded grain source. One file holds the interleaved PCM (float or 16-bit) and the
+// source's analysis blob, keyed by the content hash of the audio it was made from. Opening a cache file maps it,
+// so a cached source is ready to play without decoding and its pages are only read as grains touch them.
+//
+// File layout, little endian: FGrainSourceCacheHeader, zero padding up to DataOffset (page aligned), the PCM,
+// then the analysis blob at AnalysisOffset (8-byte aligned, may be empty).
+
+#include "GrainCore.h"
+#include "GrainMappedFile.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+
+namespace Metagrain
+{
+    enum class EGrainSampleFormat : uint32_t
+    {
+        Float32 = 0,
+        Int16 = 1
+    };
+
+    struct FGrainSourceCacheHeader
+    {
+        static constexpr uint32_t CurrentVersion = 1;
+        static constexpr uint64_t DataAlignment = 4096;
+
+        char Magic[4] = { 'M', 'G', 'S', 'C' };
+        uint32_t Version = CurrentVersion;
+        uint32_t HeaderBytes = sizeof(FGrainSourceCacheHeader);
+        EGrainSampleFormat SampleFormat = EGrainSampleFormat::Float32;
+        uint64_t ContentHash = 0;
+        int64_t NumFrames = 0;
+        int32_t NumChannels = 0;
+        float SampleRate = 0.0f;
+        uint64_t DataOffset = 0;
+        uint64_t DataBytes = 0;
+        uint64_t AnalysisOffset = 0;
+        uint64_t AnalysisBytes = 0;
+    };
+
+    // Writes a cache file from audio delivered in chunks. Everything goes to InPath + ".tmp" first and is renamed
+    // into place by Finish(), so a crash or a concurrent reader never sees a half written cache file.
+    class FGrainSourceCacheWriter
+    {
+    public:
+        ~FGrainSourceCacheWriter();
+
+        bool Begin(const std::string& InPath, int32_t InNumChannels, float InSampleRate, uint64_t InContentHash, EGrainSampleFormat InFormat, std::string& OutError);
+
+        // Appends InNumFrames interleaved frames, converted to the cache sample format.
+        bool Append(const float* InInterleaved, int32_t InNumFrames, std::string& OutError);
+
+        // Appends the analysis blob (may be empty), writes the header and moves the file into place.
+        bool Finish(const uint8_t* InAnalysis, size_t InAnalysisBytes, std::string& OutError);
+
+        // Deletes the partial file.
+        void Abort();
+
+    private:
+        std::FILE* File = nullptr;
+        std::string Path;
+        std::string TempPath;
+        FGrainSourceCacheHeader Header;
+        std::vector<int16_t> ConvertScratch;
+    };
+
+    // Grain source reading interleaved PCM straight from a mapped cache file. Memory use follows the working set
+    // of the grains rather than the file size, so sources of many gigabytes play like short ones as long as the
+    // Prefetch hints for the grains being started keep the pages they read resident.
+    class FGrainMappedSource : public IGrainSource
+    {
+    public:
+        // Prefetch hints are rounded out to this granularity, and the OS is only asked about granules not hinted
+        // in the last PrefetchRefreshHints hints, so grains drawn around the same region cost no system call.
+        static constexpr uint64_t PrefetchGranuleBytes = 256 * 1024;
+        static constexpr uint64_t PrefetchRefreshHints = 4096;  // Asked again after that in case the OS dropped the pages
+
+        // No hint covers more than this, however long the grain, so the render thread never asks for a whole file.
+        static constexpr uint64_t MaxPrefetchBytes = 1024 * 1024;
+
+        // Maps InPath and checks its header. Fails if the file is not a cache file or was made from audio with a
+        // different content hash. An expected hash of 0 accepts any file (standalone tools).
+        static std::shared_ptr<FGrainMappedSource> Open(const std::string& InPath, uint64_t InExpectedContentHash, std::string& OutError);
+
+        virtual const FGrainSourceInfo& GetInfo() const override { return Info; }
+        virtual std::unique_ptr<IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override;
+        virtual const FGrainAnalysis* GetAnalysis() const override { return Analysis.get(); }
+        virtual void Prefetch(float InStartSeconds, float InEndSeconds) override;
+
+        // The mapped PCM. Grains reading it in place page it in like readers do, so Prefetch hints still apply.
+        virtual FGrainResidentAudio GetResidentAudio() const override { return { File, Samples, SampleFormat == EGrainSampleFormat::Int16 }; }
+
+        EGrainSampleFormat GetSampleFormat() const { return SampleFormat; }
+        uint64_t GetContentHash() const { return ContentHash; }
+        size_t GetMappedBytes() const { return File->GetSize(); }
+
+        // Running totals of the page-in requests made to the OS, and the bytes they covered.
+        uint64_t GetNumPrefetchCalls() const { return NumPrefetchCalls.load(std::memory_order_relaxed); }
+        uint64_t GetNumPrefetchBytes() const { return NumPrefetchBytes.load(std::memory_order_relaxed); }
+
+    private:
+        // Asks the OS for the granules of [InFirstFrame, InEndFrame) not hinted recently.
+        void PrefetchFrames(int64_t InFirstFrame, int64_t InEndFrame);
+
+        std::shared_ptr<const FGrainMappedFile> File;
+        std::shared_ptr<const FGrainAnalysis> Analysis;
+        const uint8_t* Samples = nullptr;
+        uint64_t DataOffset = 0;
+        std::unique_ptr<std::atomic<uint64_t>[]> PrefetchStamps;  // Per granule of the file, the hint that last asked for it, 0 never
+        std::atomic<uint64_t> NumPrefetchHints{ 0 };               // Shared by every operator on this source
+        std::atomic<uint64_t> NumPrefetchCalls{ 0 };
+        std::atomic<uint64_t> NumPrefetchBytes{ 0 };
+        EGrainSampleFormat SampleFormat = EGrainSampleFormat::Float32;
+        uint64_t ContentHash = 0;
+        FGrainSourceInfo Info;
+    };
+}
@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Profiling scopes for the grain core. Standalone builds compile them away; the plugin module defines
+// METAGRAIN_WITH_UNREAL_TRACE=1 so they show up on the "Metagrain" Unreal Insights channel.
+// This is the only place the core is allowed to reach into engine headers.
+
+#if defined(METAGRAIN_WITH_UNREAL_TRACE) && METAGRAIN_WITH_UNREAL_TRACE
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+UE_TRACE_CHANNEL_EXTERN(MetagrainChannel);
+
+#define METAGRAIN_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("Metagrain::" #Name, MetagrainChannel)
+
+#else
+
+#define METAGRAIN_TRACE_SCOPE(Name)
+
+#endif
@@ -0,0 +1,130 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GrainWaveTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Metagrain
+{
+    namespace GrainWaveTablePrivate
+    {
+        // Voices read tables in place, this reader serves anything else that reads the source. It repeats the table
+        // it starts in, as grains do.
+        class FGrainWaveTableReader : public IGrainSourceReader
+        {
+        public:
+            FGrainWaveTableReader(std::shared_ptr<const std::vector<float>> InSamples, const FGrainSourceInfo& InInfo, int32_t InTableFrames, int64_t InStartFrame)
+                : Samples(std::move(InSamples))
+                , Info(InInfo)
+                , TableFrames(InTableFrames)
+            {
+                SetStartFrame(InStartFrame);
+            }
+
+            virtual int32_t PopFrames(float* OutInterleaved, int32_t InNumFrames) override
+            {
+                int32_t FramesWritten = 0;
+                while (FramesWritten < InNumFrames)
+                {
+                    const int32_t FramesToCopy = std::min(InNumFrames - FramesWritten, TableFrames - Phase);
+                    std::copy_n(Samples->data() + TableStart + Phase, FramesToCopy, OutInterleaved + FramesWritten);
+                    FramesWritten += FramesToCopy;
+                    Phase = (Phase + FramesToCopy) % TableFrames;
+                }
+                return FramesWritten;
+            }
+
+            virtual bool Seek(float InStartTimeSeconds, bool /*bInLooping*/) override
+            {
+                SetStartFrame(Info.GetStartFrame(InStartTimeSeconds, true));
+                return true;
+            }
+
+        private:
+            void SetStartFrame(int64_t InFrame)
+            {
+                InFrame = std::min(InFrame, Info.NumFrames - 1);
+                TableStart = InFrame - InFrame % TableFrames;
+                Phase = static_cast<int32_t>(InFrame - TableStart);
+            }
+
+            std::shared_ptr<const std::vector<float>> Samples;
+            FGrainSourceInfo Info;
+            int32_t TableFrames = 0;
+            int64_t TableStart = 0;
+            int32_t Phase = 0;
+        };
+    }
+
+    FGrainWaveTableSource::FGrainWaveTableSource(int32_t InTableFrames, float InSampleRate)
+        : Samples(std::make_shared<std::vector<float>>())
+        , TableFrames(std::max(1, InTableFrames))
+    {
+        Info.NumChannels = 1;
+        Info.SampleRate = InSampleRate;
+    }
+
+    void FGrainWaveTableSource::AddTable(const float* InSamples, int32_t InNumSamples)
+    {
+        if (!InSamples || InNumSamples <= 0)
+        {
+            return;
+        }
+
+        const size_t TableOffset = Samples->size();
+        Samples->resize(TableOffset + TableFrames);
+        float* Table = Samples->data() + TableOffset;
+        if (InNumSamples == TableFrames)
+        {
+            std::copy_n(InSamples, TableFrames, Table);
+        }
+        else
+        {
+            // Tables are periodic, so the last frame interpolates towards the first
+            const double Step = static_cast<double>(InNumSamples) / TableFrames;
+            for (int32_t Frame = 0; Frame < TableFrames; ++Frame)
+            {
+                const double Position = Frame * Step;
+                const int32_t Index = std::min(static_cast<int32_t>(Position), InNumSamples - 1);
+                const float Alpha = static_cast<float>(Position - Index);
+                const float Next = InSamples[(Index + 1) % InNumSamples];
+                Table[Frame] = InSamples[Index] + Alpha * (Next - InSamples[Index]);
+            }
+        }
+        Info.NumFrames = static_cast<int64_t>(Samples->size());
+    }
+
+    float FGrainWaveTableSource::GetTableStartSeconds(float InTableIndex) const
+    {
+        const float LastTable = static_cast<float>(std::max(0, GetNumTables() - 1));
+        const float TableIndex = std::max(0.0f, std::min(InTableIndex, LastTable));
+        // Half a frame in, so the start time does not round down into the previous table
+        return (TableIndex * static_cast<float>(TableFrames) + 0.5f) / Info.SampleRate;
+    }
+
+    int32_t FGrainWaveTableSource::GetTableIndex(float InStartSeconds) const
+    {
+        const int64_t Frame = Info.GetStartFrame(InStartSeconds, true);
+        return static_cast<int32_t>(std::min<int64_t>(Frame, Info.NumFrames - 1) / TableFrames);
+    }
+
+    float FGrainWaveTableSource::GetFrameRatio(float InFrequencyHz, float InSampleRate) const
+    {
+        return (InSampleRate > 0.0f) ? std::max(0.0f, InFrequencyHz) * static_cast<float>(TableFrames) / InSampleRate : 0.0f;
+    }
+
+    std::unique_ptr<IGrainSourceReader> FGrainWaveTableSource::CreateReader(float InStartTimeSeconds, bool /*bInLooping*/, int32_t /*InMaxDecodeSizeInFrames*/)
+    {
+        if (!Info.IsValid())
+        {
+            return nullptr;
+        }
+        return std::make_unique<GrainWaveTablePrivate::FGrainWaveTableReader>(Samples, Info, TableFrames, Info.GetStartFrame(InStartTimeSeconds, true));
+    }
+
+    FGrainResidentAudio FGrainWaveTableSource::GetResidentAudio() const
+    {
+        return { Samples, Samples->data(), false, TableFrames };
+    }
+}
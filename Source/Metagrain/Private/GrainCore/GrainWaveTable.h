@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Grain source over a bank of wave tables, for tonal granular and pulsar synthesis. The tables sit back to back in
+// one block of mono memory, table k spanning frames [k * TableFrames, (k + 1) * TableFrames). A grain's start time
+// picks its table and the phase it starts at, and its frame ratio the pitch: at ratio 1 a table plays one cycle per
+// TableFrames output frames. Voices read the table in place with a phase accumulator that wraps within it (see
+// FGrainResidentAudio::LoopFrames), so grains on a table need no decoder, reader or source buffer.
+
+#include "GrainCore.h"
+
+#include <memory>
+#include <vector>
+
+namespace Metagrain
+{
+    class FGrainWaveTableSource : public IGrainSource
+    {
+    public:
+        // InSampleRate is the rate the source reports, use the engine's so start times map to whole frames.
+        FGrainWaveTableSource(int32_t InTableFrames, float InSampleRate);
+
+        // Appends a table, linearly resampled to the table length if it has another one. Only call this before the
+        // source is handed to an engine.
+        void AddTable(const float* InSamples, int32_t InNumSamples);
+
+        int32_t GetNumTables() const { return (TableFrames > 0) ? static_cast<int32_t>(Info.NumFrames / TableFrames) : 0; }
+        int32_t GetTableFrames() const { return TableFrames; }
+        float GetTableSeconds() const { return static_cast<float>(TableFrames) / Info.SampleRate; }
+
+        // Start time of table InTableIndex (clamped to the bank), the fraction placing it that far into the table.
+        float GetTableStartSeconds(float InTableIndex) const;
+
+        // Table a grain starting at InStartSeconds plays.
+        int32_t GetTableIndex(float InStartSeconds) const;
+
+        // Frame ratio that plays a table at InFrequencyHz from an engine running at InSampleRate.
+        float GetFrameRatio(float InFrequencyHz, float InSampleRate) const;
+
+        virtual const FGrainSourceInfo& GetInfo() const override { return Info; }
+        virtual std::unique_ptr<IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override;
+        virtual uint64_t GetAllocatedBytes() const override { return Samples->capacity() * sizeof(float); }
+        virtual FGrainResidentAudio GetResidentAudio() const override;
+
+    private:
+        std::shared_ptr<std::vector<float>> Samples;
+        int32_t TableFrames = 0;
+        FGrainSourceInfo Info;
+    };
+}
@@ -0,0 +1,499 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Metagrain.h"
+#include "MetasoundExecutableOperator.h"
+#include "MetasoundPrimitives.h"
+#include "MetasoundNodeRegistrationMacro.h"
+#include "MetasoundFacade.h"
+#include "MetasoundParamHelper.h"
+#include "MetasoundAudioBuffer.h"
+#include "MetasoundTrigger.h"
+#include "MetasoundOperatorSettings.h"
+#include "MetasoundDataReferenceCollection.h"
+#include "MetasoundVertex.h"
+#include "MetasoundNodeInterface.h"
+#include "MetasoundBuilderInterface.h"
+#include "MetasoundLog.h"
+#include "GrainCore/GrainCore.h"            // Engine-independent grain scheduling and rendering
+#include "GrainCore/GrainCapture.h"         // Grain source over a capture ring
+#include "MetagrainTrace.h"                 // Insights scopes and counters
+#include "MetagrainStats.h"                 // stat Metagrain and CSV counters
+#include "MetagrainRealtimeCheck.h"         // Allocation and lock checks around Execute
+#include "MetagrainRecording.h"             // Grain event capture for MetagrainReplay
+#include "Misc/ScopeExit.h"
+
+#define LOCTEXT_NAMESPACE "GranularLiveInputNode"
+
+namespace Metasound
+{
+    namespace GranularLiveInputNode_VertexNames
+    {
+        // Inputs
+        METASOUND_PARAM(InputTriggerPlay, "Play", "Start generating grains.");
+        METASOUND_PARAM(InputTriggerStop, "Stop", "Stop generating grains.");
+        METASOUND_PARAM(InParamAudioIn, "Audio In", "Live audio the grains are read from. It is captured whether or not the node is playing.");
+        METASOUND_PARAM(InParamBufferLength, "Buffer Length (s)", "Seconds of live audio kept for grains to read, which bounds the longest delay. Read when the node is created.");
+        METASOUND_PARAM(InParamDelay, "Delay (ms)", "How far behind the live input grains start reading, in milliseconds. Raised for grains pitched up far enough to catch up with the input, and lowered to what the buffer holds.");
+        METASOUND_PARAM(InParamDelayRand, "Delay Rand (ms)", "Maximum POSITIVE random variation applied to the delay in milliseconds.");
+        METASOUND_PARAM(InParamGrainDuration, "Grain Duration (ms)", "The base duration of each grain in milliseconds.");
+        METASOUND_PARAM(InParamDurationRand, "Duration Rand (ms)", "Maximum POSITIVE random variation applied to the grain duration in milliseconds.");
+        METASOUND_PARAM(InParamActiveVoices, "Active Voices", "Target number of grains overlapping on average. Determines grain density based on duration.");
+        METASOUND_PARAM(InParamTimeJitter, "Time Jitter (%)", "Amount of randomization to apply to the grain spawn interval (0% = no jitter, 100% = interval can vary from 0 to 2x base interval).");
+        METASOUND_PARAM(InParamAttackTimePercent, "Attack", "Attack time as a percentage of grain duration (0.0 - 1.0).");
+        METASOUND_PARAM(InParamDecayTimePercent, "Decay", "Decay time as a percentage of grain duration (0.0 - 1.0).");
+        METASOUND_PARAM(InParamAttackCurve, "Attack Curve", "Attack envelope curve shape exponent.");
+        METASOUND_PARAM(InParamDecayCurve, "Decay Curve", "Decay envelope curve shape exponent.");
+        METASOUND_PARAM(InParamPitchShift, "Pitch Shift (Semi)", "Base pitch shift in semitones.");
+        METASOUND_PARAM(InParamPitchRand, "Pitch Rand (Semi)", "Maximum random pitch variation (+/-) in semitones.");
+        METASOUND_PARAM(InParamPan, "Pan", "Stereo pan position (-1.0 Left to 1.0 Right).");
+        METASOUND_PARAM(InParamPanRand, "Pan Rand", "Maximum random pan variation (+/-) (0.0 to 1.0).");
+        METASOUND_PARAM(InParamVolumeRand, "Volume Rand (%)", "Maximum random volume reduction (0% = full volume, 100% = can be silent).");
+        METASOUND_PARAM(InputWarmStart, "Warm Start", "If true, attempts to trigger multiple grains immediately on play, based on Active Voices count.");
+        METASOUND_PARAM(InputSeed, "Seed", "Random seed used on every Play. The same seed and inputs produce the same grains; 0 picks a new seed each time.");
+
+        // Outputs
+        METASOUND_PARAM(OutputTriggerOnPlay, "On Play", "Triggers when Play is triggered.");
+        METASOUND_PARAM(OutputTriggerOnFinished, "On Finished", "Triggers when Stop is triggered or generation otherwise finishes.");
+        METASOUND_PARAM(OutputTriggerOnGrain, "On Grain", "Triggers when a new grain is successfully started.");
+        METASOUND_PARAM(OutParamAudioLeft, "Out Left", "The left channel audio output.");
+        METASOUND_PARAM(OutParamAudioRight, "Out Right", "The right channel audio output.");
+        METASOUND_PARAM(OutputGrainDelay, "Grain Delay", "How far behind the live input the triggered grain starts (in seconds).");
+        METASOUND_PARAM(OutputGrainDurationSec, "Grain Duration", "The final calculated duration of the triggered grain (in seconds).");
+        METASOUND_PARAM(OutputGrainVolume, "Grain Volume", "The final calculated volume scale (0.0-1.0) of the triggered grain.");
+        METASOUND_PARAM(OutputGrainPitch, "Grain Pitch", "The random pitch offset (in semitones) of the triggered grain.");
+        METASOUND_PARAM(OutputGrainPan, "Grain Pan", "The final calculated stereo pan position (-1.0 to 1.0) of the triggered grain.");
+    }
+
+    // Granular synth over live audio. Every block of Audio In is written into a Metagrain::FGrainCaptureSource ring
+    // the operator allocates up front, and grains read the ring in place a chosen delay behind the input, so a live
+    // source needs no recording, decoder or wave reader, and Play allocates nothing.
+    // Runs the forward synth engine: reversed grains would end at their start point and clamp at the ring's edge
+    // instead of wrapping around it.
+    class FGranularLiveInputOperator : public TExecutableOperator<FGranularLiveInputOperator>
+    {
+        using EngineType = Metagrain::FGranularSynthForwardEngine;
+        static constexpr const TCHAR* OperatorName = TEXT("Granular Synth (Live Input)");
+        static constexpr float MinBufferLengthSeconds = 0.1f;
+        static constexpr float MaxBufferLengthSeconds = 60.0f;
+
+    public:
+        FGranularLiveInputOperator(const FOperatorSettings& InSettings,
+            const FTriggerReadRef& InPlayTrigger,
+            const FTriggerReadRef& InStopTrigger,
+            const FAudioBufferReadRef& InAudioIn,
+            float InBufferLengthSeconds,
+            const FFloatReadRef& InDelayMs,
+            const FFloatReadRef& InDelayRandMs,
+            const FFloatReadRef& InGrainDurationMs,
+            const FFloatReadRef& InDurationRandMs,
+            const FFloatReadRef& InActiveVoices,
+            const FFloatReadRef& InTimeJitter,
+            const FFloatReadRef& InAttackTimePercent,
+            const FFloatReadRef& InDecayTimePercent,
+            const FFloatReadRef& InAttackCurve,
+            const FFloatReadRef& InDecayCurve,
+            const FFloatReadRef& InPitchShift,
+            const FFloatReadRef& InPitchRand,
+            const FFloatReadRef& InPan,
+            const FFloatReadRef& InPanRand,
+            const FFloatReadRef& InVolumeRand,
+            const FBoolReadRef& InWarmStart,
+            const FInt32ReadRef& InSeed
+        )
+            : PlayTrigger(InPlayTrigger)
+            , StopTrigger(InStopTrigger)
+            , AudioInput(InAudioIn)
+            , DelayMsInput(InDelayMs)
+            , DelayRandMsInput(InDelayRandMs)
+            , GrainDurationMsInput(InGrainDurationMs)
+            , DurationRandMsInput(InDurationRandMs)
+            , ActiveVoicesInput(InActiveVoices)
+            , TimeJitterInput(InTimeJitter)
+            , AttackTimePercentInput(InAttackTimePercent)
+            , DecayTimePercentInput(InDecayTimePercent)
+            , AttackCurveInput(InAttackCurve)
+            , DecayCurveInput(InDecayCurve)
+            , PitchShiftInput(InPitchShift)
+            , PitchRandInput(InPitchRand)
+            , PanInput(InPan)
+            , PanRandInput(InPanRand)
+            , VolumeRandInput(InVolumeRand)
+            , WarmStartInput(InWarmStart)
+            , SeedInput(InSeed)
+            , OnPlayTrigger(FTriggerWriteRef::CreateNew(InSettings))
+            , OnFinishedTrigger(FTriggerWriteRef::CreateNew(InSettings))
+            , OnGrainTriggered(FTriggerWriteRef::CreateNew(InSettings))
+            , AudioOutputLeft(FAudioBufferWriteRef::CreateNew(InSettings))
+            , AudioOutputRight(FAudioBufferWriteRef::CreateNew(InSettings))
+            , OutputGrainDelayRef(FFloatWriteRef::CreateNew(0.0f))
+            , OutputGrainDurationSecRef(FFloatWriteRef::CreateNew(0.0f))
+            , OutputGrainVolumeRef(FFloatWriteRef::CreateNew(0.0f))
+            , OutputGrainPitchRef(FFloatWriteRef::CreateNew(0.0f))
+            , OutputGrainPanRef(FFloatWriteRef::CreateNew(0.0f))
+            , SampleRate(InSettings.GetSampleRate())
+            , BlockSize(InSettings.GetNumFramesPerBlock() > 0 ? InSettings.GetNumFramesPerBlock() : 256)
+            , bIsPlaying(false)
+            , BlockWriteFrame(0)
+            , Recording(OperatorName, Metagrain::EGrainRecordNode::Synth, SampleRate, BlockSize, EngineType::MaxGrainVoices)
+            , OperatorStats(OperatorName, SampleRate, BlockSize)
+        {
+            if (InSettings.GetNumFramesPerBlock() <= 0)
+            {
+                UE_LOG(LogMetaSound, Warning, TEXT("GLI Constructor: OperatorSettings provided an invalid BlockSize: %d. Defaulting to 256."), InSettings.GetNumFramesPerBlock());
+            }
+            const float BufferLengthSeconds = FMath::Clamp(InBufferLengthSeconds, MinBufferLengthSeconds, MaxBufferLengthSeconds);
+            Capture = std::make_shared<Metagrain::FGrainCaptureSource>(FMath::CeilToInt32(BufferLengthSeconds * SampleRate), SampleRate);
+
+            Engine.Init(SampleRate, BlockSize);
+            Engine.SetClock(&FPlatformTime::Cycles64);
+            Engine.SetRecorder(Recording.GetRecorder());
+            Engine.SetSource(Capture);
+        }
+
+        static const FVertexInterface& DeclareVertexInterface()
+        {
+            using namespace GranularLiveInputNode_VertexNames;
+            static const FVertexInterface Interface(
+                FInputVertexInterface(
+                    TInputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputTriggerPlay)),
+                    TInputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputTriggerStop)),
+                    TInputDataVertex<FAudioBuffer>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamAudioIn)),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamBufferLength), 4.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDelay), 100.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDelayRand), 500.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamGrainDuration), 100.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDurationRand), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamActiveVoices), 4.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamTimeJitter), 0.0f),
+                    TInputDataVertex<bool>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputWarmStart), false),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamAttackTimePercent), 0.1f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDecayTimePercent), 0.1f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamAttackCurve), 1.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDecayCurve), 1.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamPitchShift), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamPitchRand), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamPan), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamPanRand), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamVolumeRand), 0.0f),
+                    TInputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputSeed), 0)
+                ),
+                FOutputVertexInterface(
+                    TOutputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputTriggerOnPlay)),
+                    TOutputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputTriggerOnFinished)),
+                    TOutputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputTriggerOnGrain)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainDelay)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainDurationSec)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainVolume)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainPitch)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainPan)),
+                    TOutputDataVertex<FAudioBuffer>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutParamAudioLeft)),
+                    TOutputDataVertex<FAudioBuffer>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutParamAudioRight))
+                )
+            );
+            return Interface;
+        }
+
+        static const FNodeClassMetadata& GetNodeInfo()
+        {
+            auto CreateNodeClassMetadata = []() -> FNodeClassMetadata
+                {
+                    FNodeClassMetadata Metadata;
+                    Metadata.ClassName = { FName("GranularSynthLiveInput"), FName(""), FName("Metagrain") };
+                    Metadata.MajorVersion = 0; Metadata.MinorVersion = 1;
+                    Metadata.DisplayName = LOCTEXT("GranularLiveInput_DisplayName", "Granular Synth (Live Input)");
+                    Metadata.Description = LOCTEXT("GranularLiveInput_Description", "Granular synthesizer reading grains from live audio a set delay behind it, for voice chat, buses or in-game instruments");
+                    Metadata.Author = TEXT("Maksym Kokoiev & Wouter Meija");
+                    Metadata.PromptIfMissing = Metasound::PluginNodeMissingPrompt;
+                    Metadata.DefaultInterface = DeclareVertexInterface();
+                    Metadata.CategoryHierarchy = { LOCTEXT("GranularLiveInputCategory", "Synth") };
+                    Metadata.Keywords = TArray<FText>();
+                    return Metadata;
+                };
+            static const FNodeClassMetadata Metadata = CreateNodeClassMetadata();
+            return Metadata;
+        }
+
+        static TUniquePtr<IOperator> CreateOperator(const FBuildOperatorParams& InParams, FBuildResults& OutResults)
+        {
+            using namespace GranularLiveInputNode_VertexNames;
+            const FInputVertexInterfaceData& InputData = InParams.InputData;
+            const FOperatorSettings& Settings = InParams.OperatorSettings;
+            return MakeUnique<FGranularLiveInputOperator>(Settings,
+                InputData.GetOrConstructDataReadReference<FTrigger>(METASOUND_GET_PARAM_NAME(InputTriggerPlay), Settings),
+                InputData.GetOrConstructDataReadReference<FTrigger>(METASOUND_GET_PARAM_NAME(InputTriggerStop), Settings),
+                InputData.GetOrConstructDataReadReference<FAudioBuffer>(METASOUND_GET_PARAM_NAME(InParamAudioIn), Settings),
+                InputData.GetOrCreateDefaultValue<float>(METASOUND_GET_PARAM_NAME(InParamBufferLength), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDelay), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDelayRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamGrainDuration), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDurationRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamActiveVoices), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamTimeJitter), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamAttackTimePercent), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDecayTimePercent), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamAttackCurve), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDecayCurve), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamPitchShift), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamPitchRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamPan), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamPanRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamVolumeRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<bool>(METASOUND_GET_PARAM_NAME(InputWarmStart), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<int32>(METASOUND_GET_PARAM_NAME(InputSeed), Settings));
+        }
+
+        virtual void BindInputs(FInputVertexInterfaceData& InOutVertexData) override
+        {
+            using namespace GranularLiveInputNode_VertexNames;
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputTriggerPlay), PlayTrigger);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputTriggerStop), StopTrigger);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamAudioIn), AudioInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDelay), DelayMsInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDelayRand), DelayRandMsInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamGrainDuration), GrainDurationMsInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDurationRand), DurationRandMsInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamActiveVoices), ActiveVoicesInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamTimeJitter), TimeJitterInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamAttackTimePercent), AttackTimePercentInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDecayTimePercent), DecayTimePercentInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamAttackCurve), AttackCurveInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDecayCurve), DecayCurveInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamPitchShift), PitchShiftInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamPitchRand), PitchRandInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamPan), PanInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamPanRand), PanRandInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamVolumeRand), VolumeRandInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputWarmStart), WarmStartInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputSeed), SeedInput);
+        }
+
+        virtual void BindOutputs(FOutputVertexInterfaceData& InOutVertexData) override
+        {
+            using namespace GranularLiveInputNode_VertexNames;
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputTriggerOnPlay), OnPlayTrigger);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputTriggerOnFinished), OnFinishedTrigger);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputTriggerOnGrain), OnGrainTriggered);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutParamAudioLeft), AudioOutputLeft);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutParamAudioRight), AudioOutputRight);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainDelay), OutputGrainDelayRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainDurationSec), OutputGrainDurationSecRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainVolume), OutputGrainVolumeRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainPitch), OutputGrainPitchRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainPan), OutputGrainPanRef);
+        }
+        virtual FDataReferenceCollection GetInputs() const override
+        {
+            using namespace GranularLiveInputNode_VertexNames;
+            FDataReferenceCollection InputDataReferences;
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputTriggerPlay), PlayTrigger);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputTriggerStop), StopTrigger);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamAudioIn), AudioInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDelay), DelayMsInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDelayRand), DelayRandMsInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamGrainDuration), GrainDurationMsInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDurationRand), DurationRandMsInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamActiveVoices), ActiveVoicesInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamTimeJitter), TimeJitterInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamAttackTimePercent), AttackTimePercentInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDecayTimePercent), DecayTimePercentInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamAttackCurve), AttackCurveInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDecayCurve), DecayCurveInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamPitchShift), PitchShiftInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamPitchRand), PitchRandInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamPan), PanInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamPanRand), PanRandInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamVolumeRand), VolumeRandInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputWarmStart), WarmStartInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputSeed), SeedInput);
+            return InputDataReferences;
+        }
+        virtual FDataReferenceCollection GetOutputs() const override
+        {
+            using namespace GranularLiveInputNode_VertexNames;
+            FDataReferenceCollection OutputDataReferences;
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputTriggerOnPlay), OnPlayTrigger);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputTriggerOnFinished), OnFinishedTrigger);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputTriggerOnGrain), OnGrainTriggered);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutParamAudioLeft), AudioOutputLeft);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutParamAudioRight), AudioOutputRight);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainDelay), OutputGrainDelayRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainDurationSec), OutputGrainDurationSecRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainVolume), OutputGrainVolumeRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainPitch), OutputGrainPitchRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainPan), OutputGrainPanRef);
+            return OutputDataReferences;
+        }
+
+        void Execute()
+        {
+            METAGRAIN_TRACE_SCOPE(GranularLiveInput_Execute);
+            SCOPE_CYCLE_COUNTER(STAT_MetagrainExecute);
+            FMetagrainRealtimeScope RealtimeScope(OperatorName, Engine.GetVoicePool());
+            ExecuteTimer.Begin();
+            ON_SCOPE_EXIT { OperatorStats.Report(Engine.GetStats(), bIsPlaying, ExecuteTimer.End()); };
+
+            // Capture first, so grains starting this block can read it. Delays count from the head before the
+            // write, which keeps every grain behind the audio captured by the time it plays.
+            BlockWriteFrame = Capture->GetWriteFrame();
+            Capture->Write(AudioInput->GetData(), FMath::Min(AudioInput->Num(), BlockSize));
+
+            OnPlayTrigger->AdvanceBlock();
+            OnFinishedTrigger->AdvanceBlock();
+            OnGrainTriggered->AdvanceBlock();
+            Engine.ClearSpawnEvents();
+
+            int32 LastPlayFrame = -1;
+            for (int32 Frame : PlayTrigger->GetTriggeredFrames())
+            {
+                LastPlayFrame = Frame;
+                StartPlayback(Frame);
+            }
+            PublishSpawnEvents();
+
+            for (int32 Frame : StopTrigger->GetTriggeredFrames())
+            {
+                if (bIsPlaying && Frame > LastPlayFrame)
+                {
+                    bIsPlaying = false;
+                    Engine.Stop(Frame);
+                    OnFinishedTrigger->TriggerFrame(Frame);
+                    break;
+                }
+            }
+            ExecuteTimer.Switch(EMetagrainPhase::Other);
+
+            if (!bIsPlaying && !Engine.IsReleasing())
+            {
+                AudioOutputLeft->Zero(); AudioOutputRight->Zero();
+                return;
+            }
+
+            Engine.Process(GetEngineParams(), AudioOutputLeft->GetData(), AudioOutputRight->GetData());
+            ExecuteTimer.AddEngineTimings(Engine.GetLastBlockTimings());
+            PublishSpawnEvents();
+        }
+
+        void Reset(const IOperator::FResetParams& InParams)
+        {
+            Engine.Reset();
+            Engine.SetSource(Capture);
+            Capture->Clear();
+            BlockWriteFrame = 0;
+            AudioOutputLeft->Zero();
+            AudioOutputRight->Zero();
+
+            OnPlayTrigger->Reset();
+            OnFinishedTrigger->Reset();
+            OnGrainTriggered->Reset();
+
+            *OutputGrainDelayRef = 0.0f;
+            *OutputGrainDurationSecRef = 0.0f;
+            *OutputGrainVolumeRef = 0.0f;
+            *OutputGrainPitchRef = 0.0f;
+            *OutputGrainPanRef = 0.0f;
+
+            bIsPlaying = false;
+        }
+
+    private:
+        // Delay and Delay Rand become a start window behind the head, kept within the delays the ring can serve for
+        // the longest and the fastest and slowest grains these inputs allow (see FGrainCaptureSource::GetDelayLimits).
+        Metagrain::FGranularSynthParams GetEngineParams() const
+        {
+            Metagrain::FGranularSynthParams Params;
+            Params.GrainDurationMs = *GrainDurationMsInput;
+            Params.DurationRandMs = *DurationRandMsInput;
+            Params.ActiveVoices = *ActiveVoicesInput;
+            Params.TimeJitterPercent = *TimeJitterInput;
+            Params.AttackPercent = *AttackTimePercentInput;
+            Params.DecayPercent = *DecayTimePercentInput;
+            Params.AttackCurve = *AttackCurveInput;
+            Params.DecayCurve = *DecayCurveInput;
+            Params.PitchShiftSemitones = *PitchShiftInput;
+            Params.PitchRandSemitones = *PitchRandInput;
+            Params.Pan = *PanInput;
+            Params.PanRand = *PanRandInput;
+            Params.VolumeRandPercent = *VolumeRandInput;
+            Params.bWarmStart = *WarmStartInput;
+
+            const float MaxPitch = EngineType::MaxAbsPitchShiftSemitones;
+            const float PitchRand = FMath::Abs(*PitchRandInput);
+            const float MinFrameRatio = FMath::Pow(2.0f, FMath::Clamp(*PitchShiftInput - PitchRand, -MaxPitch, MaxPitch) / 12.0f);
+            const float MaxFrameRatio = FMath::Pow(2.0f, FMath::Clamp(*PitchShiftInput + PitchRand, -MaxPitch, MaxPitch) / 12.0f);
+            const float MaxGrainSeconds = (FMath::Max(0.0f, *GrainDurationMsInput) + FMath::Max(0.0f, *DurationRandMsInput)) / 1000.0f;
+
+            float MinDelaySeconds = 0.0f;
+            float MaxDelaySeconds = 0.0f;
+            Capture->GetDelayLimits(MaxGrainSeconds, MinFrameRatio, MaxFrameRatio, BlockSize, MinDelaySeconds, MaxDelaySeconds);
+            const float DelaySeconds = FMath::Clamp(*DelayMsInput / 1000.0f, MinDelaySeconds, MaxDelaySeconds);
+            const float DelayRandSeconds = FMath::Clamp(*DelayRandMsInput / 1000.0f, 0.0f, MaxDelaySeconds - DelaySeconds);
+
+            Params.StartPointSeconds = Capture->GetStartSeconds(BlockWriteFrame, DelaySeconds + DelayRandSeconds);
+            Params.StartPointRandMs = DelayRandSeconds * 1000.0f;
+            return Params;
+        }
+
+        void PublishSpawnEvents()
+        {
+            for (const Metagrain::FGrainSpawnEvent& Event : Engine.GetSpawnEvents())
+            {
+                *OutputGrainDelayRef = Capture->GetDelaySeconds(BlockWriteFrame, Event.StartTimeSeconds) + Event.FrameInBlock / SampleRate;
+                *OutputGrainDurationSecRef = Event.DurationSeconds;
+                *OutputGrainVolumeRef = Event.Volume;
+                *OutputGrainPitchRef = Event.PitchSemitones;
+                *OutputGrainPanRef = Event.Pan;
+                OnGrainTriggered->TriggerFrame(Event.FrameInBlock);
+            }
+            Engine.ClearSpawnEvents();
+        }
+
+        // The capture ring is the source from construction on, so Play has nothing to load and cannot fail.
+        void StartPlayback(int32 InFrame)
+        {
+            METAGRAIN_TRACE_SCOPE(GranularLiveInput_PlayTrigger);
+            bIsPlaying = true;
+            OnPlayTrigger->TriggerFrame(InFrame);
+            Engine.GetRandom().Seed(*SeedInput != 0 ? static_cast<uint32>(*SeedInput) : FPlatformTime::Cycles());
+            Engine.Start(GetEngineParams(), InFrame);
+        }
+
+        // Input ReadRefs
+        FTriggerReadRef PlayTrigger; FTriggerReadRef StopTrigger; FAudioBufferReadRef AudioInput;
+        FFloatReadRef DelayMsInput; FFloatReadRef DelayRandMsInput;
+        FFloatReadRef GrainDurationMsInput; FFloatReadRef DurationRandMsInput; FFloatReadRef ActiveVoicesInput; FFloatReadRef TimeJitterInput;
+        FFloatReadRef AttackTimePercentInput; FFloatReadRef DecayTimePercentInput; FFloatReadRef AttackCurveInput; FFloatReadRef DecayCurveInput;
+        FFloatReadRef PitchShiftInput; FFloatReadRef PitchRandInput; FFloatReadRef PanInput; FFloatReadRef PanRandInput; FFloatReadRef VolumeRandInput;
+        FBoolReadRef WarmStartInput; FInt32ReadRef SeedInput;
+
+        // Output WriteRefs
+        FTriggerWriteRef OnPlayTrigger; FTriggerWriteRef OnFinishedTrigger; FTriggerWriteRef OnGrainTriggered;
+        FAudioBufferWriteRef AudioOutputLeft; FAudioBufferWriteRef AudioOutputRight;
+        FFloatWriteRef OutputGrainDelayRef;
+        FFloatWriteRef OutputGrainDurationSecRef;
+        FFloatWriteRef OutputGrainVolumeRef;
+        FFloatWriteRef OutputGrainPitchRef;
+        FFloatWriteRef OutputGrainPanRef;
+
+        // Operator State
+        float SampleRate; int32 BlockSize;
+        bool bIsPlaying;
+        int64 BlockWriteFrame;  // Capture write head at the start of this block, which grain delays count from
+        std::shared_ptr<Metagrain::FGrainCaptureSource> Capture;  // Also held by the engine
+        FMetagrainOperatorRecording Recording;  // Declared before Engine, so it is written after the engine is gone
+        EngineType Engine;
+        FMetagrainOperatorStats OperatorStats;
+        FMetagrainExecuteTimer ExecuteTimer;
+    };
+
+    class FGranularLiveInputNode : public FNodeFacade
+    {
+    public:
+        FGranularLiveInputNode(const FNodeInitData& InitData)
+            : FNodeFacade(InitData.InstanceName, InitData.InstanceID, TFacadeOperatorClass<FGranularLiveInputOperator>())
+        {
+        }
+    };
+
+    METASOUND_REGISTER_NODE(FGranularLiveInputNode)
+}
+#undef LOCTEXT_NAMESPACE
@@ -17,15 +17,16 @@
 #include "MetasoundNodeInterface.h"
 #include "MetasoundBuilderInterface.h"
 #include "MetasoundLog.h"
-#include "DSP/Dsp.h"
-#include "DSP/FloatArrayMath.h"
-#include "DSP/MultichannelLinearResampler.h"
-#include "DSP/ConvertDeinterleave.h"
-#include "DSP/MultichannelBuffer.h"
-#include "DSP/BufferVectorOperations.h"
 #include "Containers/Array.h"
 #include "Sound/SoundWaveProxyReader.h"
-#include "AudioDevice.h"
+#include "GrainCore/GrainCore.h"
+#include "WaveProxyGrainSource.h"
+#include "MetagrainTrace.h"
+#include "MetagrainStats.h"
+#include "MetagrainRealtimeCheck.h"
+#include "MetagrainRecording.h"
+#include "MetagrainSourceCache.h"
+#include "Misc/ScopeExit.h"
 #include "Internationalization/Text.h"
 #include "UObject/NameTypes.h"
 #include "Math/UnrealMathUtility.h"
@@ -71,6 +72,7 @@ namespace Metasound
         METASOUND_PARAM(InParamGrainDensity, "Grain Density", "Number of simultaneous grain voices (1-32). Higher values create thicker, smoother textures.");
         METASOUND_PARAM(InParamWindowShape, "Window Shape", "Grain window function (0=Linear, 1=Parabolic, 2=Gaussian, 3=Cosine, 4=Hann, 5=Blackman, 6=Triangular, 7=Rectangular).");
         METASOUND_PARAM(InParamXfadeCurve, "Crossfade Type", "Controls grain envelope crossfade type (0=Linear, 1=Equal Power, 2=Smooth).");
+        METASOUND_PARAM(InParamSeed, "Seed", "Random seed used on every Play. The same seed and inputs produce the same grains; 0 picks a new seed each time.");
 
         // Output parameters
         METASOUND_PARAM(OutputTriggerOnPlay, "On Play", "Triggered when playback starts.");
@@ -81,50 +83,9 @@ namespace Metasound
         METASOUND_PARAM(OutParamTime, "Time", "Current playback position as time value.");
     }
 
-    // --- Grain Voice Structure ---
-    struct FWavePlayerSmoothGrainVoice
-    {
-        TUniquePtr<FSoundWaveProxyReader> Reader;
-        TUniquePtr<Audio::FMultichannelLinearResampler> Resampler;
-        Audio::FMultichannelCircularBuffer SourceCircularBuffer;
-        bool bIsActive = false;
-        int32 NumChannels = 0;
-        int32 SamplesRemaining = 0;
-        int32 SamplesPlayed = 0;
-        int32 TotalGrainSamples = 0;
-        float PanPosition = 0.0f;
-        float VolumeScale = 1.0f;
-        
-        Audio::FAlignedFloatBuffer InterleavedReadBuffer;
-        Audio::FAlignedFloatBuffer EnvelopedMonoBuffer;
-        
-        // Add fields for improved grain processing
-        float PhaseOffset = 0.0f;     // For phase alignment between grains
-        float EnvelopeCurve = 1.0f;   // Dynamic curve adjustment
-        float SmoothingAmount = 0.0f; // Per-grain smoothing 
-    };
-
     // --- Operator ---
     class FGranularWavePlayerSmoothOperator : public TExecutableOperator<FGranularWavePlayerSmoothOperator>
     {
-        static constexpr int32 MaxGrainVoices = 32;
-        static constexpr float MinGrainDurationSeconds = 0.005f;
-        static constexpr float MaxAbsPitchShiftSemitones = 60.0f;
-        static constexpr int32 DeinterleaveBlockSizeFrames = 256;
-
-        // --- Define envelope shape constants ---
-        enum class EGrainWindowShape : uint8
-        {
-            Linear = 0,
-            Parabolic = 1,
-            Gaussian = 2, 
-            Cosine = 3,
-            Hann = 4,
-            Blackman = 5,
-            Triangular = 6,
-            Rectangular = 7
-        };
-
     public:
         // --- Constructor ---
         FGranularWavePlayerSmoothOperator(const FOperatorSettings& InSettings,
@@ -152,7 +113,8 @@ namespace Metasound
             const FFloatReadRef& InPlayRange,
             const FInt32ReadRef& InGrainDensity,
             const FInt32ReadRef& InWindowShape,
-            const FInt32ReadRef& InXfadeCurve)
+            const FInt32ReadRef& InXfadeCurve,
+            const FInt32ReadRef& InSeed)
             : PlayTrigger(InPlayTrigger)
             , StopTrigger(InStopTrigger)
             , WaveAssetInput(InWaveAsset)
@@ -178,6 +140,7 @@ namespace Metasound
             , GrainDensityInput(InGrainDensity)
             , WindowShapeInput(InWindowShape)
             , XfadeCurveInput(InXfadeCurve)
+            , SeedInput(InSeed)
             , OnPlayTrigger(FTriggerWriteRef::CreateNew(InSettings))
             , OnFinishedTrigger(FTriggerWriteRef::CreateNew(InSettings))
             , OnGrainTriggered(FTriggerWriteRef::CreateNew(InSettings))
@@ -187,25 +150,12 @@ namespace Metasound
             , SampleRate(InSettings.GetSampleRate())
             , BlockSize(InSettings.GetNumFramesPerBlock())
             , bIsPlaying(false)
+            , Recording(TEXT("Granular Wave Player Smooth"), Metagrain::EGrainRecordNode::Smooth, SampleRate, BlockSize, Metagrain::FGranularSmoothEngine::MaxGrainVoices)
+            , OperatorStats(TEXT("Granular Wave Player Smooth"), SampleRate, BlockSize)
         {
-            GrainVoices.SetNum(MaxGrainVoices);
-            for (FWavePlayerSmoothGrainVoice& Voice : GrainVoices)
-            {
-                Voice.InterleavedReadBuffer.SetNumUninitialized(DeinterleaveBlockSizeFrames * 2);
-                Voice.EnvelopedMonoBuffer.SetNumUninitialized(BlockSize);
-                Audio::SetMultichannelCircularBufferCapacity(2, DeinterleaveBlockSizeFrames + BlockSize * 4, Voice.SourceCircularBuffer);
-            }
-            SamplesUntilNextGrain = 0.0f;
-            CachedSoundWaveDuration = 0.0f;
-            DeinterleavedSourceBuffer.SetNum(2);
-            Audio::SetMultichannelBufferSize(2, DeinterleaveBlockSizeFrames, DeinterleavedSourceBuffer);
-            
-            // Initialize the smoothing filter for reducing transients
-            for (int32 i = 0; i < 2; ++i)
-            {
-                EnvelopeBuffer[i].SetNumZeroed(BlockSize);
-                PrevGrainValue[i] = 0.0f;
-            }
+            Engine.Init(SampleRate, BlockSize);
+            Engine.SetClock(&FPlatformTime::Cycles64);
+            Engine.SetRecorder(Recording.GetRecorder());
         }
 
         // --- Metasound Node Interface ---
@@ -245,7 +195,8 @@ namespace Metasound
                     // Int parameters grouped together
                     TInputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamGrainDensity), 8),
                     TInputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamWindowShape), 0),
-                    TInputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamXfadeCurve), 1)
+                    TInputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamXfadeCurve), 1),
+                    TInputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamSeed), 0)
                 ),
                 FOutputVertexInterface(
                     TOutputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputTriggerOnPlay)),
@@ -265,7 +216,7 @@ namespace Metasound
                 {
                     FNodeClassMetadata Metadata;
                     Metadata.ClassName = { FName("GranularWavePlayerSmooth"), FName(""), FName("") };
-                    Metadata.MajorVersion = 1; Metadata.MinorVersion = 0;
+                    Metadata.MajorVersion = 1; Metadata.MinorVersion = 1;
                     Metadata.DisplayName = LOCTEXT("GranularWavePlayerSmooth_DisplayName", "Granular Wave Player Smooth");
                     Metadata.Description = LOCTEXT("GranularWavePlayerSmooth_Description", "Granular wave player optimized for smooth pad-like textures");
                     Metadata.Author = TEXT("Maksym Kokoiev & Wouter Meija");
@@ -313,6 +264,7 @@ namespace Metasound
             FInt32ReadRef GrainDensityIn = InputData.GetOrCreateDefaultDataReadReference<int32>(METASOUND_GET_PARAM_NAME(InParamGrainDensity), InParams.OperatorSettings);
             FInt32ReadRef WindowShapeIn = InputData.GetOrCreateDefaultDataReadReference<int32>(METASOUND_GET_PARAM_NAME(InParamWindowShape), InParams.OperatorSettings);
             FInt32ReadRef XfadeCurveIn = InputData.GetOrCreateDefaultDataReadReference<int32>(METASOUND_GET_PARAM_NAME(InParamXfadeCurve), InParams.OperatorSettings);
+            FInt32ReadRef SeedIn = InputData.GetOrCreateDefaultDataReadReference<int32>(METASOUND_GET_PARAM_NAME(InParamSeed), InParams.OperatorSettings);
             
             return MakeUnique<FGranularWavePlayerSmoothOperator>(InParams.OperatorSettings, 
                 PlayTriggerIn, StopTriggerIn, WaveAssetIn, 
@@ -320,7 +272,7 @@ namespace Metasound
                 StartPointRandIn, DurationRandIn, AttackTimePercentIn, DecayTimePercentIn, 
                 AttackCurveIn, DecayCurveIn, PitchShiftIn, PitchRandIn, PanIn, PanRandIn,
                 TimeJitterIn, VolumeRandIn, SmoothingIn, GrainOverlapIn, PlayRangeIn,
-                GrainDensityIn, WindowShapeIn, XfadeCurveIn);
+                GrainDensityIn, WindowShapeIn, XfadeCurveIn, SeedIn);
         }
 
         // --- Metasound Node Interface ---
@@ -354,6 +306,7 @@ namespace Metasound
             InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamGrainDensity), GrainDensityInput);
             InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamWindowShape), WindowShapeInput);
             InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamXfadeCurve), XfadeCurveInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamSeed), SeedInput);
         }
         
         virtual void BindOutputs(FOutputVertexInterfaceData& InOutVertexData) override
@@ -397,6 +350,7 @@ namespace Metasound
             InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamGrainDensity), GrainDensityInput);
             InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamWindowShape), WindowShapeInput);
             InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamXfadeCurve), XfadeCurveInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamSeed), SeedInput);
             
             return InputDataReferences;
         }
@@ -417,35 +371,25 @@ namespace Metasound
         // --- Execution ---
         void Execute()
         {
+            METAGRAIN_TRACE_SCOPE(GranularSmooth_Execute);
+            SCOPE_CYCLE_COUNTER(STAT_MetagrainExecute);
+            FMetagrainRealtimeScope RealtimeScope(TEXT("Granular Wave Player Smooth"), Engine.GetVoicePool());
+            ExecuteTimer.Begin();
+            ON_SCOPE_EXIT { OperatorStats.Report(Engine.GetStats(), bIsPlaying, ExecuteTimer.End()); };
+
             // Advance output triggers
             OnPlayTrigger->AdvanceBlock();
             OnFinishedTrigger->AdvanceBlock();
             OnGrainTriggered->AdvanceBlock();
+            Engine.ClearSpawnEvents();
 
-            bool bTriggeredStopThisBlock = false;
-            int32 StopFrame = -1;
-
-            // Check Stop trigger first
-            for (int32 Frame : StopTrigger->GetTriggeredFrames())
-            {
-                if (bIsPlaying)
-                {
-                    bTriggeredStopThisBlock = true;
-                    StopFrame = Frame;
-                    UE_LOG(LogMetaSound, VeryVerbose, TEXT("GWP: Stop Trigger received at frame %d."), Frame);
-                    break;
-                }
-            }
-
-            // Check Play trigger
+            // Triggers take effect at their frame: Play releases the previous grains there, and a Stop after the
+            // last Play stops spawning there and lets the playing grains fade out
+            int32 LastPlayFrame = -1;
             for (int32 Frame : PlayTrigger->GetTriggeredFrames())
             {
-                bool bStartSuccess = TryStartPlayback(Frame);
-                if (bStartSuccess)
-                {
-                    bTriggeredStopThisBlock = false; // Play overrides stop
-                }
-                else
+                LastPlayFrame = Frame;
+                if (!TryStartPlayback(Frame))
                 {
                     // TryStartPlayback failed (e.g., no valid wave).
                     // Ensure we are stopped and trigger OnFinished.
@@ -457,550 +401,93 @@ namespace Metasound
                 }
             }
 
-            // Handle stop triggered earlier if not overridden by a successful play
-            if (bTriggeredStopThisBlock)
+            for (int32 Frame : StopTrigger->GetTriggeredFrames())
             {
-                if (bIsPlaying)
+                if (bIsPlaying && Frame > LastPlayFrame)
                 {
+                    UE_LOG(LogMetaSound, VeryVerbose, TEXT("GWP: Stop Trigger received at frame %d."), Frame);
                     bIsPlaying = false;
-                    ResetVoices();
-                    OnFinishedTrigger->TriggerFrame(StopFrame);
+                    Engine.Stop(Frame);
+                    OnFinishedTrigger->TriggerFrame(Frame);
+                    break;
                 }
             }
+            ExecuteTimer.Switch(EMetagrainPhase::Other);
 
-            // If not playing after trigger checks, output silence and return
-            if (!bIsPlaying)
+            // If neither playing nor releasing after trigger checks, output silence and return. The source and its
+            // pooled readers stay for the next Play, unless the wave changed meanwhile.
+            if (!bIsPlaying && !Engine.IsReleasing())
             {
                 AudioOutputLeft->Zero();
                 AudioOutputRight->Zero();
                 *TimeOutput = FTime::FromSeconds(0.0); 
-                if (CurrentWaveProxy.IsValid() || CurrentNumChannels > 0 || ConvertDeinterleave.IsValid())
+                if (CurrentWaveProxy.IsValid() && CurrentWaveProxy != WaveAssetInput->GetSoundWaveProxy())
                 {
-                    ResetVoices();
-                    CurrentWaveProxy.Reset();
-                    CachedSoundWaveDuration = 0.0f;
-                    CurrentNumChannels = 0;
-                    ConvertDeinterleave.Reset();
+                    ReleaseWaveData();
                 }
                 return;
             }
 
-            // --- Playing State Logic ---
+            // --- Playing (or Releasing) State Logic ---
 
             // --- Check Current Wave Asset Validity ---
             if (!CurrentWaveProxy.IsValid())
             {
-                UE_LOG(LogMetaSound, Error, TEXT("GWP: Invalid CurrentWaveProxy despite bIsPlaying=true. Stopping."));
-                ResetVoices(); bIsPlaying = false; OnFinishedTrigger->TriggerFrame(0);
-                AudioOutputLeft->Zero(); AudioOutputRight->Zero(); return;
+                UE_LOG(LogMetaSound, Error, TEXT("GWP: Invalid CurrentWaveProxy while playing. Stopping."));
+                StopWithSilence();
+                return;
             }
 
             // --- Handle Wave Asset Change ---
-            bool bWaveJustChanged = false;
             const FSoundWaveProxyPtr InputProxy = WaveAssetInput->GetSoundWaveProxy();
-            if (InputProxy.IsValid() && CurrentWaveProxy != InputProxy)
+            if (bIsPlaying && InputProxy.IsValid() && CurrentWaveProxy != InputProxy)
             {
-                UE_LOG(LogMetaSound, Log, TEXT("GWP: Wave Asset Changed during playback block. Re-initializing."));
-                bWaveJustChanged = true;
-                if (!InitializeWaveData(InputProxy))
+                if (!UpdateWaveSwap(InputProxy))
                 {
-                    ResetVoices(); bIsPlaying = false; OnFinishedTrigger->TriggerFrame(0);
-                    AudioOutputLeft->Zero(); AudioOutputRight->Zero(); return;
+                    StopWithSilence();
+                    return;
                 }
             }
             else if (!InputProxy.IsValid() && CurrentWaveProxy.IsValid())
             {
                 UE_LOG(LogMetaSound, Warning, TEXT("GWP: Wave Asset Input became invalid during playback. Stopping."));
-                ResetVoices(); bIsPlaying = false; OnFinishedTrigger->TriggerFrame(0);
-                AudioOutputLeft->Zero(); AudioOutputRight->Zero(); return;
+                StopWithSilence();
+                return;
             }
 
             // --- Final Sanity Checks ---
-            if (CurrentNumChannels <= 0 || !ConvertDeinterleave.IsValid() || CachedSoundWaveDuration <= 0.0f)
+            if (!Engine.HasValidSource())
             {
                 UE_LOG(LogMetaSound, Error, TEXT("GWP: Invalid state after wave check/re-init. Stopping."));
-                ResetVoices(); bIsPlaying = false; OnFinishedTrigger->TriggerFrame(0);
-                AudioOutputLeft->Zero(); AudioOutputRight->Zero(); return;
-            }
-
-            // --- Get Input Values ---
-            const float BaseGrainDurationSeconds = FMath::Max(MinGrainDurationSeconds, *GrainDurationMsInput / 1000.0f);
-            const float MaxDurationRandSeconds = FMath::Max(0.0f, *DurationRandMsInput / 1000.0f);
-            const float GrainsPerSec = FMath::Max(0.1f, *GrainsPerSecondInput);
-            const float SamplesPerGrainInterval = (GrainsPerSec > 0.0f) ? (SampleRate / GrainsPerSec) : TNumericLimits<float>::Max();
-            
-            // Get
-            const float PlaybackSpeed = FMath::Clamp(*PlaybackSpeedInput, 0.0f, 800.0f) / 100.0f;
-            const bool bFreezed = FMath::IsNearlyZero(PlaybackSpeed, 0.001f);
-
-            // Add all the missing parameter definitions here
-            const int32 DesiredGrainDensity = FMath::Clamp(*GrainDensityInput, 1, MaxGrainVoices);
-            const float TimeJitterMs = FMath::Max(0.0f, *TimeJitterInput);
-            const int32 WindowShapeIndex = FMath::Clamp(*WindowShapeInput, 0, 7);
-            const EGrainWindowShape GrainWindowShape = static_cast<EGrainWindowShape>(WindowShapeIndex);
-            const float VolumeRandPercent = FMath::Clamp(*VolumeRandInput, 0.0f, 100.0f);
-            const float Smoothing = FMath::Clamp(*SmoothingInput, 0.0f, 100.0f) / 100.0f;
-            const float GrainOverlap = FMath::Clamp(*GrainOverlapInput, 1.0f, 5.0f);
-            const int32 XfadeCurveIndex = FMath::Clamp(*XfadeCurveInput, 0, 2);
-            const float PlayRangeMs = FMath::Max(1.0f, *PlayRangeInput); // Ensure positive value
-            const float PlayRangeSeconds = PlayRangeMs / 1000.0f;
-            
-            // Detect changes in freeze state (for optimization purposes)
-            const bool bFreezeStateChanged = bFreezed != bPreviousFreezeState;
-            bPreviousFreezeState = bFreezed;
-            
-            // When freeze state changes, handle it smoothly without resetting voices
-            if (bFreezeStateChanged && bIsPlaying)
-            {
-                // Don't reset voices, just reset grain timing for immediate new grains
-                SamplesUntilNextGrain = 0.0f;
-                
-                UE_LOG(LogMetaSound, Log, TEXT("GWP: PlaybackSpeed is now %s - Smooth transition"), 
-                    bFreezed ? TEXT("ZERO (freeze mode)") : TEXT("PLAYING"));
-                
-                // When freezing, store position exactly where we are
-                if (bFreezed)
-                {
-                    // No need to modify position - it will be used as is
-                    UE_LOG(LogMetaSound, Verbose, TEXT("GWP: Freezing at position: %.2f sec"), 
-                        CurrentPlaybackPositionSeconds);
-                }
-            }
-
-            // Calculate position differently based on speed
-            float PositionInSeconds;
-            if (bFreezed)
-            {
-                // When speed is 0, use the PlayPosition parameter
-                const float PlayPosition = FMath::Clamp(*PlayPositionInput, 0.0f, 100.0f) / 100.0f;
-                const float MaxValidPosition = FMath::Max(0.0f, CachedSoundWaveDuration - (BaseGrainDurationSeconds + MaxDurationRandSeconds));
-                const float SafePlayPosition = FMath::Min(PlayPosition, MaxValidPosition / CachedSoundWaveDuration);
-                
-                // Calculate position in seconds
-                float NewPositionInSeconds = SafePlayPosition * CachedSoundWaveDuration;
-                
-                // Check if position has changed significantly
-                // But don't reset voices - just update the target position for smooth transition
-                if (FMath::Abs(NewPositionInSeconds - CurrentPlaybackPositionSeconds) > 0.01f) // More sensitive threshold
-                {
-                    // Only reset grain timing, not the voices
-                    SamplesUntilNextGrain = 0.0f;
-                    
-                    // Log position change for debugging
-                    UE_LOG(LogMetaSound, Verbose, TEXT("GWP: Position changed in freeze mode: %.2f -> %.2f"), 
-                        CurrentPlaybackPositionSeconds, NewPositionInSeconds);
-                }
-                
-                PositionInSeconds = NewPositionInSeconds;
-                CurrentPlaybackPositionSeconds = NewPositionInSeconds;
-            }
-            else
-            {
-                // In normal playback mode, advance position based on speed
-                float BlockDurationSeconds = static_cast<float>(BlockSize) / SampleRate;
-                
-                // If we just transitioned from freeze to normal, don't advance position yet
-                if (!bFreezeStateChanged)
-                {
-                    CurrentPlaybackPositionSeconds += (BlockDurationSeconds * PlaybackSpeed);
-                }
-                
-                // Wrap around if we reach the end of the file
-                if (CurrentPlaybackPositionSeconds >= CachedSoundWaveDuration && CachedSoundWaveDuration > 0.0f)
-                {
-                    CurrentPlaybackPositionSeconds = FMath::Fmod(CurrentPlaybackPositionSeconds, CachedSoundWaveDuration);
-                }
-                
-                PositionInSeconds = CurrentPlaybackPositionSeconds;
-            }
-
-            // UPDATE THE TIME OUTPUT - add this line right after calculating position
-            *TimeOutput = FTime::FromSeconds(CurrentPlaybackPositionSeconds);
-            
-            // Use position as base start point
-            const float BaseStartPointSeconds = FMath::Max(0.0f, PositionInSeconds);
-            
-            // Calculate the effective end point depending on the wave duration
-            const float BaseEndPointSeconds = CachedSoundWaveDuration;
-            const float MaxStartPointRandSeconds = FMath::Max(0.0f, *StartPointRandMsInput / 1000.0f);
-            const float AttackPercent = FMath::Clamp(*AttackTimePercentInput, 0.0f, 1.0f);
-            const float DecayPercent = FMath::Clamp(*DecayTimePercentInput, 0.0f, 1.0f);
-            const float ClampedDecayPercent = FMath::Min(DecayPercent, 1.0f - AttackPercent);
-            const float AttackCurveFactor = FMath::Max(UE_SMALL_NUMBER, *AttackCurveInput);
-            const float DecayCurveFactor = FMath::Max(UE_SMALL_NUMBER, *DecayCurveInput);
-            
-            // Apply playback speed to the pitch shift
-            const float BasePitchShiftSemitones = FMath::Clamp(*PitchShiftInput, -MaxAbsPitchShiftSemitones, MaxAbsPitchShiftSemitones);
-            
-            // Use only the pitch parameter for pitch shifting, independent of playback speed
-            const float TotalPitchShift = BasePitchShiftSemitones;
-            const float PitchRandSemitones = FMath::Max(0.0f, *PitchRandInput);
-            
-            const float BasePan = FMath::Clamp(*PanInput, -1.0f, 1.0f);
-            const float PanRandAmount = FMath::Clamp(*PanRandInput, 0.0f, 1.0f);
-
-            // Get Stereo Output Buffers & Zero
-            float* OutputAudioLeftPtr = AudioOutputLeft->GetData();
-            float* OutputAudioRightPtr = AudioOutputRight->GetData();
-            if (!bWaveJustChanged)
-            {
-                FMemory::Memset(OutputAudioLeftPtr, 0, BlockSize * sizeof(float));
-                FMemory::Memset(OutputAudioRightPtr, 0, BlockSize * sizeof(float));
-            }
-
-            // --- Calculate Effective Playback Region ---
-            const float EffectiveEndPointSeconds = (BaseEndPointSeconds <= 0.0f || BaseEndPointSeconds > CachedSoundWaveDuration) ? 
-                CachedSoundWaveDuration : BaseEndPointSeconds;
-            const float ClampedBaseStartPointSeconds = FMath::Min(BaseStartPointSeconds, EffectiveEndPointSeconds - MinGrainDurationSeconds);
-
-            // --- Calculate Valid Start Point Randomization Range ---
-            float PotentialMaxStartTime = ClampedBaseStartPointSeconds + MaxStartPointRandSeconds;
-            float ValidRegionEndTime = FMath::Max(0.0f, EffectiveEndPointSeconds - MinGrainDurationSeconds);
-            float ClampedMaxStartTime = FMath::Clamp(PotentialMaxStartTime, ClampedBaseStartPointSeconds, ValidRegionEndTime);
-            if (ClampedBaseStartPointSeconds > ClampedMaxStartTime) { ClampedMaxStartTime = ClampedBaseStartPointSeconds; }
-
-            // --- Trigger New Grains ---
-            int32 GrainsToTriggerThisBlock = 0;
-            float ElapsedSamples = BlockSize;
-            
-            // Apply time jitter to grain triggering
-            float TimeJitterSamples = (TimeJitterMs / 1000.0f) * SampleRate;
-            
-            // When we just changed freeze state, trigger more grains for smoother transition
-            if (bFreezeStateChanged)
-            {
-                // Force at least 2 grains this block for a smoother transition
-                GrainsToTriggerThisBlock = FMath::Max(2, GrainsToTriggerThisBlock);
-            }
-            else if (SamplesPerGrainInterval > 0.0f && SamplesPerGrainInterval < TNumericLimits<float>::Max())
-            {
-                // Count active voices
-                int32 ActiveVoiceCount = 0;
-                for (const auto& Voice : GrainVoices)
-                {
-                    if (Voice.bIsActive)
-                        ActiveVoiceCount++;
-                }
-                
-                // Trigger more grains if we're under the desired density
-                float TriggerProbability = FMath::Min(1.0f, static_cast<float>(DesiredGrainDensity) / static_cast<float>(MaxGrainVoices));
-
-                while (SamplesUntilNextGrain <= ElapsedSamples) 
-                { 
-                    // Apply random time jitter
-                    if (TimeJitterSamples > 0)
-                        SamplesUntilNextGrain += FMath::RandRange(-TimeJitterSamples, TimeJitterSamples);
-                    
-                    // Only trigger a grain if we have room and probability check passes
-                    if (ActiveVoiceCount < DesiredGrainDensity && FMath::FRand() <= TriggerProbability)
-                    {
-                        GrainsToTriggerThisBlock++; 
-                        ActiveVoiceCount++;
-                    }
-                    SamplesUntilNextGrain += SamplesPerGrainInterval; 
-                }
-                SamplesUntilNextGrain -= ElapsedSamples;
+                StopWithSilence();
+                return;
             }
 
-            // Adjust the grain triggering section to use the correct parameters
-            for (int i = 0; i < GrainsToTriggerThisBlock; ++i)
-            {
-                float GrainStartTimeSeconds;
-                if (bFreezed) {
-                    // In freeze mode, use a window centered on the position with additional bounds checks
-                    const float HalfWindowSizeSeconds = FMath::Min(PlayRangeSeconds * 0.5f, 
-                                                                CachedSoundWaveDuration * 0.5f); // Don't exceed half the file
-                    
-                    // Apply jitter while ensuring we stay within file bounds
-                    GrainStartTimeSeconds = FMath::FRandRange(
-                        FMath::Max(0.0f, PositionInSeconds - HalfWindowSizeSeconds), 
-                        FMath::Min(CachedSoundWaveDuration - MinGrainDurationSeconds, PositionInSeconds + HalfWindowSizeSeconds));
-                        
-                    // Final bounds check (redundant but safe)
-                    GrainStartTimeSeconds = FMath::Clamp(GrainStartTimeSeconds, 
-                                                        0.0f, 
-                                                        CachedSoundWaveDuration - MinGrainDurationSeconds);
-                } 
-                else {
-                    // In normal playback mode, ensure end position is strictly within file boundaries
-                    const float SafeEndPositionSeconds = FMath::Min(
-                        CurrentPlaybackPositionSeconds + PlayRangeSeconds,
-                        CachedSoundWaveDuration - MinGrainDurationSeconds);
-                        
-                    // Get random position between current position and properly bounded end position
-                    GrainStartTimeSeconds = FMath::FRandRange(
-                        CurrentPlaybackPositionSeconds,
-                        SafeEndPositionSeconds);
-                        
-                    // Final bounds check (redundant but safe)
-                    GrainStartTimeSeconds = FMath::Clamp(GrainStartTimeSeconds, 
-                                                       0.0f, 
-                                                       CachedSoundWaveDuration - MinGrainDurationSeconds);
-                }
-                
-                float DurationOffset = FMath::FRandRange(0.0f, MaxDurationRandSeconds);
-                float GrainDurationSeconds = FMath::Max(MinGrainDurationSeconds, BaseGrainDurationSeconds + DurationOffset);
-                int32 GrainDurationSamples = FMath::CeilToInt(GrainDurationSeconds * SampleRate);
-                float PitchOffset = FMath::FRandRange(-PitchRandSemitones, PitchRandSemitones);
-                float TargetPitchShift = FMath::Clamp(TotalPitchShift + PitchOffset, -MaxAbsPitchShiftSemitones, MaxAbsPitchShiftSemitones);
-                
-                // Calculate random volume based on VolumeRandPercent
-                float VolumeScale = 1.0f;
-                if (VolumeRandPercent > 0.0f)
-                {
-                    // Calculate random volume reduction - higher VolumeRandPercent means more potential reduction
-                    // At 100%, volume can range from 0.0 (silent) to 1.0 (full volume)
-                    float MaxVolumeReduction = VolumeRandPercent / 100.0f;
-                    VolumeScale = 1.0f - (FMath::FRand() * MaxVolumeReduction);
-                }
-                
-                // Calculate frame ratio for pitch shifting
-                float FrameRatio = FMath::Abs(FMath::Pow(2.0f, TargetPitchShift / 12.0f));
-
-                float PanOffset = FMath::FRandRange(-PanRandAmount, PanRandAmount);
-                float GrainPanPosition = FMath::Clamp(BasePan + PanOffset, -1.0f, 1.0f);
-
-                
-                // Create a new grain with the calculated parameters
-                // When successful, trigger the OnGrain event at the appropriate frame
-                if (TriggerGrain(CurrentWaveProxy, GrainDurationSamples, GrainStartTimeSeconds, FrameRatio, 
-                                GrainPanPosition, VolumeScale, Smoothing, XfadeCurveIndex))
-                {
-                    // Determine the appropriate frame within the current block for the grain trigger
-                    int32 TriggerFrameInBlock = FMath::Clamp(BlockSize - static_cast<int32>(SamplesUntilNextGrain), 0, BlockSize - 1);
-                    OnGrainTriggered->TriggerFrame(TriggerFrameInBlock);
-                }
-            }
+            Engine.Process(GetEngineParams(), AudioOutputLeft->GetData(), AudioOutputRight->GetData());
+            ExecuteTimer.AddEngineTimings(Engine.GetLastBlockTimings());
 
-            // --- Process active grain voices ---
-            for (FWavePlayerSmoothGrainVoice& Voice : GrainVoices)
+            for (const Metagrain::FGrainSpawnEvent& Event : Engine.GetSpawnEvents())
             {
-                if (Voice.bIsActive)
-                {
-                    if (!Voice.Reader.IsValid() || !Voice.Resampler.IsValid()) { Voice.bIsActive = false; continue; }
-                    const int32 OutputFramesToProcess = FMath::Min(BlockSize, Voice.SamplesRemaining);
-                    if (OutputFramesToProcess <= 0) { Voice.bIsActive = false; Voice.Reader.Reset(); Voice.Resampler.Reset(); continue; }
-                    Voice.EnvelopedMonoBuffer.SetNumUninitialized(OutputFramesToProcess);
-                    float* MonoBufferPtr = Voice.EnvelopedMonoBuffer.GetData();
-                    
-                    Audio::FMultichannelBuffer ResampledOutputBuffer;
-                    Audio::SetMultichannelBufferSize(Voice.NumChannels, OutputFramesToProcess, ResampledOutputBuffer);
-                    
-                    // Process audio for this grain
-                    int32 ActualFramesResampled = ProcessAudioForGrain(Voice, ResampledOutputBuffer, OutputFramesToProcess);
-                    
-                    if (ActualFramesResampled > 0)
-                    {
-                        // Enhanced envelope calculation with smoothing and overlap
-                        for (int32 i = 0; i < ActualFramesResampled; ++i)
-                        {
-                            float MonoSample = 0.0f;
-                            
-                            if (Voice.NumChannels == 1) { 
-                                MonoSample = ResampledOutputBuffer[0][i]; 
-                            }
-                            else if (Voice.NumChannels >= 2) { 
-                                MonoSample = (ResampledOutputBuffer[0][i] + ResampledOutputBuffer[1][i]) * 0.5f; 
-                            }
-                            
-                            // Enhanced envelope calculation
-                            float EnvelopeScale = 1.0f;
-                            const int32 CurrentFrameInGrain = Voice.SamplesPlayed + i;
-                            
-                            // Apply adaptive attack/decay based on grain overlap
-                            // Larger overlap = gentler envelope = smoother transition
-                            const float OverlapCompensation = FMath::Min(1.0f, 1.0f / GrainOverlap);
-                            const float AdaptiveAttackPercent = FMath::Clamp(AttackPercent * OverlapCompensation, 0.05f, 0.95f);
-                            const float AdaptiveDecayPercent = FMath::Clamp(ClampedDecayPercent * OverlapCompensation, 0.05f, 0.95f);
-                            
-                            // Calculate smoothed attack/decay sample positions
-                            const int32 AttackSamples = FMath::CeilToInt(Voice.TotalGrainSamples * AdaptiveAttackPercent);
-                            const int32 DecaySamples = FMath::CeilToInt(Voice.TotalGrainSamples * AdaptiveDecayPercent);
-                            
-                            switch (GrainWindowShape)
-                            {
-                            case EGrainWindowShape::Linear:
-                                // Linear envelope
-                                if (CurrentFrameInGrain < AttackSamples) {
-                                    EnvelopeScale = (AttackSamples > 0) ? static_cast<float>(CurrentFrameInGrain) / AttackSamples : 1.0f;
-                                }
-                                else if (CurrentFrameInGrain >= (Voice.TotalGrainSamples - DecaySamples)) {
-                                    EnvelopeScale = (DecaySamples > 0) ? static_cast<float>(Voice.TotalGrainSamples - CurrentFrameInGrain) / DecaySamples : 0.0f;
-                                }
-                                break;
-                                
-                            case EGrainWindowShape::Parabolic:
-                                // Parabolic envelope (smoother transitions)
-                                if (CurrentFrameInGrain < AttackSamples) {
-                                    float t = (AttackSamples > 0) ? static_cast<float>(CurrentFrameInGrain) / AttackSamples : 1.0f;
-                                    EnvelopeScale = t * t;
-                                }
-                                else if (CurrentFrameInGrain >= (Voice.TotalGrainSamples - DecaySamples)) {
-                                    float t = (DecaySamples > 0) ? static_cast<float>(Voice.TotalGrainSamples - CurrentFrameInGrain) / DecaySamples : 0.0f;
-                                    EnvelopeScale = t * t;
-                                }
-                                break;
-                                
-                            case EGrainWindowShape::Gaussian:
-                                // Enhanced Gaussian with smoothing parameter
-                                {
-                                    // Center is shifted slightly later to reduce attack transients
-                                    const float center = Voice.TotalGrainSamples * (0.5f + Voice.SmoothingAmount * 0.1f);
-                                    const float position = CurrentFrameInGrain;
-                                    // Width is increased with smoothing for gentler attack/decay
-                                    const float width = Voice.TotalGrainSamples * (0.25f + Voice.SmoothingAmount * 0.1f);
-                                    EnvelopeScale = FMath::Exp(-0.5f * FMath::Square((position - center) / width));
-                                }
-                                break;
-                                
-                            case EGrainWindowShape::Cosine:
-                                // Cosine-based envelope (smooth)
-                                {
-                                    const float phase = PI * CurrentFrameInGrain / Voice.TotalGrainSamples;
-                                    EnvelopeScale = 0.5f * (1.0f - FMath::Cos(2.0f * phase));
-                                }
-                                break;
-                                
-                            case EGrainWindowShape::Hann:
-                                // Enhanced Hann with phase smoothing for better grain overlaps
-                                {
-                                    // Apply phase offset for better inter-grain crossfades
-                                    const float phaseOffset = Voice.PhaseOffset * PI * 0.25f;
-                                    const float normalizedPos = static_cast<float>(CurrentFrameInGrain) / Voice.TotalGrainSamples;
-                                    const float phase = PI * normalizedPos + phaseOffset;
-                                    
-                                    // Apply dynamic curve based on crossfade type and smoothing
-                                    switch (XfadeCurveIndex)
-                                    {
-                                        case 0: // Linear
-                                            EnvelopeScale = 0.5f * (1.0f - FMath::Cos(2.0f * phase));
-                                            break;
-                                            
-                                        case 1: // Equal Power
-                                            {
-                                                float sinValue = FMath::Sin(phase);
-                                                EnvelopeScale = sinValue * sinValue;
-                                            }
-                                            break;
-                                            
-                                        case 2: // Smooth
-                                            {
-                                                // S-curve with gentler attack/decay
-                                                float value = 0.5f * (1.0f - FMath::Cos(2.0f * phase));
-                                                // Add smoothing curve response
-                                                EnvelopeScale = FMath::Pow(value, 0.7f + (0.6f * Voice.SmoothingAmount));
-                                            }
-                                            break;
-                                    }
-                                }
-                                break;
-                                
-                            case EGrainWindowShape::Blackman:
-                                // Blackman window: reduced side lobes for better frequency separation
-                                {
-                                    const float x = CurrentFrameInGrain / (float)Voice.TotalGrainSamples;
-                                    const float a0 = 0.42f;
-                                    const float a1 = 0.5f;
-                                    const float a2 = 0.08f;
-                                    EnvelopeScale = a0 - a1 * FMath::Cos(2.0f * PI * x) + a2 * FMath::Cos(4.0f * PI * x);
-                                }
-                                break;
-                                
-                            case EGrainWindowShape::Triangular:
-                                // Triangular window: simple rising and falling ramp
-                                {
-                                    const float x = CurrentFrameInGrain / (float)Voice.TotalGrainSamples;
-                                    EnvelopeScale = 1.0f - FMath::Abs(2.0f * x - 1.0f);
-                                }
-                                break;
-                                
-                            case EGrainWindowShape::Rectangular:
-                                // Rectangular window: make truly rectangular with no fade for clear contrast
-                                EnvelopeScale = 1.0;
-                                break;
-                            }
-                            
-                            // Apply additional envelope softening based on attack/release values
-                            if (Voice.SmoothingAmount > 0.0f && EnvelopeScale > 0.0f && EnvelopeScale < 1.0f)
-                            {
-                                // Reduce the steepness of the envelope for smoother transitions
-                                EnvelopeScale = FMath::Pow(EnvelopeScale, 1.0f - (Voice.SmoothingAmount * 0.3f));
-                            }
-                                
-                            EnvelopeScale = FMath::Clamp(EnvelopeScale, 0.0f, 1.0f);
-                            MonoBufferPtr[i] = MonoSample * EnvelopeScale;
-                        }
-                        
-                        // Apply smooth mixing with equal power crossfading
-                        const float PanAngle = (Voice.PanPosition + 1.0f) * 0.5f * UE_PI * 0.5f;
-                        const float LeftGain = FMath::Cos(PanAngle) * Voice.VolumeScale;
-                        const float RightGain = FMath::Sin(PanAngle) * Voice.VolumeScale;
-                        
-                        // Mix audio with smoother transitions between grains
-                        Audio::ArrayMixIn(TArrayView<const float>(MonoBufferPtr, ActualFramesResampled), 
-                                         TArrayView<float>(OutputAudioLeftPtr, ActualFramesResampled), LeftGain);
-                        Audio::ArrayMixIn(TArrayView<const float>(MonoBufferPtr, ActualFramesResampled), 
-                                         TArrayView<float>(OutputAudioRightPtr, ActualFramesResampled), RightGain);
-                        
-                        // Update voice state after processing
-                        Voice.SamplesPlayed += ActualFramesResampled;
-                        Voice.SamplesRemaining -= ActualFramesResampled;
-                    }
-                    
-                    // Check if grain is finished after processing
-                    if (Voice.SamplesRemaining <= 0) { 
-                        Voice.bIsActive = false; 
-                        Voice.Reader.Reset(); 
-                        Voice.Resampler.Reset(); 
-                    }
-                }
+                OnGrainTriggered->TriggerFrame(Event.FrameInBlock);
             }
+            Engine.ClearSpawnEvents();
 
-            // Add final smoothing pass at the end of Execute if needed
-            if (Smoothing > 0.5f)
-            {
-                // Final pass to reduce any remaining transients
-                for (int32 i = 0; i < BlockSize; ++i)
-                {
-                    // Simple 1-pole low pass filter based on smoothing amount
-                    const float FilterCoeff = FMath::Max(0.1f, 1.0f - (Smoothing * 0.5f));
-                    
-                    // Apply to left channel
-                    EnvelopeBuffer[0][i] = OutputAudioLeftPtr[i] * FilterCoeff + 
-                                       PrevGrainValue[0] * (1.0f - FilterCoeff);
-                    PrevGrainValue[0] = EnvelopeBuffer[0][i];
-                    OutputAudioLeftPtr[i] = EnvelopeBuffer[0][i];
-                    
-                    // Apply to right channel
-                    EnvelopeBuffer[1][i] = OutputAudioRightPtr[i] * FilterCoeff + 
-                                       PrevGrainValue[1] * (1.0f - FilterCoeff);
-                    PrevGrainValue[1] = EnvelopeBuffer[1][i];
-                    OutputAudioRightPtr[i] = EnvelopeBuffer[1][i];
-                }
-            }
-            
-            // One more time in case anything changed the position during processing
-            *TimeOutput = FTime::FromSeconds(CurrentPlaybackPositionSeconds);
+            *TimeOutput = FTime::FromSeconds(Engine.GetPlaybackPositionSeconds());
         }
 
         // --- Reset ---
         void Reset(const IOperator::FResetParams& InParams)
         {
-            ResetVoices();
+            Engine.Reset();
+            CurrentWaveProxy.Reset();
+            PendingWave.reset();
             AudioOutputLeft->Zero();
             AudioOutputRight->Zero();
-            SamplesUntilNextGrain = 0.0f;
-            CurrentWaveProxy.Reset(); CachedSoundWaveDuration = 0.0f; CurrentNumChannels = 0;
-            ConvertDeinterleave.Reset();
+            *TimeOutput = FTime::FromSeconds(0.0);
             OnPlayTrigger->Reset();
             OnFinishedTrigger->Reset();
             OnGrainTriggered->Reset();
             bIsPlaying = false;
-            CurrentPlaybackPositionSeconds = 0.0f;
-            
-            // Reset smoothing parameters
-            PrevGrainValue[0] = 0.0f;
-            PrevGrainValue[1] = 0.0f;
             
             UE_LOG(LogMetaSound, Log, TEXT("Granular Wave Player: Operator Reset."));
         }
@@ -1008,8 +495,49 @@ namespace Metasound
     private:
         // --- Helper Functions ---
 
+        Metagrain::FGranularSmoothParams GetEngineParams() const
+        {
+            Metagrain::FGranularSmoothParams Params;
+            Params.GrainDurationMs = *GrainDurationMsInput;
+            Params.GrainsPerSecond = *GrainsPerSecondInput;
+            Params.PlaybackSpeedPercent = *PlaybackSpeedInput;
+            Params.PlayPositionPercent = *PlayPositionInput;
+            Params.PlayRangeMs = *PlayRangeInput;
+            Params.DurationRandMs = *DurationRandMsInput;
+            Params.AttackPercent = *AttackTimePercentInput;
+            Params.DecayPercent = *DecayTimePercentInput;
+            Params.PitchShiftSemitones = *PitchShiftInput;
+            Params.PitchRandSemitones = *PitchRandInput;
+            Params.Pan = *PanInput;
+            Params.PanRand = *PanRandInput;
+            Params.TimeJitterMs = *TimeJitterInput;
+            Params.VolumeRandPercent = *VolumeRandInput;
+            Params.SmoothingPercent = *SmoothingInput;
+            Params.GrainOverlap = *GrainOverlapInput;
+            Params.GrainDensity = *GrainDensityInput;
+            Params.WindowShape = *WindowShapeInput;
+            Params.XfadeCurve = *XfadeCurveInput;
+            return Params;
+        }
+
+        // Ends playback without a release, for when the wave can no longer be read.
+        void StopWithSilence()
+        {
+            if (bIsPlaying)
+            {
+                OnFinishedTrigger->TriggerFrame(0);
+            }
+            bIsPlaying = false;
+            ReleaseWaveData();
+            AudioOutputLeft->Zero();
+            AudioOutputRight->Zero();
+        }
+
         bool TryStartPlayback(int32 InFrame)
         {
+            METAGRAIN_TRACE_SCOPE(GranularSmooth_PlayTrigger);
+            FMetagrainRealtimeExemption RealtimeExemption; // Play is not steady state: wave init, logging
+
             bool bWasPlayingBeforeAttempt = bIsPlaying;
             bIsPlaying = false; // Assume failure
 
@@ -1021,7 +549,7 @@ namespace Metasound
                 {
                     OnFinishedTrigger->TriggerFrame(InFrame);
                 }
-                ResetVoices(); CurrentWaveProxy.Reset(); CachedSoundWaveDuration = 0.0f; CurrentNumChannels = 0; ConvertDeinterleave.Reset();
+                ReleaseWaveData();
                 return false;
             }
 
@@ -1033,26 +561,27 @@ namespace Metasound
                 {
                     OnFinishedTrigger->TriggerFrame(InFrame);
                 }
-                ResetVoices(); CurrentWaveProxy.Reset(); CachedSoundWaveDuration = 0.0f; CurrentNumChannels = 0; ConvertDeinterleave.Reset();
+                ReleaseWaveData();
                 return false;
             }
 
-            // Initialize or re-initialize wave data
-            if (!InitializeWaveData(SoundWaveProxy))
+            // Initialize wave data, unless this retriggers the same wave: then the source, its pooled readers and
+            // the releasing grains carry over
+            if ((CurrentWaveProxy != SoundWaveProxy || !Engine.HasValidSource()) && !InitializeWaveData(SoundWaveProxy))
             {
                 UE_LOG(LogMetaSound, Error, TEXT("GWP: Play Trigger at frame %d failed: Could not initialize wave data."), InFrame);
                 if (bWasPlayingBeforeAttempt)
                 {
                     OnFinishedTrigger->TriggerFrame(InFrame);
                 }
-                ResetVoices();
+                ReleaseWaveData();
                 return false;
             }
 
             // Success
             bIsPlaying = true;
-            ResetVoices(); // Clear old grains on start/restart
-            SamplesUntilNextGrain = 0.0f;
+            Engine.GetRandom().Seed(*SeedInput != 0 ? static_cast<uint32>(*SeedInput) : FPlatformTime::Cycles());
+            Engine.Start(InFrame); // Old grains fade out from InFrame, new ones start there
             OnPlayTrigger->TriggerFrame(InFrame);
             UE_LOG(LogMetaSound, Log, TEXT("GWP: Playback %s at frame %d."), bWasPlayingBeforeAttempt ? TEXT("Restarted") : TEXT("Started"), InFrame);
             return true;
@@ -1060,230 +589,62 @@ namespace Metasound
 
         bool InitializeWaveData(const FSoundWaveProxyPtr& InSoundWaveProxy)
         {
+            METAGRAIN_TRACE_SCOPE(GranularSmooth_WaveInit);
+            FMetagrainRealtimeExemption RealtimeExemption; // Creating the source reader and its buffers allocates
+            const EMetagrainPhase PreviousPhase = ExecuteTimer.Switch(EMetagrainPhase::WaveInit);
+            ON_SCOPE_EXIT { ExecuteTimer.Switch(PreviousPhase); };
+
+            PendingWave.reset();
             CurrentWaveProxy = InSoundWaveProxy; // Update tracked proxy
 
-            FSoundWaveProxyReader::FSettings TempSettings;
-            auto TempReader = FSoundWaveProxyReader::Create(CurrentWaveProxy.ToSharedRef(), TempSettings);
-            if (TempReader.IsValid())
+            const std::shared_ptr<Metagrain::IGrainSource> Source = MetagrainSourceCache::Resolve(FWaveProxyGrainSource::Create(CurrentWaveProxy));
+            if (!Source || !Engine.SetSource(Source))
             {
-                CachedSoundWaveDuration = (float)TempReader->GetNumFramesInWave() / FMath::Max(1.0f, TempReader->GetSampleRate());
-                CurrentNumChannels = TempReader->GetNumChannels();
-                if (CurrentNumChannels <= 0 || CachedSoundWaveDuration <= 0.0f)
-                {
-                    UE_LOG(LogMetaSound, Error, TEXT("GWP: Wave Asset reports invalid duration (%.2f) or channels (%d)."), CachedSoundWaveDuration, CurrentNumChannels);
-                    CurrentNumChannels = 0; CachedSoundWaveDuration = 0.0f; ConvertDeinterleave.Reset(); return false;
-                }
-                Audio::FConvertDeinterleaveParams ConvertParams;
-                ConvertParams.NumInputChannels = CurrentNumChannels; ConvertParams.NumOutputChannels = CurrentNumChannels;
-                ConvertDeinterleave = Audio::IConvertDeinterleave::Create(ConvertParams);
-                if (!ConvertDeinterleave.IsValid())
-                {
-                    UE_LOG(LogMetaSound, Error, TEXT("GWP: Failed to create deinterleaver for %d channels."), CurrentNumChannels);
-                    CurrentNumChannels = 0; CachedSoundWaveDuration = 0.0f; return false;
-                }
-                Audio::SetMultichannelBufferSize(CurrentNumChannels, DeinterleaveBlockSizeFrames, DeinterleavedSourceBuffer);
-                return true; // Success
-            }
-            else {
-                UE_LOG(LogMetaSound, Error, TEXT("GWP: Failed to create reader for wave asset."));
+                UE_LOG(LogMetaSound, Error, TEXT("GWP: Failed to create grain source for wave asset."));
+                Engine.ClearSource();
                 return false;
             }
+            OperatorStats.SetWaveName(CurrentWaveProxy->GetFName());
+            return true;
         }
 
-        // Process a new grain with the specified parameters
-        bool TriggerGrain(const FSoundWaveProxyPtr& InSoundWaveProxy, int32 InGrainDurationSamples, 
-                float InStartTimeSeconds, float InFrameRatio, float InPanPosition, 
-                float InVolumeScale = 1.0f, float InSmoothingAmount = 0.0f, int32 InXfadeCurveType = 0)
+        void ReleaseWaveData()
         {
-            if (!InSoundWaveProxy.IsValid() || InGrainDurationSamples <= 0 || CurrentNumChannels <= 0) 
-                return false;
-            
-            // Find an available voice
-            int32 VoiceIndex = -1;
-            for (int32 i = 0; i < GrainVoices.Num(); ++i) { 
-                if (!GrainVoices[i].bIsActive) { 
-                    VoiceIndex = i; 
-                    break; 
-                } 
-            }
-            
-            if (VoiceIndex == -1) 
-                return false;
-            
-            FWavePlayerSmoothGrainVoice& NewVoice = GrainVoices[VoiceIndex];
-            
-            // Always clamp start time to valid range
-            InStartTimeSeconds = FMath::Max(0.0f, InStartTimeSeconds);
-            
-            // Make sure we don't go beyond the end of the file
-            const float DurationInSeconds = InGrainDurationSamples / SampleRate;
-            if (InStartTimeSeconds + DurationInSeconds > CachedSoundWaveDuration) {
-                InStartTimeSeconds = FMath::Max(0.0f, CachedSoundWaveDuration - DurationInSeconds);
-                
-                if (InStartTimeSeconds <= 0.0f || DurationInSeconds < MinGrainDurationSeconds)
-                    return false;
-            }
-            
-            // Configure reader settings - always start from normal position
-            FSoundWaveProxyReader::FSettings ReaderSettings;
-            ReaderSettings.StartTimeInSeconds = InStartTimeSeconds;
-            ReaderSettings.bIsLooping = false;
-            
-            // Setup buffer sizes with safe quantization
-            const uint32 MinDecodeSize = 256; // Use a safer minimum size
-            uint32 DesiredDecodeSize = FMath::Max(InGrainDurationSamples, BlockSize * 2);
-            const uint32 DecodeSizeQuantization = 128;
-            uint32 ConformedDecodeSize = ((DesiredDecodeSize + DecodeSizeQuantization - 1) / DecodeSizeQuantization) * DecodeSizeQuantization;
-            ReaderSettings.MaxDecodeSizeInFrames = ConformedDecodeSize;
-            
-            // Create the reader
-            NewVoice.Reader = FSoundWaveProxyReader::Create(InSoundWaveProxy.ToSharedRef(), ReaderSettings);
-            if (!NewVoice.Reader.IsValid()) { 
-                return false; 
-            }
-            
-            // Set up voice
-            NewVoice.NumChannels = CurrentNumChannels;
-            
-            // Create resampler
-            NewVoice.Resampler = MakeUnique<Audio::FMultichannelLinearResampler>(NewVoice.NumChannels);
-            NewVoice.Resampler->SetFrameRatio(FMath::Abs(InFrameRatio), 0);
-            
-            // Prepare buffers
-            NewVoice.InterleavedReadBuffer.SetNumUninitialized(ConformedDecodeSize * NewVoice.NumChannels);
-            NewVoice.EnvelopedMonoBuffer.SetNumUninitialized(BlockSize);
-            NewVoice.SourceCircularBuffer.Empty();
-            Audio::SetMultichannelCircularBufferCapacity(NewVoice.NumChannels, 
-                ConformedDecodeSize + BlockSize * 4, NewVoice.SourceCircularBuffer);
-            
-            // Apply phase alignment and time correction for smoother overlapping 
-            // Only shift if smoothing is requested
-            if (InSmoothingAmount > 0.0f)
-            {
-                // Find zero crossings for optimal grain start to reduce transients
-                const float PhaseRand = FMath::FRand() * 0.05f * InSmoothingAmount;
-                
-                // Small time adjustment based on smoothing amount (0-10ms)
-                float TimeAdjustMs = FMath::FRand() * InSmoothingAmount * 10.0f;  
-                float AdjustedStartTime = InStartTimeSeconds + (TimeAdjustMs / 1000.0f);
-                
-                // Ensure we're still within valid range
-                AdjustedStartTime = FMath::Clamp(AdjustedStartTime, 0.0f, 
-                                      CachedSoundWaveDuration - (InGrainDurationSamples / SampleRate));
-                
-                // Update start time with the adjusted value
-                ReaderSettings.StartTimeInSeconds = AdjustedStartTime;
-                NewVoice.PhaseOffset = PhaseRand; // Store for envelope calculation
-            }
-            
-            // Initialize voice state with enhanced parameters
-            NewVoice.bIsActive = true;
-            NewVoice.SamplesRemaining = InGrainDurationSamples;
-            NewVoice.SamplesPlayed = 0;
-            NewVoice.TotalGrainSamples = InGrainDurationSamples;
-            NewVoice.PanPosition = InPanPosition;
-            NewVoice.VolumeScale = InVolumeScale;
-            NewVoice.SmoothingAmount = InSmoothingAmount;
-            NewVoice.EnvelopeCurve = 1.0f - (InSmoothingAmount * 0.3f); // Flatter curve for smoother transitions
-            
-            return true;
+            FMetagrainRealtimeExemption RealtimeExemption; // Only on stop or wave change, frees the source
+            Engine.ClearSource();
+            CurrentWaveProxy.Reset();
+            PendingWave.reset();
+            OperatorStats.SetWaveName(NAME_None);
         }
 
-        // Modify the ProcessAudioForGrain function to fix variable scope issues
-        int32 ProcessAudioForGrain(FWavePlayerSmoothGrainVoice& Voice, Audio::FMultichannelBuffer& ResampledOutputBuffer, int32 OutputFramesToProcess)
+        // Wave changes during playback swap sources without a voice reset. The new wave's source is prepared in the
+        // background while grains keep drawing from the current one; once it is ready new grains draw from it, and
+        // the grains already playing finish on the old source, which goes away with their readers. Returns false if
+        // the new wave cannot be played.
+        bool UpdateWaveSwap(const FSoundWaveProxyPtr& InWaveProxy)
         {
-            // Basic validation
-            if (!Voice.Reader.IsValid() || !Voice.Resampler.IsValid() || !Voice.bIsActive || OutputFramesToProcess <= 0)
-                return 0;
-            
-            int32 ActualFramesResampled = 0;
-            
-            try {
-                // Standard audio processing
-                int32 InputFramesAvailable = Audio::GetMultichannelBufferNumFrames(Voice.SourceCircularBuffer);
-                int32 InputFramesNeeded = Voice.Resampler->GetNumInputFramesNeededToProduceOutputFrames(OutputFramesToProcess);
-                
-                // Keep reading data as needed
-                if (InputFramesAvailable < InputFramesNeeded) {
-                    int32 BlocksToRead = FMath::CeilToInt((float)(InputFramesNeeded - InputFramesAvailable) / DeinterleaveBlockSizeFrames);
-                    
-                    for (int32 Block = 0; Block < BlocksToRead; ++Block) {
-                        int32 FramesToRead = DeinterleaveBlockSizeFrames;
-                        
-                        if (Voice.InterleavedReadBuffer.Num() < FramesToRead * Voice.NumChannels) {
-                            Voice.InterleavedReadBuffer.SetNumUninitialized(FramesToRead * Voice.NumChannels);
-                        }
-                        
-                        // Create an explicit reference to ensure the compiler recognizes the correct type
-                        Audio::FAlignedFloatBuffer& AlignedBuffer = Voice.InterleavedReadBuffer;
-                        const int32 SamplesRead = Voice.Reader->PopAudio(AlignedBuffer);
-                        
-                        if (SamplesRead <= 0 || Voice.Reader->HasFailed()) {
-                            break;
-                        }
-                        
-                        const int32 FramesRead = SamplesRead / Voice.NumChannels;
-                        
-                        // Deinterleave the audio
-                        Audio::SetMultichannelBufferSize(Voice.NumChannels, FramesRead, DeinterleavedSourceBuffer);
-                        ConvertDeinterleave->ProcessAudio(
-                            TArrayView<const float>(Voice.InterleavedReadBuffer.GetData(), SamplesRead), 
-                            DeinterleavedSourceBuffer
-                        );
-                        
-                        // Push to circular buffer
-                        for (int32 Chan = 0; Chan < Voice.NumChannels; ++Chan) {
-                            int32 PushResult = Voice.SourceCircularBuffer[Chan].Push(DeinterleavedSourceBuffer[Chan].GetData(), FramesRead);
-                            bool bPushSuccess = (PushResult > 0) ? true : false;  // Use explicit conversion
-                        }
-                        
-                        InputFramesAvailable = Audio::GetMultichannelBufferNumFrames(Voice.SourceCircularBuffer);
-                        if (InputFramesAvailable >= InputFramesNeeded) {
-                            break;
-                        }
-                    }
-                }
-                
-                // If there's nothing to process or voice became inactive, exit
-                if (!Voice.bIsActive) {
-                    return 0;
-                }
-                
-                // Now process the audio through the resampler
-                ActualFramesResampled = Voice.Resampler->ProcessAndConsumeAudio(
-                    Voice.SourceCircularBuffer, ResampledOutputBuffer);
+            if (!PendingWave || PendingWave->GetWaveProxy() != InWaveProxy)
+            {
+                FMetagrainRealtimeExemption RealtimeExemption; // Only on wave change, queues the background task
+                UE_LOG(LogMetaSound, Log, TEXT("GWP: Wave Asset changed to %s, preparing it while the current wave plays."), *InWaveProxy->GetFName().ToString());
+                PendingWave = MetagrainSourceCache::PrepareAsync(InWaveProxy);
+                return true;
             }
-            catch (...) {
-                // Catch any unexpected exceptions - fail gracefully
-                UE_LOG(LogMetaSound, Error, TEXT("GWP: Exception during grain processing. Voice deactivated."));
-                Voice.bIsActive = false;
-                return 0;
+            if (!PendingWave->IsReady())
+            {
+                return true;
             }
-            
-            return ActualFramesResampled;
-        }
 
-        void ResetVoices()
-        {
-            for (FWavePlayerSmoothGrainVoice& Voice : GrainVoices)
+            FMetagrainRealtimeExemption RealtimeExemption; // Frees the old source's pooled readers
+            const std::shared_ptr<FMetagrainPreparedSource> Prepared = MoveTemp(PendingWave);
+            if (!Prepared->GetSource() || !Engine.SetSource(Prepared->GetSource()))
             {
-                Voice.bIsActive = false; 
-                Voice.NumChannels = 0; 
-                Voice.SamplesRemaining = 0;
-                Voice.SamplesPlayed = 0; 
-                Voice.TotalGrainSamples = 0; 
-                Voice.PanPosition = 0.0f;
-                Voice.VolumeScale = 1.0f;
-                
-                // Reset the smooth grain voice specific fields
-                Voice.PhaseOffset = 0.0f;
-                Voice.EnvelopeCurve = 1.0f;
-                Voice.SmoothingAmount = 0.0f;
-                
-                Voice.Reader.Reset(); 
-                Voice.Resampler.Reset(); 
-                Voice.SourceCircularBuffer.Empty();
+                UE_LOG(LogMetaSound, Error, TEXT("GWP: Failed to create grain source for wave asset %s."), *InWaveProxy->GetFName().ToString());
+                return false;
             }
+            CurrentWaveProxy = InWaveProxy;
+            OperatorStats.SetWaveName(CurrentWaveProxy->GetFName());
+            return true;
         }
 
         // --- Input Parameter References ---
@@ -1316,6 +677,7 @@ namespace Metasound
         FInt32ReadRef GrainDensityInput;
         FInt32ReadRef WindowShapeInput;
         FInt32ReadRef XfadeCurveInput;
+        FInt32ReadRef SeedInput;
         
         // --- Output Parameter References ---
         FTriggerWriteRef OnPlayTrigger;
@@ -1331,20 +693,12 @@ namespace Metasound
 
         // --- Internal State ---
         bool bIsPlaying;
-        bool bPreviousFreezeState = false;  // Keep to detect changes in freeze state
-        float SamplesUntilNextGrain;
-        TArray<FWavePlayerSmoothGrainVoice> GrainVoices;
         FSoundWaveProxyPtr CurrentWaveProxy;
-        float CachedSoundWaveDuration;
-        int32 CurrentNumChannels;
-        TUniquePtr<Audio::IConvertDeinterleave> ConvertDeinterleave;
-        Audio::FMultichannelBuffer DeinterleavedSourceBuffer;
-
-        float CurrentPlaybackPositionSeconds = 0.0f; // Tracks actual playback position
-
-        // Add smoothing-related members
-        Audio::FAlignedFloatBuffer EnvelopeBuffer[2];
-        float PrevGrainValue[2];
+        std::shared_ptr<FMetagrainPreparedSource> PendingWave;  // Wave swap in preparation, see UpdateWaveSwap
+        FMetagrainOperatorRecording Recording;  // Declared before Engine, so it is written after the engine is gone
+        Metagrain::FGranularSmoothEngine Engine;
+        FMetagrainOperatorStats OperatorStats;
+        FMetagrainExecuteTimer ExecuteTimer;
     };
 
     // --- Node ---
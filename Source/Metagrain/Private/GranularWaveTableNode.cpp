@@ -0,0 +1,577 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Metagrain.h"
+#include "MetasoundExecutableOperator.h"
+#include "MetasoundPrimitives.h"
+#include "MetasoundNodeRegistrationMacro.h"
+#include "MetasoundFacade.h"
+#include "MetasoundParamHelper.h"
+#include "MetasoundAudioBuffer.h"
+#include "MetasoundTrigger.h"
+#include "MetasoundOperatorSettings.h"
+#include "MetasoundDataReferenceCollection.h"
+#include "MetasoundVertex.h"
+#include "MetasoundNodeInterface.h"
+#include "MetasoundBuilderInterface.h"
+#include "MetasoundLog.h"
+#include "MetasoundWaveTable.h"             // For FWaveTableBankAsset
+#include "WaveTableBank.h"                  // For FWaveTableBankAssetProxy
+#include "GrainCore/GrainCore.h"            // Engine-independent grain scheduling and rendering
+#include "GrainCore/GrainWaveTable.h"       // Grain source over wave tables
+#include "MetagrainTrace.h"                 // Insights scopes and counters
+#include "MetagrainStats.h"                 // stat Metagrain and CSV counters
+#include "MetagrainRealtimeCheck.h"         // Allocation and lock checks around Execute
+#include "MetagrainRecording.h"             // Grain event capture for MetagrainReplay
+#include "Misc/ScopeExit.h"
+
+#define LOCTEXT_NAMESPACE "GranularWaveTableNode"
+
+namespace Metasound
+{
+    namespace GranularWaveTableNode_VertexNames
+    {
+        // Inputs
+        METASOUND_PARAM(InputTriggerPlay, "Play", "Start generating grains.");
+        METASOUND_PARAM(InputTriggerStop, "Stop", "Stop generating grains.");
+        METASOUND_PARAM(InParamWaveTableBank, "WaveTable Bank", "The bank of wave tables grains are read from.");
+        METASOUND_PARAM(InParamTableIndex, "Table Index", "Table grains read from. Between two tables, grains pick one of them with odds set by the fraction, which morphs the cloud from one to the other.");
+        METASOUND_PARAM(InParamIndexRand, "Index Rand", "Number of tables above Table Index grains may pick from at random.");
+        METASOUND_PARAM(InParamFrequency, "Frequency (Hz)", "Frequency the tables are played at.");
+        METASOUND_PARAM(InParamPitchRand, "Pitch Rand (Semi)", "Maximum random pitch variation (+/-) in semitones.");
+        METASOUND_PARAM(InParamGrainDuration, "Grain Duration (ms)", "The base duration of each grain in milliseconds.");
+        METASOUND_PARAM(InParamDurationRand, "Duration Rand (ms)", "Maximum POSITIVE random variation applied to the grain duration in milliseconds.");
+        METASOUND_PARAM(InParamActiveVoices, "Active Voices", "Target number of grains overlapping on average. Determines grain density based on duration.");
+        METASOUND_PARAM(InParamTimeJitter, "Time Jitter (%)", "Amount of randomization to apply to the grain spawn interval (0% = no jitter, 100% = interval can vary from 0 to 2x base interval).");
+        METASOUND_PARAM(InParamAttackTimePercent, "Attack", "Attack time as a percentage of grain duration (0.0 - 1.0).");
+        METASOUND_PARAM(InParamDecayTimePercent, "Decay", "Decay time as a percentage of grain duration (0.0 - 1.0).");
+        METASOUND_PARAM(InParamAttackCurve, "Attack Curve", "Attack envelope curve shape exponent.");
+        METASOUND_PARAM(InParamDecayCurve, "Decay Curve", "Decay envelope curve shape exponent.");
+        METASOUND_PARAM(InParamPan, "Pan", "Stereo pan position (-1.0 Left to 1.0 Right).");
+        METASOUND_PARAM(InParamPanRand, "Pan Rand", "Maximum random pan variation (+/-) (0.0 to 1.0).");
+        METASOUND_PARAM(InParamVolumeRand, "Volume Rand (%)", "Maximum random volume reduction (0% = full volume, 100% = can be silent).");
+        METASOUND_PARAM(InputWarmStart, "Warm Start", "If true, attempts to trigger multiple grains immediately on play, based on Active Voices count.");
+        METASOUND_PARAM(InputSeed, "Seed", "Random seed used on every Play. The same seed and inputs produce the same grains; 0 picks a new seed each time.");
+
+        // Outputs
+        METASOUND_PARAM(OutputTriggerOnPlay, "On Play", "Triggers when Play is triggered.");
+        METASOUND_PARAM(OutputTriggerOnFinished, "On Finished", "Triggers when Stop is triggered or generation otherwise finishes.");
+        METASOUND_PARAM(OutputTriggerOnGrain, "On Grain", "Triggers when a new grain is successfully started.");
+        METASOUND_PARAM(OutParamAudioLeft, "Out Left", "The left channel audio output.");
+        METASOUND_PARAM(OutParamAudioRight, "Out Right", "The right channel audio output.");
+        METASOUND_PARAM(OutputGrainTable, "Grain Table", "The table the triggered grain reads.");
+        METASOUND_PARAM(OutputGrainDurationSec, "Grain Duration", "The final calculated duration of the triggered grain (in seconds).");
+        METASOUND_PARAM(OutputGrainVolume, "Grain Volume", "The final calculated volume scale (0.0-1.0) of the triggered grain.");
+        METASOUND_PARAM(OutputGrainPitch, "Grain Pitch", "The random pitch offset (in semitones) of the triggered grain.");
+        METASOUND_PARAM(OutputGrainPan, "Grain Pan", "The final calculated stereo pan position (-1.0 to 1.0) of the triggered grain.");
+    }
+
+    // Granular synth over a WaveTable bank. The bank's tables are copied into one Metagrain::FGrainWaveTableSource
+    // on Play, grains then read them in place at the Frequency input, with no decoder, wave reader or file I/O.
+    // Runs the forward synth engine: a reversed single-cycle table is just another table.
+    class FGranularWaveTableOperator : public TExecutableOperator<FGranularWaveTableOperator>
+    {
+        using EngineType = Metagrain::FGranularSynthForwardEngine;
+        static constexpr const TCHAR* OperatorName = TEXT("Granular Synth (WaveTable)");
+
+    public:
+        FGranularWaveTableOperator(const FOperatorSettings& InSettings,
+            const FTriggerReadRef& InPlayTrigger,
+            const FTriggerReadRef& InStopTrigger,
+            const FWaveTableBankAssetReadRef& InWaveTableBank,
+            const FFloatReadRef& InTableIndex,
+            const FFloatReadRef& InIndexRand,
+            const FFloatReadRef& InFrequency,
+            const FFloatReadRef& InPitchRand,
+            const FFloatReadRef& InGrainDurationMs,
+            const FFloatReadRef& InDurationRandMs,
+            const FFloatReadRef& InActiveVoices,
+            const FFloatReadRef& InTimeJitter,
+            const FFloatReadRef& InAttackTimePercent,
+            const FFloatReadRef& InDecayTimePercent,
+            const FFloatReadRef& InAttackCurve,
+            const FFloatReadRef& InDecayCurve,
+            const FFloatReadRef& InPan,
+            const FFloatReadRef& InPanRand,
+            const FFloatReadRef& InVolumeRand,
+            const FBoolReadRef& InWarmStart,
+            const FInt32ReadRef& InSeed
+        )
+            : PlayTrigger(InPlayTrigger)
+            , StopTrigger(InStopTrigger)
+            , WaveTableBankInput(InWaveTableBank)
+            , TableIndexInput(InTableIndex)
+            , IndexRandInput(InIndexRand)
+            , FrequencyInput(InFrequency)
+            , PitchRandInput(InPitchRand)
+            , GrainDurationMsInput(InGrainDurationMs)
+            , DurationRandMsInput(InDurationRandMs)
+            , ActiveVoicesInput(InActiveVoices)
+            , TimeJitterInput(InTimeJitter)
+            , AttackTimePercentInput(InAttackTimePercent)
+            , DecayTimePercentInput(InDecayTimePercent)
+            , AttackCurveInput(InAttackCurve)
+            , DecayCurveInput(InDecayCurve)
+            , PanInput(InPan)
+            , PanRandInput(InPanRand)
+            , VolumeRandInput(InVolumeRand)
+            , WarmStartInput(InWarmStart)
+            , SeedInput(InSeed)
+            , OnPlayTrigger(FTriggerWriteRef::CreateNew(InSettings))
+            , OnFinishedTrigger(FTriggerWriteRef::CreateNew(InSettings))
+            , OnGrainTriggered(FTriggerWriteRef::CreateNew(InSettings))
+            , AudioOutputLeft(FAudioBufferWriteRef::CreateNew(InSettings))
+            , AudioOutputRight(FAudioBufferWriteRef::CreateNew(InSettings))
+            , OutputGrainTableRef(FInt32WriteRef::CreateNew(0))
+            , OutputGrainDurationSecRef(FFloatWriteRef::CreateNew(0.0f))
+            , OutputGrainVolumeRef(FFloatWriteRef::CreateNew(0.0f))
+            , OutputGrainPitchRef(FFloatWriteRef::CreateNew(0.0f))
+            , OutputGrainPanRef(FFloatWriteRef::CreateNew(0.0f))
+            , SampleRate(InSettings.GetSampleRate())
+            , BlockSize(InSettings.GetNumFramesPerBlock() > 0 ? InSettings.GetNumFramesPerBlock() : 256)
+            , bIsPlaying(false)
+            , Recording(OperatorName, Metagrain::EGrainRecordNode::Synth, SampleRate, BlockSize, EngineType::MaxGrainVoices)
+            , OperatorStats(OperatorName, SampleRate, BlockSize)
+        {
+            if (InSettings.GetNumFramesPerBlock() <= 0)
+            {
+                UE_LOG(LogMetaSound, Warning, TEXT("GWT Constructor: OperatorSettings provided an invalid BlockSize: %d. Defaulting to 256."), InSettings.GetNumFramesPerBlock());
+            }
+            Engine.Init(SampleRate, BlockSize);
+            Engine.SetClock(&FPlatformTime::Cycles64);
+            Engine.SetRecorder(Recording.GetRecorder());
+        }
+
+        static const FVertexInterface& DeclareVertexInterface()
+        {
+            using namespace GranularWaveTableNode_VertexNames;
+            static const FVertexInterface Interface(
+                FInputVertexInterface(
+                    TInputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputTriggerPlay)),
+                    TInputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputTriggerStop)),
+                    TInputDataVertex<FWaveTableBankAsset>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamWaveTableBank)),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamTableIndex), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamIndexRand), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamFrequency), 220.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamPitchRand), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamGrainDuration), 50.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDurationRand), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamActiveVoices), 4.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamTimeJitter), 0.0f),
+                    TInputDataVertex<bool>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputWarmStart), false),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamAttackTimePercent), 0.1f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDecayTimePercent), 0.1f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamAttackCurve), 1.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamDecayCurve), 1.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamPan), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamPanRand), 0.0f),
+                    TInputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(InParamVolumeRand), 0.0f),
+                    TInputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(InputSeed), 0)
+                ),
+                FOutputVertexInterface(
+                    TOutputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputTriggerOnPlay)),
+                    TOutputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputTriggerOnFinished)),
+                    TOutputDataVertex<FTrigger>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputTriggerOnGrain)),
+                    TOutputDataVertex<int32>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainTable)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainDurationSec)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainVolume)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainPitch)),
+                    TOutputDataVertex<float>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutputGrainPan)),
+                    TOutputDataVertex<FAudioBuffer>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutParamAudioLeft)),
+                    TOutputDataVertex<FAudioBuffer>(METASOUND_GET_PARAM_NAME_AND_METADATA(OutParamAudioRight))
+                )
+            );
+            return Interface;
+        }
+
+        static const FNodeClassMetadata& GetNodeInfo()
+        {
+            auto CreateNodeClassMetadata = []() -> FNodeClassMetadata
+                {
+                    FNodeClassMetadata Metadata;
+                    Metadata.ClassName = { FName("GranularSynthWaveTable"), FName(""), FName("Metagrain") };
+                    Metadata.MajorVersion = 0; Metadata.MinorVersion = 1;
+                    Metadata.DisplayName = LOCTEXT("GranularWaveTable_DisplayName", "Granular Synth (WaveTable)");
+                    Metadata.Description = LOCTEXT("GranularWaveTable_Description", "Granular synthesizer reading grains from a WaveTable bank at a set frequency, for tonal granular and pulsar textures");
+                    Metadata.Author = TEXT("Maksym Kokoiev & Wouter Meija");
+                    Metadata.PromptIfMissing = Metasound::PluginNodeMissingPrompt;
+                    Metadata.DefaultInterface = DeclareVertexInterface();
+                    Metadata.CategoryHierarchy = { LOCTEXT("GranularWaveTableCategory", "Synth") };
+                    Metadata.Keywords = TArray<FText>();
+                    return Metadata;
+                };
+            static const FNodeClassMetadata Metadata = CreateNodeClassMetadata();
+            return Metadata;
+        }
+
+        static TUniquePtr<IOperator> CreateOperator(const FBuildOperatorParams& InParams, FBuildResults& OutResults)
+        {
+            using namespace GranularWaveTableNode_VertexNames;
+            const FInputVertexInterfaceData& InputData = InParams.InputData;
+            const FOperatorSettings& Settings = InParams.OperatorSettings;
+            return MakeUnique<FGranularWaveTableOperator>(Settings,
+                InputData.GetOrConstructDataReadReference<FTrigger>(METASOUND_GET_PARAM_NAME(InputTriggerPlay), Settings),
+                InputData.GetOrConstructDataReadReference<FTrigger>(METASOUND_GET_PARAM_NAME(InputTriggerStop), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<FWaveTableBankAsset>(METASOUND_GET_PARAM_NAME(InParamWaveTableBank), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamTableIndex), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamIndexRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamFrequency), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamPitchRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamGrainDuration), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDurationRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamActiveVoices), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamTimeJitter), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamAttackTimePercent), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDecayTimePercent), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamAttackCurve), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamDecayCurve), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamPan), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamPanRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<float>(METASOUND_GET_PARAM_NAME(InParamVolumeRand), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<bool>(METASOUND_GET_PARAM_NAME(InputWarmStart), Settings),
+                InputData.GetOrCreateDefaultDataReadReference<int32>(METASOUND_GET_PARAM_NAME(InputSeed), Settings));
+        }
+
+        virtual void BindInputs(FInputVertexInterfaceData& InOutVertexData) override
+        {
+            using namespace GranularWaveTableNode_VertexNames;
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputTriggerPlay), PlayTrigger);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputTriggerStop), StopTrigger);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamWaveTableBank), WaveTableBankInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamTableIndex), TableIndexInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamIndexRand), IndexRandInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamFrequency), FrequencyInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamPitchRand), PitchRandInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamGrainDuration), GrainDurationMsInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDurationRand), DurationRandMsInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamActiveVoices), ActiveVoicesInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamTimeJitter), TimeJitterInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamAttackTimePercent), AttackTimePercentInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDecayTimePercent), DecayTimePercentInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamAttackCurve), AttackCurveInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamDecayCurve), DecayCurveInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamPan), PanInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamPanRand), PanRandInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InParamVolumeRand), VolumeRandInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputWarmStart), WarmStartInput);
+            InOutVertexData.BindReadVertex(METASOUND_GET_PARAM_NAME(InputSeed), SeedInput);
+        }
+
+        virtual void BindOutputs(FOutputVertexInterfaceData& InOutVertexData) override
+        {
+            using namespace GranularWaveTableNode_VertexNames;
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputTriggerOnPlay), OnPlayTrigger);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputTriggerOnFinished), OnFinishedTrigger);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputTriggerOnGrain), OnGrainTriggered);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutParamAudioLeft), AudioOutputLeft);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutParamAudioRight), AudioOutputRight);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainTable), OutputGrainTableRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainDurationSec), OutputGrainDurationSecRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainVolume), OutputGrainVolumeRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainPitch), OutputGrainPitchRef);
+            InOutVertexData.BindWriteVertex(METASOUND_GET_PARAM_NAME(OutputGrainPan), OutputGrainPanRef);
+        }
+        virtual FDataReferenceCollection GetInputs() const override
+        {
+            using namespace GranularWaveTableNode_VertexNames;
+            FDataReferenceCollection InputDataReferences;
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputTriggerPlay), PlayTrigger);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputTriggerStop), StopTrigger);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamWaveTableBank), WaveTableBankInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamTableIndex), TableIndexInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamIndexRand), IndexRandInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamFrequency), FrequencyInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamPitchRand), PitchRandInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamGrainDuration), GrainDurationMsInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDurationRand), DurationRandMsInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamActiveVoices), ActiveVoicesInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamTimeJitter), TimeJitterInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamAttackTimePercent), AttackTimePercentInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDecayTimePercent), DecayTimePercentInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamAttackCurve), AttackCurveInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamDecayCurve), DecayCurveInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamPan), PanInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamPanRand), PanRandInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InParamVolumeRand), VolumeRandInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputWarmStart), WarmStartInput);
+            InputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(InputSeed), SeedInput);
+            return InputDataReferences;
+        }
+        virtual FDataReferenceCollection GetOutputs() const override
+        {
+            using namespace GranularWaveTableNode_VertexNames;
+            FDataReferenceCollection OutputDataReferences;
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputTriggerOnPlay), OnPlayTrigger);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputTriggerOnFinished), OnFinishedTrigger);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputTriggerOnGrain), OnGrainTriggered);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutParamAudioLeft), AudioOutputLeft);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutParamAudioRight), AudioOutputRight);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainTable), OutputGrainTableRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainDurationSec), OutputGrainDurationSecRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainVolume), OutputGrainVolumeRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainPitch), OutputGrainPitchRef);
+            OutputDataReferences.AddDataReadReference(METASOUND_GET_PARAM_NAME(OutputGrainPan), OutputGrainPanRef);
+            return OutputDataReferences;
+        }
+
+        void Execute()
+        {
+            METAGRAIN_TRACE_SCOPE(GranularWaveTable_Execute);
+            SCOPE_CYCLE_COUNTER(STAT_MetagrainExecute);
+            FMetagrainRealtimeScope RealtimeScope(OperatorName, Engine.GetVoicePool());
+            ExecuteTimer.Begin();
+            ON_SCOPE_EXIT { OperatorStats.Report(Engine.GetStats(), bIsPlaying, ExecuteTimer.End()); };
+
+            OnPlayTrigger->AdvanceBlock();
+            OnFinishedTrigger->AdvanceBlock();
+            OnGrainTriggered->AdvanceBlock();
+            Engine.ClearSpawnEvents();
+
+            int32 LastPlayFrame = -1;
+            for (int32 Frame : PlayTrigger->GetTriggeredFrames())
+            {
+                LastPlayFrame = Frame;
+                if (!TryStartPlayback(Frame))
+                {
+                    OnFinishedTrigger->TriggerFrame(Frame);
+                    bIsPlaying = false;
+                }
+            }
+            PublishSpawnEvents();
+
+            for (int32 Frame : StopTrigger->GetTriggeredFrames())
+            {
+                if (bIsPlaying && Frame > LastPlayFrame)
+                {
+                    bIsPlaying = false;
+                    Engine.Stop(Frame);
+                    OnFinishedTrigger->TriggerFrame(Frame);
+                    break;
+                }
+            }
+            ExecuteTimer.Switch(EMetagrainPhase::Other);
+
+            if (!bIsPlaying && !Engine.IsReleasing())
+            {
+                AudioOutputLeft->Zero(); AudioOutputRight->Zero();
+                return;
+            }
+
+            // A bank change during playback rebuilds the tables; the grains playing keep the old ones until they end
+            const FWaveTableBankAssetProxyPtr& InputProxy = WaveTableBankInput->GetProxy();
+            if (bIsPlaying && InputProxy.IsValid() && InputProxy != CurrentBankProxy && !InitializeTables(InputProxy))
+            {
+                StopImmediately(); return;
+            }
+            if (!Engine.HasValidSource())
+            {
+                StopImmediately(); return;
+            }
+
+            Engine.Process(GetEngineParams(), AudioOutputLeft->GetData(), AudioOutputRight->GetData());
+            ExecuteTimer.AddEngineTimings(Engine.GetLastBlockTimings());
+            PublishSpawnEvents();
+        }
+
+        void Reset(const IOperator::FResetParams& InParams)
+        {
+            Engine.Reset();
+            TableSource.reset();
+            CurrentBankProxy.Reset();
+            AudioOutputLeft->Zero();
+            AudioOutputRight->Zero();
+
+            OnPlayTrigger->Reset();
+            OnFinishedTrigger->Reset();
+            OnGrainTriggered->Reset();
+
+            *OutputGrainTableRef = 0;
+            *OutputGrainDurationSecRef = 0.0f;
+            *OutputGrainVolumeRef = 0.0f;
+            *OutputGrainPitchRef = 0.0f;
+            *OutputGrainPanRef = 0.0f;
+
+            bIsPlaying = false;
+        }
+
+    private:
+        // Table Index and Index Rand become a start window over the tables: a start drawn uniformly over one table
+        // length from a fractional index lands in the next table with odds equal to the fraction. The window stops a
+        // frame short of the bank end so no start wraps back to the first table.
+        Metagrain::FGranularSynthParams GetEngineParams() const
+        {
+            Metagrain::FGranularSynthParams Params;
+            Params.GrainDurationMs = *GrainDurationMsInput;
+            Params.DurationRandMs = *DurationRandMsInput;
+            Params.ActiveVoices = *ActiveVoicesInput;
+            Params.TimeJitterPercent = *TimeJitterInput;
+            Params.AttackPercent = *AttackTimePercentInput;
+            Params.DecayPercent = *DecayTimePercentInput;
+            Params.AttackCurve = *AttackCurveInput;
+            Params.DecayCurve = *DecayCurveInput;
+            Params.PitchRandSemitones = *PitchRandInput;
+            Params.Pan = *PanInput;
+            Params.PanRand = *PanRandInput;
+            Params.VolumeRandPercent = *VolumeRandInput;
+            Params.bWarmStart = *WarmStartInput;
+            if (TableSource)
+            {
+                const float NumTables = static_cast<float>(TableSource->GetNumTables());
+                const float TableIndex = FMath::Clamp(*TableIndexInput, 0.0f, NumTables - 1.0f);
+                const float TablesSpanned = FMath::Min(1.0f + FMath::Max(0.0f, *IndexRandInput), NumTables - TableIndex);
+                Params.StartPointSeconds = TableSource->GetTableStartSeconds(TableIndex);
+                Params.StartPointRandMs = FMath::Max(0.0f, TablesSpanned * TableSource->GetTableFrames() - 1.0f) / SampleRate * 1000.0f;
+                Params.FrameRatioScale = TableSource->GetFrameRatio(*FrequencyInput, SampleRate);
+            }
+            return Params;
+        }
+
+        void PublishSpawnEvents()
+        {
+            for (const Metagrain::FGrainSpawnEvent& Event : Engine.GetSpawnEvents())
+            {
+                *OutputGrainTableRef = TableSource ? TableSource->GetTableIndex(Event.StartTimeSeconds) : 0;
+                *OutputGrainDurationSecRef = Event.DurationSeconds;
+                *OutputGrainVolumeRef = Event.Volume;
+                *OutputGrainPitchRef = Event.PitchSemitones;
+                *OutputGrainPanRef = Event.Pan;
+                OnGrainTriggered->TriggerFrame(Event.FrameInBlock);
+            }
+            Engine.ClearSpawnEvents();
+        }
+
+        void StopImmediately()
+        {
+            if (bIsPlaying)
+            {
+                OnFinishedTrigger->TriggerFrame(0);
+            }
+            bIsPlaying = false;
+            ReleaseTables();
+            AudioOutputLeft->Zero(); AudioOutputRight->Zero();
+        }
+
+        bool TryStartPlayback(int32 InFrame)
+        {
+            METAGRAIN_TRACE_SCOPE(GranularWaveTable_PlayTrigger);
+            FMetagrainRealtimeExemption RealtimeExemption; // Play is not steady state: table copy, logging
+
+            bIsPlaying = false;
+            const FWaveTableBankAssetProxyPtr& BankProxy = WaveTableBankInput->GetProxy();
+            if (!BankProxy.IsValid())
+            {
+                UE_LOG(LogMetaSound, Warning, TEXT("GWT: Play Trigger: WaveTable Bank input is not valid."));
+                ReleaseTables();
+                return false;
+            }
+            if ((BankProxy != CurrentBankProxy || !Engine.HasValidSource()) && !InitializeTables(BankProxy))
+            {
+                ReleaseTables();
+                return false;
+            }
+
+            bIsPlaying = true;
+            OnPlayTrigger->TriggerFrame(InFrame);
+            Engine.GetRandom().Seed(*SeedInput != 0 ? static_cast<uint32>(*SeedInput) : FPlatformTime::Cycles());
+            Engine.Start(GetEngineParams(), InFrame);
+            return true;
+        }
+
+        // Copies the bank's tables into a new source, converting 16-bit tables and resampling any whose length
+        // differs from the first one.
+        bool InitializeTables(const FWaveTableBankAssetProxyPtr& InBankProxy)
+        {
+            METAGRAIN_TRACE_SCOPE(GranularWaveTable_TableInit);
+            FMetagrainRealtimeExemption RealtimeExemption; // Only on Play or bank change, allocates the tables
+            const EMetagrainPhase PreviousPhase = ExecuteTimer.Switch(EMetagrainPhase::WaveInit);
+            ON_SCOPE_EXIT { ExecuteTimer.Switch(PreviousPhase); };
+
+            const TArray<FWaveTableData>& Tables = InBankProxy->GetWaveTableData();
+            if (Tables.IsEmpty() || Tables[0].GetNumSamples() <= 0)
+            {
+                UE_LOG(LogMetaSound, Warning, TEXT("GWT: WaveTable Bank has no tables."));
+                return false;
+            }
+
+            auto Source = std::make_shared<Metagrain::FGrainWaveTableSource>(Tables[0].GetNumSamples(), SampleRate);
+            TArray<float> ConvertScratch;
+            for (const FWaveTableData& Table : Tables)
+            {
+                if (Table.GetBitDepth() == EWaveTableBitDepth::PCM_16)
+                {
+                    TArrayView<const int16> Samples;
+                    if (Table.GetDataView(Samples))
+                    {
+                        ConvertScratch.SetNumUninitialized(Samples.Num());
+                        Metagrain::ConvertPcm16ToFloat(Samples.GetData(), ConvertScratch.GetData(), Samples.Num());
+                        Source->AddTable(ConvertScratch.GetData(), ConvertScratch.Num());
+                    }
+                }
+                else
+                {
+                    TArrayView<const float> Samples;
+                    if (Table.GetDataView(Samples))
+                    {
+                        Source->AddTable(Samples.GetData(), Samples.Num());
+                    }
+                }
+            }
+
+            if (!Engine.SetSource(Source))
+            {
+                UE_LOG(LogMetaSound, Error, TEXT("GWT: Failed to create grain source for the WaveTable Bank."));
+                return false;
+            }
+            TableSource = MoveTemp(Source);
+            CurrentBankProxy = InBankProxy;
+            UE_LOG(LogMetaSound, Verbose, TEXT("GWT: Initialized %d tables of %d frames."), TableSource->GetNumTables(), TableSource->GetTableFrames());
+            return true;
+        }
+
+        void ReleaseTables()
+        {
+            FMetagrainRealtimeExemption RealtimeExemption; // Only on stop or bank change, frees the tables
+            Engine.ClearSource();
+            TableSource.reset();
+            CurrentBankProxy.Reset();
+        }
+
+        // Input ReadRefs
+        FTriggerReadRef PlayTrigger; FTriggerReadRef StopTrigger; FWaveTableBankAssetReadRef WaveTableBankInput;
+        FFloatReadRef TableIndexInput; FFloatReadRef IndexRandInput; FFloatReadRef FrequencyInput; FFloatReadRef PitchRandInput;
+        FFloatReadRef GrainDurationMsInput; FFloatReadRef DurationRandMsInput; FFloatReadRef ActiveVoicesInput; FFloatReadRef TimeJitterInput;
+        FFloatReadRef AttackTimePercentInput; FFloatReadRef DecayTimePercentInput; FFloatReadRef AttackCurveInput; FFloatReadRef DecayCurveInput;
+        FFloatReadRef PanInput; FFloatReadRef PanRandInput; FFloatReadRef VolumeRandInput;
+        FBoolReadRef WarmStartInput; FInt32ReadRef SeedInput;
+
+        // Output WriteRefs
+        FTriggerWriteRef OnPlayTrigger; FTriggerWriteRef OnFinishedTrigger; FTriggerWriteRef OnGrainTriggered;
+        FAudioBufferWriteRef AudioOutputLeft; FAudioBufferWriteRef AudioOutputRight;
+        FInt32WriteRef OutputGrainTableRef;
+        FFloatWriteRef OutputGrainDurationSecRef;
+        FFloatWriteRef OutputGrainVolumeRef;
+        FFloatWriteRef OutputGrainPitchRef;
+        FFloatWriteRef OutputGrainPanRef;
+
+        // Operator State
+        float SampleRate; int32 BlockSize;
+        bool bIsPlaying;
+        FWaveTableBankAssetProxyPtr CurrentBankProxy;
+        std::shared_ptr<Metagrain::FGrainWaveTableSource> TableSource;  // Also held by the engine while it is set
+        FMetagrainOperatorRecording Recording;  // Declared before Engine, so it is written after the engine is gone
+        EngineType Engine;
+        FMetagrainOperatorStats OperatorStats;
+        FMetagrainExecuteTimer ExecuteTimer;
+    };
+
+    class FGranularWaveTableNode : public FNodeFacade
+    {
+    public:
+        FGranularWaveTableNode(const FNodeInitData& InitData)
+            : FNodeFacade(InitData.InstanceName, InitData.InstanceID, TFacadeOperatorClass<FGranularWaveTableOperator>())
+        {
+        }
+    };
+
+    METASOUND_REGISTER_NODE(FGranularWaveTableNode)
+}
+#undef LOCTEXT_NAMESPACE
@@ -1,21 +1,111 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Metagrain.h"
+#include "MetagrainRealtimeCheck.h"
+#include "MetagrainSourceCache.h"
+#include "MetagrainStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
 
 #define LOCTEXT_NAMESPACE "FMetagrainModule"
 
+FCriticalSection FMetagrainModule::OperatorRegistryLock;
+TArray<Metasound::FMetagrainOperatorStats*> FMetagrainModule::LiveOperators;
+
+static FAutoConsoleCommandWithOutputDevice GMetagrainDumpCommand(
+	TEXT("metagrain.dump"),
+	TEXT("Lists every live Metagrain operator with its wave, playing state, voices, spawn rate, memory and recent Execute time."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FMetagrainModule::DumpOperators));
+
 void FMetagrainModule::StartupModule()
 {
+	// Does nothing unless -MetagrainRealtimeCheck is passed to a non-shipping build
+	Metasound::MetagrainRealtimeCheck::Install();
+
+	StatsTickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("MetagrainStats"), 0.0f, [](float DeltaTime)
+	{
+		Metasound::MetagrainStats::Tick(DeltaTime);
+		return true;
+	});
+
+	SeekPointsTickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("MetagrainSeekPoints"), 0.0f, [](float)
+	{
+		Metasound::MetagrainSourceCache::Tick();
+		return true;
+	});
 
 	UE_LOG(LogTemp, Warning, TEXT("Metagrain module has started."));
 }
 
 void FMetagrainModule::ShutdownModule()
 {
+	FTSTicker::GetCoreTicker().RemoveTicker(StatsTickerHandle);
+	StatsTickerHandle.Reset();
+	FTSTicker::GetCoreTicker().RemoveTicker(SeekPointsTickerHandle);
+	SeekPointsTickerHandle.Reset();
 
 	UE_LOG(LogTemp, Warning, TEXT("Metagrain module has shut down."));
 }
 
+void FMetagrainModule::RegisterOperator(Metasound::FMetagrainOperatorStats* InOperator)
+{
+	FScopeLock Lock(&OperatorRegistryLock);
+	LiveOperators.Add(InOperator);
+}
+
+void FMetagrainModule::UnregisterOperator(Metasound::FMetagrainOperatorStats* InOperator)
+{
+	FScopeLock Lock(&OperatorRegistryLock);
+	LiveOperators.RemoveSingleSwap(InOperator);
+}
+
+void FMetagrainModule::ForEachLiveOperator(TFunctionRef<void(Metasound::FMetagrainOperatorStats&)> InCallback)
+{
+	FScopeLock Lock(&OperatorRegistryLock);
+	for (Metasound::FMetagrainOperatorStats* Operator : LiveOperators)
+	{
+		InCallback(*Operator);
+	}
+}
+
+void FMetagrainModule::DumpOperators(FOutputDevice& Ar)
+{
+	// Copy under the lock and format afterwards, so operators being created on the audio thread never wait on the log
+	TArray<Metasound::FMetagrainOperatorSnapshot> Snapshots;
+	ForEachLiveOperator([&Snapshots](Metasound::FMetagrainOperatorStats& InOperator)
+	{
+		Snapshots.Add(InOperator.GetSnapshot());
+	});
+
+	Snapshots.Sort([](const Metasound::FMetagrainOperatorSnapshot& A, const Metasound::FMetagrainOperatorSnapshot& B)
+	{
+		return A.PeakExecuteMicroseconds > B.PeakExecuteMicroseconds;
+	});
+
+	int32 NumPlaying = 0;
+	int32 TotalVoices = 0;
+	uint64 TotalMemoryBytes = 0;
+	for (const Metasound::FMetagrainOperatorSnapshot& Snapshot : Snapshots)
+	{
+		NumPlaying += Snapshot.bIsPlaying ? 1 : 0;
+		TotalVoices += Snapshot.ActiveVoices;
+		TotalMemoryBytes += Snapshot.MemoryBytes;
+	}
+
+	Ar.Logf(TEXT("Metagrain: %d live operator(s), %d playing, %d active voice(s), %.1f KB"),
+		Snapshots.Num(), NumPlaying, TotalVoices, TotalMemoryBytes / 1024.0);
+
+	for (int32 Index = 0; Index < Snapshots.Num(); ++Index)
+	{
+		const Metasound::FMetagrainOperatorSnapshot& Snapshot = Snapshots[Index];
+		Ar.Logf(TEXT("  [%2d] %-26s %-8s voices %2d/%-2d  %7.1f grains/s  %8.1f KB  execute avg %7.1f us  peak %7.1f us  wave %s"),
+			Index, Snapshot.NodeName, Snapshot.bIsPlaying ? TEXT("playing") : TEXT("stopped"),
+			Snapshot.ActiveVoices, Snapshot.MaxVoices, Snapshot.GrainsPerSecond, Snapshot.MemoryBytes / 1024.0,
+			Snapshot.AvgExecuteMicroseconds, Snapshot.PeakExecuteMicroseconds,
+			Snapshot.WaveName.IsNone() ? TEXT("(none)") : *Snapshot.WaveName.ToString());
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
 
 IMPLEMENT_MODULE(FMetagrainModule, Metagrain) 
@@ -0,0 +1,190 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MetagrainAnalysisUserData.h"
+#include "MetasoundLog.h"
+#include "Misc/ScopeRWLock.h"
+#include "Sound/SoundWave.h"
+#include "UObject/ObjectSaveContext.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MetagrainAnalysisUserData)
+
+namespace Metasound
+{
+	namespace MetagrainAnalysisPrivate
+	{
+		struct FRegisteredAnalysis
+		{
+			const UMetagrainAnalysisUserData* Owner = nullptr;
+			std::shared_ptr<const Metagrain::FGrainAnalysis> Analysis;
+			uint64 DecodeKey = 0;
+		};
+
+		// Written on the game thread as waves load and unload, read when an operator creates a grain source
+		FRWLock RegistryLock;
+		TMap<FName, TArray<FRegisteredAnalysis>> Registry;
+
+		void Unregister(const UMetagrainAnalysisUserData* InOwner, FName InWaveKey)
+		{
+			FWriteScopeLock Lock(RegistryLock);
+			if (TArray<FRegisteredAnalysis>* Entries = Registry.Find(InWaveKey))
+			{
+				Entries->RemoveAllSwap([InOwner](const FRegisteredAnalysis& Entry) { return Entry.Owner == InOwner; });
+				if (Entries->IsEmpty())
+				{
+					Registry.Remove(InWaveKey);
+				}
+			}
+		}
+	}
+
+	FName MetagrainAnalysis::GetWaveKey(FName InPackageName, FName InWaveName)
+	{
+		return FName(*FString::Printf(TEXT("%s.%s"), *InPackageName.ToString(), *InWaveName.ToString()));
+	}
+
+	std::shared_ptr<const Metagrain::FGrainAnalysis> MetagrainAnalysis::Find(FName InWaveKey, const Metagrain::FGrainSourceInfo& InInfo, uint64& OutDecodeKey)
+	{
+		using namespace MetagrainAnalysisPrivate;
+
+		FReadScopeLock Lock(RegistryLock);
+		if (const TArray<FRegisteredAnalysis>* Entries = Registry.Find(InWaveKey))
+		{
+			for (const FRegisteredAnalysis& Entry : *Entries)
+			{
+				if (Entry.Analysis->Matches(InInfo))
+				{
+					OutDecodeKey = Entry.DecodeKey;
+					return Entry.Analysis;
+				}
+			}
+			UE_LOG(LogMetaSound, Warning, TEXT("Metagrain: analysis of '%s' was made from different audio, re-save the wave to rebuild it."), *InWaveKey.ToString());
+		}
+		return nullptr;
+	}
+}
+
+void UMetagrainAnalysisUserData::PostLoad()
+{
+	Super::PostLoad();
+	RegisterAnalysis();
+}
+
+void UMetagrainAnalysisUserData::BeginDestroy()
+{
+	if (!RegisteredWaveKey.IsNone())
+	{
+		Metasound::MetagrainAnalysisPrivate::Unregister(this, RegisteredWaveKey);
+		RegisteredWaveKey = NAME_None;
+	}
+	Super::BeginDestroy();
+}
+
+void UMetagrainAnalysisUserData::RegisterAnalysis()
+{
+	using namespace Metasound::MetagrainAnalysisPrivate;
+
+	if (!RegisteredWaveKey.IsNone())
+	{
+		Unregister(this, RegisteredWaveKey);
+		RegisteredWaveKey = NAME_None;
+	}
+
+	const USoundWave* Wave = GetTypedOuter<USoundWave>();
+	if (!Wave || AnalysisData.IsEmpty())
+	{
+		return;
+	}
+
+	// The registry owns its own copy, so sources keep the analysis after this object is gone
+	TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Blob = MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(AnalysisData);
+	std::string Error;
+	std::shared_ptr<const Metagrain::FGrainAnalysis> Analysis = Metagrain::FGrainAnalysis::Create(
+		std::shared_ptr<const void>(Blob->GetData(), [Blob](const void*) {}), Blob->GetData(), Blob->Num(), Error);
+	if (!Analysis)
+	{
+		UE_LOG(LogMetaSound, Warning, TEXT("Metagrain: ignoring analysis of '%s': %s"), *Wave->GetName(), UTF8_TO_TCHAR(Error.c_str()));
+		return;
+	}
+
+	// Decoded audio depends on the compressed data as well as the imported audio, so any setting that changes the
+	// compressed data changes the key, as it does the wave's derived data key
+	const FString RuntimeFormat = Wave->GetRuntimeFormat().ToString();
+	const int32 CompressionQuality = Wave->GetCompressionQuality();
+	const float SampleRate = Wave->GetSampleRateForCurrentPlatform();
+	uint64 DecodeKey = Analysis->GetHeader().ContentHash;
+	DecodeKey = Metagrain::HashGrainContent(*RuntimeFormat, RuntimeFormat.Len() * sizeof(TCHAR), DecodeKey);
+	DecodeKey = Metagrain::HashGrainContent(&CompressionQuality, sizeof(CompressionQuality), DecodeKey);
+	DecodeKey = Metagrain::HashGrainContent(&SampleRate, sizeof(SampleRate), DecodeKey);
+
+	RegisteredWaveKey = Metasound::MetagrainAnalysis::GetWaveKey(Wave->GetPackage()->GetFName(), Wave->GetFName());
+	FWriteScopeLock Lock(RegistryLock);
+	Registry.FindOrAdd(RegisteredWaveKey).Add({ this, MoveTemp(Analysis), DecodeKey });
+}
+
+#if WITH_EDITOR
+void UMetagrainAnalysisUserData::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+	UpdateAnalysis();
+}
+
+void UMetagrainAnalysisUserData::UpdateAnalysis()
+{
+	USoundWave* Wave = GetTypedOuter<USoundWave>();
+	if (!Wave)
+	{
+		return;
+	}
+
+	TArray<uint8> RawPCMData;
+	uint32 SampleRate = 0;
+	uint16 NumChannels = 0;
+	if (!Wave->GetImportedSoundWaveData(RawPCMData, SampleRate, NumChannels) || NumChannels == 0 || SampleRate == 0)
+	{
+		UE_LOG(LogMetaSound, Warning, TEXT("Metagrain: no imported audio to analyze for '%s'."), *Wave->GetName());
+		return;
+	}
+
+	const uint64 ContentHash = Metagrain::HashGrainContent(RawPCMData.GetData(), RawPCMData.Num());
+	std::string Error;
+	const std::shared_ptr<const Metagrain::FGrainAnalysis> Existing = Metagrain::FGrainAnalysis::Create(nullptr, AnalysisData.GetData(), AnalysisData.Num(), Error);
+	if (Existing && Existing->GetHeader().ContentHash == ContentHash && Existing->GetHopFrames() == HopFrames)
+	{
+		// The compression settings may have changed without the audio
+		RegisterAnalysis();
+		return;
+	}
+
+	Metagrain::FGrainSourceInfo Info;
+	Info.NumChannels = NumChannels;
+	Info.SampleRate = static_cast<float>(SampleRate);
+	Info.NumFrames = RawPCMData.Num() / (static_cast<int32>(sizeof(int16)) * NumChannels);
+
+	// Converted in chunks, long recordings never exist as float in memory
+	constexpr int32 ChunkFrames = 4096;
+	const int16* Samples = reinterpret_cast<const int16*>(RawPCMData.GetData());
+	TArray<float> Chunk;
+	Chunk.SetNumUninitialized(ChunkFrames * NumChannels);
+
+	Metagrain::FGrainAnalysisBuilder Builder;
+	Builder.Begin(Info, ContentHash, HopFrames);
+	for (int64 Frame = 0; Frame < Info.NumFrames; Frame += ChunkFrames)
+	{
+		const int32 NumFrames = static_cast<int32>(FMath::Min<int64>(ChunkFrames, Info.NumFrames - Frame));
+		const int16* ChunkSamples = Samples + Frame * NumChannels;
+		for (int32 Index = 0; Index < NumFrames * NumChannels; ++Index)
+		{
+			Chunk[Index] = ChunkSamples[Index] * (1.0f / 32768.0f);
+		}
+		Builder.Append(Chunk.GetData(), NumFrames);
+	}
+
+	const std::vector<uint8_t> Blob = Builder.Finish();
+	AnalysisData = TArray<uint8>(Blob.data(), static_cast<int32>(Blob.size()));
+	AnalysisBytes = AnalysisData.Num();
+	NumOnsets = static_cast<int32>(reinterpret_cast<const Metagrain::FGrainAnalysisHeader*>(Blob.data())->NumOnsets);
+
+	UE_LOG(LogMetaSound, Log, TEXT("Metagrain: analyzed '%s' (%.1f s): %d onsets, %d bytes."), *Wave->GetName(), Info.GetDurationSeconds(), NumOnsets, AnalysisBytes);
+	RegisterAnalysis();
+}
+#endif
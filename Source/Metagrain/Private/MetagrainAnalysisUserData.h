@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "GrainCore/GrainAnalysis.h"
+
+#include "MetagrainAnalysisUserData.generated.h"
+
+/**
+ * Add to a Sound Wave's Asset User Data to have Metagrain analyze it (level envelope, zero crossings, pitch and
+ * onsets) whenever the wave is saved or cooked. The analysis is stored in the asset as one blob and handed to
+ * grain sources for the wave when it loads, so nothing is analyzed at runtime.
+ */
+UCLASS(meta = (DisplayName = "Metagrain Analysis"))
+class UMetagrainAnalysisUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** Hop size in frames of the stored analysis. Smaller hops resolve onsets and pitch more finely and take more space. */
+	UPROPERTY(EditAnywhere, Category = "Metagrain", meta = (ClampMin = "64", ClampMax = "8192"))
+	int32 HopFrames = Metagrain::FGrainAnalysisBuilder::DefaultHopFrames;
+
+	/** Onsets found by the last analysis */
+	UPROPERTY(VisibleAnywhere, Category = "Metagrain")
+	int32 NumOnsets = 0;
+
+	/** Size of the stored analysis */
+	UPROPERTY(VisibleAnywhere, Category = "Metagrain")
+	int32 AnalysisBytes = 0;
+
+	//~ Begin UObject Interface
+	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+	//~ End UObject Interface
+
+private:
+#if WITH_EDITOR
+	/** Rebuilds AnalysisData if the owning wave's audio or the hop size changed since the last analysis */
+	void UpdateAnalysis();
+#endif
+
+	/** Makes the analysis available to grain sources created for the owning wave */
+	void RegisterAnalysis();
+
+	/** Blob in the FGrainAnalysisHeader format, written by the editor */
+	UPROPERTY()
+	TArray<uint8> AnalysisData;
+
+	FName RegisteredWaveKey;
+};
+
+namespace Metasound
+{
+	namespace MetagrainAnalysis
+	{
+		/** Identifies a wave by its package and name, which unlike its name alone is unique across folders */
+		FName GetWaveKey(FName InPackageName, FName InWaveName);
+
+		/**
+		 * Analysis registered for the wave with InWaveKey (see GetWaveKey), or null if there is none or it was made
+		 * from audio with a different layout. OutDecodeKey receives the key of the wave's decoded audio: the analysis
+		 * content hash combined with the codec, compression quality and sample rate the wave is compressed with, as
+		 * derived data keys are.
+		 */
+		std::shared_ptr<const Metagrain::FGrainAnalysis> Find(FName InWaveKey, const Metagrain::FGrainSourceInfo& InInfo, uint64& OutDecodeKey);
+	}
+}
@@ -0,0 +1,357 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MetagrainLatency.h"
+#include "Metagrain.h"
+#include "MetagrainStats.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace Metasound
+{
+    namespace MetagrainLatencyPrivate
+    {
+        float CyclesToMicroseconds(uint64 InCycles)
+        {
+            return static_cast<float>(FPlatformTime::ToMilliseconds64(InCycles) * 1000.0);
+        }
+
+        // A spike together with the operator it came from, for the merged report
+        struct FOperatorSpike
+        {
+            FMetagrainOperatorSnapshot Operator;
+            FMetagrainSpike Spike;
+        };
+
+        struct FOperatorLatency
+        {
+            FMetagrainOperatorSnapshot Operator;
+            uint64 Counts[FMetagrainLatencyProfile::NumBuckets] = {};
+            TArray<FMetagrainSpike> Spikes;
+        };
+
+        TArray<FOperatorLatency> CollectLatency()
+        {
+            TArray<FOperatorLatency> Result;
+            FMetagrainModule::ForEachLiveOperator([&Result](FMetagrainOperatorStats& InOperator)
+            {
+                FOperatorLatency& Latency = Result.AddDefaulted_GetRef();
+                Latency.Operator = InOperator.GetSnapshot();
+                InOperator.GetLatencyProfile().GetHistogram(Latency.Counts);
+                Latency.Spikes = InOperator.GetLatencyProfile().GetSpikes();
+            });
+            return Result;
+        }
+
+        FString GetBucketLabel(int32 InBucket)
+        {
+            if (InBucket == 0)
+            {
+                return TEXT("< 1 us");
+            }
+            const float Lower = FMetagrainLatencyProfile::GetBucketLowerMicroseconds(InBucket);
+            if (InBucket == FMetagrainLatencyProfile::NumBuckets - 1)
+            {
+                return FString::Printf(TEXT(">= %.0f us"), Lower);
+            }
+            return FString::Printf(TEXT("%.0f - %.0f us"), Lower, FMetagrainLatencyProfile::GetBucketLowerMicroseconds(InBucket + 1));
+        }
+
+        FString GetWaveLabel(const FMetagrainOperatorSnapshot& InOperator)
+        {
+            return InOperator.WaveName.IsNone() ? FString(TEXT("(none)")) : InOperator.WaveName.ToString();
+        }
+
+        void PrintLatency(FOutputDevice& Ar)
+        {
+            const TArray<FOperatorLatency> Operators = CollectLatency();
+
+            uint64 Counts[FMetagrainLatencyProfile::NumBuckets] = {};
+            uint64 NumBlocks = 0;
+            TArray<FOperatorSpike> AllSpikes;
+            for (const FOperatorLatency& Latency : Operators)
+            {
+                for (int32 Bucket = 0; Bucket < FMetagrainLatencyProfile::NumBuckets; ++Bucket)
+                {
+                    Counts[Bucket] += Latency.Counts[Bucket];
+                    NumBlocks += Latency.Counts[Bucket];
+                }
+                for (const FMetagrainSpike& Spike : Latency.Spikes)
+                {
+                    AllSpikes.Add({ Latency.Operator, Spike });
+                }
+            }
+
+            Ar.Logf(TEXT("Metagrain Execute latency: %llu block(s) across %d live operator(s)"), NumBlocks, Operators.Num());
+            uint64 Cumulative = 0;
+            for (int32 Bucket = 0; Bucket < FMetagrainLatencyProfile::NumBuckets; ++Bucket)
+            {
+                if (Counts[Bucket] == 0)
+                {
+                    continue;
+                }
+                Cumulative += Counts[Bucket];
+                Ar.Logf(TEXT("  %-18s %10llu  %6.2f%%  cumulative %7.3f%%"), *GetBucketLabel(Bucket), Counts[Bucket],
+                    100.0 * Counts[Bucket] / NumBlocks, 100.0 * Cumulative / NumBlocks);
+            }
+
+            AllSpikes.Sort([](const FOperatorSpike& A, const FOperatorSpike& B)
+            {
+                return A.Spike.ExecuteMicroseconds > B.Spike.ExecuteMicroseconds;
+            });
+
+            constexpr int32 MaxPrintedSpikes = 16;
+            Ar.Logf(TEXT("Worst blocks (us):"));
+            for (int32 Index = 0; Index < FMath::Min(AllSpikes.Num(), MaxPrintedSpikes); ++Index)
+            {
+                const FOperatorSpike& Entry = AllSpikes[Index];
+                const FMetagrainSpike& Spike = Entry.Spike;
+                FString Phases;
+                for (int32 Phase = 0; Phase < NumMetagrainPhases; ++Phase)
+                {
+                    if (Spike.PhaseMicroseconds[Phase] >= 0.5f)
+                    {
+                        Phases += FString::Printf(TEXT(" %s %.1f"), LexToString(static_cast<EMetagrainPhase>(Phase)), Spike.PhaseMicroseconds[Phase]);
+                    }
+                }
+                Ar.Logf(TEXT("  %8.1f  %s (%s) t=%.3f block %llu  grains %d readers %d voices %d |%s"),
+                    Spike.ExecuteMicroseconds, Entry.Operator.NodeName, *GetWaveLabel(Entry.Operator), Spike.TimeSeconds, Spike.BlockIndex,
+                    Spike.GrainsStarted, Spike.ReadersCreated, Spike.ActiveVoices, *Phases);
+            }
+        }
+
+        void WriteLatencyCsv(const TArray<FString>& InArgs, FOutputDevice& Ar)
+        {
+            const FString Directory = (InArgs.Num() > 0) ? InArgs[0] : FPaths::ProfilingDir() / TEXT("Metagrain");
+            const FString BaseName = FString::Printf(TEXT("Latency-%s"), *FDateTime::Now().ToString());
+            const TArray<FOperatorLatency> Operators = CollectLatency();
+
+            FString Histogram = TEXT("operator,node,wave,bucket,lower_us,count\n");
+            FString Spikes = TEXT("operator,node,wave,time_s,block,execute_us");
+            for (int32 Phase = 0; Phase < NumMetagrainPhases; ++Phase)
+            {
+                Spikes += FString::Printf(TEXT(",%s_us"), LexToString(static_cast<EMetagrainPhase>(Phase)));
+            }
+            Spikes += TEXT(",grains_started,readers_created,active_voices\n");
+
+            for (int32 OperatorIndex = 0; OperatorIndex < Operators.Num(); ++OperatorIndex)
+            {
+                const FOperatorLatency& Latency = Operators[OperatorIndex];
+                const FString WaveLabel = GetWaveLabel(Latency.Operator);
+                for (int32 Bucket = 0; Bucket < FMetagrainLatencyProfile::NumBuckets; ++Bucket)
+                {
+                    Histogram += FString::Printf(TEXT("%d,%s,%s,%d,%.0f,%llu\n"), OperatorIndex, Latency.Operator.NodeName, *WaveLabel,
+                        Bucket, FMetagrainLatencyProfile::GetBucketLowerMicroseconds(Bucket), Latency.Counts[Bucket]);
+                }
+                for (const FMetagrainSpike& Spike : Latency.Spikes)
+                {
+                    Spikes += FString::Printf(TEXT("%d,%s,%s,%.6f,%llu,%.2f"), OperatorIndex, Latency.Operator.NodeName, *WaveLabel,
+                        Spike.TimeSeconds, Spike.BlockIndex, Spike.ExecuteMicroseconds);
+                    for (int32 Phase = 0; Phase < NumMetagrainPhases; ++Phase)
+                    {
+                        Spikes += FString::Printf(TEXT(",%.2f"), Spike.PhaseMicroseconds[Phase]);
+                    }
+                    Spikes += FString::Printf(TEXT(",%d,%d,%d\n"), Spike.GrainsStarted, Spike.ReadersCreated, Spike.ActiveVoices);
+                }
+            }
+
+            const FString HistogramPath = Directory / (BaseName + TEXT("-Histogram.csv"));
+            const FString SpikesPath = Directory / (BaseName + TEXT("-Spikes.csv"));
+            if (!FFileHelper::SaveStringToFile(Histogram, *HistogramPath) || !FFileHelper::SaveStringToFile(Spikes, *SpikesPath))
+            {
+                Ar.Logf(ELogVerbosity::Error, TEXT("Metagrain: could not write latency CSVs to %s"), *Directory);
+                return;
+            }
+            Ar.Logf(TEXT("Metagrain: wrote %s and %s"), *HistogramPath, *SpikesPath);
+        }
+
+        void ResetLatency(FOutputDevice& Ar)
+        {
+            int32 NumOperators = 0;
+            FMetagrainModule::ForEachLiveOperator([&NumOperators](FMetagrainOperatorStats& InOperator)
+            {
+                InOperator.GetLatencyProfile().RequestReset();
+                ++NumOperators;
+            });
+            Ar.Logf(TEXT("Metagrain: latency profiles of %d operator(s) reset on their next block"), NumOperators);
+        }
+
+        FAutoConsoleCommandWithOutputDevice GLatencyCommand(
+            TEXT("metagrain.latency"),
+            TEXT("Prints the Execute latency histogram of all live Metagrain operators and their worst blocks with a phase breakdown."),
+            FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&PrintLatency));
+
+        FAutoConsoleCommandWithArgsAndOutputDevice GLatencyCsvCommand(
+            TEXT("metagrain.latency.csv"),
+            TEXT("Writes the Execute latency histograms and worst blocks of all live Metagrain operators to CSV. Optional argument: output directory (default Saved/Profiling/Metagrain)."),
+            FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&WriteLatencyCsv));
+
+        FAutoConsoleCommandWithOutputDevice GLatencyResetCommand(
+            TEXT("metagrain.latency.reset"),
+            TEXT("Clears the Execute latency histograms and worst blocks of all live Metagrain operators."),
+            FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&ResetLatency));
+    }
+
+    const TCHAR* LexToString(EMetagrainPhase InPhase)
+    {
+        switch (InPhase)
+        {
+        case EMetagrainPhase::Triggers: return TEXT("triggers");
+        case EMetagrainPhase::WaveInit: return TEXT("wave_init");
+        case EMetagrainPhase::Plan: return TEXT("plan");
+        case EMetagrainPhase::StartGrains: return TEXT("start_grains");
+        case EMetagrainPhase::Render: return TEXT("render");
+        case EMetagrainPhase::PostFilter: return TEXT("post_filter");
+        case EMetagrainPhase::Other: return TEXT("other");
+        default: return TEXT("unknown");
+        }
+    }
+
+    // --- FMetagrainExecuteTimer ---
+
+    void FMetagrainExecuteTimer::Begin()
+    {
+        Timing = FMetagrainBlockTiming();
+        Timing.StartCycles = FPlatformTime::Cycles64();
+        PhaseStartCycles = Timing.StartCycles;
+        CurrentPhase = EMetagrainPhase::Triggers;
+    }
+
+    EMetagrainPhase FMetagrainExecuteTimer::Switch(EMetagrainPhase InPhase)
+    {
+        const uint64 Now = FPlatformTime::Cycles64();
+        Timing.PhaseCycles[static_cast<int32>(CurrentPhase)] += Now - PhaseStartCycles;
+        PhaseStartCycles = Now;
+
+        const EMetagrainPhase PreviousPhase = CurrentPhase;
+        CurrentPhase = InPhase;
+        return PreviousPhase;
+    }
+
+    void FMetagrainExecuteTimer::AddEngineTimings(const Metagrain::FGrainBlockTimings& InTimings)
+    {
+        const uint64 Now = FPlatformTime::Cycles64();
+        const uint64 Elapsed = Now - PhaseStartCycles;
+        const uint64 EngineCycles = InTimings.Plan + InTimings.StartGrains + InTimings.Render + InTimings.PostFilter;
+        Timing.PhaseCycles[static_cast<int32>(CurrentPhase)] += Elapsed - FMath::Min(Elapsed, EngineCycles);
+        Timing.PhaseCycles[static_cast<int32>(EMetagrainPhase::Plan)] += InTimings.Plan;
+        Timing.PhaseCycles[static_cast<int32>(EMetagrainPhase::StartGrains)] += InTimings.StartGrains;
+        Timing.PhaseCycles[static_cast<int32>(EMetagrainPhase::Render)] += InTimings.Render;
+        Timing.PhaseCycles[static_cast<int32>(EMetagrainPhase::PostFilter)] += InTimings.PostFilter;
+        PhaseStartCycles = Now;
+    }
+
+    const FMetagrainBlockTiming& FMetagrainExecuteTimer::End()
+    {
+        Switch(CurrentPhase);
+        Timing.TotalCycles = PhaseStartCycles - Timing.StartCycles;
+        return Timing;
+    }
+
+    // --- FMetagrainLatencyProfile ---
+
+    int32 FMetagrainLatencyProfile::GetBucketIndex(float InMicroseconds)
+    {
+        if (InMicroseconds < 1.0f)
+        {
+            return 0;
+        }
+        const uint32 WholeMicroseconds = static_cast<uint32>(FMath::Min(InMicroseconds, static_cast<float>(MAX_uint32)));
+        return FMath::Min(NumBuckets - 1, static_cast<int32>(FMath::FloorLog2(WholeMicroseconds)) + 1);
+    }
+
+    float FMetagrainLatencyProfile::GetBucketLowerMicroseconds(int32 InBucket)
+    {
+        return (InBucket <= 0) ? 0.0f : static_cast<float>(1u << (InBucket - 1));
+    }
+
+    void FMetagrainLatencyProfile::Record(const FMetagrainBlockTiming& InTiming, int32 InGrainsStarted, int32 InReadersCreated, int32 InActiveVoices)
+    {
+        using namespace MetagrainLatencyPrivate;
+
+        if (bResetRequested.load(std::memory_order_relaxed) && SpikeLock.TryLock())
+        {
+            NumSpikes = 0;
+            SpikeLock.Unlock();
+            SpikeThresholdCycles = 0;
+            for (std::atomic<uint64>& Count : BucketCounts)
+            {
+                Count.store(0, std::memory_order_relaxed);
+            }
+            bResetRequested.store(false, std::memory_order_relaxed);
+        }
+
+        const uint64 BlockIndex = NumBlocks++;
+        const float ExecuteMicroseconds = CyclesToMicroseconds(InTiming.TotalCycles);
+        std::atomic<uint64>& Bucket = BucketCounts[GetBucketIndex(ExecuteMicroseconds)];
+        Bucket.store(Bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (InTiming.TotalCycles <= SpikeThresholdCycles || !SpikeLock.TryLock())
+        {
+            return;
+        }
+
+        int32 Slot = NumSpikes;
+        if (NumSpikes < MaxSpikes)
+        {
+            ++NumSpikes;
+        }
+        else
+        {
+            // Replace the mildest spike
+            Slot = 0;
+            for (int32 Index = 1; Index < MaxSpikes; ++Index)
+            {
+                Slot = (SpikeCycles[Index] < SpikeCycles[Slot]) ? Index : Slot;
+            }
+        }
+
+        FMetagrainSpike& Spike = Spikes[Slot];
+        Spike.TimeSeconds = static_cast<double>(InTiming.StartCycles) * FPlatformTime::GetSecondsPerCycle64();
+        Spike.BlockIndex = BlockIndex;
+        Spike.ExecuteMicroseconds = ExecuteMicroseconds;
+        for (int32 Phase = 0; Phase < NumMetagrainPhases; ++Phase)
+        {
+            Spike.PhaseMicroseconds[Phase] = CyclesToMicroseconds(InTiming.PhaseCycles[Phase]);
+        }
+        Spike.GrainsStarted = InGrainsStarted;
+        Spike.ReadersCreated = InReadersCreated;
+        Spike.ActiveVoices = InActiveVoices;
+        SpikeCycles[Slot] = InTiming.TotalCycles;
+
+        if (NumSpikes == MaxSpikes)
+        {
+            SpikeThresholdCycles = SpikeCycles[0];
+            for (int32 Index = 1; Index < MaxSpikes; ++Index)
+            {
+                SpikeThresholdCycles = FMath::Min(SpikeThresholdCycles, SpikeCycles[Index]);
+            }
+        }
+        SpikeLock.Unlock();
+    }
+
+    void FMetagrainLatencyProfile::GetHistogram(uint64 (&OutCounts)[NumBuckets]) const
+    {
+        for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+        {
+            OutCounts[Bucket] = BucketCounts[Bucket].load(std::memory_order_relaxed);
+        }
+    }
+
+    TArray<FMetagrainSpike> FMetagrainLatencyProfile::GetSpikes() const
+    {
+        TArray<FMetagrainSpike> Result;
+        {
+            FScopeLock Lock(&SpikeLock);
+            Result.Append(Spikes, NumSpikes);
+        }
+        Result.Sort([](const FMetagrainSpike& A, const FMetagrainSpike& B)
+        {
+            return A.ExecuteMicroseconds > B.ExecuteMicroseconds;
+        });
+        return Result;
+    }
+}
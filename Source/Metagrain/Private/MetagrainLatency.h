@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrainCore/GrainCore.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+namespace Metasound
+{
+    // Where an Execute spends its time. Plan, StartGrains, Render and PostFilter come from the engine's block timings.
+    enum class EMetagrainPhase : uint8
+    {
+        Triggers,       // Play/Stop handling, including warm start grains
+        WaveInit,       // Creating the grain source for a new wave
+        Plan,
+        StartGrains,
+        Render,
+        PostFilter,
+        Other,          // Validity checks, output publishing, silence
+        Num
+    };
+
+    constexpr int32 NumMetagrainPhases = static_cast<int32>(EMetagrainPhase::Num);
+
+    const TCHAR* LexToString(EMetagrainPhase InPhase);
+
+    // Timing of one Execute, in FPlatformTime cycles.
+    struct FMetagrainBlockTiming
+    {
+        uint64 StartCycles = 0;
+        uint64 TotalCycles = 0;
+        uint64 PhaseCycles[NumMetagrainPhases] = {};
+    };
+
+    // Splits one Execute into phases: Begin() at the top, Switch() whenever the kind of work changes,
+    // AddEngineTimings() right after the engine's Process() and End() when the block is done.
+    class FMetagrainExecuteTimer
+    {
+    public:
+        void Begin();
+
+        // Charges the time since the last switch to the current phase and makes InPhase current. Returns the previous phase.
+        EMetagrainPhase Switch(EMetagrainPhase InPhase);
+
+        // Charges the engine phases of the Process() call that just returned; the rest goes to the current phase.
+        void AddEngineTimings(const Metagrain::FGrainBlockTimings& InTimings);
+
+        const FMetagrainBlockTiming& End();
+
+    private:
+        FMetagrainBlockTiming Timing;
+        uint64 PhaseStartCycles = 0;
+        EMetagrainPhase CurrentPhase = EMetagrainPhase::Triggers;
+    };
+
+    // One of the worst blocks an operator has rendered.
+    struct FMetagrainSpike
+    {
+        double TimeSeconds = 0.0;       // Same clock as FPlatformTime::Seconds(), to line up with Insights and logs
+        uint64 BlockIndex = 0;
+        float ExecuteMicroseconds = 0.0f;
+        float PhaseMicroseconds[NumMetagrainPhases] = {};
+        int32 GrainsStarted = 0;
+        int32 ReadersCreated = 0;
+        int32 ActiveVoices = 0;
+    };
+
+    // Execute duration histogram with log2 microsecond buckets, plus the worst blocks seen so far.
+    class FMetagrainLatencyProfile
+    {
+    public:
+        // Bucket 0 is below 1 us, bucket N covers [2^(N-1), 2^N) us and the last one is open ended.
+        static constexpr int32 NumBuckets = 16;
+        static constexpr int32 MaxSpikes = 8;
+
+        static int32 GetBucketIndex(float InMicroseconds);
+        static float GetBucketLowerMicroseconds(int32 InBucket);
+
+        // Audio thread, once per Execute. Never blocks: a spike that races a reader is not recorded.
+        void Record(const FMetagrainBlockTiming& InTiming, int32 InGrainsStarted, int32 InReadersCreated, int32 InActiveVoices);
+
+        // Any thread.
+        void GetHistogram(uint64 (&OutCounts)[NumBuckets]) const;
+        TArray<FMetagrainSpike> GetSpikes() const;    // Worst first
+        void RequestReset() { bResetRequested.store(true, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64> BucketCounts[NumBuckets] = {};
+        std::atomic<bool> bResetRequested{ false };
+
+        // Audio thread only
+        uint64 NumBlocks = 0;
+        uint64 SpikeThresholdCycles = 0;
+
+        mutable FCriticalSection SpikeLock;
+        FMetagrainSpike Spikes[MaxSpikes];
+        uint64 SpikeCycles[MaxSpikes] = {};
+        int32 NumSpikes = 0;
+    };
+}
@@ -0,0 +1,317 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MetagrainRealtimeCheck.h"
+
+#if METAGRAIN_REALTIME_CHECKS
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformStackWalk.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+namespace Metasound
+{
+    namespace MetagrainRealtimeCheckPrivate
+    {
+        constexpr int32 MaxStackDepth = 32;
+        constexpr int32 MaxStacksPerBlock = 4;
+        constexpr int32 MaxKeptStacks = 16;
+
+        struct FAllocationStack
+        {
+            uint64 Frames[MaxStackDepth];
+            int32 NumFrames = 0;
+            SIZE_T Size = 0;
+        };
+
+        // Filled from inside the allocator, so it is fixed size and constant initialized
+        struct FThreadState
+        {
+            int32 ExemptDepth = 0;
+            bool bInsideHook = false;
+            int32 NumStacks = 0;
+            FAllocationStack Stacks[MaxStacksPerBlock];
+        };
+
+        thread_local FThreadState ThreadState;
+
+        // A violating block's stacks, copied out after the real-time section has closed
+        struct FKeptStack
+        {
+            const TCHAR* NodeName = nullptr;
+            FAllocationStack Stack;
+        };
+
+        FCriticalSection KeptStacksLock;
+        FKeptStack KeptStacks[MaxKeptStacks];
+        int32 NumKeptStacks = 0;
+
+        std::atomic<uint64> NumBlocks{ 0 };
+        std::atomic<uint64> NumViolatingBlocks{ 0 };
+        std::atomic<uint64> NumAllocations{ 0 };
+        std::atomic<uint64> NumUnexpectedAllocations{ 0 };
+        std::atomic<uint64> NumLocks{ 0 };
+
+        std::atomic<bool> bInstalled{ false };
+
+        int32 FatalOnViolation = 0;
+        FAutoConsoleVariableRef CVarFatalOnViolation(
+            TEXT("metagrain.rtcheck.fatal"),
+            FatalOnViolation,
+            TEXT("When the real-time checker is installed (-MetagrainRealtimeCheck), fail an ensure on every Execute that allocates\n")
+            TEXT("more than once per grain reader the voice pool creates or takes a lock. Use in automation runs to enforce zero steady-state allocations."));
+
+        bool IsCounting()
+        {
+            const FThreadState& State = ThreadState;
+            return !State.bInsideHook && State.ExemptDepth == 0 && Metagrain::FRealtimeScope::IsActive();
+        }
+
+        void NoteAllocation(SIZE_T InSize)
+        {
+            if (!IsCounting())
+            {
+                return;
+            }
+
+            FThreadState& State = ThreadState;
+            State.bInsideHook = true;
+            Metagrain::FRealtimeScope::NoteAllocation();
+            if (State.NumStacks < MaxStacksPerBlock)
+            {
+                FAllocationStack& Stack = State.Stacks[State.NumStacks++];
+                Stack.Size = InSize;
+                Stack.NumFrames = FPlatformStackWalk::CaptureStackBackTrace(Stack.Frames, MaxStackDepth);
+            }
+            State.bInsideHook = false;
+        }
+
+        // Forwards everything to the allocator it replaced and counts allocations made inside a real-time section.
+        class FRealtimeCheckMalloc final : public FMalloc
+        {
+        public:
+            explicit FRealtimeCheckMalloc(FMalloc* InInner)
+                : Inner(InInner)
+            {
+            }
+
+            virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+            {
+                NoteAllocation(Count);
+                return Inner->Malloc(Count, Alignment);
+            }
+
+            virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+            {
+                NoteAllocation(Count);
+                return Inner->TryMalloc(Count, Alignment);
+            }
+
+            virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+            {
+                if (Count > 0)
+                {
+                    NoteAllocation(Count);
+                }
+                return Inner->Realloc(Original, Count, Alignment);
+            }
+
+            virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+            {
+                if (Count > 0)
+                {
+                    NoteAllocation(Count);
+                }
+                return Inner->TryRealloc(Original, Count, Alignment);
+            }
+
+            virtual void Free(void* Original) override { Inner->Free(Original); }
+            virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+            virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+            virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+            virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+            virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+            virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+            virtual void UpdateStats() override { Inner->UpdateStats(); }
+            virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+            virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+            virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+            virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+            virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+        private:
+            FMalloc* Inner;
+        };
+
+        void PrintReport(FOutputDevice& Ar)
+        {
+            if (!bInstalled.load(std::memory_order_relaxed))
+            {
+                Ar.Logf(TEXT("Metagrain real-time checker is not installed, start with -MetagrainRealtimeCheck."));
+                return;
+            }
+
+            Ar.Logf(TEXT("Metagrain real-time checker: %llu block(s), %llu violating, %llu allocation(s) (%llu unexpected), %llu lock(s)"),
+                NumBlocks.load(std::memory_order_relaxed), NumViolatingBlocks.load(std::memory_order_relaxed),
+                NumAllocations.load(std::memory_order_relaxed), NumUnexpectedAllocations.load(std::memory_order_relaxed),
+                NumLocks.load(std::memory_order_relaxed));
+
+            FKeptStack Stacks[MaxKeptStacks];
+            int32 NumStacks = 0;
+            {
+                FScopeLock Lock(&KeptStacksLock);
+                NumStacks = NumKeptStacks;
+                FMemory::Memcpy(Stacks, KeptStacks, sizeof(FKeptStack) * NumStacks);
+            }
+
+            for (int32 Index = 0; Index < NumStacks; ++Index)
+            {
+                const FKeptStack& Kept = Stacks[Index];
+                Ar.Logf(TEXT("  %s: allocation of %llu bytes"), Kept.NodeName, static_cast<uint64>(Kept.Stack.Size));
+                for (int32 Frame = 0; Frame < Kept.Stack.NumFrames; ++Frame)
+                {
+                    ANSICHAR Line[1024] = {};
+                    FPlatformStackWalk::ProgramCounterToHumanReadableString(Frame, Kept.Stack.Frames[Frame], Line, UE_ARRAY_COUNT(Line));
+                    Ar.Logf(TEXT("    %s"), ANSI_TO_TCHAR(Line));
+                }
+            }
+        }
+
+        void Reset()
+        {
+            NumBlocks.store(0, std::memory_order_relaxed);
+            NumViolatingBlocks.store(0, std::memory_order_relaxed);
+            NumAllocations.store(0, std::memory_order_relaxed);
+            NumUnexpectedAllocations.store(0, std::memory_order_relaxed);
+            NumLocks.store(0, std::memory_order_relaxed);
+
+            FScopeLock Lock(&KeptStacksLock);
+            NumKeptStacks = 0;
+        }
+
+        FAutoConsoleCommandWithOutputDevice ReportCommand(
+            TEXT("metagrain.rtcheck"),
+            TEXT("Prints allocations and locks seen inside Metagrain operator Execute, with the stacks of the first violations."),
+            FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&PrintReport));
+
+        FAutoConsoleCommand ResetCommand(
+            TEXT("metagrain.rtcheck.reset"),
+            TEXT("Clears the counts and stacks of the Metagrain real-time checker."),
+            FConsoleCommandDelegate::CreateStatic(&Reset));
+    }
+
+    void MetagrainRealtimeCheck::Install()
+    {
+        using namespace MetagrainRealtimeCheckPrivate;
+
+        if (bInstalled.load(std::memory_order_relaxed) || !FParse::Param(FCommandLine::Get(), TEXT("MetagrainRealtimeCheck")))
+        {
+            return;
+        }
+
+        // Loaded at EarliestPossible, so few threads are allocating yet. The proxy is never removed:
+        // memory allocated through it is freed through the allocator it wraps and vice versa.
+        GMalloc = new FRealtimeCheckMalloc(GMalloc);
+        bInstalled.store(true, std::memory_order_relaxed);
+    }
+
+    bool MetagrainRealtimeCheck::IsInstalled()
+    {
+        return MetagrainRealtimeCheckPrivate::bInstalled.load(std::memory_order_relaxed);
+    }
+
+    void MetagrainRealtimeCheck::NoteLock()
+    {
+        if (MetagrainRealtimeCheckPrivate::IsCounting())
+        {
+            Metagrain::FRealtimeScope::NoteLock();
+        }
+    }
+
+    FMetagrainRealtimeScope::FMetagrainRealtimeScope(const TCHAR* InNodeName, const Metagrain::FGrainVoicePool& InVoicePool)
+        : NodeName(InNodeName)
+        , VoicePool(InVoicePool)
+    {
+        if (MetagrainRealtimeCheck::IsInstalled())
+        {
+            MetagrainRealtimeCheckPrivate::ThreadState.NumStacks = 0;
+            ReadersCreatedAtStart = VoicePool.GetNumReadersCreated();
+            Scope.Emplace();
+        }
+    }
+
+    FMetagrainRealtimeScope::~FMetagrainRealtimeScope()
+    {
+        using namespace MetagrainRealtimeCheckPrivate;
+
+        if (!Scope.IsSet())
+        {
+            return;
+        }
+
+        const uint32 BlockAllocations = Scope->GetNumAllocations();
+        const uint32 BlockLocks = Scope->GetNumLocks();
+        Scope.Reset();
+
+        // The real-time section is closed, so everything below may allocate and lock freely
+        const uint64 ReadersCreated = VoicePool.GetNumReadersCreated() - FMath::Min(ReadersCreatedAtStart, VoicePool.GetNumReadersCreated());
+        const uint64 UnexpectedAllocations = BlockAllocations > ReadersCreated ? BlockAllocations - ReadersCreated : 0;
+        NumBlocks.fetch_add(1, std::memory_order_relaxed);
+        NumAllocations.fetch_add(BlockAllocations, std::memory_order_relaxed);
+        NumLocks.fetch_add(BlockLocks, std::memory_order_relaxed);
+        if (UnexpectedAllocations == 0 && BlockLocks == 0)
+        {
+            return;
+        }
+
+        NumViolatingBlocks.fetch_add(1, std::memory_order_relaxed);
+        NumUnexpectedAllocations.fetch_add(UnexpectedAllocations, std::memory_order_relaxed);
+        {
+            FScopeLock Lock(&KeptStacksLock);
+            const FThreadState& State = ThreadState;
+            for (int32 Index = 0; Index < State.NumStacks && NumKeptStacks < MaxKeptStacks; ++Index)
+            {
+                KeptStacks[NumKeptStacks].NodeName = NodeName;
+                KeptStacks[NumKeptStacks].Stack = State.Stacks[Index];
+                ++NumKeptStacks;
+            }
+        }
+
+        ensureMsgf(FatalOnViolation == 0, TEXT("%s Execute made %llu unexpected allocation(s) and took %u lock(s), see metagrain.rtcheck"),
+            NodeName, UnexpectedAllocations, BlockLocks);
+    }
+
+    FMetagrainRealtimeExemption::FMetagrainRealtimeExemption()
+    {
+        ++MetagrainRealtimeCheckPrivate::ThreadState.ExemptDepth;
+    }
+
+    FMetagrainRealtimeExemption::~FMetagrainRealtimeExemption()
+    {
+        --MetagrainRealtimeCheckPrivate::ThreadState.ExemptDepth;
+    }
+}
+
+#else
+
+namespace Metasound
+{
+    void MetagrainRealtimeCheck::Install()
+    {
+    }
+
+    bool MetagrainRealtimeCheck::IsInstalled()
+    {
+        return false;
+    }
+
+    void MetagrainRealtimeCheck::NoteLock()
+    {
+    }
+}
+
+#endif
@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrainCore/GrainCore.h"
+#include "GrainCore/GrainRealtime.h"
+#include "Misc/Optional.h"
+
+// Set by Metagrain.Build.cs for non-shipping configurations
+#ifndef METAGRAIN_REALTIME_CHECKS
+#define METAGRAIN_REALTIME_CHECKS 0
+#endif
+
+namespace Metasound
+{
+    namespace MetagrainRealtimeCheck
+    {
+        // Wraps GMalloc in the checking proxy when -MetagrainRealtimeCheck is on the command line. Module startup only.
+        void Install();
+
+        bool IsInstalled();
+
+        // Call before taking a blocking lock on a path Execute can reach.
+        void NoteLock();
+    }
+
+#if METAGRAIN_REALTIME_CHECKS
+
+    // Marks one Execute as a real-time section. With the checker installed, every heap allocation and annotated
+    // lock inside it is counted and the first few allocation stacks are kept. Grains reuse pooled readers, and only
+    // a grain that finds none to reuse creates one, so a block may allocate once per reader the voice pool created
+    // during it; anything beyond that is recorded as a violation (and fails an ensure with metagrain.rtcheck.fatal 1,
+    // which fails automation runs).
+    class FMetagrainRealtimeScope
+    {
+    public:
+        FMetagrainRealtimeScope(const TCHAR* InNodeName, const Metagrain::FGrainVoicePool& InVoicePool);
+        ~FMetagrainRealtimeScope();
+
+        FMetagrainRealtimeScope(const FMetagrainRealtimeScope&) = delete;
+        FMetagrainRealtimeScope& operator=(const FMetagrainRealtimeScope&) = delete;
+
+    private:
+        TOptional<Metagrain::FRealtimeScope> Scope;
+        const TCHAR* NodeName;
+        const Metagrain::FGrainVoicePool& VoicePool;
+        uint64 ReadersCreatedAtStart = 0;
+    };
+
+    // Work inside this scope is allowed to allocate and lock, e.g. creating the grain source for a new wave.
+    class FMetagrainRealtimeExemption
+    {
+    public:
+        FMetagrainRealtimeExemption();
+        ~FMetagrainRealtimeExemption();
+    };
+
+#else
+
+    class FMetagrainRealtimeScope
+    {
+    public:
+        FMetagrainRealtimeScope(const TCHAR*, const Metagrain::FGrainVoicePool&) {}
+    };
+
+    class FMetagrainRealtimeExemption
+    {
+    };
+
+#endif
+}
@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MetagrainRecording.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "MetasoundLog.h"
+
+#include <atomic>
+
+namespace Metasound
+{
+    namespace MetagrainRecordingPrivate
+    {
+        int32 RecordEnabled = 0;
+        FAutoConsoleVariableRef CVarRecord(
+            TEXT("metagrain.record"),
+            RecordEnabled,
+            TEXT("1: Metagrain operators created from now on record their grain events and write them to Saved/Profiling/Metagrain\n")
+            TEXT("when their sound stops, for MetagrainReplay. Recording allocates on the audio thread; do not combine with -MetagrainRealtimeCheck."));
+
+        int32 RecordMaxMegabytes = 64;
+        FAutoConsoleVariableRef CVarRecordMaxMegabytes(
+            TEXT("metagrain.record.maxmb"),
+            RecordMaxMegabytes,
+            TEXT("Size at which an operator's grain recording stops (whole blocks are kept). 0 = unlimited."));
+
+        // Keeps file names unique when several operators stop within the same second
+        std::atomic<uint32> NumRecordingsWritten{ 0 };
+    }
+
+    FMetagrainOperatorRecording::FMetagrainOperatorRecording(const TCHAR* InNodeName, Metagrain::EGrainRecordNode InNode, float InSampleRate, int32 InBlockSize, int32 InMaxVoices)
+        : NodeName(InNodeName)
+    {
+        using namespace MetagrainRecordingPrivate;
+
+        bRecording = RecordEnabled != 0;
+        if (bRecording)
+        {
+            Recorder.Begin(InNode, InSampleRate, InBlockSize, InMaxVoices, static_cast<size_t>(FMath::Max(0, RecordMaxMegabytes)) * 1024 * 1024);
+        }
+    }
+
+    FMetagrainOperatorRecording::~FMetagrainOperatorRecording()
+    {
+        using namespace MetagrainRecordingPrivate;
+
+        if (!bRecording || Recorder.IsEmpty())
+        {
+            return;
+        }
+
+        const std::vector<uint8_t>& Bytes = Recorder.Finish();
+        TArray<uint8> Data(Bytes.data(), static_cast<int32>(Bytes.size()));
+        const FString Path = FPaths::ProfilingDir() / TEXT("Metagrain") / FString::Printf(TEXT("GrainRecord-%s-%s-%u.mgrec"),
+            *FString(NodeName).Replace(TEXT(" "), TEXT("")), *FDateTime::Now().ToString(), NumRecordingsWritten++);
+
+        UE_LOG(LogMetaSound, Log, TEXT("Metagrain: %s recorded %u blocks, %llu grains%s -> %s"),
+            NodeName, Recorder.GetNumBlocks(), Recorder.GetNumGrains(), Recorder.IsTruncated() ? TEXT(" (truncated, see metagrain.record.maxmb)") : TEXT(""), *Path);
+
+        // Operators are destroyed on the audio render thread, keep the file write off it
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Data = MoveTemp(Data), Path]()
+        {
+            if (!FFileHelper::SaveArrayToFile(Data, *Path))
+            {
+                UE_LOG(LogMetaSound, Error, TEXT("Metagrain: could not write grain recording %s"), *Path);
+            }
+        });
+    }
+}
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrainCore/GrainRecord.h"
+
+namespace Metasound
+{
+    // Captures one operator's grain events for MetagrainReplay while metagrain.record is 1 at operator creation.
+    // The recording is written to Saved/Profiling/Metagrain when the operator is destroyed, i.e. when its sound stops.
+    class FMetagrainOperatorRecording
+    {
+    public:
+        FMetagrainOperatorRecording(const TCHAR* InNodeName, Metagrain::EGrainRecordNode InNode, float InSampleRate, int32 InBlockSize, int32 InMaxVoices);
+        ~FMetagrainOperatorRecording();
+
+        FMetagrainOperatorRecording(const FMetagrainOperatorRecording&) = delete;
+        FMetagrainOperatorRecording& operator=(const FMetagrainOperatorRecording&) = delete;
+
+        // Null unless recording. Pass to the engine's SetRecorder().
+        Metagrain::FGrainRecorder* GetRecorder() { return bRecording ? &Recorder : nullptr; }
+
+    private:
+        const TCHAR* NodeName;
+        Metagrain::FGrainRecorder Recorder;
+        bool bRecording = false;
+    };
+}
@@ -0,0 +1,386 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MetagrainSourceCache.h"
+#include "WaveProxyGrainSource.h"
+#include "MetagrainAnalysisUserData.h"
+#include "GrainCore/GrainAnalysis.h"
+#include "GrainCore/GrainSeekPoints.h"
+#include "GrainCore/GrainSourceCache.h"
+#include "Async/Async.h"
+#include "DSP/AlignedBuffer.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "MetasoundLog.h"
+
+namespace Metasound
+{
+    namespace MetagrainSourceCachePrivate
+    {
+        int32 CacheEnabled = WITH_EDITOR ? 1 : 0;
+        FAutoConsoleVariableRef CVarCacheEnabled(
+            TEXT("metagrain.sourcecache"),
+            CacheEnabled,
+            TEXT("1: waves with Metagrain Analysis are decoded once into Saved/Metagrain/SourceCache and played from the mapped file\n")
+            TEXT("afterwards, without decoding. Defaults to 1 in editor builds."));
+
+        int32 CacheFormat = 0;
+        FAutoConsoleVariableRef CVarCacheFormat(
+            TEXT("metagrain.sourcecache.format"),
+            CacheFormat,
+            TEXT("Sample format of new cache files. 0: 32-bit float (plays exactly like the streamed wave), 1: 16-bit (half the disk space)."));
+
+        int32 SeekPointsMaxMegabytes = 32;
+        FAutoConsoleVariableRef CVarSeekPointsMaxMegabytes(
+            TEXT("metagrain.seekpoints.maxmb"),
+            SeekPointsMaxMegabytes,
+            TEXT("Memory for decoders parked at seek points through waves played without a cache file, so grains start from the point\n")
+            TEXT("before them instead of seeking the codec (see GrainCore/GrainSeekPoints.h). Waves that would need points more than a\n")
+            TEXT("second apart keep streaming, the least recently played give theirs up first. Defaults to 32, 0 disables seek points."));
+
+        // Grains decode forward from their point, at most one interval. Closer points would cost more memory than the
+        // codec seeks they save.
+        constexpr int32 MinSeekPointIntervalFrames = 4096;
+        constexpr float MaxSeekPointIntervalSeconds = 1.0f;
+        constexpr int32 SeekPointDecodeFrames = 1024;
+
+        // Rough size of a parked reader besides its decode buffers: codec state and the compressed chunk it holds
+        constexpr uint64 SeekPointCodecBytes = 64 * 1024;
+
+        // Decoded in the same chunk size whatever the wave's format, only memory use depends on it
+        constexpr int32 DecodeChunkFrames = 16384;
+
+        struct FSeekPointEntry
+        {
+            std::shared_ptr<Metagrain::FGrainSeekPointSource> Source;
+            uint64 LastUsed = 0;
+            uint64 Bytes = 0;
+        };
+
+        // Guards the tables below. Taken on wave initialization, never inside a block's grain rendering.
+        FCriticalSection CacheLock;
+        TMap<uint64, std::weak_ptr<Metagrain::FGrainMappedSource>> OpenSources;  // Shared by every operator playing the wave
+        TSet<uint64> PendingBuilds;
+        TSet<uint64> FailedBuilds;  // Not retried until the editor restarts
+        TMap<FName, FSeekPointEntry> SeekPoints;  // By wave key, see MetagrainAnalysis::GetWaveKey
+        uint64 SeekPointsUseCount = 0;
+        std::atomic<bool> bRefillInFlight = false;
+
+        // What Resolve returns when it looked the wave up: one lookup, hit if a cache file or seek points were found,
+        // reported through GetCacheStats to the operator that resolved it. Forwards everything else.
+        class FResolvedSource : public Metagrain::IGrainSource
+        {
+        public:
+            FResolvedSource(std::shared_ptr<Metagrain::IGrainSource> InSource, bool bInHit)
+                : Source(MoveTemp(InSource))
+                , bHit(bInHit)
+            {
+            }
+
+            virtual const Metagrain::FGrainSourceInfo& GetInfo() const override { return Source->GetInfo(); }
+            virtual std::unique_ptr<Metagrain::IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override
+            {
+                return Source->CreateReader(InStartTimeSeconds, bInLooping, InMaxDecodeSizeInFrames);
+            }
+            virtual void GetCacheStats(uint64_t& OutLookups, uint64_t& OutHits) const override
+            {
+                OutLookups = 1;
+                OutHits = bHit ? 1 : 0;
+            }
+            virtual Metagrain::FGrainResidentAudio GetResidentAudio() const override { return Source->GetResidentAudio(); }
+            virtual uint64_t GetAllocatedBytes() const override { return Source->GetAllocatedBytes(); }
+            virtual const Metagrain::FGrainAnalysis* GetAnalysis() const override { return Source->GetAnalysis(); }
+            virtual void Prefetch(float InStartSeconds, float InEndSeconds) override { Source->Prefetch(InStartSeconds, InEndSeconds); }
+
+        private:
+            std::shared_ptr<Metagrain::IGrainSource> Source;
+            bool bHit = false;
+        };
+
+        FString GetCachePath(uint64 InDecodeKey)
+        {
+            return FPaths::ProjectSavedDir() / TEXT("Metagrain") / TEXT("SourceCache") / FString::Printf(TEXT("%016llx.mgsc"), InDecodeKey);
+        }
+
+        void OnBuildFinished(uint64 InDecodeKey, bool bInSucceeded)
+        {
+            FScopeLock Lock(&CacheLock);
+            PendingBuilds.Remove(InDecodeKey);
+            if (!bInSucceeded)
+            {
+                FailedBuilds.Add(InDecodeKey);
+            }
+        }
+
+        // Decodes the whole wave front to back through the same reader the streaming source uses, so the result holds
+        // exactly the samples grains would otherwise decode. Fails unless every frame was delivered.
+        bool DecodeWave(const FWaveProxyGrainSource& InSource, TFunctionRef<bool(const float*, int32)> InOnFrames, std::string& OutError)
+        {
+            const Metagrain::FGrainSourceInfo& Info = InSource.GetInfo();
+
+            FSoundWaveProxyReader::FSettings ReaderSettings;
+            ReaderSettings.bIsLooping = false;
+            ReaderSettings.MaxDecodeSizeInFrames = DecodeChunkFrames;
+            TUniquePtr<FSoundWaveProxyReader> Reader = FSoundWaveProxyReader::Create(InSource.GetWaveProxy().ToSharedRef(), ReaderSettings);
+            if (!Reader.IsValid())
+            {
+                OutError = "cannot create a reader";
+                return false;
+            }
+
+            Audio::FAlignedFloatBuffer Buffer;
+            Buffer.SetNumUninitialized(DecodeChunkFrames * Info.NumChannels);
+            int64 NumFramesDecoded = 0;
+            while (NumFramesDecoded < Info.NumFrames)
+            {
+                const int32 NumSamples = Reader->PopAudio(Buffer);
+                if (NumSamples <= 0 || Reader->HasFailed())
+                {
+                    break;
+                }
+                const int32 NumFrames = static_cast<int32>(FMath::Min<int64>(NumSamples / Info.NumChannels, Info.NumFrames - NumFramesDecoded));
+                if (!InOnFrames(Buffer.GetData(), NumFrames))
+                {
+                    return false;
+                }
+                NumFramesDecoded += NumFrames;
+            }
+
+            // A short decode would leave grains near the end silent
+            if (NumFramesDecoded != Info.NumFrames)
+            {
+                OutError = "decoded " + std::to_string(NumFramesDecoded) + " of " + std::to_string(Info.NumFrames) + " frames";
+                return false;
+            }
+            return true;
+        }
+
+        // Runs on a background thread
+        void BuildCacheFile(const FWaveProxyGrainSource& InSource, uint64 InDecodeKey, Metagrain::EGrainSampleFormat InFormat)
+        {
+            const Metagrain::FGrainSourceInfo& Info = InSource.GetInfo();
+            const FString Path = GetCachePath(InDecodeKey);
+            IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+
+            std::string Error;
+            Metagrain::FGrainSourceCacheWriter Writer;
+            bool bSucceeded = Writer.Begin(TCHAR_TO_UTF8(*Path), Info.NumChannels, Info.SampleRate, InDecodeKey, InFormat, Error)
+                && DecodeWave(InSource, [&Writer, &Error](const float* InFrames, int32 InNumFrames) { return Writer.Append(InFrames, InNumFrames, Error); }, Error)
+                && Writer.Finish(InSource.GetAnalysis()->GetData(), InSource.GetAnalysis()->GetSize(), Error);
+
+            const FName WaveName = InSource.GetWaveProxy()->GetFName();
+            if (bSucceeded)
+            {
+                UE_LOG(LogMetaSound, Log, TEXT("Metagrain: cached decoded '%s' (%.1f s) -> %s"), *WaveName.ToString(), Info.GetDurationSeconds(), *Path);
+            }
+            else
+            {
+                Writer.Abort();
+                UE_LOG(LogMetaSound, Warning, TEXT("Metagrain: could not cache decoded '%s': %s"), *WaveName.ToString(), UTF8_TO_TCHAR(Error.c_str()));
+            }
+            OnBuildFinished(InDecodeKey, bSucceeded);
+        }
+
+        // Makes room for InBytes more by dropping the points of the least recently used waves. Called with CacheLock held.
+        bool ReserveSeekPointBytes(uint64 InBytes)
+        {
+            const uint64 BudgetBytes = static_cast<uint64>(FMath::Max(0, SeekPointsMaxMegabytes)) * 1024 * 1024;
+            if (InBytes > BudgetBytes)
+            {
+                return false;
+            }
+
+            uint64 UsedBytes = 0;
+            for (const TPair<FName, FSeekPointEntry>& Pair : SeekPoints)
+            {
+                UsedBytes += Pair.Value.Bytes;
+            }
+            while (UsedBytes + InBytes > BudgetBytes && SeekPoints.Num() > 0)
+            {
+                FName Oldest;
+                uint64 OldestUse = MAX_uint64;
+                for (const TPair<FName, FSeekPointEntry>& Pair : SeekPoints)
+                {
+                    if (Pair.Value.LastUsed < OldestUse)
+                    {
+                        Oldest = Pair.Key;
+                        OldestUse = Pair.Value.LastUsed;
+                    }
+                }
+                UsedBytes -= SeekPoints.FindChecked(Oldest).Bytes;
+                SeekPoints.Remove(Oldest);  // Sources still playing from it keep it alive, it is just no longer refilled
+            }
+            return true;
+        }
+
+        // The wave's seek point source, created if it fits the budget, or null. Called with CacheLock held.
+        std::shared_ptr<Metagrain::IGrainSource> FindSeekPoints(const std::shared_ptr<FWaveProxyGrainSource>& InSource)
+        {
+            // Waves of the same name in different folders are different audio
+            const FName WaveKey = MetagrainAnalysis::GetWaveKey(InSource->GetWaveProxy()->GetPackageName(), InSource->GetWaveProxy()->GetFName());
+            const Metagrain::FGrainSourceInfo& Info = InSource->GetInfo();
+            if (FSeekPointEntry* Entry = SeekPoints.Find(WaveKey))
+            {
+                const Metagrain::FGrainSourceInfo& PointsInfo = Entry->Source->GetInfo();
+                if (PointsInfo.NumChannels == Info.NumChannels && PointsInfo.NumFrames == Info.NumFrames && PointsInfo.SampleRate == Info.SampleRate)
+                {
+                    Entry->LastUsed = ++SeekPointsUseCount;
+                    return Entry->Source;
+                }
+                SeekPoints.Remove(WaveKey);  // The wave was re-imported
+            }
+
+            const uint64 BytesPerPoint = static_cast<uint64>(SeekPointDecodeFrames) * Info.NumChannels * sizeof(float) * 2 + SeekPointCodecBytes;
+            const uint64 BudgetBytes = static_cast<uint64>(FMath::Max(0, SeekPointsMaxMegabytes)) * 1024 * 1024;
+            const int32 IntervalFrames = Metagrain::FGrainSeekPointSource::GetIntervalFrames(Info, static_cast<int64>(BudgetBytes / BytesPerPoint), MinSeekPointIntervalFrames);
+            if (IntervalFrames > MaxSeekPointIntervalSeconds * Info.SampleRate)
+            {
+                return nullptr;
+            }
+
+            // Nothing is decoded here, Tick hands the empty points to a worker
+            std::shared_ptr<Metagrain::FGrainSeekPointSource> Points = std::make_shared<Metagrain::FGrainSeekPointSource>(InSource, IntervalFrames, SeekPointDecodeFrames);
+            const uint64 Bytes = static_cast<uint64>(Points->GetNumPoints()) * BytesPerPoint;
+            if (!ReserveSeekPointBytes(Bytes))
+            {
+                return nullptr;
+            }
+
+            FSeekPointEntry& Entry = SeekPoints.Add(WaveKey);
+            Entry.Source = Points;
+            Entry.LastUsed = ++SeekPointsUseCount;
+            Entry.Bytes = Bytes;
+            return Points;
+        }
+
+        // The wave's mapped cache file if it is built, otherwise null after queueing its build. Called with CacheLock held.
+        std::shared_ptr<Metagrain::IGrainSource> FindCacheFile(const std::shared_ptr<FWaveProxyGrainSource>& InSource)
+        {
+            // Keyed by the decoded audio rather than the analysis' content hash, so a wave compressed differently
+            // since its last import gets a new file instead of the stale decode
+            const uint64 DecodeKey = InSource->GetDecodeKey();
+            const Metagrain::FGrainSourceInfo& Info = InSource->GetInfo();
+            const auto MatchesWave = [&Info](const Metagrain::FGrainMappedSource& InCached)
+            {
+                return InCached.GetInfo().NumChannels == Info.NumChannels && InCached.GetInfo().NumFrames == Info.NumFrames
+                    && InCached.GetInfo().SampleRate == Info.SampleRate;
+            };
+
+            if (std::shared_ptr<Metagrain::FGrainMappedSource> Open = OpenSources.FindRef(DecodeKey).lock())
+            {
+                if (MatchesWave(*Open))
+                {
+                    return Open;
+                }
+            }
+            if (PendingBuilds.Contains(DecodeKey) || FailedBuilds.Contains(DecodeKey))
+            {
+                return nullptr;
+            }
+
+            std::string Error;
+            std::shared_ptr<Metagrain::FGrainMappedSource> Cached = Metagrain::FGrainMappedSource::Open(TCHAR_TO_UTF8(*GetCachePath(DecodeKey)), DecodeKey, Error);
+            if (Cached && MatchesWave(*Cached))
+            {
+                OpenSources.Add(DecodeKey, Cached);
+                return Cached;
+            }
+
+            // Missing, or left by an older build of the plugin or a different decode of the wave, build it anew
+            PendingBuilds.Add(DecodeKey);
+            const Metagrain::EGrainSampleFormat Format = CacheFormat == 1 ? Metagrain::EGrainSampleFormat::Int16 : Metagrain::EGrainSampleFormat::Float32;
+            AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [InSource, DecodeKey, Format]()
+            {
+                BuildCacheFile(*InSource, DecodeKey, Format);
+            });
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<Metagrain::IGrainSource> MetagrainSourceCache::Resolve(const std::shared_ptr<FWaveProxyGrainSource>& InSource)
+    {
+        using namespace MetagrainSourceCachePrivate;
+
+        if (!InSource)
+        {
+            return nullptr;
+        }
+
+        const bool bLookUpCacheFile = CacheEnabled && InSource->GetAnalysis();
+        const bool bLookUpSeekPoints = SeekPointsMaxMegabytes > 0;
+        if (!bLookUpCacheFile && !bLookUpSeekPoints)
+        {
+            return InSource;
+        }
+
+        std::shared_ptr<Metagrain::IGrainSource> Found;
+        {
+            FScopeLock Lock(&CacheLock);
+            if (bLookUpCacheFile)
+            {
+                Found = FindCacheFile(InSource);
+            }
+
+            // Also while the wave's cache file builds
+            if (!Found && bLookUpSeekPoints)
+            {
+                Found = FindSeekPoints(InSource);
+            }
+        }
+
+        const bool bHit = Found != nullptr;
+        if (!bHit)
+        {
+            Found = InSource;
+        }
+        return std::make_shared<FResolvedSource>(MoveTemp(Found), bHit);
+    }
+
+    std::shared_ptr<FMetagrainPreparedSource> MetagrainSourceCache::PrepareAsync(const FSoundWaveProxyPtr& InWaveProxy)
+    {
+        std::shared_ptr<FMetagrainPreparedSource> Prepared = std::make_shared<FMetagrainPreparedSource>(InWaveProxy);
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Prepared]()
+        {
+            Prepared->SetSource(Resolve(FWaveProxyGrainSource::Create(Prepared->GetWaveProxy())));
+        });
+        return Prepared;
+    }
+
+    void MetagrainSourceCache::Tick()
+    {
+        using namespace MetagrainSourceCachePrivate;
+
+        // One refill at a time, the next tick picks up whatever grains took meanwhile
+        if (bRefillInFlight.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        TArray<std::shared_ptr<Metagrain::FGrainSeekPointSource>> ToRefill;
+        {
+            FScopeLock Lock(&CacheLock);
+            for (const TPair<FName, FSeekPointEntry>& Pair : SeekPoints)
+            {
+                if (Pair.Value.Source->NeedsRefill())
+                {
+                    ToRefill.Add(Pair.Value.Source);
+                }
+            }
+        }
+        if (ToRefill.IsEmpty())
+        {
+            return;
+        }
+
+        bRefillInFlight.store(true, std::memory_order_release);
+        AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [ToRefill = MoveTemp(ToRefill)]()
+        {
+            for (const std::shared_ptr<Metagrain::FGrainSeekPointSource>& Points : ToRefill)
+            {
+                Points->Refill();
+            }
+            bRefillInFlight.store(false, std::memory_order_release);
+        });
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrainCore/GrainCore.h"
+#include "Sound/SoundWaveProxyReader.h"
+
+#include <atomic>
+
+namespace Metasound
+{
+    class FWaveProxyGrainSource;
+
+    // A wave's grain source prepared on a background task by MetagrainSourceCache::PrepareAsync. Polled by the
+    // operator from the audio thread, the source is only read once IsReady() returns true.
+    class FMetagrainPreparedSource
+    {
+    public:
+        explicit FMetagrainPreparedSource(const FSoundWaveProxyPtr& InWaveProxy) : WaveProxy(InWaveProxy) {}
+
+        bool IsReady() const { return bIsReady.load(std::memory_order_acquire); }
+
+        // Null if the wave cannot be read
+        const std::shared_ptr<Metagrain::IGrainSource>& GetSource() const { return Source; }
+        const FSoundWaveProxyPtr& GetWaveProxy() const { return WaveProxy; }
+
+        // Called once, by the background task
+        void SetSource(std::shared_ptr<Metagrain::IGrainSource> InSource)
+        {
+            Source = std::move(InSource);
+            bIsReady.store(true, std::memory_order_release);
+        }
+
+    private:
+        FSoundWaveProxyPtr WaveProxy;
+        std::shared_ptr<Metagrain::IGrainSource> Source;
+        std::atomic<bool> bIsReady = false;
+    };
+
+    // Faster stand-ins for streaming wave sources, tried in this order:
+    //
+    // Persistent cache of fully decoded waves under Saved/Metagrain/SourceCache, one file per decode key (see
+    // GrainCore/GrainSourceCache.h and MetagrainAnalysis::Find). The first time a wave plays it streams as usual while a
+    // background task decodes it into a cache file; from then on, including after an editor restart, the wave opens as a
+    // mapped source that plays without decoding or seeking. Only waves with Metagrain Analysis user data are cached, since
+    // their analysis carries the content hash the key starts from; the wave's codec, compression quality and sample rate
+    // complete it, so recompressing a wave without reimporting it builds a new file. Controlled by metagrain.sourcecache.
+    //
+    // Every other wave, and a wave whose cache file is still building, gets seek points if they fit
+    // metagrain.seekpoints.maxmb (see GrainCore/GrainSeekPoints.h): decoders parked at fixed intervals through the wave
+    // by a worker, so a grain decodes forward from the point before its start instead of seeking the codec on the
+    // render thread. On in every build, the audio is unchanged.
+    namespace MetagrainSourceCache
+    {
+        // The wave's cache file if it is built, otherwise its seek points, otherwise InSource. Queues the cache file's build.
+        // Unless both are off, the result reports the lookup and whether it hit through IGrainSource::GetCacheStats.
+        std::shared_ptr<Metagrain::IGrainSource> Resolve(const std::shared_ptr<FWaveProxyGrainSource>& InSource);
+
+        // Creates and resolves the wave's source on a background task, for wave changes during playback where the
+        // probe reader and cache lookup would otherwise run on the audio thread.
+        std::shared_ptr<FMetagrainPreparedSource> PrepareAsync(const FSoundWaveProxyPtr& InWaveProxy);
+
+        // Hands seek points that grains took to a background task to refill. Called by the module's ticker.
+        void Tick();
+    }
+}
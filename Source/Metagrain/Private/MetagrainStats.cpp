@@ -0,0 +1,246 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MetagrainStats.h"
+#include "Metagrain.h"
+#include "MetagrainRealtimeCheck.h"
+#include "MetagrainTrace.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#include <atomic>
+
+DEFINE_STAT(STAT_MetagrainExecute);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Live Operators"), STAT_MetagrainLiveOperators, STATGROUP_Metagrain);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Playing Operators"), STAT_MetagrainPlayingOperators, STATGROUP_Metagrain);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Voices"), STAT_MetagrainActiveVoices, STATGROUP_Metagrain);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Grains Started / s"), STAT_MetagrainGrainsStartedPerSecond, STATGROUP_Metagrain);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Grains Dropped / s"), STAT_MetagrainGrainsDroppedPerSecond, STATGROUP_Metagrain);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Readers Created / s"), STAT_MetagrainReadersPerSecond, STATGROUP_Metagrain);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Decoded KB / s"), STAT_MetagrainDecodedKBPerSecond, STATGROUP_Metagrain);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Source Cache Hit Rate (%)"), STAT_MetagrainCacheHitRate, STATGROUP_Metagrain);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Execute Time (ms / s)"), STAT_MetagrainExecuteMsPerSecond, STATGROUP_Metagrain);
+
+CSV_DEFINE_CATEGORY(Metagrain, true);
+
+namespace Metasound
+{
+    namespace MetagrainStatsPrivate
+    {
+        std::atomic<int32> LiveOperators{ 0 };
+        std::atomic<int32> PlayingOperators{ 0 };
+        std::atomic<int32> ActiveVoices{ 0 };
+        std::atomic<uint64> GrainsStarted{ 0 };
+        std::atomic<uint64> GrainsDropped{ 0 };
+        std::atomic<uint64> ReadersCreated{ 0 };
+        std::atomic<uint64> DecodedBytes{ 0 };
+        std::atomic<uint64> CacheLookups{ 0 };
+        std::atomic<uint64> CacheHits{ 0 };
+        std::atomic<uint64> ExecuteCycles{ 0 };
+
+        // Engine and source totals restart from zero when the engine or its source is replaced
+        uint64 GetDelta(uint64 InNow, uint64 InLast)
+        {
+            return (InNow >= InLast) ? InNow - InLast : InNow;
+        }
+
+        struct FTotals
+        {
+            uint64 GrainsStarted = 0;
+            uint64 GrainsDropped = 0;
+            uint64 ReadersCreated = 0;
+            uint64 DecodedBytes = 0;
+            uint64 CacheLookups = 0;
+            uint64 CacheHits = 0;
+            uint64 ExecuteCycles = 0;
+        };
+
+        // Totals at the previous Tick, only touched on the game thread
+        FTotals LastTickTotals;
+    }
+
+    FMetagrainOperatorStats::FMetagrainOperatorStats(const TCHAR* InNodeName, float InSampleRate, int32 InBlockSize)
+        : NodeName(InNodeName)
+    {
+        if (InSampleRate > 0.0f && InBlockSize > 0)
+        {
+            SecondsPerBlock = static_cast<float>(InBlockSize) / InSampleRate;
+            BlocksPerWindow = FMath::Max(1, FMath::RoundToInt(InSampleRate / static_cast<float>(InBlockSize)));
+        }
+
+        ++MetagrainStatsPrivate::LiveOperators;
+        FMetagrainModule::RegisterOperator(this);
+    }
+
+    FMetagrainOperatorStats::~FMetagrainOperatorStats()
+    {
+        using namespace MetagrainStatsPrivate;
+
+        FMetagrainModule::UnregisterOperator(this);
+        --LiveOperators;
+        if (bLastIsPlaying)
+        {
+            --PlayingOperators;
+        }
+        if (LastStats.ActiveVoices != 0)
+        {
+            const int32 NewActiveVoices = ActiveVoices.fetch_sub(LastStats.ActiveVoices) - LastStats.ActiveVoices;
+            TRACE_COUNTER_SET(MetagrainActiveVoices, NewActiveVoices);
+        }
+    }
+
+    void FMetagrainOperatorStats::Report(const Metagrain::FGrainEngineStats& InStats, bool bInIsPlaying, const FMetagrainBlockTiming& InTiming)
+    {
+        using namespace MetagrainStatsPrivate;
+
+        const uint64 BlockCycles = InTiming.TotalCycles;
+
+        const uint64 StartedDelta = GetDelta(InStats.GrainsStarted, LastStats.GrainsStarted);
+        const uint64 DroppedDelta = GetDelta(InStats.GrainsDropped, LastStats.GrainsDropped);
+        const uint64 ReadersDelta = GetDelta(InStats.ReadersCreated, LastStats.ReadersCreated);
+        const uint64 DecodedSamplesDelta = GetDelta(InStats.ReaderSamplesRead, LastStats.ReaderSamplesRead);
+        const uint64 LookupsDelta = GetDelta(InStats.CacheLookups, LastStats.CacheLookups);
+        const uint64 HitsDelta = GetDelta(InStats.CacheHits, LastStats.CacheHits);
+        const int32 VoicesDelta = InStats.ActiveVoices - LastStats.ActiveVoices;
+
+        if (bInIsPlaying != bLastIsPlaying)
+        {
+            PlayingOperators += bInIsPlaying ? 1 : -1;
+            bLastIsPlaying = bInIsPlaying;
+        }
+
+        if (StartedDelta != 0)
+        {
+            const uint64 NewGrainsStarted = GrainsStarted.fetch_add(StartedDelta) + StartedDelta;
+            TRACE_COUNTER_SET(MetagrainGrainsSpawned, static_cast<int64>(NewGrainsStarted));
+        }
+        if (DroppedDelta != 0)
+        {
+            const uint64 NewGrainsDropped = GrainsDropped.fetch_add(DroppedDelta) + DroppedDelta;
+            TRACE_COUNTER_SET(MetagrainGrainsDropped, static_cast<int64>(NewGrainsDropped));
+        }
+        if (VoicesDelta != 0)
+        {
+            const int32 NewActiveVoices = ActiveVoices.fetch_add(VoicesDelta) + VoicesDelta;
+            TRACE_COUNTER_SET(MetagrainActiveVoices, NewActiveVoices);
+        }
+
+        ReadersCreated += ReadersDelta;
+        DecodedBytes += DecodedSamplesDelta * sizeof(float);  // Resident audio is read in place, not decoded
+        CacheLookups += LookupsDelta;
+        CacheHits += HitsDelta;
+        ExecuteCycles += BlockCycles;
+
+        LastStats = InStats;
+
+        LatencyProfile.Record(InTiming, static_cast<int32>(StartedDelta), static_cast<int32>(ReadersDelta), InStats.ActiveVoices);
+
+        bPublishedIsPlaying.store(bInIsPlaying, std::memory_order_relaxed);
+        PublishedActiveVoices.store(InStats.ActiveVoices, std::memory_order_relaxed);
+        PublishedMaxVoices.store(InStats.MaxVoices, std::memory_order_relaxed);
+        PublishedMemoryBytes.store(InStats.VoiceBufferBytes + InStats.SourceBytes, std::memory_order_relaxed);
+
+        ++WindowBlocks;
+        WindowCycles += BlockCycles;
+        WindowPeakCycles = FMath::Max(WindowPeakCycles, BlockCycles);
+        WindowGrainsStarted += StartedDelta;
+        if (WindowBlocks >= BlocksPerWindow)
+        {
+            const float WindowSeconds = WindowBlocks * SecondsPerBlock;
+            PublishedGrainsPerSecond.store(WindowSeconds > 0.0f ? static_cast<float>(WindowGrainsStarted) / WindowSeconds : 0.0f, std::memory_order_relaxed);
+            PublishedAvgExecuteMicroseconds.store(static_cast<float>(FPlatformTime::ToMilliseconds64(WindowCycles) * 1000.0 / WindowBlocks), std::memory_order_relaxed);
+            PublishedPeakExecuteMicroseconds.store(static_cast<float>(FPlatformTime::ToMilliseconds64(WindowPeakCycles) * 1000.0), std::memory_order_relaxed);
+            WindowBlocks = 0;
+            WindowCycles = 0;
+            WindowPeakCycles = 0;
+            WindowGrainsStarted = 0;
+        }
+    }
+
+    void FMetagrainOperatorStats::SetWaveName(FName InWaveName)
+    {
+        // The new wave's source counts its cache lookups from zero, which may equal the last source's count
+        LastStats.CacheLookups = 0;
+        LastStats.CacheHits = 0;
+
+        MetagrainRealtimeCheck::NoteLock();
+        FScopeLock Lock(&WaveNameLock);
+        WaveName = InWaveName;
+    }
+
+    FMetagrainOperatorSnapshot FMetagrainOperatorStats::GetSnapshot() const
+    {
+        FMetagrainOperatorSnapshot Snapshot;
+        Snapshot.NodeName = NodeName;
+        {
+            FScopeLock Lock(&WaveNameLock);
+            Snapshot.WaveName = WaveName;
+        }
+        Snapshot.bIsPlaying = bPublishedIsPlaying.load(std::memory_order_relaxed);
+        Snapshot.ActiveVoices = PublishedActiveVoices.load(std::memory_order_relaxed);
+        Snapshot.MaxVoices = PublishedMaxVoices.load(std::memory_order_relaxed);
+        Snapshot.GrainsPerSecond = PublishedGrainsPerSecond.load(std::memory_order_relaxed);
+        Snapshot.MemoryBytes = PublishedMemoryBytes.load(std::memory_order_relaxed);
+        Snapshot.AvgExecuteMicroseconds = PublishedAvgExecuteMicroseconds.load(std::memory_order_relaxed);
+        Snapshot.PeakExecuteMicroseconds = PublishedPeakExecuteMicroseconds.load(std::memory_order_relaxed);
+        return Snapshot;
+    }
+
+    namespace MetagrainStats
+    {
+        void Tick(float InDeltaSeconds)
+        {
+#if STATS || CSV_PROFILER
+            using namespace MetagrainStatsPrivate;
+
+            if (InDeltaSeconds <= 0.0f)
+            {
+                return;
+            }
+
+            FTotals Totals;
+            Totals.GrainsStarted = GrainsStarted.load();
+            Totals.GrainsDropped = GrainsDropped.load();
+            Totals.ReadersCreated = ReadersCreated.load();
+            Totals.DecodedBytes = DecodedBytes.load();
+            Totals.CacheLookups = CacheLookups.load();
+            Totals.CacheHits = CacheHits.load();
+            Totals.ExecuteCycles = ExecuteCycles.load();
+
+            const double InvDeltaSeconds = 1.0 / InDeltaSeconds;
+            const float GrainsStartedPerSecond = static_cast<float>((Totals.GrainsStarted - LastTickTotals.GrainsStarted) * InvDeltaSeconds);
+            const float GrainsDroppedPerSecond = static_cast<float>((Totals.GrainsDropped - LastTickTotals.GrainsDropped) * InvDeltaSeconds);
+            const float ReadersPerSecond = static_cast<float>((Totals.ReadersCreated - LastTickTotals.ReadersCreated) * InvDeltaSeconds);
+            const float DecodedKBPerSecond = static_cast<float>((Totals.DecodedBytes - LastTickTotals.DecodedBytes) * InvDeltaSeconds / 1024.0);
+            const uint64 Lookups = Totals.CacheLookups - LastTickTotals.CacheLookups;
+            const float CacheHitRate = (Lookups > 0) ? 100.0f * static_cast<float>(Totals.CacheHits - LastTickTotals.CacheHits) / static_cast<float>(Lookups) : 0.0f;
+            const float ExecuteMsPerSecond = static_cast<float>(FPlatformTime::ToMilliseconds64(Totals.ExecuteCycles - LastTickTotals.ExecuteCycles) * InvDeltaSeconds);
+            LastTickTotals = Totals;
+
+            const int32 NumLiveOperators = LiveOperators.load();
+            const int32 NumPlayingOperators = PlayingOperators.load();
+            const int32 NumActiveVoices = ActiveVoices.load();
+
+            SET_DWORD_STAT(STAT_MetagrainLiveOperators, NumLiveOperators);
+            SET_DWORD_STAT(STAT_MetagrainPlayingOperators, NumPlayingOperators);
+            SET_DWORD_STAT(STAT_MetagrainActiveVoices, NumActiveVoices);
+            SET_FLOAT_STAT(STAT_MetagrainGrainsStartedPerSecond, GrainsStartedPerSecond);
+            SET_FLOAT_STAT(STAT_MetagrainGrainsDroppedPerSecond, GrainsDroppedPerSecond);
+            SET_FLOAT_STAT(STAT_MetagrainReadersPerSecond, ReadersPerSecond);
+            SET_FLOAT_STAT(STAT_MetagrainDecodedKBPerSecond, DecodedKBPerSecond);
+            SET_FLOAT_STAT(STAT_MetagrainCacheHitRate, CacheHitRate);
+            SET_FLOAT_STAT(STAT_MetagrainExecuteMsPerSecond, ExecuteMsPerSecond);
+
+            CSV_CUSTOM_STAT(Metagrain, LiveOperators, NumLiveOperators, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, PlayingOperators, NumPlayingOperators, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, ActiveVoices, NumActiveVoices, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, GrainsStartedPerSec, GrainsStartedPerSecond, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, GrainsDroppedPerSec, GrainsDroppedPerSecond, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, ReadersCreatedPerSec, ReadersPerSecond, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, DecodedKBPerSec, DecodedKBPerSecond, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, CacheHitRatePercent, CacheHitRate, ECsvCustomStatOp::Set);
+            CSV_CUSTOM_STAT(Metagrain, ExecuteMsPerSec, ExecuteMsPerSecond, ECsvCustomStatOp::Set);
+#endif
+        }
+    }
+}
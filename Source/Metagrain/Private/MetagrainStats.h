@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrainCore/GrainCore.h"
+#include "HAL/CriticalSection.h"
+#include "MetagrainLatency.h"
+#include "Stats/Stats.h"
+
+#include <atomic>
+
+DECLARE_STATS_GROUP(TEXT("Metagrain"), STATGROUP_Metagrain, STATCAT_Advanced);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Operator Execute"), STAT_MetagrainExecute, STATGROUP_Metagrain, );
+
+namespace Metasound
+{
+    // One operator's state as printed by metagrain.dump.
+    struct FMetagrainOperatorSnapshot
+    {
+        const TCHAR* NodeName = nullptr;
+        FName WaveName;
+        bool bIsPlaying = false;
+        int32 ActiveVoices = 0;
+        int32 MaxVoices = 0;
+        float GrainsPerSecond = 0.0f;
+        uint64 MemoryBytes = 0;
+        float AvgExecuteMicroseconds = 0.0f;
+        float PeakExecuteMicroseconds = 0.0f;
+    };
+
+    // Feeds one operator's load into the module-wide Metagrain stats, CSV counters and Insights counters.
+    // Everything is kept as running totals in atomics, so reporting from the audio threads never locks.
+    class FMetagrainOperatorStats
+    {
+    public:
+        // Registers with the live operator list in FMetagrainModule until destroyed.
+        FMetagrainOperatorStats(const TCHAR* InNodeName, float InSampleRate, int32 InBlockSize);
+        ~FMetagrainOperatorStats();
+
+        FMetagrainOperatorStats(const FMetagrainOperatorStats&) = delete;
+        FMetagrainOperatorStats& operator=(const FMetagrainOperatorStats&) = delete;
+
+        // Call once at the end of every Execute with the engine's running totals.
+        void Report(const Metagrain::FGrainEngineStats& InStats, bool bInIsPlaying, const FMetagrainBlockTiming& InTiming);
+
+        // Call when the operator switches to a new wave (NAME_None once released), on the thread that calls Report.
+        void SetWaveName(FName InWaveName);
+
+        // Safe from any thread. Rates and Execute times cover the last full second of rendered audio.
+        FMetagrainOperatorSnapshot GetSnapshot() const;
+
+        FMetagrainLatencyProfile& GetLatencyProfile() { return LatencyProfile; }
+
+    private:
+        const TCHAR* NodeName;
+        Metagrain::FGrainEngineStats LastStats;
+        bool bLastIsPlaying = false;
+
+        // Rolling one second window, audio thread only
+        float SecondsPerBlock = 0.0f;
+        int32 BlocksPerWindow = 1;
+        int32 WindowBlocks = 0;
+        uint64 WindowCycles = 0;
+        uint64 WindowPeakCycles = 0;
+        uint64 WindowGrainsStarted = 0;
+
+        // Published for GetSnapshot()
+        std::atomic<bool> bPublishedIsPlaying{ false };
+        std::atomic<int32> PublishedActiveVoices{ 0 };
+        std::atomic<int32> PublishedMaxVoices{ 0 };
+        std::atomic<uint64> PublishedMemoryBytes{ 0 };
+        std::atomic<float> PublishedGrainsPerSecond{ 0.0f };
+        std::atomic<float> PublishedAvgExecuteMicroseconds{ 0.0f };
+        std::atomic<float> PublishedPeakExecuteMicroseconds{ 0.0f };
+
+        mutable FCriticalSection WaveNameLock;
+        FName WaveName;
+
+        FMetagrainLatencyProfile LatencyProfile;
+    };
+
+    namespace MetagrainStats
+    {
+        // Turns the running totals into per-second rates for `stat Metagrain` and CSV captures. Game thread, once per frame.
+        void Tick(float InDeltaSeconds);
+    }
+}
@@ -0,0 +1,9 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MetagrainTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(MetagrainChannel);
+
+TRACE_DECLARE_INT_COUNTER(MetagrainGrainsSpawned, TEXT("Metagrain/GrainsSpawned"));
+TRACE_DECLARE_INT_COUNTER(MetagrainGrainsDropped, TEXT("Metagrain/GrainsDropped"));
+TRACE_DECLARE_INT_COUNTER(MetagrainActiveVoices, TEXT("Metagrain/ActiveVoices"));
@@ -0,0 +1,12 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrainCore/GrainTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+// Insights counters, summed across every live operator by FMetagrainOperatorStats.
+TRACE_DECLARE_INT_COUNTER_EXTERN(MetagrainGrainsSpawned);
+TRACE_DECLARE_INT_COUNTER_EXTERN(MetagrainGrainsDropped);
+TRACE_DECLARE_INT_COUNTER_EXTERN(MetagrainActiveVoices);
@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "WaveProxyGrainSource.h"
+#include "MetagrainAnalysisUserData.h"
+#include "MetasoundLog.h"
+#include "DSP/AlignedBuffer.h"
+
+namespace Metasound
+{
+    namespace WaveProxyGrainSourcePrivate
+    {
+        class FWaveProxyGrainSourceReader : public Metagrain::IGrainSourceReader
+        {
+        public:
+            FWaveProxyGrainSourceReader(TUniquePtr<FSoundWaveProxyReader>&& InReader, int32 InNumChannels)
+                : Reader(MoveTemp(InReader))
+                , NumChannels(InNumChannels)
+            {
+            }
+
+            virtual int32_t PopFrames(float* OutInterleaved, int32_t InNumFrames) override
+            {
+                if (!Reader.IsValid() || Reader->HasFailed() || InNumFrames <= 0)
+                {
+                    return 0;
+                }
+
+                InterleavedBuffer.SetNumUninitialized(InNumFrames * NumChannels, EAllowShrinking::No);
+                const int32 SamplesPopped = Reader->PopAudio(InterleavedBuffer);
+                if (SamplesPopped <= 0)
+                {
+                    return 0;
+                }
+
+                FMemory::Memcpy(OutInterleaved, InterleavedBuffer.GetData(), SamplesPopped * sizeof(float));
+                return SamplesPopped / NumChannels;
+            }
+
+            virtual bool Seek(float InStartTimeSeconds, bool bInLooping) override
+            {
+                // Keeps the decoder and its buffers, false for codecs that cannot seek
+                if (!Reader.IsValid() || Reader->HasFailed())
+                {
+                    return false;
+                }
+                Reader->SetIsLooping(bInLooping);
+                return Reader->SeekToTime(FMath::Max(0.0f, InStartTimeSeconds));
+            }
+
+        private:
+            TUniquePtr<FSoundWaveProxyReader> Reader;
+            Audio::FAlignedFloatBuffer InterleavedBuffer;
+            int32 NumChannels = 0;
+        };
+    }
+
+    std::shared_ptr<FWaveProxyGrainSource> FWaveProxyGrainSource::Create(const FSoundWaveProxyPtr& InWaveProxy)
+    {
+        if (!InWaveProxy.IsValid())
+        {
+            return nullptr;
+        }
+
+        FSoundWaveProxyReader::FSettings TempReaderSettings;
+        TUniquePtr<FSoundWaveProxyReader> TempReader = FSoundWaveProxyReader::Create(InWaveProxy.ToSharedRef(), TempReaderSettings);
+        if (!TempReader.IsValid())
+        {
+            UE_LOG(LogMetaSound, Error, TEXT("Metagrain: Failed to create temporary reader for wave asset '%s'."), *InWaveProxy->GetFName().ToString());
+            return nullptr;
+        }
+
+        std::shared_ptr<FWaveProxyGrainSource> Source = std::make_shared<FWaveProxyGrainSource>();
+        Source->WaveProxy = InWaveProxy;
+        Source->Info.NumChannels = TempReader->GetNumChannels();
+        Source->Info.SampleRate = FMath::Max(1.0f, TempReader->GetSampleRate());
+        Source->Info.NumFrames = TempReader->GetNumFramesInWave();
+
+        if (!Source->Info.IsValid())
+        {
+            UE_LOG(LogMetaSound, Error, TEXT("Metagrain: Wave Asset '%s' reports invalid duration (%.2fs) or channels (%d)."),
+                *InWaveProxy->GetFName().ToString(), Source->Info.GetDurationSeconds(), Source->Info.NumChannels);
+            return nullptr;
+        }
+
+        Source->Analysis = MetagrainAnalysis::Find(MetagrainAnalysis::GetWaveKey(InWaveProxy->GetPackageName(), InWaveProxy->GetFName()), Source->Info, Source->DecodeKey);
+        return Source;
+    }
+
+    std::unique_ptr<Metagrain::IGrainSourceReader> FWaveProxyGrainSource::CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames)
+    {
+        FSoundWaveProxyReader::FSettings ReaderSettings;
+        ReaderSettings.StartTimeInSeconds = FMath::Max(0.0f, InStartTimeSeconds);
+        ReaderSettings.bIsLooping = bInLooping;
+
+        const uint32 DecodeSizeQuantization = FSoundWaveProxyReader::DecodeSizeQuantizationInFrames;
+        const uint32 DesiredDecodeSize = FMath::Max(static_cast<uint32>(FMath::Max(1, InMaxDecodeSizeInFrames)), FSoundWaveProxyReader::DefaultMinDecodeSizeInFrames);
+        ReaderSettings.MaxDecodeSizeInFrames = ((DesiredDecodeSize + DecodeSizeQuantization - 1) / DecodeSizeQuantization) * DecodeSizeQuantization;
+
+        TUniquePtr<FSoundWaveProxyReader> Reader = FSoundWaveProxyReader::Create(WaveProxy.ToSharedRef(), ReaderSettings);
+        if (!Reader.IsValid())
+        {
+            UE_LOG(LogMetaSound, Verbose, TEXT("Metagrain: Failed to create grain reader at %.3fs."), InStartTimeSeconds);
+            return nullptr;
+        }
+        return std::make_unique<WaveProxyGrainSourcePrivate::FWaveProxyGrainSourceReader>(MoveTemp(Reader), Info.NumChannels);
+    }
+}
@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GrainCore/GrainCore.h"
+#include "Sound/SoundWaveProxyReader.h"
+
+namespace Metasound
+{
+    // Grain source that streams from a sound wave proxy, one FSoundWaveProxyReader per grain.
+    class FWaveProxyGrainSource : public Metagrain::IGrainSource
+    {
+    public:
+        // Probes the wave with a temporary reader and picks up its cooked analysis. Returns null if the wave cannot be read.
+        static std::shared_ptr<FWaveProxyGrainSource> Create(const FSoundWaveProxyPtr& InWaveProxy);
+
+        virtual const Metagrain::FGrainSourceInfo& GetInfo() const override { return Info; }
+        virtual std::unique_ptr<Metagrain::IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override;
+        virtual const Metagrain::FGrainAnalysis* GetAnalysis() const override { return Analysis.get(); }
+
+        const FSoundWaveProxyPtr& GetWaveProxy() const { return WaveProxy; }
+
+        // Key of the wave's decoded audio, see MetagrainAnalysis::Find. 0 without analysis.
+        uint64 GetDecodeKey() const { return DecodeKey; }
+
+    private:
+        FSoundWaveProxyPtr WaveProxy;
+        Metagrain::FGrainSourceInfo Info;
+        std::shared_ptr<const Metagrain::FGrainAnalysis> Analysis;  // From the wave's Metagrain Analysis user data, if it has one
+        uint64 DecodeKey = 0;
+    };
+}
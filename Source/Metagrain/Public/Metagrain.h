@@ -3,7 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "HAL/CriticalSection.h"
 #include "Modules/ModuleManager.h"
+#include "Templates/Function.h"
+
+namespace Metasound
+{
+	class FMetagrainOperatorStats;
+}
 
 class FMetagrainModule : public IModuleInterface
 {
@@ -12,6 +20,26 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+	/** Live operator registry behind metagrain.dump. Touched when operators are created and destroyed, never per block. */
+	static void RegisterOperator(Metasound::FMetagrainOperatorStats* InOperator);
+	static void UnregisterOperator(Metasound::FMetagrainOperatorStats* InOperator);
+
+	/** Runs InCallback for every live operator while holding the registry lock, so keep it short */
+	static void ForEachLiveOperator(TFunctionRef<void(Metasound::FMetagrainOperatorStats&)> InCallback);
+
+	/** Prints every live operator, worst recent Execute peak first */
+	static void DumpOperators(FOutputDevice& Ar);
+
+private:
+	static FCriticalSection OperatorRegistryLock;
+	static TArray<Metasound::FMetagrainOperatorStats*> LiveOperators;
+
+	/** Publishes the aggregated operator load to stat Metagrain and the CSV profiler every frame */
+	FTSTicker::FDelegateHandle StatsTickerHandle;
+
+	/** Hands the seek points grains took to a background refill every frame, see MetagrainSourceCache.h */
+	FTSTicker::FDelegateHandle SeekPointsTickerHandle;
 };
 
 
@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Computes the grain analysis blob the editor stores with waves that carry Metagrain Analysis user data, for a
+// WAV file. Reports what was found and how long the analysis took, so cook cost can be judged for long
+// recordings, and optionally writes the blob (the same bytes the editor would store) or a complete source
+// cache file, which MetagrainRender and MetagrainReplay accept as --in.
+//
+//   MetagrainAnalyze --in field_recording.wav --out field_recording.mganalysis
+//   MetagrainAnalyze --in field_recording.wav --cache field_recording.mgsc --pcm16
+//   MetagrainAnalyze --in drums.wav --onsets                                   list onset times
+
+#include "GrainAnalysis.h"
+#include "GrainSourceCache.h"
+#include "OfflineRender.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace MetagrainTools;
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+            "Usage: MetagrainAnalyze --in <source.wav> [options]\n"
+            "\n"
+            "  --out <file>            Write the analysis blob\n"
+            "  --cache <file.mgsc>     Write a source cache file (audio and analysis, as the plugin's source cache)\n"
+            "  --pcm16                 Store 16-bit PCM in the cache file instead of 32-bit float\n"
+            "  --hop <frames>          Analysis hop (default %d)\n"
+            "  --onsets                Print every onset time\n",
+            Metagrain::FGrainAnalysisBuilder::DefaultHopFrames);
+    }
+}
+
+int main(int ArgC, char** ArgV)
+{
+    std::string InputPath;
+    std::string OutputPath;
+    std::string CachePath;
+    Metagrain::EGrainSampleFormat CacheFormat = Metagrain::EGrainSampleFormat::Float32;
+    int32_t HopFrames = Metagrain::FGrainAnalysisBuilder::DefaultHopFrames;
+    bool bPrintOnsets = false;
+    for (int32_t Index = 1; Index < ArgC; ++Index)
+    {
+        const std::string Arg = ArgV[Index];
+        const bool bHasValue = Index + 1 < ArgC;
+        if (Arg == "--onsets") { bPrintOnsets = true; }
+        else if (Arg == "--pcm16") { CacheFormat = Metagrain::EGrainSampleFormat::Int16; }
+        else if (Arg == "--cache" && bHasValue) { CachePath = ArgV[++Index]; }
+        else if (Arg == "--in" && bHasValue) { InputPath = ArgV[++Index]; }
+        else if (Arg == "--out" && bHasValue) { OutputPath = ArgV[++Index]; }
+        else if (Arg == "--hop" && bHasValue) { HopFrames = std::atoi(ArgV[++Index]); }
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (InputPath.empty())
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::string Error;
+    FWavData Wav;
+    if (!ReadWavFile(InputPath, Wav, Error))
+    {
+        std::fprintf(stderr, "MetagrainAnalyze: %s\n", Error.c_str());
+        return 1;
+    }
+
+    Metagrain::FGrainSourceInfo Info;
+    Info.NumChannels = Wav.NumChannels;
+    Info.SampleRate = static_cast<float>(Wav.SampleRate);
+    Info.NumFrames = Wav.GetNumFrames();
+
+    // Fed in chunks the way the editor feeds decoded PCM
+    constexpr int32_t ChunkFrames = 4096;
+    const auto StartTime = std::chrono::steady_clock::now();
+    const uint64_t ContentHash = Metagrain::HashGrainContent(Wav.Samples.data(), Wav.Samples.size() * sizeof(float));
+    Metagrain::FGrainAnalysisBuilder Builder;
+    Builder.Begin(Info, ContentHash, HopFrames);
+    for (int64_t Frame = 0; Frame < Info.NumFrames; Frame += ChunkFrames)
+    {
+        const int32_t NumFrames = static_cast<int32_t>(std::min<int64_t>(ChunkFrames, Info.NumFrames - Frame));
+        Builder.Append(Wav.Samples.data() + Frame * Info.NumChannels, NumFrames);
+    }
+    const std::vector<uint8_t> Blob = Builder.Finish();
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+    const std::shared_ptr<const Metagrain::FGrainAnalysis> Analysis = Metagrain::FGrainAnalysis::Create(nullptr, Blob.data(), Blob.size(), Error);
+    if (!Analysis)
+    {
+        std::fprintf(stderr, "MetagrainAnalyze: %s\n", Error.c_str());
+        return 1;
+    }
+
+    uint32_t NumVoiced = 0;
+    uint32_t NumWithCrossing = 0;
+    for (uint32_t HopIndex = 0; HopIndex < Analysis->GetNumHops(); ++HopIndex)
+    {
+        NumVoiced += Analysis->GetPitchPeriodFrames(HopIndex) > 0 ? 1 : 0;
+        NumWithCrossing += Analysis->GetZeroCrossingFrame(HopIndex) >= 0 ? 1 : 0;
+    }
+    const double Duration = Info.GetDurationSeconds();
+    const float HopCount = static_cast<float>(std::max(1u, Analysis->GetNumHops()));
+    std::printf("%s: %.1f s, %d ch, %u hops of %d frames, %u onsets, %.0f%% pitched, %.0f%% with a rising zero crossing\n",
+        InputPath.c_str(), Duration, Info.NumChannels, Analysis->GetNumHops(), Analysis->GetHopFrames(), Analysis->GetNumOnsets(),
+        100.0f * NumVoiced / HopCount, 100.0f * NumWithCrossing / HopCount);
+    std::printf("analysis %.3f s (%.0fx real time), blob %.1f KB (%.2f%% of 16-bit PCM)\n", Seconds, Seconds > 0.0 ? Duration / Seconds : 0.0,
+        Blob.size() / 1024.0, 100.0 * static_cast<double>(Blob.size()) / std::max<double>(1.0, static_cast<double>(Wav.Samples.size()) * 2.0));
+
+    if (bPrintOnsets)
+    {
+        for (uint32_t Onset = 0; Onset < Analysis->GetNumOnsets(); ++Onset)
+        {
+            std::printf("  onset %4u  %10.3f s\n", Onset, static_cast<double>(Analysis->GetOnsetFrame(Onset)) / Info.SampleRate);
+        }
+    }
+
+    if (!OutputPath.empty() && !WriteBinaryFile(OutputPath, Blob, Error))
+    {
+        std::fprintf(stderr, "MetagrainAnalyze: %s\n", Error.c_str());
+        return 1;
+    }
+
+    if (!CachePath.empty())
+    {
+        Metagrain::FGrainSourceCacheWriter Writer;
+        const bool bWritten = Writer.Begin(CachePath, Info.NumChannels, Info.SampleRate, ContentHash, CacheFormat, Error)
+            && Writer.Append(Wav.Samples.data(), static_cast<int32_t>(Info.NumFrames), Error)
+            && Writer.Finish(Blob.data(), Blob.size(), Error);
+        if (!bWritten)
+        {
+            std::fprintf(stderr, "MetagrainAnalyze: %s\n", Error.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
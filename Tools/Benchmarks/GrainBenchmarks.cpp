@@ -0,0 +1,358 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Micro-benchmarks for the grain render path. Each benchmark drives the same engine Process()
+// call the Metasound operators make from Execute(), fed by a synthetic in-memory source.
+//
+// Reported counters:
+//   ns/frame        wall time per output frame (one stereo sample pair)
+//   ns/grain-start  wall time per grain started, amortized over the whole render
+//   grains/block    average grains started per block
+//
+// Run e.g. `MetagrainBenchmarks --benchmark_filter=Synth` or add `--benchmark_format=csv` for budgets.
+// Grain records captured in game are timed with `MetagrainReplay --repeat` instead.
+
+#include "GrainCapture.h"
+#include "GrainCore.h"
+#include "GrainRecord.h"
+#include "GrainWaveTable.h"
+#include "SyntheticSource.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    using namespace Metagrain;
+
+    constexpr float BenchSampleRate = 48000.0f;
+    constexpr float BenchSourceSeconds = 4.0f;
+
+    const std::shared_ptr<FGrainMemorySource>& GetSource(int32_t InNumChannels)
+    {
+        static std::shared_ptr<FGrainMemorySource> Sources[8];
+        std::shared_ptr<FGrainMemorySource>& Source = Sources[InNumChannels & 7];
+        if (!Source)
+        {
+            Source = MetagrainTools::MakeSyntheticSource(InNumChannels, BenchSampleRate, BenchSourceSeconds);
+        }
+        return Source;
+    }
+
+    template <typename EngineType, typename ProcessFunc>
+    void RunRenderLoop(benchmark::State& State, EngineType& Engine, int32_t InBlockSize, ProcessFunc&& Process)
+    {
+        std::vector<float> Left(InBlockSize);
+        std::vector<float> Right(InBlockSize);
+
+        // Let the scheduler reach a steady voice count before timing
+        for (int32_t Block = 0; Block < 64; ++Block)
+        {
+            Process(Left.data(), Right.data());
+            Engine.ClearSpawnEvents();
+        }
+
+        int64_t NumBlocks = 0;
+        int64_t NumGrainStarts = 0;
+        const auto StartTime = std::chrono::steady_clock::now();
+        for (auto _ : State)
+        {
+            Process(Left.data(), Right.data());
+            NumGrainStarts += static_cast<int64_t>(Engine.GetSpawnEvents().size());
+            Engine.ClearSpawnEvents();
+            benchmark::DoNotOptimize(Left.data());
+            benchmark::DoNotOptimize(Right.data());
+            ++NumBlocks;
+        }
+        const double ElapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - StartTime).count();
+
+        const int64_t NumFrames = NumBlocks * InBlockSize;
+        State.SetItemsProcessed(NumFrames);
+        State.counters["ns/frame"] = NumFrames > 0 ? ElapsedNs / static_cast<double>(NumFrames) : 0.0;
+        State.counters["ns/grain-start"] = NumGrainStarts > 0 ? ElapsedNs / static_cast<double>(NumGrainStarts) : 0.0;
+        State.counters["grains/block"] = NumBlocks > 0 ? static_cast<double>(NumGrainStarts) / static_cast<double>(NumBlocks) : 0.0;
+        State.counters["voices"] = static_cast<double>(Engine.GetVoicePool().GetNumActiveVoices());
+    }
+
+    // Args: active voices, grain ms, pitch semitones, reverse chance %, channels, block size. The lite engine ignores
+    // pitch and reverse chance.
+    template <typename EngineType>
+    void BM_SynthRender(benchmark::State& State)
+    {
+        const int32_t BlockSize = static_cast<int32_t>(State.range(5));
+
+        EngineType Engine;
+        Engine.Init(BenchSampleRate, BlockSize);
+        Engine.GetRandom().Seed(1234);
+        Engine.SetSource(GetSource(static_cast<int32_t>(State.range(4))));
+
+        FGranularSynthParams Params;
+        Params.ActiveVoices = static_cast<float>(State.range(0));
+        Params.GrainDurationMs = static_cast<float>(State.range(1));
+        Params.PitchShiftSemitones = static_cast<float>(State.range(2));
+        Params.ReverseChancePercent = static_cast<float>(State.range(3));
+        Params.StartPointRandMs = 2000.0f;
+        Params.PanRand = 0.5f;
+        Params.TimeJitterPercent = 20.0f;
+
+        Engine.Start(Params, 0);
+        RunRenderLoop(State, Engine, BlockSize, [&](float* OutLeft, float* OutRight) { Engine.Process(Params, OutLeft, OutRight); });
+    }
+
+    // Args: active voices, grain ms, frequency Hz, index rand (tables). Grains read a bank of 64 single-cycle tables
+    // in place, compare with BM_SynthRender at the same voices and grain length.
+    void BM_SynthWaveTable(benchmark::State& State)
+    {
+        constexpr int32_t BlockSize = 256;
+        static const std::shared_ptr<FGrainWaveTableSource> Source = MetagrainTools::MakeSyntheticWaveTableSource(64, 2048, BenchSampleRate);
+
+        FGranularSynthForwardEngine Engine;
+        Engine.Init(BenchSampleRate, BlockSize);
+        Engine.GetRandom().Seed(1234);
+        Engine.SetSource(Source);
+
+        FGranularSynthParams Params;
+        Params.ActiveVoices = static_cast<float>(State.range(0));
+        Params.GrainDurationMs = static_cast<float>(State.range(1));
+        Params.FrameRatioScale = Source->GetFrameRatio(static_cast<float>(State.range(2)), BenchSampleRate);
+        Params.StartPointSeconds = Source->GetTableStartSeconds(16.0f);
+        Params.StartPointRandMs = (1.0f + static_cast<float>(State.range(3))) * Source->GetTableSeconds() * 1000.0f;
+        Params.PanRand = 0.5f;
+        Params.TimeJitterPercent = 20.0f;
+
+        Engine.Start(Params, 0);
+        RunRenderLoop(State, Engine, BlockSize, [&](float* OutLeft, float* OutRight) { Engine.Process(Params, OutLeft, OutRight); });
+    }
+
+    // Args: active voices, grain ms, pitch shift semitones. Live input is captured into the ring every block, as
+    // the live input operator does, and grains read it at the widest delay range the ring allows.
+    void BM_SynthLiveInput(benchmark::State& State)
+    {
+        constexpr int32_t BlockSize = 256;
+        const float* Input = static_cast<const float*>(GetSource(1)->GetResidentAudio().Samples);
+        const int64_t InputFrames = GetSource(1)->GetInfo().NumFrames;
+
+        const std::shared_ptr<FGrainCaptureSource> Capture = std::make_shared<FGrainCaptureSource>(static_cast<int32_t>(BenchSourceSeconds * BenchSampleRate), BenchSampleRate);
+
+        FGranularSynthForwardEngine Engine;
+        Engine.Init(BenchSampleRate, BlockSize);
+        Engine.GetRandom().Seed(1234);
+        Engine.SetSource(Capture);
+
+        FGranularSynthParams Params;
+        Params.ActiveVoices = static_cast<float>(State.range(0));
+        Params.GrainDurationMs = static_cast<float>(State.range(1));
+        Params.PitchShiftSemitones = static_cast<float>(State.range(2));
+        Params.PanRand = 0.5f;
+        Params.TimeJitterPercent = 20.0f;
+
+        const float FrameRatio = std::pow(2.0f, Params.PitchShiftSemitones / 12.0f);
+        float MinDelaySeconds = 0.0f;
+        float MaxDelaySeconds = 0.0f;
+        Capture->GetDelayLimits(Params.GrainDurationMs / 1000.0f, FrameRatio, FrameRatio, BlockSize, MinDelaySeconds, MaxDelaySeconds);
+        Params.StartPointSeconds = Capture->GetStartSeconds(0, MaxDelaySeconds);
+        Params.StartPointRandMs = (MaxDelaySeconds - MinDelaySeconds) * 1000.0f;
+
+        int64_t InputFrame = 0;
+        auto ProcessBlock = [&](float* OutLeft, float* OutRight)
+        {
+            const int64_t WriteFrame = Capture->GetWriteFrame();
+            Capture->Write(Input + InputFrame, BlockSize);
+            InputFrame = (InputFrame + BlockSize + BlockSize <= InputFrames) ? InputFrame + BlockSize : 0;
+            Params.StartPointSeconds = Capture->GetStartSeconds(WriteFrame, MaxDelaySeconds);
+            Engine.Process(Params, OutLeft, OutRight);
+        };
+
+        Engine.Start(Params, 0);
+        RunRenderLoop(State, Engine, BlockSize, ProcessBlock);
+    }
+
+    // Args: grain density, grain ms, window shape, channels, block size, playback speed %
+    void BM_SmoothRender(benchmark::State& State)
+    {
+        const int32_t BlockSize = static_cast<int32_t>(State.range(4));
+
+        FGranularSmoothEngine Engine;
+        Engine.Init(BenchSampleRate, BlockSize);
+        Engine.GetRandom().Seed(1234);
+        Engine.SetSource(GetSource(static_cast<int32_t>(State.range(3))));
+
+        FGranularSmoothParams Params;
+        Params.GrainDensity = static_cast<int32_t>(State.range(0));
+        Params.GrainDurationMs = static_cast<float>(State.range(1));
+        Params.WindowShape = static_cast<int32_t>(State.range(2));
+        Params.PlaybackSpeedPercent = static_cast<float>(State.range(5));
+        // The smooth scheduler only fires Density / MaxGrainVoices of its ticks, so tick fast enough
+        // to actually hold "density" overlapping grains.
+        Params.GrainsPerSecond = FGranularSmoothEngine::MaxGrainVoices * 1000.0f / Params.GrainDurationMs;
+        Params.PitchRandSemitones = 2.0f;
+        Params.PanRand = 0.5f;
+
+        Engine.Start();
+        RunRenderLoop(State, Engine, BlockSize, [&](float* OutLeft, float* OutRight) { Engine.Process(Params, OutLeft, OutRight); });
+    }
+
+    // Isolates grain start cost: very short grains at full density, so nearly every block restarts voices.
+    // Args: channels, reverse chance %
+    void BM_SynthGrainStart(benchmark::State& State)
+    {
+        constexpr int32_t BlockSize = 256;
+
+        FGranularSynthEngine Engine;
+        Engine.Init(BenchSampleRate, BlockSize);
+        Engine.GetRandom().Seed(1234);
+        Engine.SetSource(GetSource(static_cast<int32_t>(State.range(0))));
+
+        FGranularSynthParams Params;
+        Params.ActiveVoices = static_cast<float>(FGranularSynthEngine::MaxGrainVoices);
+        Params.GrainDurationMs = 5.0f;
+        Params.ReverseChancePercent = static_cast<float>(State.range(1));
+        Params.StartPointRandMs = 3000.0f;
+
+        Engine.Start(Params, 0);
+        RunRenderLoop(State, Engine, BlockSize, [&](float* OutLeft, float* OutRight) { Engine.Process(Params, OutLeft, OutRight); });
+    }
+
+    // Records ReplaySeconds of an engine once per argument set, so BM_Replay times the voice pool alone
+    constexpr float ReplaySeconds = 8.0f;
+    constexpr int32_t ReplayBlockSize = 256;
+
+    const FGrainRecording& GetReplayRecording(bool bInSmooth, int32_t InNumChannels)
+    {
+        static FGrainRecording Recordings[2][8];
+        FGrainRecording& Recording = Recordings[bInSmooth ? 1 : 0][InNumChannels & 7];
+        if (Recording.NumBlocks > 0)
+        {
+            return Recording;
+        }
+
+        FGrainRecorder Recorder;
+        Recorder.Begin(bInSmooth ? EGrainRecordNode::Smooth : EGrainRecordNode::Synth, BenchSampleRate, ReplayBlockSize,
+            bInSmooth ? FGranularSmoothEngine::MaxGrainVoices : FGranularSynthEngine::MaxGrainVoices);
+
+        std::vector<float> Left(ReplayBlockSize);
+        std::vector<float> Right(ReplayBlockSize);
+        const int32_t NumBlocks = static_cast<int32_t>(ReplaySeconds * BenchSampleRate) / ReplayBlockSize;
+        if (bInSmooth)
+        {
+            FGranularSmoothEngine Engine;
+            Engine.Init(BenchSampleRate, ReplayBlockSize);
+            Engine.GetRandom().Seed(1234);
+            Engine.SetSource(GetSource(InNumChannels));
+            Engine.SetRecorder(&Recorder);
+
+            FGranularSmoothParams Params;
+            Params.GrainDensity = 16;
+            Params.GrainsPerSecond = FGranularSmoothEngine::MaxGrainVoices * 1000.0f / Params.GrainDurationMs;
+            Params.PitchRandSemitones = 2.0f;
+            Params.PanRand = 0.5f;
+
+            Engine.Start();
+            for (int32_t Block = 0; Block < NumBlocks; ++Block)
+            {
+                Engine.Process(Params, Left.data(), Right.data());
+                Engine.ClearSpawnEvents();
+            }
+            Engine.SetRecorder(nullptr);
+        }
+        else
+        {
+            FGranularSynthEngine Engine;
+            Engine.Init(BenchSampleRate, ReplayBlockSize);
+            Engine.GetRandom().Seed(1234);
+            Engine.SetSource(GetSource(InNumChannels));
+            Engine.SetRecorder(&Recorder);
+
+            FGranularSynthParams Params;
+            Params.ActiveVoices = 16.0f;
+            Params.PitchRandSemitones = 5.0f;
+            Params.ReverseChancePercent = 25.0f;
+            Params.StartPointRandMs = 2000.0f;
+            Params.PanRand = 0.5f;
+
+            Engine.Start(Params, 0);
+            for (int32_t Block = 0; Block < NumBlocks; ++Block)
+            {
+                Engine.Process(Params, Left.data(), Right.data());
+                Engine.ClearSpawnEvents();
+            }
+            Engine.SetRecorder(nullptr);
+        }
+
+        const std::vector<uint8_t>& Bytes = Recorder.Finish();
+        std::string Error;
+        Recording.Parse(Bytes.data(), Bytes.size(), Error);
+        return Recording;
+    }
+
+    // Replays a recorded session: the same grains as the live render, without scheduling or random draws.
+    // Comparing against BM_SynthRender/BM_SmoothRender separates render cost from scheduler cost.
+    // Args: node (0 synth, 1 smooth), channels
+    void BM_Replay(benchmark::State& State)
+    {
+        const FGrainRecording& Recording = GetReplayRecording(State.range(0) != 0, static_cast<int32_t>(State.range(1)));
+
+        FGrainReplayer Replayer;
+        std::string Error;
+        if (!Replayer.Init(Recording, GetSource(static_cast<int32_t>(State.range(1))), Error))
+        {
+            State.SkipWithError(Error.c_str());
+            return;
+        }
+
+        std::vector<float> Left(ReplayBlockSize);
+        std::vector<float> Right(ReplayBlockSize);
+        int64_t NumBlocks = 0;
+        for (auto _ : State)
+        {
+            if (!Replayer.Process(Left.data(), Right.data()))
+            {
+                State.PauseTiming();
+                Replayer.Rewind();
+                State.ResumeTiming();
+                continue;
+            }
+            benchmark::DoNotOptimize(Left.data());
+            benchmark::DoNotOptimize(Right.data());
+            ++NumBlocks;
+        }
+
+        State.SetItemsProcessed(NumBlocks * ReplayBlockSize);
+        State.counters["grains/block"] = Recording.NumBlocks > 0 ? static_cast<double>(Recording.NumGrains) / Recording.NumBlocks : 0.0;
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_SynthRender, Metagrain::FGranularSynthEngine)
+    ->ArgNames({ "voices", "grain_ms", "pitch_st", "reverse_pct", "channels", "block" })
+    ->ArgsProduct({ { 1, 8, 32 }, { 10, 100, 500 }, { -12, 0, 7 }, { 0, 50 }, { 1, 2 }, { 256 } })
+    ->ArgsProduct({ { 8, 32 }, { 1, 2 }, { 0, 7 }, { 0 }, { 2 }, { 256 } })
+    ->ArgsProduct({ { 8 }, { 100 }, { 0 }, { 0 }, { 2 }, { 64, 128, 256, 512, 1024 } });
+
+BENCHMARK_TEMPLATE(BM_SynthRender, Metagrain::FGranularSynthLiteEngine)
+    ->ArgNames({ "voices", "grain_ms", "pitch_st", "reverse_pct", "channels", "block" })
+    ->ArgsProduct({ { 1, 8, 32 }, { 10, 100, 500 }, { 0 }, { 0 }, { 1, 2 }, { 256 } });
+
+BENCHMARK(BM_SynthWaveTable)
+    ->ArgNames({ "voices", "grain_ms", "freq_hz", "index_rand" })
+    ->ArgsProduct({ { 8, 32 }, { 2, 10, 100 }, { 110, 880 }, { 0, 8 } });
+
+BENCHMARK(BM_SynthLiveInput)
+    ->ArgNames({ "voices", "grain_ms", "pitch" })
+    ->ArgsProduct({ { 8, 32 }, { 10, 100 }, { 0, 7 } });
+
+BENCHMARK(BM_SmoothRender)
+    ->ArgNames({ "density", "grain_ms", "window", "channels", "block", "speed_pct" })
+    ->ArgsProduct({ { 1, 8, 32 }, { 20, 100, 500 }, { 0, 2, 4, 5 }, { 1, 2 }, { 256 }, { 100 } })
+    ->ArgsProduct({ { 8 }, { 100 }, { 4 }, { 2 }, { 64, 256, 1024 }, { 0, 100, 400 } });
+
+BENCHMARK(BM_SynthGrainStart)
+    ->ArgNames({ "channels", "reverse_pct" })
+    ->ArgsProduct({ { 1, 2, 6 }, { 0, 100 } });
+
+BENCHMARK(BM_Replay)
+    ->ArgNames({ "node", "channels" })
+    ->ArgsProduct({ { 0, 1 }, { 1, 2 } });
+
+BENCHMARK_MAIN();
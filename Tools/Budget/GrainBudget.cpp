@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// CPU budget check for both granular engines. Each case renders a few seconds offline at a fixed voice
+// count and fails when the engine needs more CPU per rendered second than its budget, or when the output
+// breaks a basic invariant (non-finite samples, silence, runaway level, no grains started).
+//
+//   MetagrainBudget                       check every case against the reference budgets
+//   MetagrainBudget --scale 2             double every budget (e.g. for a slower target platform or a shared CI
+//                                         runner); below 1 tightens them
+//   MetagrainBudget --csv budget.csv      also write the measurements as CSV
+//
+// Budgets are in milliseconds of CPU per second of rendered audio at 48 kHz / 256 frame blocks,
+// roughly 3x the measured cost on a desktop x86-64 core so only real regressions trip them. ctest runs it with
+// looser budgets (see CMakeLists.txt). It times the engines the nodes wrap, not a MetaSound graph: graph-level
+// cost under the Unreal automation framework is not covered here.
+
+#include "OfflineRender.h"
+#include "SyntheticSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+    using namespace MetagrainTools;
+
+    struct FBudgetCase
+    {
+        const char* Name;
+        ERenderNode Node;
+        const char* Script;
+        double BudgetMsPerSecond;
+    };
+
+    const FBudgetCase BudgetCases[] =
+    {
+        { "synth_1_voice", ERenderNode::Synth, "ActiveVoices = 1\nStartPointRandMs = 2000", 2.0 },
+        { "synth_8_voices", ERenderNode::Synth, "ActiveVoices = 8\nStartPointRandMs = 2000\nPanRand = 0.5", 12.0 },
+        { "synth_32_voices", ERenderNode::Synth, "ActiveVoices = 32\nStartPointRandMs = 2000\nPanRand = 0.5", 45.0 },
+        { "synth_lite_32_voices", ERenderNode::SynthLite, "ActiveVoices = 32\nStartPointRandMs = 2000\nPanRand = 0.5", 35.0 },
+        { "synth_micro_2ms", ERenderNode::Synth, "ActiveVoices = 16\nGrainDurationMs = 2\nStartPointRandMs = 2000\nPanRand = 0.5", 45.0 },
+        { "synth_32_voices_pitched_reverse", ERenderNode::Synth, "ActiveVoices = 32\nPitchRandSemitones = 12\nReverseChancePercent = 50\nStartPointRandMs = 2000", 50.0 },
+        { "smooth_8_voices", ERenderNode::Smooth, "GrainDensity = 8\nGrainsPerSecond = 320", 10.0 },
+        { "smooth_32_voices", ERenderNode::Smooth, "GrainDensity = 32\nGrainsPerSecond = 320", 45.0 },
+    };
+
+    constexpr float RenderSeconds = 4.0f;
+    constexpr int32_t NumTimedRenders = 3;
+
+    struct FInvariantResult
+    {
+        bool bAllFinite = true;
+        double Peak = 0.0;
+        double Rms = 0.0;
+    };
+
+    FInvariantResult CheckInvariants(const FRenderResult& InResult)
+    {
+        FInvariantResult Result;
+        double SumSquares = 0.0;
+        for (const std::vector<float>* Channel : { &InResult.Left, &InResult.Right })
+        {
+            for (float Sample : *Channel)
+            {
+                if (!std::isfinite(Sample))
+                {
+                    Result.bAllFinite = false;
+                    continue;
+                }
+                Result.Peak = std::max(Result.Peak, static_cast<double>(std::abs(Sample)));
+                SumSquares += static_cast<double>(Sample) * Sample;
+            }
+        }
+        const size_t NumSamples = InResult.Left.size() + InResult.Right.size();
+        Result.Rms = NumSamples > 0 ? std::sqrt(SumSquares / static_cast<double>(NumSamples)) : 0.0;
+        return Result;
+    }
+}
+
+int main(int ArgC, char** ArgV)
+{
+    double BudgetScale = 1.0;
+    std::string CsvPath;
+    std::string Filter;
+    for (int32_t Index = 1; Index < ArgC; ++Index)
+    {
+        const std::string Arg = ArgV[Index];
+        const bool bHasValue = Index + 1 < ArgC;
+        if (Arg == "--scale" && bHasValue) { BudgetScale = std::atof(ArgV[++Index]); }
+        else if (Arg == "--csv" && bHasValue) { CsvPath = ArgV[++Index]; }
+        else if (Arg == "--filter" && bHasValue) { Filter = ArgV[++Index]; }
+        else
+        {
+            std::fprintf(stderr, "Usage: MetagrainBudget [--scale <factor>] [--csv <file>] [--filter <text>]\n");
+            return 2;
+        }
+    }
+
+    FILE* CsvFile = nullptr;
+    if (!CsvPath.empty())
+    {
+        CsvFile = std::fopen(CsvPath.c_str(), "w");
+        if (CsvFile == nullptr)
+        {
+            std::fprintf(stderr, "MetagrainBudget: cannot write '%s'\n", CsvPath.c_str());
+            return 1;
+        }
+        std::fprintf(CsvFile, "case,node,ms_per_second,budget_ms_per_second,grains,peak,rms,passed\n");
+    }
+
+    std::string Error;
+    int32_t NumFailed = 0;
+    int32_t NumRun = 0;
+    for (const FBudgetCase& Case : BudgetCases)
+    {
+        if (!Filter.empty() && std::string(Case.Name).find(Filter) == std::string::npos)
+        {
+            continue;
+        }
+        ++NumRun;
+
+        FRenderSettings Settings;
+        Settings.Node = Case.Node;
+        Settings.DurationSeconds = RenderSeconds;
+        Settings.Seed = 1;
+        if (!Settings.Script.ParseString(Case.Script, Error) || !ValidateScript(Settings.Script, Case.Node, Error))
+        {
+            std::fprintf(stderr, "MetagrainBudget: case %s: %s\n", Case.Name, Error.c_str());
+            return 1;
+        }
+        const std::shared_ptr<Metagrain::FGrainMemorySource> Source = MakeSyntheticSource(2, Settings.SampleRate, 8.0f);
+
+        // Best of several renders keeps scheduler noise out of the measurement
+        FRenderResult Result;
+        double BestProcessSeconds = 0.0;
+        for (int32_t Attempt = 0; Attempt < NumTimedRenders; ++Attempt)
+        {
+            Result = RenderOffline(Settings, Source);
+            BestProcessSeconds = (Attempt == 0) ? Result.ProcessSeconds : std::min(BestProcessSeconds, Result.ProcessSeconds);
+        }
+
+        const double MsPerSecond = BestProcessSeconds * 1000.0 / RenderSeconds;
+        const double BudgetMsPerSecond = Case.BudgetMsPerSecond * BudgetScale;
+        const FInvariantResult Invariants = CheckInvariants(Result);
+
+        std::string Failure;
+        if (!Invariants.bAllFinite)
+        {
+            Failure = "non-finite samples";
+        }
+        else if (Result.NumGrainStarts == 0)
+        {
+            Failure = "no grains started";
+        }
+        else if (Invariants.Rms < 1.0e-4)
+        {
+            Failure = "output is silent";
+        }
+        else if (Invariants.Peak > static_cast<double>(Metagrain::FGranularSynthEngine::MaxGrainVoices))
+        {
+            Failure = "output level ran away";
+        }
+        else if (MsPerSecond > BudgetMsPerSecond)
+        {
+            Failure = "over budget";
+        }
+
+        const bool bPassed = Failure.empty();
+        NumFailed += bPassed ? 0 : 1;
+        std::printf("%s %-34s %7.2f ms/s (budget %7.2f)  %6lld grains  peak %.3f  %s\n", bPassed ? "ok  " : "FAIL", Case.Name,
+            MsPerSecond, BudgetMsPerSecond, static_cast<long long>(Result.NumGrainStarts), Invariants.Peak, Failure.c_str());
+        if (CsvFile != nullptr)
+        {
+            std::fprintf(CsvFile, "%s,%s,%.4f,%.4f,%lld,%.6f,%.6f,%d\n", Case.Name, LexToString(Case.Node), MsPerSecond, BudgetMsPerSecond,
+                static_cast<long long>(Result.NumGrainStarts), Invariants.Peak, Invariants.Rms, bPassed ? 1 : 0);
+        }
+    }
+
+    if (CsvFile != nullptr)
+    {
+        std::fclose(CsvFile);
+    }
+    std::printf("%d of %d case(s) within budget\n", NumRun - NumFailed, NumRun);
+    return NumFailed > 0 ? 1 : 0;
+}
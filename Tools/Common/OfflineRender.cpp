@@ -0,0 +1,429 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "OfflineRender.h"
+#include "GrainRecord.h"
+#include "GrainSourceCache.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace MetagrainTools
+{
+    namespace OfflineRenderPrivate
+    {
+        std::string Trim(const std::string& InString)
+        {
+            const size_t First = InString.find_first_not_of(" \t\r");
+            if (First == std::string::npos)
+            {
+                return std::string();
+            }
+            const size_t Last = InString.find_last_not_of(" \t\r");
+            return InString.substr(First, Last - First + 1);
+        }
+
+        bool ParseFloat(const std::string& InString, float& OutValue)
+        {
+            char* End = nullptr;
+            OutValue = std::strtof(InString.c_str(), &End);
+            return End != InString.c_str() && *End == '\0';
+        }
+
+        // Common driver for both engines so block timing, script handling and reporting stay identical.
+        template <typename EngineType, typename ParamsType, typename SetParamFunc, typename StartFunc>
+        FRenderResult Render(const FRenderSettings& InSettings, const std::shared_ptr<Metagrain::IGrainSource>& InSource,
+            SetParamFunc&& SetParam, StartFunc&& Start)
+        {
+            FRenderResult Result;
+            const int32_t BlockSize = std::max(1, InSettings.BlockSize);
+            const int64_t NumFrames = static_cast<int64_t>(std::max(0.0f, InSettings.DurationSeconds) * InSettings.SampleRate);
+            const int64_t NumBlocks = (NumFrames + BlockSize - 1) / BlockSize;
+
+            EngineType Engine;
+            Engine.Init(InSettings.SampleRate, BlockSize);
+            Engine.GetRandom().Seed(InSettings.Seed);
+
+            Metagrain::FGrainRecorder Recorder;
+            if (InSettings.bRecordGrains)
+            {
+                Recorder.Begin(InSettings.Node == ERenderNode::Smooth ? Metagrain::EGrainRecordNode::Smooth : Metagrain::EGrainRecordNode::Synth,
+                    InSettings.SampleRate, BlockSize, EngineType::MaxGrainVoices);
+                Engine.SetRecorder(&Recorder);
+            }
+            if (!Engine.SetSource(InSource))
+            {
+                Result.Left.assign(static_cast<size_t>(NumFrames), 0.0f);
+                Result.Right.assign(static_cast<size_t>(NumFrames), 0.0f);
+                return Result;
+            }
+
+            ParamsType Params;
+            Result.Left.resize(static_cast<size_t>(NumBlocks * BlockSize));
+            Result.Right.resize(static_cast<size_t>(NumBlocks * BlockSize));
+
+            const std::vector<FParamScriptEvent>& Events = InSettings.Script.Events;
+            size_t NextEvent = 0;
+            bool bIsPlaying = true;
+            bool bStartPending = true;
+            int32_t StartFrame = 0;
+
+            std::chrono::steady_clock::duration ProcessTime{};
+            for (int64_t Block = 0; Block < NumBlocks; ++Block)
+            {
+                // Parameters change at block boundaries like node inputs, Play and Stop at their frame like triggers
+                const int64_t BlockStartFrame = Block * BlockSize;
+                const float BlockStartSeconds = static_cast<float>(BlockStartFrame) / InSettings.SampleRate;
+                const float BlockEndSeconds = static_cast<float>(BlockStartFrame + BlockSize) / InSettings.SampleRate;
+                while (NextEvent < Events.size())
+                {
+                    const FParamScriptEvent& Event = Events[NextEvent];
+                    const bool bIsTrigger = Event.Type != FParamScriptEvent::EType::SetParam;
+                    if (Event.TimeSeconds > BlockStartSeconds && !(bIsTrigger && Event.TimeSeconds < BlockEndSeconds))
+                    {
+                        break;
+                    }
+                    ++NextEvent;
+
+                    const int32_t Frame = static_cast<int32_t>(std::clamp<int64_t>(
+                        static_cast<int64_t>(Event.TimeSeconds * InSettings.SampleRate) - BlockStartFrame, 0, BlockSize - 1));
+                    switch (Event.Type)
+                    {
+                    case FParamScriptEvent::EType::SetParam:
+                        SetParam(Params, Event.Name, Event.Value);
+                        break;
+                    case FParamScriptEvent::EType::Play:
+                        bIsPlaying = true;
+                        bStartPending = true;
+                        StartFrame = Frame;
+                        break;
+                    case FParamScriptEvent::EType::Stop:
+                        if (bStartPending)
+                        {
+                            Start(Engine, Params, StartFrame);
+                            bStartPending = false;
+                        }
+                        bIsPlaying = false;
+                        Engine.Stop(Frame);
+                        break;
+                    }
+                }
+
+                float* Left = Result.Left.data() + Block * BlockSize;
+                float* Right = Result.Right.data() + Block * BlockSize;
+                if (!bIsPlaying && !bStartPending && !Engine.IsReleasing())
+                {
+                    std::fill(Left, Left + BlockSize, 0.0f);
+                    std::fill(Right, Right + BlockSize, 0.0f);
+                    continue;
+                }
+
+                const auto StartTime = std::chrono::steady_clock::now();
+                if (bStartPending)
+                {
+                    Start(Engine, Params, StartFrame);
+                    bStartPending = false;
+                }
+                Engine.Process(Params, Left, Right);
+                ProcessTime += std::chrono::steady_clock::now() - StartTime;
+
+                Result.NumGrainStarts += static_cast<int64_t>(Engine.GetSpawnEvents().size());
+                Engine.ClearSpawnEvents();
+
+                if (InSettings.OnBlockEnd)
+                {
+                    InSettings.OnBlockEnd();
+                }
+            }
+
+            Result.Left.resize(static_cast<size_t>(NumFrames));
+            Result.Right.resize(static_cast<size_t>(NumFrames));
+            Result.ProcessSeconds = std::chrono::duration<double>(ProcessTime).count();
+            if (InSettings.bRecordGrains)
+            {
+                Engine.SetRecorder(nullptr);
+                Result.GrainRecord = Recorder.Finish();
+            }
+            return Result;
+        }
+    }
+
+    const char* LexToString(ERenderNode InNode)
+    {
+        switch (InNode)
+        {
+            case ERenderNode::SynthLite: return "synth-lite";
+            case ERenderNode::Smooth: return "smooth";
+            default: return "synth";
+        }
+    }
+
+    bool LexFromString(const std::string& InString, ERenderNode& OutNode)
+    {
+        if (InString == "synth")
+        {
+            OutNode = ERenderNode::Synth;
+            return true;
+        }
+        if (InString == "synth-lite")
+        {
+            OutNode = ERenderNode::SynthLite;
+            return true;
+        }
+        if (InString == "smooth")
+        {
+            OutNode = ERenderNode::Smooth;
+            return true;
+        }
+        return false;
+    }
+
+    bool FParamScript::ParseFile(const std::string& InPath, std::string& OutError)
+    {
+        std::ifstream File(InPath);
+        if (!File)
+        {
+            OutError = "cannot open parameter script '" + InPath + "'";
+            return false;
+        }
+        std::stringstream Text;
+        Text << File.rdbuf();
+        return ParseString(Text.str(), OutError);
+    }
+
+    bool FParamScript::ParseString(const std::string& InText, std::string& OutError)
+    {
+        using namespace OfflineRenderPrivate;
+
+        std::istringstream Lines(InText);
+        std::string Line;
+        int32_t LineNumber = 0;
+        while (std::getline(Lines, Line))
+        {
+            ++LineNumber;
+            Line = Trim(Line.substr(0, Line.find('#')));
+            if (Line.empty())
+            {
+                continue;
+            }
+
+            const std::string LinePrefix = "line " + std::to_string(LineNumber) + ": ";
+            FParamScriptEvent Event;
+            if (Line[0] == '@')
+            {
+                const size_t TimeEnd = Line.find_first_of(" \t");
+                if (TimeEnd == std::string::npos || !ParseFloat(Line.substr(1, TimeEnd - 1), Event.TimeSeconds) || Event.TimeSeconds < 0.0f)
+                {
+                    OutError = LinePrefix + "expected '@<seconds> <statement>'";
+                    return false;
+                }
+                Line = Trim(Line.substr(TimeEnd));
+            }
+
+            const size_t Equals = Line.find('=');
+            if (Equals == std::string::npos)
+            {
+                if (Line == "play")
+                {
+                    Event.Type = FParamScriptEvent::EType::Play;
+                }
+                else if (Line == "stop")
+                {
+                    Event.Type = FParamScriptEvent::EType::Stop;
+                }
+                else
+                {
+                    OutError = LinePrefix + "expected 'Name = Value', 'play' or 'stop'";
+                    return false;
+                }
+            }
+            else
+            {
+                Event.Name = Trim(Line.substr(0, Equals));
+                if (Event.Name.empty() || !ParseFloat(Trim(Line.substr(Equals + 1)), Event.Value))
+                {
+                    OutError = LinePrefix + "expected 'Name = Value'";
+                    return false;
+                }
+            }
+            Events.push_back(Event);
+        }
+
+        std::stable_sort(Events.begin(), Events.end(), [](const FParamScriptEvent& A, const FParamScriptEvent& B) { return A.TimeSeconds < B.TimeSeconds; });
+        return true;
+    }
+
+    bool SetSynthParam(Metagrain::FGranularSynthParams& OutParams, const std::string& InName, float InValue)
+    {
+        struct FEntry { const char* Name; float Metagrain::FGranularSynthParams::* Member; };
+        static const FEntry Entries[] =
+        {
+            { "GrainDurationMs", &Metagrain::FGranularSynthParams::GrainDurationMs },
+            { "DurationRandMs", &Metagrain::FGranularSynthParams::DurationRandMs },
+            { "ActiveVoices", &Metagrain::FGranularSynthParams::ActiveVoices },
+            { "TimeJitterPercent", &Metagrain::FGranularSynthParams::TimeJitterPercent },
+            { "StartPointSeconds", &Metagrain::FGranularSynthParams::StartPointSeconds },
+            { "StartPointRandMs", &Metagrain::FGranularSynthParams::StartPointRandMs },
+            { "ReverseChancePercent", &Metagrain::FGranularSynthParams::ReverseChancePercent },
+            { "AttackPercent", &Metagrain::FGranularSynthParams::AttackPercent },
+            { "DecayPercent", &Metagrain::FGranularSynthParams::DecayPercent },
+            { "AttackCurve", &Metagrain::FGranularSynthParams::AttackCurve },
+            { "DecayCurve", &Metagrain::FGranularSynthParams::DecayCurve },
+            { "PitchShiftSemitones", &Metagrain::FGranularSynthParams::PitchShiftSemitones },
+            { "PitchRandSemitones", &Metagrain::FGranularSynthParams::PitchRandSemitones },
+            { "Pan", &Metagrain::FGranularSynthParams::Pan },
+            { "PanRand", &Metagrain::FGranularSynthParams::PanRand },
+            { "VolumeRandPercent", &Metagrain::FGranularSynthParams::VolumeRandPercent },
+        };
+
+        if (InName == "bWarmStart")
+        {
+            OutParams.bWarmStart = InValue != 0.0f;
+            return true;
+        }
+        for (const FEntry& Entry : Entries)
+        {
+            if (InName == Entry.Name)
+            {
+                OutParams.*Entry.Member = InValue;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool SetSmoothParam(Metagrain::FGranularSmoothParams& OutParams, const std::string& InName, float InValue)
+    {
+        struct FEntry { const char* Name; float Metagrain::FGranularSmoothParams::* Member; };
+        static const FEntry Entries[] =
+        {
+            { "GrainDurationMs", &Metagrain::FGranularSmoothParams::GrainDurationMs },
+            { "GrainsPerSecond", &Metagrain::FGranularSmoothParams::GrainsPerSecond },
+            { "PlaybackSpeedPercent", &Metagrain::FGranularSmoothParams::PlaybackSpeedPercent },
+            { "PlayPositionPercent", &Metagrain::FGranularSmoothParams::PlayPositionPercent },
+            { "PlayRangeMs", &Metagrain::FGranularSmoothParams::PlayRangeMs },
+            { "DurationRandMs", &Metagrain::FGranularSmoothParams::DurationRandMs },
+            { "AttackPercent", &Metagrain::FGranularSmoothParams::AttackPercent },
+            { "DecayPercent", &Metagrain::FGranularSmoothParams::DecayPercent },
+            { "PitchShiftSemitones", &Metagrain::FGranularSmoothParams::PitchShiftSemitones },
+            { "PitchRandSemitones", &Metagrain::FGranularSmoothParams::PitchRandSemitones },
+            { "Pan", &Metagrain::FGranularSmoothParams::Pan },
+            { "PanRand", &Metagrain::FGranularSmoothParams::PanRand },
+            { "TimeJitterMs", &Metagrain::FGranularSmoothParams::TimeJitterMs },
+            { "VolumeRandPercent", &Metagrain::FGranularSmoothParams::VolumeRandPercent },
+            { "SmoothingPercent", &Metagrain::FGranularSmoothParams::SmoothingPercent },
+            { "GrainOverlap", &Metagrain::FGranularSmoothParams::GrainOverlap },
+        };
+        struct FIntEntry { const char* Name; int32_t Metagrain::FGranularSmoothParams::* Member; };
+        static const FIntEntry IntEntries[] =
+        {
+            { "GrainDensity", &Metagrain::FGranularSmoothParams::GrainDensity },
+            { "WindowShape", &Metagrain::FGranularSmoothParams::WindowShape },
+            { "XfadeCurve", &Metagrain::FGranularSmoothParams::XfadeCurve },
+        };
+
+        for (const FEntry& Entry : Entries)
+        {
+            if (InName == Entry.Name)
+            {
+                OutParams.*Entry.Member = InValue;
+                return true;
+            }
+        }
+        for (const FIntEntry& Entry : IntEntries)
+        {
+            if (InName == Entry.Name)
+            {
+                OutParams.*Entry.Member = static_cast<int32_t>(InValue);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ValidateScript(const FParamScript& InScript, ERenderNode InNode, std::string& OutError)
+    {
+        Metagrain::FGranularSynthParams SynthParams;
+        Metagrain::FGranularSmoothParams SmoothParams;
+        for (const FParamScriptEvent& Event : InScript.Events)
+        {
+            if (Event.Type != FParamScriptEvent::EType::SetParam)
+            {
+                continue;
+            }
+            const bool bKnown = (InNode != ERenderNode::Smooth) ? SetSynthParam(SynthParams, Event.Name, Event.Value) : SetSmoothParam(SmoothParams, Event.Name, Event.Value);
+            if (!bKnown)
+            {
+                OutError = "unknown " + std::string(LexToString(InNode)) + " parameter '" + Event.Name + "'";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    FRenderResult RenderOffline(const FRenderSettings& InSettings, const std::shared_ptr<Metagrain::IGrainSource>& InSource)
+    {
+        using namespace Metagrain;
+
+        if (InSettings.Node == ERenderNode::Smooth)
+        {
+            return OfflineRenderPrivate::Render<FGranularSmoothEngine, FGranularSmoothParams>(InSettings, InSource,
+                [](FGranularSmoothParams& OutParams, const std::string& InName, float InValue) { SetSmoothParam(OutParams, InName, InValue); },
+                [](FGranularSmoothEngine& Engine, const FGranularSmoothParams&, int32_t InFrame) { Engine.Start(InFrame); });
+        }
+
+        if (InSettings.Node == ERenderNode::SynthLite)
+        {
+            return OfflineRenderPrivate::Render<FGranularSynthLiteEngine, FGranularSynthParams>(InSettings, InSource,
+                [](FGranularSynthParams& OutParams, const std::string& InName, float InValue) { SetSynthParam(OutParams, InName, InValue); },
+                [](FGranularSynthLiteEngine& Engine, const FGranularSynthParams& InParams, int32_t InFrame) { Engine.Start(InParams, InFrame); });
+        }
+
+        return OfflineRenderPrivate::Render<FGranularSynthEngine, FGranularSynthParams>(InSettings, InSource,
+            [](FGranularSynthParams& OutParams, const std::string& InName, float InValue) { SetSynthParam(OutParams, InName, InValue); },
+            [](FGranularSynthEngine& Engine, const FGranularSynthParams& InParams, int32_t InFrame) { Engine.Start(InParams, InFrame); });
+    }
+
+    std::shared_ptr<Metagrain::IGrainSource> OpenSourceFile(const std::string& InPath, std::string& OutError)
+    {
+        const std::string CacheExtension = ".mgsc";
+        if (InPath.size() > CacheExtension.size() && InPath.compare(InPath.size() - CacheExtension.size(), CacheExtension.size(), CacheExtension) == 0)
+        {
+            return Metagrain::FGrainMappedSource::Open(InPath, 0, OutError);
+        }
+
+        FWavData Wav;
+        if (!ReadWavFile(InPath, Wav, OutError))
+        {
+            return nullptr;
+        }
+        return std::make_shared<Metagrain::FGrainMemorySource>(std::move(Wav.Samples), Wav.NumChannels, static_cast<float>(Wav.SampleRate));
+    }
+
+    bool WriteBinaryFile(const std::string& InPath, const std::vector<uint8_t>& InBytes, std::string& OutError)
+    {
+        std::ofstream File(InPath, std::ios::binary);
+        if (!File.write(reinterpret_cast<const char*>(InBytes.data()), static_cast<std::streamsize>(InBytes.size())))
+        {
+            OutError = "cannot write '" + InPath + "'";
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadBinaryFile(const std::string& InPath, std::vector<uint8_t>& OutBytes, std::string& OutError)
+    {
+        std::ifstream File(InPath, std::ios::binary);
+        if (!File)
+        {
+            OutError = "cannot open '" + InPath + "'";
+            return false;
+        }
+        OutBytes.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Offline (faster than real time) rendering of either granular engine, driven by a parameter script.
+//
+// Parameter script format, one statement per line, '#' starts a comment:
+//
+//     GrainDurationMs = 80            # applied before the first block
+//     @1.5 PitchShiftSemitones = 7    # applied at the first block starting at or after 1.5 s
+//     @4.0 stop                       # stop at that frame, playing grains fade out as with the Stop trigger
+//     @5.0 play                       # start playback again at that frame
+//
+// Parameter names are the FGranularSynthParams / FGranularSmoothParams member names.
+
+#include "GrainCore.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace MetagrainTools
+{
+    enum class ERenderNode : uint8_t
+    {
+        Synth,
+        SynthLite,  // Granular Synth (Lite): forward grains at the source pitch
+        Smooth
+    };
+
+    const char* LexToString(ERenderNode InNode);
+    bool LexFromString(const std::string& InString, ERenderNode& OutNode);
+
+    struct FParamScriptEvent
+    {
+        enum class EType : uint8_t
+        {
+            SetParam,
+            Play,
+            Stop
+        };
+
+        float TimeSeconds = 0.0f;
+        EType Type = EType::SetParam;
+        std::string Name;
+        float Value = 0.0f;
+    };
+
+    struct FParamScript
+    {
+        std::vector<FParamScriptEvent> Events;  // Sorted by time
+
+        bool ParseFile(const std::string& InPath, std::string& OutError);
+        bool ParseString(const std::string& InText, std::string& OutError);
+    };
+
+    // Sets a parameter by member name. Returns false for unknown names.
+    bool SetSynthParam(Metagrain::FGranularSynthParams& OutParams, const std::string& InName, float InValue);
+    bool SetSmoothParam(Metagrain::FGranularSmoothParams& OutParams, const std::string& InName, float InValue);
+
+    // Checks every SetParam event against the parameter set of InNode.
+    bool ValidateScript(const FParamScript& InScript, ERenderNode InNode, std::string& OutError);
+
+    struct FRenderSettings
+    {
+        ERenderNode Node = ERenderNode::Synth;
+        float SampleRate = 48000.0f;
+        int32_t BlockSize = 256;
+        float DurationSeconds = 10.0f;
+        uint32_t Seed = 1;
+        FParamScript Script;
+        bool bRecordGrains = false;     // Fill FRenderResult::GrainRecord, see GrainRecord.h
+        std::function<void()> OnBlockEnd;  // Run after every block, e.g. the work a worker thread does in the plugin
+    };
+
+    struct FRenderResult
+    {
+        std::vector<float> Left;
+        std::vector<float> Right;
+        int64_t NumGrainStarts = 0;
+        double ProcessSeconds = 0.0;  // Wall time spent inside the engine
+        std::vector<uint8_t> GrainRecord;
+
+        double GetRealTimeFactor(float InSampleRate) const
+        {
+            return ProcessSeconds > 0.0 ? (static_cast<double>(Left.size()) / InSampleRate) / ProcessSeconds : 0.0;
+        }
+    };
+
+    // Renders InSettings.DurationSeconds of output. Playback starts at frame 0.
+    FRenderResult RenderOffline(const FRenderSettings& InSettings, const std::shared_ptr<Metagrain::IGrainSource>& InSource);
+
+    // Opens a WAV file as an in-memory source, or a source cache file (.mgsc, see GrainSourceCache.h) as a mapped source.
+    std::shared_ptr<Metagrain::IGrainSource> OpenSourceFile(const std::string& InPath, std::string& OutError);
+
+    // Whole-file binary I/O for grain recordings (.mgrec).
+    bool WriteBinaryFile(const std::string& InPath, const std::vector<uint8_t>& InBytes, std::string& OutError);
+    bool ReadBinaryFile(const std::string& InPath, std::vector<uint8_t>& OutBytes, std::string& OutError);
+}
@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SyntheticSource.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MetagrainTools
+{
+    namespace SyntheticSourcePrivate
+    {
+        class FStreamingSource : public Metagrain::IGrainSource
+        {
+        public:
+            explicit FStreamingSource(std::shared_ptr<Metagrain::IGrainSource> InSource)
+                : Source(std::move(InSource))
+            {
+            }
+
+            virtual const Metagrain::FGrainSourceInfo& GetInfo() const override { return Source->GetInfo(); }
+            virtual std::unique_ptr<Metagrain::IGrainSourceReader> CreateReader(float InStartTimeSeconds, bool bInLooping, int32_t InMaxDecodeSizeInFrames) override
+            {
+                return Source->CreateReader(InStartTimeSeconds, bInLooping, InMaxDecodeSizeInFrames);
+            }
+            virtual const Metagrain::FGrainAnalysis* GetAnalysis() const override { return Source->GetAnalysis(); }
+
+        private:
+            std::shared_ptr<Metagrain::IGrainSource> Source;
+        };
+    }
+
+    std::shared_ptr<Metagrain::FGrainMemorySource> MakeSyntheticSource(int32_t InNumChannels, float InSampleRate, float InDurationSeconds, uint32_t InSeed)
+    {
+        const int32_t NumChannels = std::max(1, InNumChannels);
+        const int64_t NumFrames = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(InDurationSeconds * InSampleRate)));
+
+        std::vector<float> Samples(static_cast<size_t>(NumFrames * NumChannels));
+        Metagrain::FGrainRandom Random(InSeed);
+        constexpr double TwoPi = 6.283185307179586;
+
+        for (int64_t Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            const double Time = static_cast<double>(Frame) / InSampleRate;
+            // Slow amplitude sweep so RMS differs along the file
+            const double Sweep = 0.5 + 0.5 * std::sin(TwoPi * 0.25 * Time);
+            for (int32_t Channel = 0; Channel < NumChannels; ++Channel)
+            {
+                const double Fundamental = 110.0 * (1.0 + 0.5 * Channel);
+                double Value = 0.5 * std::sin(TwoPi * Fundamental * Time)
+                    + 0.25 * std::sin(TwoPi * Fundamental * 3.0 * Time)
+                    + 0.1 * std::sin(TwoPi * Fundamental * 7.0 * Time);
+                Value = Value * Sweep + 0.05 * (Random.FRand() * 2.0f - 1.0f);
+                Samples[static_cast<size_t>(Frame * NumChannels + Channel)] = static_cast<float>(Value);
+            }
+        }
+
+        return std::make_shared<Metagrain::FGrainMemorySource>(std::move(Samples), NumChannels, InSampleRate);
+    }
+
+    std::shared_ptr<Metagrain::IGrainSource> MakeStreamingSource(std::shared_ptr<Metagrain::IGrainSource> InSource)
+    {
+        return std::make_shared<SyntheticSourcePrivate::FStreamingSource>(std::move(InSource));
+    }
+
+    std::shared_ptr<Metagrain::FGrainWaveTableSource> MakeSyntheticWaveTableSource(int32_t InNumTables, int32_t InTableFrames, float InSampleRate)
+    {
+        auto Source = std::make_shared<Metagrain::FGrainWaveTableSource>(InTableFrames, InSampleRate);
+        constexpr double TwoPi = 6.283185307179586;
+
+        std::vector<float> Table(static_cast<size_t>(std::max(1, InTableFrames)));
+        for (int32_t TableIndex = 0; TableIndex < std::max(1, InNumTables); ++TableIndex)
+        {
+            for (size_t Frame = 0; Frame < Table.size(); ++Frame)
+            {
+                const double Phase = TwoPi * static_cast<double>(Frame) / static_cast<double>(Table.size());
+                double Value = 0.0;
+                for (int32_t Harmonic = 1; Harmonic <= TableIndex + 1; ++Harmonic)
+                {
+                    Value += std::sin(Phase * Harmonic) / Harmonic;
+                }
+                Table[Frame] = static_cast<float>(0.6 * Value);
+            }
+            Source->AddTable(Table.data(), static_cast<int32_t>(Table.size()));
+        }
+        return Source;
+    }
+}
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Deterministic test material for the standalone Metagrain tools.
+
+#include "GrainCore.h"
+#include "GrainWaveTable.h"
+
+namespace MetagrainTools
+{
+    // Interleaved source with a different partial mix per channel plus a little noise, so grains
+    // taken from different positions and channels never cancel out or compare equal by accident.
+    std::shared_ptr<Metagrain::FGrainMemorySource> MakeSyntheticSource(int32_t InNumChannels, float InSampleRate, float InDurationSeconds, uint32_t InSeed = 1);
+
+    // Forwards to InSource but hides its resident audio, so grains read it through readers like a wave that decodes.
+    std::shared_ptr<Metagrain::IGrainSource> MakeStreamingSource(std::shared_ptr<Metagrain::IGrainSource> InSource);
+
+    // Bank of single-cycle tables going from a sine to a bright additive wave, one more harmonic per table.
+    std::shared_ptr<Metagrain::FGrainWaveTableSource> MakeSyntheticWaveTableSource(int32_t InNumTables, int32_t InTableFrames, float InSampleRate);
+}
@@ -0,0 +1,218 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "WavFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace MetagrainTools
+{
+    namespace WavFilePrivate
+    {
+        constexpr uint16_t FormatPCM = 1;
+        constexpr uint16_t FormatFloat = 3;
+        constexpr uint16_t FormatExtensible = 0xFFFE;
+
+        uint16_t ReadU16(const uint8_t* InData) { return static_cast<uint16_t>(InData[0] | (InData[1] << 8)); }
+        uint32_t ReadU32(const uint8_t* InData) { return InData[0] | (InData[1] << 8) | (InData[2] << 16) | (static_cast<uint32_t>(InData[3]) << 24); }
+
+        void WriteU16(std::vector<uint8_t>& Out, uint16_t InValue)
+        {
+            Out.push_back(static_cast<uint8_t>(InValue & 0xFF));
+            Out.push_back(static_cast<uint8_t>(InValue >> 8));
+        }
+
+        void WriteU32(std::vector<uint8_t>& Out, uint32_t InValue)
+        {
+            for (int32_t Byte = 0; Byte < 4; ++Byte)
+            {
+                Out.push_back(static_cast<uint8_t>((InValue >> (Byte * 8)) & 0xFF));
+            }
+        }
+
+        void WriteTag(std::vector<uint8_t>& Out, const char* InTag)
+        {
+            Out.insert(Out.end(), InTag, InTag + 4);
+        }
+
+        float DecodeSample(const uint8_t* InData, uint16_t InFormat, uint16_t InBitsPerSample)
+        {
+            if (InFormat == FormatFloat)
+            {
+                if (InBitsPerSample == 32)
+                {
+                    float Value;
+                    std::memcpy(&Value, InData, sizeof(float));
+                    return Value;
+                }
+                double Value;
+                std::memcpy(&Value, InData, sizeof(double));
+                return static_cast<float>(Value);
+            }
+
+            switch (InBitsPerSample)
+            {
+            case 8:
+                return (static_cast<int32_t>(InData[0]) - 128) / 128.0f;
+            case 16:
+                return static_cast<int16_t>(ReadU16(InData)) / 32768.0f;
+            case 24:
+            {
+                int32_t Value = InData[0] | (InData[1] << 8) | (InData[2] << 16);
+                if (Value & 0x800000)
+                {
+                    Value |= ~0xFFFFFF;
+                }
+                return Value / 8388608.0f;
+            }
+            default:
+                return static_cast<float>(static_cast<int32_t>(ReadU32(InData)) / 2147483648.0);
+            }
+        }
+    }
+
+    bool ReadWavFile(const std::string& InPath, FWavData& OutWav, std::string& OutError)
+    {
+        using namespace WavFilePrivate;
+
+        std::ifstream File(InPath, std::ios::binary);
+        if (!File)
+        {
+            OutError = "cannot open '" + InPath + "'";
+            return false;
+        }
+        const std::vector<uint8_t> Bytes((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+
+        if (Bytes.size() < 12 || std::memcmp(Bytes.data(), "RIFF", 4) != 0 || std::memcmp(Bytes.data() + 8, "WAVE", 4) != 0)
+        {
+            OutError = "'" + InPath + "' is not a RIFF/WAVE file";
+            return false;
+        }
+
+        uint16_t Format = 0;
+        uint16_t NumChannels = 0;
+        uint32_t SampleRate = 0;
+        uint16_t BitsPerSample = 0;
+        const uint8_t* SampleData = nullptr;
+        size_t SampleDataSize = 0;
+
+        size_t Offset = 12;
+        while (Offset + 8 <= Bytes.size())
+        {
+            const uint8_t* Chunk = Bytes.data() + Offset;
+            const size_t ChunkSize = std::min<size_t>(ReadU32(Chunk + 4), Bytes.size() - Offset - 8);
+
+            if (std::memcmp(Chunk, "fmt ", 4) == 0 && ChunkSize >= 16)
+            {
+                Format = ReadU16(Chunk + 8);
+                NumChannels = ReadU16(Chunk + 10);
+                SampleRate = ReadU32(Chunk + 12);
+                BitsPerSample = ReadU16(Chunk + 22);
+                if (Format == FormatExtensible && ChunkSize >= 26)
+                {
+                    // First two bytes of the sub-format GUID carry the actual format tag
+                    Format = ReadU16(Chunk + 32);
+                }
+            }
+            else if (std::memcmp(Chunk, "data", 4) == 0)
+            {
+                SampleData = Chunk + 8;
+                SampleDataSize = ChunkSize;
+            }
+            Offset += 8 + ChunkSize + (ChunkSize & 1);
+        }
+
+        const bool bSupportedFormat = (Format == FormatPCM && (BitsPerSample == 8 || BitsPerSample == 16 || BitsPerSample == 24 || BitsPerSample == 32))
+            || (Format == FormatFloat && (BitsPerSample == 32 || BitsPerSample == 64));
+        if (!bSupportedFormat || NumChannels == 0 || SampleRate == 0)
+        {
+            OutError = "'" + InPath + "' has an unsupported sample format (format " + std::to_string(Format) + ", " + std::to_string(BitsPerSample) + " bits)";
+            return false;
+        }
+        if (SampleData == nullptr)
+        {
+            OutError = "'" + InPath + "' has no data chunk";
+            return false;
+        }
+
+        const size_t BytesPerSample = BitsPerSample / 8;
+        const size_t NumSamples = (SampleDataSize / (BytesPerSample * NumChannels)) * NumChannels;
+
+        OutWav.NumChannels = NumChannels;
+        OutWav.SampleRate = static_cast<int32_t>(SampleRate);
+        OutWav.Samples.resize(NumSamples);
+        for (size_t Index = 0; Index < NumSamples; ++Index)
+        {
+            OutWav.Samples[Index] = DecodeSample(SampleData + Index * BytesPerSample, Format, BitsPerSample);
+        }
+        return true;
+    }
+
+    bool WriteWavFile(const std::string& InPath, const FWavData& InWav, EWavSampleFormat InFormat, std::string& OutError)
+    {
+        using namespace WavFilePrivate;
+
+        const uint16_t BitsPerSample = (InFormat == EWavSampleFormat::Float32) ? 32 : 16;
+        const uint16_t BlockAlign = static_cast<uint16_t>(InWav.NumChannels * BitsPerSample / 8);
+        const uint32_t DataSize = static_cast<uint32_t>(InWav.Samples.size() * (BitsPerSample / 8));
+
+        std::vector<uint8_t> Bytes;
+        Bytes.reserve(44 + DataSize);
+        WriteTag(Bytes, "RIFF");
+        WriteU32(Bytes, 36 + DataSize);
+        WriteTag(Bytes, "WAVE");
+        WriteTag(Bytes, "fmt ");
+        WriteU32(Bytes, 16);
+        WriteU16(Bytes, (InFormat == EWavSampleFormat::Float32) ? FormatFloat : FormatPCM);
+        WriteU16(Bytes, static_cast<uint16_t>(InWav.NumChannels));
+        WriteU32(Bytes, static_cast<uint32_t>(InWav.SampleRate));
+        WriteU32(Bytes, static_cast<uint32_t>(InWav.SampleRate) * BlockAlign);
+        WriteU16(Bytes, BlockAlign);
+        WriteU16(Bytes, BitsPerSample);
+        WriteTag(Bytes, "data");
+        WriteU32(Bytes, DataSize);
+
+        for (float Sample : InWav.Samples)
+        {
+            if (InFormat == EWavSampleFormat::Float32)
+            {
+                uint32_t Bits;
+                std::memcpy(&Bits, &Sample, sizeof(float));
+                WriteU32(Bytes, Bits);
+            }
+            else
+            {
+                const float Clamped = std::clamp(Sample, -1.0f, 1.0f);
+                WriteU16(Bytes, static_cast<uint16_t>(static_cast<int16_t>(std::lrint(Clamped * 32767.0f))));
+            }
+        }
+
+        std::ofstream File(InPath, std::ios::binary);
+        if (!File || !File.write(reinterpret_cast<const char*>(Bytes.data()), static_cast<std::streamsize>(Bytes.size())))
+        {
+            OutError = "cannot write '" + InPath + "'";
+            return false;
+        }
+        return true;
+    }
+
+    bool WriteStereoWavFile(const std::string& InPath, const std::vector<float>& InLeft, const std::vector<float>& InRight,
+        int32_t InSampleRate, EWavSampleFormat InFormat, std::string& OutError)
+    {
+        FWavData Wav;
+        Wav.NumChannels = 2;
+        Wav.SampleRate = InSampleRate;
+
+        const size_t NumFrames = std::min(InLeft.size(), InRight.size());
+        Wav.Samples.resize(NumFrames * 2);
+        for (size_t Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            Wav.Samples[Frame * 2] = InLeft[Frame];
+            Wav.Samples[Frame * 2 + 1] = InRight[Frame];
+        }
+        return WriteWavFile(InPath, Wav, InFormat, OutError);
+    }
+}
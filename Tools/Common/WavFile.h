@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Minimal RIFF/WAVE reader and writer for the standalone tools.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MetagrainTools
+{
+    struct FWavData
+    {
+        std::vector<float> Samples;   // Interleaved, normalized to [-1, 1]
+        int32_t NumChannels = 0;
+        int32_t SampleRate = 0;
+
+        int64_t GetNumFrames() const { return NumChannels > 0 ? static_cast<int64_t>(Samples.size()) / NumChannels : 0; }
+    };
+
+    enum class EWavSampleFormat : uint8_t
+    {
+        Float32,
+        Int16
+    };
+
+    // Reads 8/16/24/32-bit integer PCM and 32/64-bit float WAV files. Returns false and fills OutError on failure.
+    bool ReadWavFile(const std::string& InPath, FWavData& OutWav, std::string& OutError);
+
+    bool WriteWavFile(const std::string& InPath, const FWavData& InWav, EWavSampleFormat InFormat, std::string& OutError);
+
+    // Writes two mono channels as one interleaved stereo file.
+    bool WriteStereoWavFile(const std::string& InPath, const std::vector<float>& InLeft, const std::vector<float>& InRight,
+        int32_t InSampleRate, EWavSampleFormat InFormat, std::string& OutError);
+}
@@ -0,0 +1,626 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Golden-output regression harness for both granular engines.
+//
+//   MetagrainGolden --generate <dir>   render every case and store <dir>/<case>.wav and <dir>/<case>.mgref
+//   MetagrainGolden --check <dir>      render again and compare against the stored references
+//
+// Every case uses a fixed seed, block size and parameter script, so renders are repeatable. Check mode
+// also renders each case twice and requires identical output, which catches state leaking between runs, and
+// requires rendering through seek points (GrainSeekPoints.h) to match rendering through plain readers exactly.
+// Tolerances are grouped in tiers so approximate kernels (LUT windows, SIMD resampling, ...) can be
+// accepted against references rendered by the exact scalar path.
+//
+// A case is compared against <case>.wav when it exists, otherwise against <case>.mgref, a compact reference
+// holding the length and hash of the output, every 32nd frame and the RMS and peak of every 128 frames. An
+// exact case must match the hash. Other cases pass on a matching hash, or when the stored frames and the block
+// RMS and peak are within the tier's tolerance; neither can differ by more than the samples do, so the compact
+// check never fails output the full comparison would accept, though it can miss an error between stored frames.
+//
+// Tools/Golden/References holds the compact references ctest checks, each rendered by the commit that
+// introduced its case or last changed its output on purpose. --compact writes only the .mgref files, and
+// --from <wavdir> writes them from WAVs rendered by an earlier build instead of rendering.
+//
+// Pass --source <file.wav> to add the same cases rendered from a real recording.
+
+#include "GrainSeekPoints.h"
+#include "OfflineRender.h"
+#include "SyntheticSource.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace MetagrainTools;
+
+    enum class EGoldenTier : uint8_t
+    {
+        Exact,        // Bit identical
+        Reassociated, // Same math, different summation order or fused multiply-adds
+        Approximate   // Lookup tables or polynomial approximations of the envelopes / resampler
+    };
+
+    struct FGoldenTolerance
+    {
+        double MaxPeakError;
+        double MaxRmsError;
+    };
+
+    FGoldenTolerance GetTolerance(EGoldenTier InTier)
+    {
+        switch (InTier)
+        {
+        case EGoldenTier::Exact:
+            return { 0.0, 0.0 };
+        case EGoldenTier::Reassociated:
+            return { 1.0e-5, 1.0e-6 };
+        default:
+            return { 2.0e-3, 2.0e-4 };
+        }
+    }
+
+    const char* LexToString(EGoldenTier InTier)
+    {
+        switch (InTier)
+        {
+        case EGoldenTier::Exact:
+            return "exact";
+        case EGoldenTier::Reassociated:
+            return "reassociated";
+        default:
+            return "approximate";
+        }
+    }
+
+    bool LexFromString(const std::string& InString, EGoldenTier& OutTier)
+    {
+        for (EGoldenTier Tier : { EGoldenTier::Exact, EGoldenTier::Reassociated, EGoldenTier::Approximate })
+        {
+            if (InString == LexToString(Tier))
+            {
+                OutTier = Tier;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct FGoldenCase
+    {
+        const char* Name;
+        ERenderNode Node;
+        int32_t SourceChannels;
+        int32_t BlockSize;
+        float DurationSeconds;
+        uint32_t Seed;
+        const char* Script;
+        EGoldenTier Tier;
+    };
+
+    // Cover every envelope type / window shape, pitch up and down, reverse grains, mono and stereo
+    // sources, non power of two blocks and the scripted play/stop path, including Stop partway through a block
+    // with no grain playing, Play and Stop in the same block, and a freeze that begins on the frame of a Stop.
+    const FGoldenCase GoldenCases[] =
+    {
+        { "synth_default_stereo", ERenderNode::Synth, 2, 256, 3.0f, 1, "StartPointRandMs = 1500", EGoldenTier::Reassociated },
+        { "synth_dense_mono", ERenderNode::Synth, 1, 256, 3.0f, 2, "ActiveVoices = 16\nGrainDurationMs = 40\nStartPointRandMs = 2500\nPanRand = 1", EGoldenTier::Reassociated },
+        { "synth_pitch_up_reverse", ERenderNode::Synth, 2, 256, 3.0f, 3, "ActiveVoices = 6\nPitchShiftSemitones = 7\nPitchRandSemitones = 3\nReverseChancePercent = 50\nStartPointRandMs = 2000", EGoldenTier::Reassociated },
+        { "synth_pitch_down_curves", ERenderNode::Synth, 2, 480, 3.0f, 4, "ActiveVoices = 4\nPitchShiftSemitones = -12\nAttackPercent = 0.4\nDecayPercent = 0.4\nAttackCurve = 3\nDecayCurve = 0.5\nVolumeRandPercent = 50", EGoldenTier::Reassociated },
+        { "synth_warm_start_stop", ERenderNode::Synth, 2, 128, 3.0f, 5, "bWarmStart = 1\nActiveVoices = 8\nTimeJitterPercent = 60\nDurationRandMs = 80\n@1.0 stop\n@1.5 play\n@2.0 PitchShiftSemitones = 5", EGoldenTier::Reassociated },
+        { "synth_lite_warm_start", ERenderNode::SynthLite, 2, 256, 3.0f, 11, "bWarmStart = 1\nActiveVoices = 16\nStartPointRandMs = 2000\nPanRand = 0.5\n@1.5 stop\n@2.0 play", EGoldenTier::Reassociated },
+        { "synth_stop_idle_pool", ERenderNode::Synth, 2, 256, 2.5f, 12, "ActiveVoices = 0.25\nGrainDurationMs = 2\nStartPointRandMs = 1000\n@1.0 stop\n@1.5 play\n@1.5025 stop", EGoldenTier::Reassociated },
+        { "smooth_default", ERenderNode::Smooth, 2, 256, 3.0f, 6, "", EGoldenTier::Reassociated },
+        { "smooth_gaussian_dense", ERenderNode::Smooth, 2, 256, 3.0f, 7, "WindowShape = 2\nGrainDensity = 24\nGrainsPerSecond = 200\nSmoothingPercent = 80", EGoldenTier::Reassociated },
+        { "smooth_hann_xfades", ERenderNode::Smooth, 1, 256, 3.0f, 8, "WindowShape = 4\nGrainsPerSecond = 60\nXfadeCurve = 2\n@1.5 XfadeCurve = 0", EGoldenTier::Reassociated },
+        { "smooth_blackman_freeze", ERenderNode::Smooth, 2, 512, 3.0f, 9, "WindowShape = 5\nPlaybackSpeedPercent = 0\nPlayPositionPercent = 40\nGrainsPerSecond = 80\n@1.5 PlayPositionPercent = 70", EGoldenTier::Reassociated },
+        { "smooth_play_stop_same_block", ERenderNode::Smooth, 2, 256, 2.5f, 13, "GrainDensity = 32\nGrainsPerSecond = 40\n@1.0 stop\n@1.5 play\n@1.5025 stop", EGoldenTier::Reassociated },
+        { "smooth_freeze_at_stop", ERenderNode::Smooth, 2, 256, 2.5f, 14, "GrainsPerSecond = 40\n@1.535 PlaybackSpeedPercent = 0\n@1.53601 stop", EGoldenTier::Reassociated },
+        { "smooth_pitch_jitter", ERenderNode::Smooth, 2, 256, 3.0f, 10, "WindowShape = 6\nPitchShiftSemitones = 5\nPitchRandSemitones = 2\nTimeJitterMs = 30\nVolumeRandPercent = 40\nPlaybackSpeedPercent = 250", EGoldenTier::Reassociated },
+    };
+
+    struct FCaseRun
+    {
+        std::string Name;
+        FRenderSettings Settings;
+        std::shared_ptr<Metagrain::IGrainSource> Source;
+        EGoldenTier Tier = EGoldenTier::Reassociated;
+    };
+
+    struct FCompareResult
+    {
+        double PeakError = 0.0;
+        double RmsError = 0.0;
+        bool bLengthMatches = true;
+    };
+
+    FCompareResult Compare(const FRenderResult& InResult, const FWavData& InReference)
+    {
+        FCompareResult Compare;
+        const int64_t NumFrames = static_cast<int64_t>(InResult.Left.size());
+        Compare.bLengthMatches = InReference.NumChannels == 2 && InReference.GetNumFrames() == NumFrames;
+        if (!Compare.bLengthMatches)
+        {
+            return Compare;
+        }
+
+        double SumSquares = 0.0;
+        for (int64_t Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            const double LeftError = static_cast<double>(InResult.Left[Frame]) - InReference.Samples[Frame * 2];
+            const double RightError = static_cast<double>(InResult.Right[Frame]) - InReference.Samples[Frame * 2 + 1];
+            Compare.PeakError = std::max({ Compare.PeakError, std::abs(LeftError), std::abs(RightError) });
+            SumSquares += LeftError * LeftError + RightError * RightError;
+        }
+        Compare.RmsError = NumFrames > 0 ? std::sqrt(SumSquares / (2.0 * NumFrames)) : 0.0;
+        return Compare;
+    }
+
+    // FNV-1a over the samples as a stereo WAV stores them, left and right interleaved
+    uint64_t HashRender(const FRenderResult& InResult)
+    {
+        uint64_t Hash = 0xcbf29ce484222325ull;
+        auto HashSample = [&Hash](float InSample)
+        {
+            uint8_t Bytes[sizeof(float)];
+            std::memcpy(Bytes, &InSample, sizeof(float));
+            for (uint8_t Byte : Bytes)
+            {
+                Hash = (Hash ^ Byte) * 0x100000001b3ull;
+            }
+        };
+        for (size_t Frame = 0; Frame < InResult.Left.size(); ++Frame)
+        {
+            HashSample(InResult.Left[Frame]);
+            HashSample(InResult.Right[Frame]);
+        }
+        return Hash;
+    }
+
+    constexpr uint32_t ReferenceMagic = 0x4652474d;  // "MGRF"
+    constexpr uint32_t ReferenceVersion = 1;
+    constexpr int32_t ReferenceDecimationFrames = 32;
+    constexpr int32_t ReferenceBlockFrames = 128;
+
+    // Compact reference of one case's output. Samples holds left and right of every DecimationFrames-th frame,
+    // BlockRms and BlockPeak left and right of every BlockFrames frames, the last block possibly shorter.
+    struct FGoldenReference
+    {
+        int64_t NumFrames = 0;
+        uint64_t Hash = 0;
+        int32_t DecimationFrames = ReferenceDecimationFrames;
+        int32_t BlockFrames = ReferenceBlockFrames;
+        std::vector<float> Samples;
+        std::vector<float> BlockRms;
+        std::vector<float> BlockPeak;
+    };
+
+    FGoldenReference MakeReference(const FRenderResult& InResult)
+    {
+        FGoldenReference Reference;
+        Reference.NumFrames = static_cast<int64_t>(InResult.Left.size());
+        Reference.Hash = HashRender(InResult);
+        for (int64_t Frame = 0; Frame < Reference.NumFrames; Frame += Reference.DecimationFrames)
+        {
+            Reference.Samples.push_back(InResult.Left[Frame]);
+            Reference.Samples.push_back(InResult.Right[Frame]);
+        }
+        for (int64_t BlockStart = 0; BlockStart < Reference.NumFrames; BlockStart += Reference.BlockFrames)
+        {
+            const int64_t BlockEnd = std::min<int64_t>(BlockStart + Reference.BlockFrames, Reference.NumFrames);
+            for (const std::vector<float>* Channel : { &InResult.Left, &InResult.Right })
+            {
+                double SumSquares = 0.0;
+                double Peak = 0.0;
+                for (int64_t Frame = BlockStart; Frame < BlockEnd; ++Frame)
+                {
+                    const double Sample = (*Channel)[Frame];
+                    SumSquares += Sample * Sample;
+                    Peak = std::max(Peak, std::abs(Sample));
+                }
+                Reference.BlockRms.push_back(static_cast<float>(std::sqrt(SumSquares / static_cast<double>(BlockEnd - BlockStart))));
+                Reference.BlockPeak.push_back(static_cast<float>(Peak));
+            }
+        }
+        return Reference;
+    }
+
+    // Little endian, as the WAV files are: magic, version, frames, hash, decimation, block size, then the samples,
+    // block RMS and block peaks as 32-bit floats.
+    bool WriteReference(const std::string& InPath, const FGoldenReference& InReference)
+    {
+        std::vector<uint8_t> Bytes;
+        auto WriteU64 = [&Bytes](uint64_t InValue)
+        {
+            for (int32_t Byte = 0; Byte < 8; ++Byte)
+            {
+                Bytes.push_back(static_cast<uint8_t>(InValue >> (8 * Byte)));
+            }
+        };
+        auto WriteU32 = [&Bytes](uint32_t InValue)
+        {
+            for (int32_t Byte = 0; Byte < 4; ++Byte)
+            {
+                Bytes.push_back(static_cast<uint8_t>(InValue >> (8 * Byte)));
+            }
+        };
+        WriteU32(ReferenceMagic);
+        WriteU32(ReferenceVersion);
+        WriteU64(static_cast<uint64_t>(InReference.NumFrames));
+        WriteU64(InReference.Hash);
+        WriteU32(static_cast<uint32_t>(InReference.DecimationFrames));
+        WriteU32(static_cast<uint32_t>(InReference.BlockFrames));
+        for (const std::vector<float>* Values : { &InReference.Samples, &InReference.BlockRms, &InReference.BlockPeak })
+        {
+            for (float Value : *Values)
+            {
+                uint32_t Bits = 0;
+                std::memcpy(&Bits, &Value, sizeof(float));
+                WriteU32(Bits);
+            }
+        }
+
+        std::ofstream File(InPath, std::ios::binary);
+        return static_cast<bool>(File.write(reinterpret_cast<const char*>(Bytes.data()), static_cast<std::streamsize>(Bytes.size())));
+    }
+
+    bool ReadReference(const std::string& InPath, FGoldenReference& OutReference, std::string& OutError)
+    {
+        std::ifstream File(InPath, std::ios::binary);
+        const std::vector<uint8_t> Bytes((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+        size_t Offset = 0;
+        auto ReadU64 = [&Bytes, &Offset](uint64_t& OutValue)
+        {
+            if (Offset + 8 > Bytes.size())
+            {
+                return false;
+            }
+            OutValue = 0;
+            for (int32_t Byte = 0; Byte < 8; ++Byte)
+            {
+                OutValue |= static_cast<uint64_t>(Bytes[Offset++]) << (8 * Byte);
+            }
+            return true;
+        };
+        auto ReadU32 = [&Bytes, &Offset](uint32_t& OutValue)
+        {
+            if (Offset + 4 > Bytes.size())
+            {
+                return false;
+            }
+            OutValue = 0;
+            for (int32_t Byte = 0; Byte < 4; ++Byte)
+            {
+                OutValue |= static_cast<uint32_t>(Bytes[Offset++]) << (8 * Byte);
+            }
+            return true;
+        };
+
+        uint32_t Magic = 0;
+        uint32_t Version = 0;
+        uint64_t NumFrames = 0;
+        uint32_t DecimationFrames = 0;
+        uint32_t BlockFrames = 0;
+        if (!ReadU32(Magic) || Magic != ReferenceMagic || !ReadU32(Version) || Version != ReferenceVersion)
+        {
+            OutError = "not a version " + std::to_string(ReferenceVersion) + " reference: " + InPath;
+            return false;
+        }
+        if (!ReadU64(NumFrames) || !ReadU64(OutReference.Hash) || !ReadU32(DecimationFrames) || !ReadU32(BlockFrames)
+            || DecimationFrames == 0 || BlockFrames == 0)
+        {
+            OutError = "truncated reference header: " + InPath;
+            return false;
+        }
+        OutReference.NumFrames = static_cast<int64_t>(NumFrames);
+        OutReference.DecimationFrames = static_cast<int32_t>(DecimationFrames);
+        OutReference.BlockFrames = static_cast<int32_t>(BlockFrames);
+
+        const size_t NumSamples = 2 * static_cast<size_t>((NumFrames + DecimationFrames - 1) / DecimationFrames);
+        const size_t NumBlockValues = 2 * static_cast<size_t>((NumFrames + BlockFrames - 1) / BlockFrames);
+        OutReference.Samples.resize(NumSamples);
+        OutReference.BlockRms.resize(NumBlockValues);
+        OutReference.BlockPeak.resize(NumBlockValues);
+        for (std::vector<float>* Values : { &OutReference.Samples, &OutReference.BlockRms, &OutReference.BlockPeak })
+        {
+            for (float& Value : *Values)
+            {
+                uint32_t Bits = 0;
+                if (!ReadU32(Bits))
+                {
+                    OutError = "truncated reference: " + InPath;
+                    return false;
+                }
+                std::memcpy(&Value, &Bits, sizeof(float));
+            }
+        }
+        return true;
+    }
+
+    // A sample differs from the stored one by at most the peak error, and a block's RMS and peak by at most the
+    // largest sample error within it, so PeakError never exceeds the full comparison's. RmsError is the larger of
+    // the RMS error of the stored frames and the RMS of the block RMS errors, which is at most the full RMS error.
+    FCompareResult Compare(const FRenderResult& InResult, const FGoldenReference& InReference)
+    {
+        FCompareResult Compare;
+        Compare.bLengthMatches = InReference.NumFrames == static_cast<int64_t>(InResult.Left.size());
+        if (!Compare.bLengthMatches || InReference.Hash == HashRender(InResult))
+        {
+            return Compare;
+        }
+
+        const FGoldenReference Rendered = MakeReference(InResult);
+        auto CompareValues = [&Compare](const std::vector<float>& InRendered, const std::vector<float>& InStored)
+        {
+            double SumSquares = 0.0;
+            for (size_t Index = 0; Index < InStored.size(); ++Index)
+            {
+                const double Error = static_cast<double>(InRendered[Index]) - InStored[Index];
+                Compare.PeakError = std::max(Compare.PeakError, std::abs(Error));
+                SumSquares += Error * Error;
+            }
+            return InStored.empty() ? 0.0 : std::sqrt(SumSquares / static_cast<double>(InStored.size()));
+        };
+        const double SampleRmsError = CompareValues(Rendered.Samples, InReference.Samples);
+        const double BlockRmsError = CompareValues(Rendered.BlockRms, InReference.BlockRms);
+        CompareValues(Rendered.BlockPeak, InReference.BlockPeak);
+        Compare.RmsError = std::max(SampleRmsError, BlockRmsError);
+        return Compare;
+    }
+
+    FRenderResult MakeRenderResult(const FWavData& InWav)
+    {
+        FRenderResult Result;
+        const int64_t NumFrames = InWav.GetNumFrames();
+        Result.Left.resize(static_cast<size_t>(NumFrames));
+        Result.Right.resize(static_cast<size_t>(NumFrames));
+        for (int64_t Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            Result.Left[Frame] = InWav.Samples[Frame * InWav.NumChannels];
+            Result.Right[Frame] = InWav.Samples[Frame * InWav.NumChannels + (InWav.NumChannels > 1 ? 1 : 0)];
+        }
+        return Result;
+    }
+
+    bool FileExists(const std::string& InPath)
+    {
+        return std::ifstream(InPath).good();
+    }
+
+    bool IsIdentical(const FRenderResult& A, const FRenderResult& B)
+    {
+        return A.Left.size() == B.Left.size()
+            && std::memcmp(A.Left.data(), B.Left.data(), A.Left.size() * sizeof(float)) == 0
+            && std::memcmp(A.Right.data(), B.Right.data(), A.Right.size() * sizeof(float)) == 0;
+    }
+
+    // Renders InRun through readers of its source, once from plain readers and once from seek points refilled after
+    // every block, and returns whether both are identical.
+    bool SeekPointsMatchReaders(const FCaseRun& InRun)
+    {
+        const std::shared_ptr<Metagrain::IGrainSource> Streaming = MakeStreamingSource(InRun.Source);
+        const auto SeekPoints = std::make_shared<Metagrain::FGrainSeekPointSource>(Streaming, 4096, InRun.Settings.BlockSize);
+        SeekPoints->Refill();
+
+        FRenderSettings Settings = InRun.Settings;
+        Settings.OnBlockEnd = [&SeekPoints]() { SeekPoints->Refill(); };
+        return IsIdentical(RenderOffline(InRun.Settings, Streaming), RenderOffline(Settings, SeekPoints));
+    }
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+            "Usage: MetagrainGolden (--generate <dir> | --check <dir> | --list) [options]\n"
+            "\n"
+            "  --compact             With --generate, only write the compact <dir>/<case>.mgref references\n"
+            "  --from <wavdir>       With --generate, write <dir>/<case>.mgref from <wavdir>/<case>.wav instead of rendering\n"
+            "  --source <file.wav>   Also run every case on this recording\n"
+            "  --filter <text>       Only run cases whose name contains text\n"
+            "  --tier <tier>         Override the tolerance tier of every case (exact, reassociated, approximate)\n");
+    }
+}
+
+int main(int ArgC, char** ArgV)
+{
+    enum class EMode { None, Generate, Check, List } Mode = EMode::None;
+    std::string Directory;
+    std::string SourcePath;
+    std::string Filter;
+    bool bOverrideTier = false;
+    std::string FromDirectory;
+    bool bCompact = false;
+    EGoldenTier OverrideTier = EGoldenTier::Reassociated;
+
+    for (int32_t Index = 1; Index < ArgC; ++Index)
+    {
+        const std::string Arg = ArgV[Index];
+        const bool bHasValue = Index + 1 < ArgC;
+        if (Arg == "--list") { Mode = EMode::List; }
+        else if (Arg == "--generate" && bHasValue) { Mode = EMode::Generate; Directory = ArgV[++Index]; }
+        else if (Arg == "--check" && bHasValue) { Mode = EMode::Check; Directory = ArgV[++Index]; }
+        else if (Arg == "--compact") { bCompact = true; }
+        else if (Arg == "--from" && bHasValue) { FromDirectory = ArgV[++Index]; }
+        else if (Arg == "--source" && bHasValue) { SourcePath = ArgV[++Index]; }
+        else if (Arg == "--filter" && bHasValue) { Filter = ArgV[++Index]; }
+        else if (Arg == "--tier" && bHasValue && LexFromString(ArgV[Index + 1], OverrideTier)) { bOverrideTier = true; ++Index; }
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (Mode == EMode::None)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::string Error;
+    std::shared_ptr<Metagrain::IGrainSource> RecordedSource;
+    if (!SourcePath.empty())
+    {
+        FWavData Wav;
+        if (!ReadWavFile(SourcePath, Wav, Error))
+        {
+            std::fprintf(stderr, "MetagrainGolden: %s\n", Error.c_str());
+            return 1;
+        }
+        RecordedSource = std::make_shared<Metagrain::FGrainMemorySource>(std::move(Wav.Samples), Wav.NumChannels, static_cast<float>(Wav.SampleRate));
+    }
+
+    std::vector<FCaseRun> Runs;
+    for (const FGoldenCase& Case : GoldenCases)
+    {
+        FCaseRun Run;
+        Run.Name = Case.Name;
+        Run.Settings.Node = Case.Node;
+        Run.Settings.BlockSize = Case.BlockSize;
+        Run.Settings.DurationSeconds = Case.DurationSeconds;
+        Run.Settings.Seed = Case.Seed;
+        Run.Tier = bOverrideTier ? OverrideTier : Case.Tier;
+        if (!Run.Settings.Script.ParseString(Case.Script, Error) || !ValidateScript(Run.Settings.Script, Case.Node, Error))
+        {
+            std::fprintf(stderr, "MetagrainGolden: case %s: %s\n", Case.Name, Error.c_str());
+            return 1;
+        }
+
+        Run.Source = MakeSyntheticSource(Case.SourceChannels, Run.Settings.SampleRate, 4.0f, Case.Seed);
+        Runs.push_back(Run);
+
+        if (RecordedSource)
+        {
+            Run.Name += "_recorded";
+            Run.Source = RecordedSource;
+            Runs.push_back(Run);
+        }
+    }
+
+    int32_t NumFailed = 0;
+    int32_t NumRun = 0;
+    for (const FCaseRun& Run : Runs)
+    {
+        if (!Filter.empty() && Run.Name.find(Filter) == std::string::npos)
+        {
+            continue;
+        }
+        ++NumRun;
+
+        if (Mode == EMode::List)
+        {
+            std::printf("%-32s %-7s %s\n", Run.Name.c_str(), LexToString(Run.Settings.Node), LexToString(Run.Tier));
+            continue;
+        }
+
+        const std::string ReferencePath = Directory + "/" + Run.Name + ".wav";
+        const std::string CompactPath = Directory + "/" + Run.Name + ".mgref";
+
+        if (Mode == EMode::Generate && !FromDirectory.empty())
+        {
+            FWavData Wav;
+            if (!ReadWavFile(FromDirectory + "/" + Run.Name + ".wav", Wav, Error))
+            {
+                std::fprintf(stderr, "MetagrainGolden: %s\n", Error.c_str());
+                ++NumFailed;
+                continue;
+            }
+            if (!WriteReference(CompactPath, MakeReference(MakeRenderResult(Wav))))
+            {
+                std::fprintf(stderr, "MetagrainGolden: could not write %s\n", CompactPath.c_str());
+                ++NumFailed;
+                continue;
+            }
+            std::printf("wrote %s\n", CompactPath.c_str());
+            continue;
+        }
+
+        const FRenderResult Result = RenderOffline(Run.Settings, Run.Source);
+
+        if (Mode == EMode::Generate)
+        {
+            if (!WriteReference(CompactPath, MakeReference(Result)))
+            {
+                std::fprintf(stderr, "MetagrainGolden: could not write %s\n", CompactPath.c_str());
+                ++NumFailed;
+                continue;
+            }
+            if (!bCompact && !WriteStereoWavFile(ReferencePath, Result.Left, Result.Right, static_cast<int32_t>(Run.Settings.SampleRate), EWavSampleFormat::Float32, Error))
+            {
+                std::fprintf(stderr, "MetagrainGolden: %s\n", Error.c_str());
+                ++NumFailed;
+                continue;
+            }
+            std::printf("wrote %s (%lld grains)\n", bCompact ? CompactPath.c_str() : ReferencePath.c_str(), static_cast<long long>(Result.NumGrainStarts));
+            continue;
+        }
+
+        if (!IsIdentical(Result, RenderOffline(Run.Settings, Run.Source)))
+        {
+            std::printf("FAIL %-32s two renders with the same seed differ\n", Run.Name.c_str());
+            ++NumFailed;
+            continue;
+        }
+        if (!SeekPointsMatchReaders(Run))
+        {
+            std::printf("FAIL %-32s rendering from seek points differs from rendering from readers\n", Run.Name.c_str());
+            ++NumFailed;
+            continue;
+        }
+
+        FCompareResult Compared;
+        const bool bCompactReference = !FileExists(ReferencePath);
+        if (bCompactReference)
+        {
+            FGoldenReference Reference;
+            if (!ReadReference(CompactPath, Reference, Error))
+            {
+                std::printf("FAIL %-32s %s\n", Run.Name.c_str(), FileExists(CompactPath) ? Error.c_str() : "no reference");
+                ++NumFailed;
+                continue;
+            }
+            if (Run.Tier == EGoldenTier::Exact && Reference.NumFrames == static_cast<int64_t>(Result.Left.size()) && Reference.Hash != HashRender(Result))
+            {
+                std::printf("FAIL %-32s hash differs, output changed  [exact, compact]\n", Run.Name.c_str());
+                ++NumFailed;
+                continue;
+            }
+            Compared = Compare(Result, Reference);
+        }
+        else
+        {
+            FWavData Reference;
+            if (!ReadWavFile(ReferencePath, Reference, Error))
+            {
+                std::printf("FAIL %-32s %s\n", Run.Name.c_str(), Error.c_str());
+                ++NumFailed;
+                continue;
+            }
+            Compared = Compare(Result, Reference);
+        }
+
+        const FGoldenTolerance Tolerance = GetTolerance(Run.Tier);
+        const bool bPassed = Compared.bLengthMatches && Compared.PeakError <= Tolerance.MaxPeakError && Compared.RmsError <= Tolerance.MaxRmsError;
+        if (!Compared.bLengthMatches)
+        {
+            std::printf("FAIL %-32s length or channel count differs from reference\n", Run.Name.c_str());
+        }
+        else
+        {
+            std::printf("%s %-32s peak %.3g (max %.3g)  rms %.3g (max %.3g)  [%s%s]\n", bPassed ? "ok  " : "FAIL", Run.Name.c_str(),
+                Compared.PeakError, Tolerance.MaxPeakError, Compared.RmsError, Tolerance.MaxRmsError, LexToString(Run.Tier), bCompactReference ? ", compact" : "");
+        }
+        NumFailed += bPassed ? 0 : 1;
+    }
+
+    if (Mode == EMode::Check)
+    {
+        std::printf("%d of %d case(s) passed\n", NumRun - NumFailed, NumRun);
+    }
+    return NumFailed > 0 ? 1 : 0;
+}
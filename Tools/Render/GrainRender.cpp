@@ -0,0 +1,270 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Offline grain cloud renderer. Runs either granular engine over a WAV (or synthetic) source as fast as
+// the CPU allows and writes the stereo result to WAV. Several seeds can be rendered in parallel to bake
+// variations, and every render reports its throughput as a multiple of real time.
+
+#include "OfflineRender.h"
+#include "SyntheticSource.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace MetagrainTools;
+
+    struct FCommandLine
+    {
+        FRenderSettings Settings;
+        std::string InputPath;
+        std::string OutputPath;
+        std::string RecordPath;
+        int32_t SyntheticChannels = 0;
+        int32_t NumVariations = 1;
+        int32_t NumJobs = 0;
+        bool bSampleRateSet = false;
+        EWavSampleFormat OutputFormat = EWavSampleFormat::Float32;
+    };
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+            "Usage: MetagrainRender --out <file.wav> (--in <source.wav|.mgsc> | --synthetic <channels>) [options]\n"
+            "\n"
+            "  --node synth|synth-lite|smooth\n"
+            "                        Engine to run (default synth)\n"
+            "  --script <file>       Parameter script, see Tools/Common/OfflineRender.h\n"
+            "  --set Name=Value      Parameter applied before the first block (repeatable)\n"
+            "  --seconds <s>         Output length (default 10)\n"
+            "  --rate <hz>           Output sample rate (default: source rate, 48000 for synthetic)\n"
+            "  --block <frames>      Block size (default 256)\n"
+            "  --seed <n>            Random seed of the first render (default 1)\n"
+            "  --variations <n>      Render n variations with seeds seed..seed+n-1 (default 1)\n"
+            "  --jobs <n>            Parallel renders (default: hardware threads)\n"
+            "  --pcm16               Write 16-bit PCM instead of 32-bit float\n"
+            "  --record <file>       Also write the grain record of each render, for MetagrainReplay\n");
+    }
+
+    bool ParseCommandLine(int32_t ArgC, char** ArgV, FCommandLine& Out, std::string& OutError)
+    {
+        FParamScript CommandLineSets;
+        for (int32_t Index = 1; Index < ArgC; ++Index)
+        {
+            const std::string Arg = ArgV[Index];
+            auto NextValue = [&]() -> const char*
+            {
+                return (Index + 1 < ArgC) ? ArgV[++Index] : nullptr;
+            };
+
+            const char* Value = nullptr;
+            if (Arg == "--pcm16")
+            {
+                Out.OutputFormat = EWavSampleFormat::Int16;
+                continue;
+            }
+            if (Arg == "--help" || Arg == "-h")
+            {
+                return false;
+            }
+            if ((Value = NextValue()) == nullptr)
+            {
+                OutError = "missing value for " + Arg;
+                return false;
+            }
+
+            if (Arg == "--node")
+            {
+                if (!LexFromString(Value, Out.Settings.Node))
+                {
+                    OutError = "unknown node '" + std::string(Value) + "'";
+                    return false;
+                }
+            }
+            else if (Arg == "--in") { Out.InputPath = Value; }
+            else if (Arg == "--out") { Out.OutputPath = Value; }
+            else if (Arg == "--record") { Out.RecordPath = Value; Out.Settings.bRecordGrains = true; }
+            else if (Arg == "--synthetic") { Out.SyntheticChannels = std::atoi(Value); }
+            else if (Arg == "--script")
+            {
+                if (!Out.Settings.Script.ParseFile(Value, OutError))
+                {
+                    return false;
+                }
+            }
+            else if (Arg == "--set")
+            {
+                if (!CommandLineSets.ParseString(Value, OutError))
+                {
+                    return false;
+                }
+            }
+            else if (Arg == "--seconds") { Out.Settings.DurationSeconds = static_cast<float>(std::atof(Value)); }
+            else if (Arg == "--rate") { Out.Settings.SampleRate = static_cast<float>(std::atof(Value)); Out.bSampleRateSet = true; }
+            else if (Arg == "--block") { Out.Settings.BlockSize = std::atoi(Value); }
+            else if (Arg == "--seed") { Out.Settings.Seed = static_cast<uint32_t>(std::strtoul(Value, nullptr, 10)); }
+            else if (Arg == "--variations") { Out.NumVariations = std::max(1, std::atoi(Value)); }
+            else if (Arg == "--jobs") { Out.NumJobs = std::max(1, std::atoi(Value)); }
+            else
+            {
+                OutError = "unknown option " + Arg;
+                return false;
+            }
+        }
+
+        // Command line values act as the initial state, the script can still automate them later
+        std::vector<FParamScriptEvent>& Events = Out.Settings.Script.Events;
+        Events.insert(Events.begin(), CommandLineSets.Events.begin(), CommandLineSets.Events.end());
+
+        if (Out.OutputPath.empty() || (Out.InputPath.empty() && Out.SyntheticChannels <= 0))
+        {
+            OutError = "--out and one of --in / --synthetic are required";
+            return false;
+        }
+        if (Out.Settings.BlockSize <= 0 || Out.Settings.SampleRate <= 0.0f)
+        {
+            OutError = "block size and sample rate must be positive";
+            return false;
+        }
+        return ValidateScript(Out.Settings.Script, Out.Settings.Node, OutError);
+    }
+
+    std::string GetVariationPath(const std::string& InPath, int32_t InVariation, int32_t InNumVariations)
+    {
+        if (InNumVariations <= 1)
+        {
+            return InPath;
+        }
+        char Suffix[16];
+        std::snprintf(Suffix, sizeof(Suffix), "_%04d", InVariation);
+        const size_t Dot = InPath.rfind('.');
+        const size_t Slash = InPath.find_last_of("/\\");
+        if (Dot == std::string::npos || (Slash != std::string::npos && Dot < Slash))
+        {
+            return InPath + Suffix;
+        }
+        return InPath.substr(0, Dot) + Suffix + InPath.substr(Dot);
+    }
+}
+
+int main(int ArgC, char** ArgV)
+{
+    FCommandLine CommandLine;
+    std::string Error;
+    if (!ParseCommandLine(ArgC, ArgV, CommandLine, Error))
+    {
+        if (!Error.empty())
+        {
+            std::fprintf(stderr, "MetagrainRender: %s\n\n", Error.c_str());
+        }
+        PrintUsage();
+        return 2;
+    }
+
+    std::shared_ptr<Metagrain::IGrainSource> Source;
+    if (!CommandLine.InputPath.empty())
+    {
+        Source = OpenSourceFile(CommandLine.InputPath, Error);
+        if (!Source)
+        {
+            std::fprintf(stderr, "MetagrainRender: %s\n", Error.c_str());
+            return 1;
+        }
+        if (!CommandLine.bSampleRateSet)
+        {
+            CommandLine.Settings.SampleRate = Source->GetInfo().SampleRate;
+        }
+    }
+    else
+    {
+        Source = MakeSyntheticSource(CommandLine.SyntheticChannels, CommandLine.Settings.SampleRate, 10.0f);
+    }
+
+    if (!Source->GetInfo().IsValid())
+    {
+        std::fprintf(stderr, "MetagrainRender: source is empty\n");
+        return 1;
+    }
+
+    const int32_t NumVariations = CommandLine.NumVariations;
+    const int32_t NumJobs = std::min(NumVariations,
+        CommandLine.NumJobs > 0 ? CommandLine.NumJobs : std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency())));
+
+    struct FVariationReport
+    {
+        double ProcessSeconds = 0.0;
+        int64_t NumGrainStarts = 0;
+        bool bWritten = false;
+        std::string Error;
+    };
+    std::vector<FVariationReport> Reports(NumVariations);
+    std::atomic<int32_t> NextVariation{ 0 };
+
+    // Sources are immutable once built, so all workers can share one
+    auto Worker = [&]()
+    {
+        for (int32_t Variation = NextVariation++; Variation < NumVariations; Variation = NextVariation++)
+        {
+            FRenderSettings Settings = CommandLine.Settings;
+            Settings.Seed = CommandLine.Settings.Seed + static_cast<uint32_t>(Variation);
+
+            const FRenderResult Result = RenderOffline(Settings, Source);
+            FVariationReport& Report = Reports[Variation];
+            Report.ProcessSeconds = Result.ProcessSeconds;
+            Report.NumGrainStarts = Result.NumGrainStarts;
+            Report.bWritten = WriteStereoWavFile(GetVariationPath(CommandLine.OutputPath, Variation, NumVariations),
+                Result.Left, Result.Right, static_cast<int32_t>(Settings.SampleRate), CommandLine.OutputFormat, Report.Error);
+            if (Report.bWritten && Settings.bRecordGrains)
+            {
+                Report.bWritten = WriteBinaryFile(GetVariationPath(CommandLine.RecordPath, Variation, NumVariations), Result.GrainRecord, Report.Error);
+            }
+        }
+    };
+
+    const auto WallStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> Threads;
+    for (int32_t Job = 1; Job < NumJobs; ++Job)
+    {
+        Threads.emplace_back(Worker);
+    }
+    Worker();
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+    const double WallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - WallStart).count();
+
+    const double RenderedSeconds = CommandLine.Settings.DurationSeconds;
+    int32_t NumFailed = 0;
+    double TotalProcessSeconds = 0.0;
+    for (int32_t Variation = 0; Variation < NumVariations; ++Variation)
+    {
+        const FVariationReport& Report = Reports[Variation];
+        TotalProcessSeconds += Report.ProcessSeconds;
+        if (!Report.bWritten)
+        {
+            ++NumFailed;
+            std::fprintf(stderr, "MetagrainRender: %s\n", Report.Error.c_str());
+            continue;
+        }
+        std::printf("%s  seed %u  %.1f s  %lld grains  %.1fx real time\n",
+            GetVariationPath(CommandLine.OutputPath, Variation, NumVariations).c_str(),
+            CommandLine.Settings.Seed + static_cast<uint32_t>(Variation), RenderedSeconds,
+            static_cast<long long>(Report.NumGrainStarts),
+            Report.ProcessSeconds > 0.0 ? RenderedSeconds / Report.ProcessSeconds : 0.0);
+    }
+
+    std::printf("%s: %d render(s) on %d job(s), %.2f s wall, %.1fx real time per core, %.1fx real time aggregate\n",
+        LexToString(CommandLine.Settings.Node), NumVariations, NumJobs, WallSeconds,
+        TotalProcessSeconds > 0.0 ? RenderedSeconds * NumVariations / TotalProcessSeconds : 0.0,
+        WallSeconds > 0.0 ? RenderedSeconds * NumVariations / WallSeconds : 0.0);
+
+    return NumFailed > 0 ? 1 : 0;
+}
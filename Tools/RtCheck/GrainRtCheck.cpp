@@ -0,0 +1,400 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Real-time safety check for both granular engines. Replaces the global operator new/delete so that every
+// heap allocation made inside a render block (an FRealtimeScope around Process()) is counted and its call
+// stack captured, then renders each case for a while and fails when steady-state blocks allocate.
+//
+//   MetagrainRtCheck                      check every case
+//   MetagrainRtCheck --filter smooth      only cases whose name contains "smooth"
+//   MetagrainRtCheck --stacks 4           print up to 4 captured allocation stacks per failing case
+//
+// Blocks that start no grain must not allocate at all. Grains reuse the readers of finished grains, but the
+// pool fills as the voice count rises, so blocks that start grains may allocate once per new reader created.
+// Anything beyond that is voice buffer growth, which is tolerated while grain sizes settle but must be over
+// by the second half of the checked blocks.
+//
+// The mapped cases play a minute-long source cache file with grains drawn from all of it, and also check the page-in
+// hints sent to the OS from the render thread: only blocks that start grains may send them, no block may ask for
+// more than MaxPrefetchBytes per grain, and once the file has been hinted, grains returning to it must not ask again.
+
+#include "GrainRealtime.h"
+#include "GrainSourceCache.h"
+#include "OfflineRender.h"
+#include "SyntheticSource.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <unistd.h>
+#define METAGRAIN_RTCHECK_HAS_BACKTRACE 1
+#else
+#define METAGRAIN_RTCHECK_HAS_BACKTRACE 0
+#endif
+
+namespace
+{
+    // Captured from inside operator new, so storage is fixed and nothing here may allocate
+    struct FAllocationStack
+    {
+        static constexpr int32_t MaxFrames = 32;
+        void* Frames[MaxFrames];
+        int32_t NumFrames = 0;
+        size_t Size = 0;
+    };
+
+    // Stacks of the block being rendered; copied to ViolationStacks when the block breaks a rule
+    constexpr int32_t MaxCapturedStacks = 16;
+    FAllocationStack CapturedStacks[MaxCapturedStacks];
+    int32_t NumCapturedStacks = 0;
+    FAllocationStack ViolationStacks[MaxCapturedStacks];
+    int32_t NumViolationStacks = 0;
+    thread_local bool bInsideHook = false;
+
+    void NoteRealtimeAllocation(size_t InSize)
+    {
+        if (bInsideHook || !Metagrain::FRealtimeScope::IsActive())
+        {
+            return;
+        }
+        bInsideHook = true;
+        Metagrain::FRealtimeScope::NoteAllocation();
+        if (NumCapturedStacks < MaxCapturedStacks)
+        {
+            FAllocationStack& Stack = CapturedStacks[NumCapturedStacks++];
+            Stack.Size = InSize;
+#if METAGRAIN_RTCHECK_HAS_BACKTRACE
+            Stack.NumFrames = backtrace(Stack.Frames, FAllocationStack::MaxFrames);
+#endif
+        }
+        bInsideHook = false;
+    }
+
+    void* AllocateOrThrow(size_t InSize)
+    {
+        NoteRealtimeAllocation(InSize);
+        void* Memory = std::malloc(InSize > 0 ? InSize : 1);
+        if (Memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return Memory;
+    }
+
+    void* AllocateAlignedOrThrow(size_t InSize, std::align_val_t InAlignment)
+    {
+        NoteRealtimeAllocation(InSize);
+        const size_t Alignment = std::max(static_cast<size_t>(InAlignment), sizeof(void*));
+        void* Memory = nullptr;
+        if (posix_memalign(&Memory, Alignment, InSize > 0 ? InSize : 1) != 0)
+        {
+            throw std::bad_alloc();
+        }
+        return Memory;
+    }
+}
+
+void* operator new(size_t InSize) { return AllocateOrThrow(InSize); }
+void* operator new[](size_t InSize) { return AllocateOrThrow(InSize); }
+void* operator new(size_t InSize, std::align_val_t InAlignment) { return AllocateAlignedOrThrow(InSize, InAlignment); }
+void* operator new[](size_t InSize, std::align_val_t InAlignment) { return AllocateAlignedOrThrow(InSize, InAlignment); }
+void operator delete(void* InMemory) noexcept { std::free(InMemory); }
+void operator delete[](void* InMemory) noexcept { std::free(InMemory); }
+void operator delete(void* InMemory, size_t) noexcept { std::free(InMemory); }
+void operator delete[](void* InMemory, size_t) noexcept { std::free(InMemory); }
+void operator delete(void* InMemory, std::align_val_t) noexcept { std::free(InMemory); }
+void operator delete[](void* InMemory, std::align_val_t) noexcept { std::free(InMemory); }
+void operator delete(void* InMemory, size_t, std::align_val_t) noexcept { std::free(InMemory); }
+void operator delete[](void* InMemory, size_t, std::align_val_t) noexcept { std::free(InMemory); }
+
+namespace
+{
+    using namespace MetagrainTools;
+
+    struct FRtCheckCase
+    {
+        const char* Name;
+        ERenderNode Node;
+        const char* Script;
+        bool bMappedSource;  // Play MappedSourceSeconds of source cache file instead of a short in-memory source
+    };
+
+    const FRtCheckCase RtCheckCases[] =
+    {
+        { "synth_8_voices", ERenderNode::Synth, "ActiveVoices = 8\nStartPointRandMs = 2000\nPanRand = 0.5", false },
+        { "synth_32_voices_pitched_reverse", ERenderNode::Synth, "ActiveVoices = 32\nPitchRandSemitones = 12\nReverseChancePercent = 50\nStartPointRandMs = 2000", false },
+        { "synth_32_voices_short_grains", ERenderNode::Synth, "ActiveVoices = 32\nGrainDurationMs = 10\nStartPointRandMs = 2000", false },
+        { "smooth_8_voices", ERenderNode::Smooth, "GrainDensity = 8\nGrainsPerSecond = 320", false },
+        { "smooth_32_voices_pitched", ERenderNode::Smooth, "GrainDensity = 32\nGrainsPerSecond = 320\nPitchRandSemitones = 12", false },
+        { "synth_mapped_whole_file", ERenderNode::Synth, "ActiveVoices = 32\nStartPointRandMs = 60000\nReverseChancePercent = 30\nPitchRandSemitones = 12", true },
+        { "smooth_mapped_fast_playhead", ERenderNode::Smooth, "GrainDensity = 32\nGrainsPerSecond = 320\nPlaybackSpeedPercent = 400", true },
+    };
+
+    constexpr float MappedSourceSeconds = 60.0f;
+
+    constexpr float SampleRate = 48000.0f;
+    constexpr int32_t BlockSize = 256;
+    constexpr int32_t NumWarmupBlocks = 64;    // Lets lazily sized buffers reach their steady-state capacity
+    constexpr int32_t NumCheckedBlocks = 2000;
+
+    struct FCaseResult
+    {
+        int64_t NumBlocks = 0;
+        int64_t NumQuietBlocks = 0;            // Blocks that started no grain
+        int64_t QuietBlockAllocations = 0;
+        int64_t SpawnBlockAllocations = 0;
+        int64_t GrainsStarted = 0;
+        int64_t ReadersCreated = 0;
+        int64_t WorstBlockAllocations = 0;
+        int64_t GrowthAllocations = 0;         // Allocations beyond one per reader created
+        int64_t LateGrowthAllocations = 0;     // ... in the second half of the checked blocks
+        int64_t PrefetchCalls = 0;             // Page-in requests to the OS, mapped cases only
+        int64_t QuietBlockPrefetchCalls = 0;
+        int64_t OversizedPrefetchBlocks = 0;   // Blocks hinting more than MaxPrefetchBytes per grain started
+        int64_t LatePrefetchBytes = 0;
+        int64_t LateGrainsStarted = 0;
+    };
+
+    // Rounding out to granules adds less than a granule at each end, and a hint wrapping past the end is two ranges
+    constexpr uint64_t MaxBytesPerHint = Metagrain::FGrainMappedSource::MaxPrefetchBytes + 4 * Metagrain::FGrainMappedSource::PrefetchGranuleBytes;
+
+    std::shared_ptr<Metagrain::FGrainMappedSource> MakeMappedSource(const std::string& InPath, std::string& OutError)
+    {
+        const std::shared_ptr<Metagrain::FGrainMemorySource> Memory = MakeSyntheticSource(2, SampleRate, MappedSourceSeconds);
+        const Metagrain::FGrainSourceInfo& Info = Memory->GetInfo();
+        const float* Samples = static_cast<const float*>(Memory->GetResidentAudio().Samples);
+
+        Metagrain::FGrainSourceCacheWriter Writer;
+        if (!Writer.Begin(InPath, Info.NumChannels, Info.SampleRate, 0, Metagrain::EGrainSampleFormat::Float32, OutError)
+            || !Writer.Append(Samples, static_cast<int32_t>(Info.NumFrames), OutError)
+            || !Writer.Finish(nullptr, 0, OutError))
+        {
+            return nullptr;
+        }
+        return Metagrain::FGrainMappedSource::Open(InPath, 0, OutError);
+    }
+
+    template<typename EngineType, typename ParamsType, typename SetParamFunc, typename StartFunc>
+    FCaseResult RunCase(const FParamScript& InScript, const std::shared_ptr<Metagrain::IGrainSource>& InSource, const Metagrain::FGrainMappedSource* InMapped,
+        SetParamFunc&& InSetParam, StartFunc&& InStart)
+    {
+        ParamsType Params;
+        for (const FParamScriptEvent& Event : InScript.Events)
+        {
+            InSetParam(Params, Event.Name, Event.Value);
+        }
+
+        EngineType Engine;
+        Engine.Init(SampleRate, BlockSize);
+        Engine.SetSource(InSource);
+        Engine.GetRandom().Seed(1);
+        InStart(Engine, Params);
+
+        std::vector<float> Left(BlockSize);
+        std::vector<float> Right(BlockSize);
+        FCaseResult Result;
+        for (int32_t Block = 0; Block < NumWarmupBlocks + NumCheckedBlocks; ++Block)
+        {
+            const uint64_t GrainsBefore = Engine.GetStats().GrainsStarted;
+            const uint64_t ReadersBefore = Engine.GetStats().ReadersCreated;
+            const uint64_t PrefetchCallsBefore = InMapped ? InMapped->GetNumPrefetchCalls() : 0;
+            const uint64_t PrefetchBytesBefore = InMapped ? InMapped->GetNumPrefetchBytes() : 0;
+            uint32_t NumAllocations = 0;
+            NumCapturedStacks = 0;
+            {
+                Metagrain::FRealtimeScope RealtimeScope;
+                Engine.Process(Params, Left.data(), Right.data());
+                Engine.ClearSpawnEvents();
+                NumAllocations = RealtimeScope.GetNumAllocations();
+            }
+            if (Block < NumWarmupBlocks)
+            {
+                continue;
+            }
+
+            const int64_t GrainsStarted = static_cast<int64_t>(Engine.GetStats().GrainsStarted - GrainsBefore);
+            const int64_t ReadersCreated = static_cast<int64_t>(Engine.GetStats().ReadersCreated - ReadersBefore);
+            ++Result.NumBlocks;
+            Result.GrainsStarted += GrainsStarted;
+            Result.ReadersCreated += ReadersCreated;
+            Result.WorstBlockAllocations = std::max<int64_t>(Result.WorstBlockAllocations, NumAllocations);
+            if (GrainsStarted == 0)
+            {
+                ++Result.NumQuietBlocks;
+                Result.QuietBlockAllocations += NumAllocations;
+            }
+            else
+            {
+                Result.SpawnBlockAllocations += NumAllocations;
+            }
+
+            const int64_t GrowthAllocations = std::max<int64_t>(0, static_cast<int64_t>(NumAllocations) - ReadersCreated);
+            const bool bLateBlock = Block >= NumWarmupBlocks + NumCheckedBlocks / 2;
+            Result.GrowthAllocations += GrowthAllocations;
+            Result.LateGrowthAllocations += bLateBlock ? GrowthAllocations : 0;
+
+            const int64_t PrefetchCalls = InMapped ? static_cast<int64_t>(InMapped->GetNumPrefetchCalls() - PrefetchCallsBefore) : 0;
+            const uint64_t PrefetchBytes = InMapped ? InMapped->GetNumPrefetchBytes() - PrefetchBytesBefore : 0;
+            Result.PrefetchCalls += PrefetchCalls;
+            Result.QuietBlockPrefetchCalls += (GrainsStarted == 0) ? PrefetchCalls : 0;
+            Result.OversizedPrefetchBlocks += (PrefetchBytes > static_cast<uint64_t>(GrainsStarted) * MaxBytesPerHint) ? 1 : 0;
+            Result.LatePrefetchBytes += bLateBlock ? static_cast<int64_t>(PrefetchBytes) : 0;
+            Result.LateGrainsStarted += bLateBlock ? GrainsStarted : 0;
+
+            const bool bViolation = (GrainsStarted == 0 && NumAllocations > 0) || (bLateBlock && GrowthAllocations > 0);
+            for (int32_t Index = 0; bViolation && Index < NumCapturedStacks && NumViolationStacks < MaxCapturedStacks; ++Index)
+            {
+                ViolationStacks[NumViolationStacks++] = CapturedStacks[Index];
+            }
+        }
+        return Result;
+    }
+
+    void PrintViolationStacks(int32_t InMaxStacks)
+    {
+        for (int32_t Index = 0; Index < std::min(InMaxStacks, NumViolationStacks); ++Index)
+        {
+            const FAllocationStack& Stack = ViolationStacks[Index];
+            std::printf("    allocation of %zu bytes:\n", Stack.Size);
+            std::fflush(stdout);
+#if METAGRAIN_RTCHECK_HAS_BACKTRACE
+            // Skip the hook itself and operator new
+            const int32_t FirstFrame = std::min(2, Stack.NumFrames);
+            backtrace_symbols_fd(Stack.Frames + FirstFrame, Stack.NumFrames - FirstFrame, STDOUT_FILENO);
+#else
+            std::printf("      (no backtrace support on this platform)\n");
+#endif
+        }
+    }
+}
+
+int main(int ArgC, char** ArgV)
+{
+    std::string Filter;
+    int32_t MaxStacks = 2;
+    for (int32_t Index = 1; Index < ArgC; ++Index)
+    {
+        const std::string Arg = ArgV[Index];
+        const bool bHasValue = Index + 1 < ArgC;
+        if (Arg == "--filter" && bHasValue) { Filter = ArgV[++Index]; }
+        else if (Arg == "--stacks" && bHasValue) { MaxStacks = std::max(0, std::atoi(ArgV[++Index])); }
+        else
+        {
+            std::fprintf(stderr, "Usage: MetagrainRtCheck [--filter <text>] [--stacks <n>]\n");
+            return 2;
+        }
+    }
+
+#if METAGRAIN_RTCHECK_HAS_BACKTRACE
+    // The first backtrace() loads the unwinder, which allocates; do it before any scope is open
+    void* WarmupFrames[4];
+    backtrace(WarmupFrames, 4);
+#endif
+
+    std::string Error;
+    const std::shared_ptr<Metagrain::IGrainSource> MemorySource = MakeSyntheticSource(2, SampleRate, 8.0f);
+    const std::string MappedPath = (std::filesystem::temp_directory_path() / "MetagrainRtCheck.mgsc").string();
+    bool bMappedWritten = false;
+    int32_t NumFailed = 0;
+    int32_t NumRun = 0;
+    for (const FRtCheckCase& Case : RtCheckCases)
+    {
+        if (!Filter.empty() && std::string(Case.Name).find(Filter) == std::string::npos)
+        {
+            continue;
+        }
+        ++NumRun;
+
+        FParamScript Script;
+        if (!Script.ParseString(Case.Script, Error) || !ValidateScript(Script, Case.Node, Error))
+        {
+            std::fprintf(stderr, "MetagrainRtCheck: case %s: %s\n", Case.Name, Error.c_str());
+            return 1;
+        }
+
+        using namespace Metagrain;
+
+        // Each mapped case opens the file anew, so hints from the previous case do not count as already sent
+        std::shared_ptr<FGrainMappedSource> Mapped;
+        if (Case.bMappedSource)
+        {
+            Mapped = bMappedWritten ? FGrainMappedSource::Open(MappedPath, 0, Error) : MakeMappedSource(MappedPath, Error);
+            if (!Mapped)
+            {
+                std::fprintf(stderr, "MetagrainRtCheck: case %s: %s\n", Case.Name, Error.c_str());
+                return 1;
+            }
+            bMappedWritten = true;
+        }
+        const std::shared_ptr<IGrainSource> Source = Mapped ? std::shared_ptr<IGrainSource>(Mapped) : MemorySource;
+
+        NumViolationStacks = 0;
+        const FCaseResult Result = (Case.Node == ERenderNode::Smooth)
+            ? RunCase<FGranularSmoothEngine, FGranularSmoothParams>(Script, Source, Mapped.get(),
+                [](FGranularSmoothParams& OutParams, const std::string& InName, float InValue) { SetSmoothParam(OutParams, InName, InValue); },
+                [](FGranularSmoothEngine& Engine, const FGranularSmoothParams&) { Engine.Start(); })
+            : RunCase<FGranularSynthEngine, FGranularSynthParams>(Script, Source, Mapped.get(),
+                [](FGranularSynthParams& OutParams, const std::string& InName, float InValue) { SetSynthParam(OutParams, InName, InValue); },
+                [](FGranularSynthEngine& Engine, const FGranularSynthParams& InParams) { Engine.Start(InParams, 0); });
+
+        std::string Failure;
+        if (Result.GrainsStarted == 0)
+        {
+            Failure = "no grains started";
+        }
+        else if (Result.QuietBlockAllocations > 0)
+        {
+            Failure = "blocks without grain starts allocated";
+        }
+        else if (Result.LateGrowthAllocations > 0)
+        {
+            Failure = "buffers still growing in steady state";
+        }
+        else if (Result.QuietBlockPrefetchCalls > 0)
+        {
+            Failure = "blocks without grain starts sent page-in hints";
+        }
+        else if (Result.OversizedPrefetchBlocks > 0)
+        {
+            Failure = "page-in hints larger than the grains started";
+        }
+        else if (Mapped && static_cast<double>(Result.LatePrefetchBytes) > static_cast<double>(Mapped->GetMappedBytes())
+            * (1.0 + 2.0 * static_cast<double>(Result.LateGrainsStarted) / FGrainMappedSource::PrefetchRefreshHints))
+        {
+            // Every granule at most once, plus once per refresh interval of hints (two per grain when wrapping)
+            Failure = "page-in hints repeated for pages already hinted";
+        }
+
+        const bool bPassed = Failure.empty();
+        NumFailed += bPassed ? 0 : 1;
+        std::printf("%s %-34s %5lld blocks (%lld quiet)  %6lld grains (%lld new readers)  allocs: %lld quiet, %lld in spawn blocks (%lld growth, %lld late), worst block %lld  %s\n",
+            bPassed ? "ok  " : "FAIL", Case.Name, static_cast<long long>(Result.NumBlocks), static_cast<long long>(Result.NumQuietBlocks),
+            static_cast<long long>(Result.GrainsStarted), static_cast<long long>(Result.ReadersCreated), static_cast<long long>(Result.QuietBlockAllocations),
+            static_cast<long long>(Result.SpawnBlockAllocations), static_cast<long long>(Result.GrowthAllocations),
+            static_cast<long long>(Result.LateGrowthAllocations), static_cast<long long>(Result.WorstBlockAllocations), Failure.c_str());
+        if (Mapped)
+        {
+            std::printf("     %-34s page-in hints: %lld calls, %lld KB in the second half for a %lld KB file\n", "", static_cast<long long>(Result.PrefetchCalls),
+                static_cast<long long>(Result.LatePrefetchBytes / 1024), static_cast<long long>(Mapped->GetMappedBytes() / 1024));
+        }
+        if (!bPassed)
+        {
+            PrintViolationStacks(MaxStacks);
+        }
+    }
+
+    if (bMappedWritten)
+    {
+        std::error_code RemoveError;
+        std::filesystem::remove(MappedPath, RemoveError);
+    }
+
+    std::printf("%d of %d case(s) real-time safe\n", NumRun - NumFailed, NumRun);
+    return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,490 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Soak and scalability harness. Renders N instances of a granular engine side by side, the way one audio
+// render thread runs every emitter in a busy area, and reports how the cost scales with N: CPU per rendered
+// second, per-instance cost per block, block time percentiles against the block's real-time deadline,
+// memory held by voices and sources, and heap allocations made while rendering.
+//
+//   MetagrainSoak --node synth --counts 1,16,64,150,300 --seconds 120
+//   MetagrainSoak --node smooth --sources 1 --vary GrainDurationMs=40:400 --vary PitchShiftSemitones=-12:12
+//
+// Every instance gets its own seed and draws each --vary parameter uniformly from its range, on top of the
+// --set values. Instances use --sources distinct synthetic sources round robin, so --sources 1 shares one
+// source between all of them and --sources 0 gives every instance its own.
+
+#include "OfflineRender.h"
+#include "SyntheticSource.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Counts every heap allocation; the harness diffs it around the render loop
+    std::atomic<uint64_t> NumHeapAllocations{ 0 };
+
+    void* CountedAllocate(size_t InSize)
+    {
+        NumHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+        void* Memory = std::malloc(InSize > 0 ? InSize : 1);
+        if (Memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return Memory;
+    }
+}
+
+void* operator new(size_t InSize) { return CountedAllocate(InSize); }
+void* operator new[](size_t InSize) { return CountedAllocate(InSize); }
+void operator delete(void* InMemory) noexcept { std::free(InMemory); }
+void operator delete[](void* InMemory) noexcept { std::free(InMemory); }
+void operator delete(void* InMemory, size_t) noexcept { std::free(InMemory); }
+void operator delete[](void* InMemory, size_t) noexcept { std::free(InMemory); }
+
+namespace
+{
+    using namespace MetagrainTools;
+
+    struct FParamRange
+    {
+        std::string Name;
+        float Min = 0.0f;
+        float Max = 0.0f;
+    };
+
+    struct FCommandLine
+    {
+        ERenderNode Node = ERenderNode::Synth;
+        std::vector<int32_t> Counts = { 1, 8, 32, 64, 150 };
+        float Seconds = 30.0f;
+        float SampleRate = 48000.0f;
+        int32_t BlockSize = 256;
+        int32_t NumSources = 1;
+        int32_t SourceChannels = 2;
+        float SourceSeconds = 10.0f;
+        uint32_t Seed = 1;
+        std::string InputPath;
+        std::string CsvPath;
+        FParamScript Sets;
+        std::vector<FParamRange> Ranges;
+    };
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+            "Usage: MetagrainSoak [options]\n"
+            "\n"
+            "  --node synth|synth-lite|smooth\n"
+            "                          Engine to instantiate (default synth)\n"
+            "  --counts a,b,c          Instance counts to measure (default 1,8,32,64,150)\n"
+            "  --seconds <s>           Audio rendered per instance count (default 30)\n"
+            "  --rate <hz>             Sample rate (default 48000)\n"
+            "  --block <frames>        Block size (default 256)\n"
+            "  --set Name=Value        Parameter for every instance (repeatable)\n"
+            "  --vary Name=Min:Max     Parameter drawn per instance from a uniform range (repeatable)\n"
+            "  --sources <n>           Distinct synthetic sources, assigned round robin; 0 = one per instance (default 1)\n"
+            "  --channels <n>          Channels of the synthetic sources (default 2)\n"
+            "  --in <source.wav>       Share one WAV source between all instances instead\n"
+            "  --seed <n>              Seed of the first instance (default 1)\n"
+            "  --csv <file>            Also write one row per instance count\n");
+    }
+
+    bool ParseCounts(const std::string& InText, std::vector<int32_t>& OutCounts)
+    {
+        OutCounts.clear();
+        size_t Start = 0;
+        while (Start <= InText.size())
+        {
+            const size_t Comma = std::min(InText.find(',', Start), InText.size());
+            const int32_t Count = std::atoi(InText.substr(Start, Comma - Start).c_str());
+            if (Count <= 0)
+            {
+                return false;
+            }
+            OutCounts.push_back(Count);
+            Start = Comma + 1;
+        }
+        return !OutCounts.empty();
+    }
+
+    bool ParseRange(const std::string& InText, FParamRange& OutRange)
+    {
+        const size_t Equals = InText.find('=');
+        const size_t Colon = InText.find(':', Equals);
+        if (Equals == std::string::npos || Colon == std::string::npos)
+        {
+            return false;
+        }
+        OutRange.Name = InText.substr(0, Equals);
+        OutRange.Min = static_cast<float>(std::atof(InText.substr(Equals + 1, Colon - Equals - 1).c_str()));
+        OutRange.Max = static_cast<float>(std::atof(InText.substr(Colon + 1).c_str()));
+        return !OutRange.Name.empty();
+    }
+
+    bool ParseCommandLine(int32_t ArgC, char** ArgV, FCommandLine& Out, std::string& OutError)
+    {
+        for (int32_t Index = 1; Index < ArgC; ++Index)
+        {
+            const std::string Arg = ArgV[Index];
+            if (Arg == "--help" || Arg == "-h")
+            {
+                return false;
+            }
+            if (Index + 1 >= ArgC)
+            {
+                OutError = "missing value for " + Arg;
+                return false;
+            }
+            const std::string Value = ArgV[++Index];
+
+            if (Arg == "--node")
+            {
+                if (!LexFromString(Value, Out.Node))
+                {
+                    OutError = "unknown node '" + Value + "'";
+                    return false;
+                }
+            }
+            else if (Arg == "--counts")
+            {
+                if (!ParseCounts(Value, Out.Counts))
+                {
+                    OutError = "bad instance counts '" + Value + "'";
+                    return false;
+                }
+            }
+            else if (Arg == "--set")
+            {
+                if (!Out.Sets.ParseString(Value, OutError))
+                {
+                    return false;
+                }
+            }
+            else if (Arg == "--vary")
+            {
+                FParamRange Range;
+                if (!ParseRange(Value, Range))
+                {
+                    OutError = "bad range '" + Value + "', expected Name=Min:Max";
+                    return false;
+                }
+                Out.Ranges.push_back(Range);
+            }
+            else if (Arg == "--seconds") { Out.Seconds = static_cast<float>(std::atof(Value.c_str())); }
+            else if (Arg == "--rate") { Out.SampleRate = static_cast<float>(std::atof(Value.c_str())); }
+            else if (Arg == "--block") { Out.BlockSize = std::atoi(Value.c_str()); }
+            else if (Arg == "--sources") { Out.NumSources = std::max(0, std::atoi(Value.c_str())); }
+            else if (Arg == "--channels") { Out.SourceChannels = std::max(1, std::atoi(Value.c_str())); }
+            else if (Arg == "--in") { Out.InputPath = Value; }
+            else if (Arg == "--seed") { Out.Seed = static_cast<uint32_t>(std::strtoul(Value.c_str(), nullptr, 10)); }
+            else if (Arg == "--csv") { Out.CsvPath = Value; }
+            else
+            {
+                OutError = "unknown option " + Arg;
+                return false;
+            }
+        }
+
+        if (Out.BlockSize <= 0 || Out.SampleRate <= 0.0f || Out.Seconds <= 0.0f)
+        {
+            OutError = "block size, sample rate and seconds must be positive";
+            return false;
+        }
+
+        // Ranges go through the same name check as the --set values
+        FParamScript RangeCheck;
+        for (const FParamRange& Range : Out.Ranges)
+        {
+            FParamScriptEvent Event;
+            Event.Name = Range.Name;
+            RangeCheck.Events.push_back(Event);
+        }
+        return ValidateScript(Out.Sets, Out.Node, OutError) && ValidateScript(RangeCheck, Out.Node, OutError);
+    }
+
+    // One emitter: an engine with its own parameters and seed.
+    class ISoakInstance
+    {
+    public:
+        virtual ~ISoakInstance() = default;
+        virtual void Process(float* OutLeft, float* OutRight) = 0;
+        virtual Metagrain::FGrainEngineStats GetStats() const = 0;
+    };
+
+    template<typename EngineType, typename ParamsType>
+    class TSoakInstance final : public ISoakInstance
+    {
+    public:
+        template<typename SetParamFunc, typename StartFunc>
+        TSoakInstance(const FCommandLine& InCommandLine, std::shared_ptr<Metagrain::IGrainSource> InSource, uint32_t InSeed,
+            SetParamFunc&& InSetParam, StartFunc&& InStart)
+        {
+            for (const FParamScriptEvent& Event : InCommandLine.Sets.Events)
+            {
+                InSetParam(Params, Event.Name, Event.Value);
+            }
+
+            Engine.Init(InCommandLine.SampleRate, InCommandLine.BlockSize);
+            Engine.SetSource(std::move(InSource));
+            Engine.GetRandom().Seed(InSeed);
+            for (const FParamRange& Range : InCommandLine.Ranges)
+            {
+                InSetParam(Params, Range.Name, Engine.GetRandom().FRandRange(Range.Min, Range.Max));
+            }
+            InStart(Engine, Params);
+        }
+
+        virtual void Process(float* OutLeft, float* OutRight) override
+        {
+            Engine.Process(Params, OutLeft, OutRight);
+            Engine.ClearSpawnEvents();
+        }
+
+        virtual Metagrain::FGrainEngineStats GetStats() const override
+        {
+            return Engine.GetStats();
+        }
+
+    private:
+        EngineType Engine;
+        ParamsType Params;
+    };
+
+    std::unique_ptr<ISoakInstance> MakeInstance(const FCommandLine& InCommandLine, std::shared_ptr<Metagrain::IGrainSource> InSource, uint32_t InSeed)
+    {
+        using namespace Metagrain;
+
+        if (InCommandLine.Node == ERenderNode::Smooth)
+        {
+            return std::make_unique<TSoakInstance<FGranularSmoothEngine, FGranularSmoothParams>>(InCommandLine, std::move(InSource), InSeed,
+                [](FGranularSmoothParams& OutParams, const std::string& InName, float InValue) { SetSmoothParam(OutParams, InName, InValue); },
+                [](FGranularSmoothEngine& Engine, const FGranularSmoothParams&) { Engine.Start(); });
+        }
+
+        if (InCommandLine.Node == ERenderNode::SynthLite)
+        {
+            return std::make_unique<TSoakInstance<FGranularSynthLiteEngine, FGranularSynthParams>>(InCommandLine, std::move(InSource), InSeed,
+                [](FGranularSynthParams& OutParams, const std::string& InName, float InValue) { SetSynthParam(OutParams, InName, InValue); },
+                [](FGranularSynthLiteEngine& Engine, const FGranularSynthParams& InParams) { Engine.Start(InParams, 0); });
+        }
+
+        return std::make_unique<TSoakInstance<FGranularSynthEngine, FGranularSynthParams>>(InCommandLine, std::move(InSource), InSeed,
+            [](FGranularSynthParams& OutParams, const std::string& InName, float InValue) { SetSynthParam(OutParams, InName, InValue); },
+            [](FGranularSynthEngine& Engine, const FGranularSynthParams& InParams) { Engine.Start(InParams, 0); });
+    }
+
+    struct FSoakResult
+    {
+        int32_t NumInstances = 0;
+        double MsPerSecond = 0.0;              // CPU per rendered second, all instances
+        double InstanceUsPerBlock = 0.0;       // Mean cost of one instance for one block
+        double P50BlockUs = 0.0;               // Percentiles of the time to render one block of every instance
+        double P95BlockUs = 0.0;
+        double P99BlockUs = 0.0;
+        double MaxBlockUs = 0.0;
+        double DeadlineUs = 0.0;               // Real-time duration of one block
+        uint64_t VoiceBytes = 0;
+        uint64_t SourceBytes = 0;              // Counted once per distinct source
+        double AllocationsPerSecond = 0.0;
+        double GrainsPerSecond = 0.0;
+        int32_t MeanActiveVoices = 0;
+    };
+
+    double GetPercentile(std::vector<double>& InOutSorted, double InFraction)
+    {
+        const size_t Index = std::min(InOutSorted.size() - 1, static_cast<size_t>(InFraction * static_cast<double>(InOutSorted.size() - 1) + 0.5));
+        return InOutSorted[Index];
+    }
+
+    FSoakResult RunSoak(const FCommandLine& InCommandLine, const std::vector<std::shared_ptr<Metagrain::IGrainSource>>& InSources, int32_t InNumInstances)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<std::unique_ptr<ISoakInstance>> Instances;
+        Instances.reserve(InNumInstances);
+        for (int32_t Index = 0; Index < InNumInstances; ++Index)
+        {
+            const std::shared_ptr<Metagrain::IGrainSource>& Source = InSources[Index % InSources.size()];
+            Instances.push_back(MakeInstance(InCommandLine, Source, InCommandLine.Seed + static_cast<uint32_t>(Index)));
+        }
+
+        const int32_t BlockSize = InCommandLine.BlockSize;
+        const int64_t NumBlocks = std::max<int64_t>(1, static_cast<int64_t>(InCommandLine.Seconds * InCommandLine.SampleRate) / BlockSize);
+        std::vector<float> Left(BlockSize);
+        std::vector<float> Right(BlockSize);
+        std::vector<double> BlockUs;
+        BlockUs.reserve(static_cast<size_t>(NumBlocks));
+
+        uint64_t GrainsBefore = 0;
+        for (const std::unique_ptr<ISoakInstance>& Instance : Instances)
+        {
+            GrainsBefore += Instance->GetStats().GrainsStarted;
+        }
+
+        double TotalSeconds = 0.0;
+        int64_t ActiveVoiceSum = 0;
+        const uint64_t AllocationsBefore = NumHeapAllocations.load(std::memory_order_relaxed);
+        for (int64_t Block = 0; Block < NumBlocks; ++Block)
+        {
+            const Clock::time_point BlockStart = Clock::now();
+            for (const std::unique_ptr<ISoakInstance>& Instance : Instances)
+            {
+                Instance->Process(Left.data(), Right.data());
+            }
+            const double Seconds = std::chrono::duration<double>(Clock::now() - BlockStart).count();
+            TotalSeconds += Seconds;
+            BlockUs.push_back(Seconds * 1.0e6);
+
+            // Sampled sparsely, summing stats is not free with hundreds of instances
+            if ((Block & 63) == 0)
+            {
+                for (const std::unique_ptr<ISoakInstance>& Instance : Instances)
+                {
+                    ActiveVoiceSum += Instance->GetStats().ActiveVoices;
+                }
+            }
+        }
+        const uint64_t Allocations = NumHeapAllocations.load(std::memory_order_relaxed) - AllocationsBefore;
+
+        FSoakResult Result;
+        Result.NumInstances = InNumInstances;
+        const double RenderedSeconds = static_cast<double>(NumBlocks * BlockSize) / InCommandLine.SampleRate;
+        Result.MsPerSecond = TotalSeconds * 1000.0 / RenderedSeconds;
+        Result.InstanceUsPerBlock = TotalSeconds * 1.0e6 / (static_cast<double>(NumBlocks) * InNumInstances);
+        std::sort(BlockUs.begin(), BlockUs.end());
+        Result.P50BlockUs = GetPercentile(BlockUs, 0.50);
+        Result.P95BlockUs = GetPercentile(BlockUs, 0.95);
+        Result.P99BlockUs = GetPercentile(BlockUs, 0.99);
+        Result.MaxBlockUs = BlockUs.back();
+        Result.DeadlineUs = BlockSize * 1.0e6 / InCommandLine.SampleRate;
+        Result.AllocationsPerSecond = static_cast<double>(Allocations) / RenderedSeconds;
+        Result.MeanActiveVoices = static_cast<int32_t>(ActiveVoiceSum / ((NumBlocks + 63) / 64));
+
+        uint64_t GrainsAfter = 0;
+        for (const std::unique_ptr<ISoakInstance>& Instance : Instances)
+        {
+            const Metagrain::FGrainEngineStats Stats = Instance->GetStats();
+            GrainsAfter += Stats.GrainsStarted;
+            Result.VoiceBytes += Stats.VoiceBufferBytes;
+        }
+        Result.GrainsPerSecond = static_cast<double>(GrainsAfter - GrainsBefore) / RenderedSeconds;
+
+        const size_t NumDistinctSources = std::min(InSources.size(), static_cast<size_t>(InNumInstances));
+        for (size_t Index = 0; Index < NumDistinctSources; ++Index)
+        {
+            Result.SourceBytes += InSources[Index]->GetAllocatedBytes();
+        }
+        return Result;
+    }
+}
+
+int main(int ArgC, char** ArgV)
+{
+    FCommandLine CommandLine;
+    std::string Error;
+    if (!ParseCommandLine(ArgC, ArgV, CommandLine, Error))
+    {
+        if (!Error.empty())
+        {
+            std::fprintf(stderr, "MetagrainSoak: %s\n\n", Error.c_str());
+        }
+        PrintUsage();
+        return 2;
+    }
+
+    const int32_t MaxInstances = *std::max_element(CommandLine.Counts.begin(), CommandLine.Counts.end());
+    std::vector<std::shared_ptr<Metagrain::IGrainSource>> Sources;
+    if (!CommandLine.InputPath.empty())
+    {
+        FWavData Wav;
+        if (!ReadWavFile(CommandLine.InputPath, Wav, Error))
+        {
+            std::fprintf(stderr, "MetagrainSoak: %s\n", Error.c_str());
+            return 1;
+        }
+        Sources.push_back(std::make_shared<Metagrain::FGrainMemorySource>(std::move(Wav.Samples), Wav.NumChannels, static_cast<float>(Wav.SampleRate)));
+    }
+    else
+    {
+        const int32_t NumSources = CommandLine.NumSources > 0 ? std::min(CommandLine.NumSources, MaxInstances) : MaxInstances;
+        for (int32_t Index = 0; Index < NumSources; ++Index)
+        {
+            Sources.push_back(MakeSyntheticSource(CommandLine.SourceChannels, CommandLine.SampleRate, CommandLine.SourceSeconds, static_cast<uint32_t>(Index + 1)));
+        }
+    }
+
+    FILE* CsvFile = nullptr;
+    if (!CommandLine.CsvPath.empty())
+    {
+        CsvFile = std::fopen(CommandLine.CsvPath.c_str(), "w");
+        if (CsvFile == nullptr)
+        {
+            std::fprintf(stderr, "MetagrainSoak: cannot write '%s'\n", CommandLine.CsvPath.c_str());
+            return 1;
+        }
+        std::fprintf(CsvFile, "node,instances,ms_per_second,instance_us_per_block,p50_block_us,p95_block_us,p99_block_us,max_block_us,"
+            "deadline_us,voice_bytes,source_bytes,allocations_per_second,grains_per_second,mean_active_voices\n");
+    }
+
+    std::printf("%s, %d source(s), %.0f s per count, %d frame blocks at %.0f Hz\n", LexToString(CommandLine.Node),
+        static_cast<int32_t>(Sources.size()), CommandLine.Seconds, CommandLine.BlockSize, CommandLine.SampleRate);
+    std::printf("%9s %10s %10s %9s %9s %9s %9s %7s %10s %10s %9s %9s\n", "instances", "ms/s", "us/inst", "p50 us", "p95 us", "p99 us",
+        "max us", "p99 %", "voice KB", "source KB", "allocs/s", "grains/s");
+
+    // The bend is where one instance starts to cost noticeably more than it does alone (cache pressure)
+    // or where the slowest blocks no longer fit the real-time deadline
+    double BaselineInstanceUs = 0.0;
+    int32_t FirstBendCount = 0;
+    int32_t FirstOverDeadlineCount = 0;
+    for (int32_t Count : CommandLine.Counts)
+    {
+        const FSoakResult Result = RunSoak(CommandLine, Sources, Count);
+        BaselineInstanceUs = (BaselineInstanceUs > 0.0) ? BaselineInstanceUs : Result.InstanceUsPerBlock;
+        if (FirstBendCount == 0 && Result.InstanceUsPerBlock > BaselineInstanceUs * 1.25)
+        {
+            FirstBendCount = Count;
+        }
+        if (FirstOverDeadlineCount == 0 && Result.P99BlockUs > Result.DeadlineUs)
+        {
+            FirstOverDeadlineCount = Count;
+        }
+
+        std::printf("%9d %10.2f %10.2f %9.1f %9.1f %9.1f %9.1f %6.1f%% %10.1f %10.1f %9.1f %9.1f\n", Result.NumInstances, Result.MsPerSecond,
+            Result.InstanceUsPerBlock, Result.P50BlockUs, Result.P95BlockUs, Result.P99BlockUs, Result.MaxBlockUs,
+            Result.P99BlockUs * 100.0 / Result.DeadlineUs, Result.VoiceBytes / 1024.0, Result.SourceBytes / 1024.0,
+            Result.AllocationsPerSecond, Result.GrainsPerSecond);
+        std::fflush(stdout);
+
+        if (CsvFile != nullptr)
+        {
+            std::fprintf(CsvFile, "%s,%d,%.4f,%.4f,%.2f,%.2f,%.2f,%.2f,%.2f,%llu,%llu,%.2f,%.2f,%d\n", LexToString(CommandLine.Node),
+                Result.NumInstances, Result.MsPerSecond, Result.InstanceUsPerBlock, Result.P50BlockUs, Result.P95BlockUs, Result.P99BlockUs,
+                Result.MaxBlockUs, Result.DeadlineUs, static_cast<unsigned long long>(Result.VoiceBytes),
+                static_cast<unsigned long long>(Result.SourceBytes), Result.AllocationsPerSecond, Result.GrainsPerSecond, Result.MeanActiveVoices);
+        }
+    }
+
+    if (CsvFile != nullptr)
+    {
+        std::fclose(CsvFile);
+    }
+
+    if (FirstBendCount > 0)
+    {
+        std::printf("per-instance cost is 25%% above the %d-instance baseline from %d instances\n", CommandLine.Counts.front(), FirstBendCount);
+    }
+    if (FirstOverDeadlineCount > 0)
+    {
+        std::printf("p99 block time exceeds the %.0f us deadline from %d instances\n", CommandLine.BlockSize * 1.0e6 / CommandLine.SampleRate, FirstOverDeadlineCount);
+    }
+    return 0;
+}